@@ -155,6 +155,8 @@ extern void read_voisj_ (int *,
                          int *);
 
 extern int alloc_contj_voisj_ (int *,
+                               int *,
+                               int *,
                                int *);
 
 extern int bonding_ (int *,
@@ -165,8 +167,7 @@ extern int bonding_ (int *,
                      double *,
                      char *);
 
-extern int molecules_ (int *,
-                       int *);
+extern int molecules_ (int *);
 
 extern int bond_angles_ (int *);
 extern int bond_diedrals_ (int *);
@@ -212,6 +213,7 @@ extern int s_of_k_t_ (int *,
                       double *,
                       int *,
                       double *,
+                      int *,
                       int *);
 
 extern int send_gr_ (int *,
@@ -233,9 +235,27 @@ extern int g_of_r_fft_ (int *,
 extern int msd_ (double *,
                  int *);
 
+extern int vacf_ (double *,
+                  int *,
+                  int *,
+                  float *);
+
+extern int fs_of_k_t_ (int *,
+                       double *);
+
+extern int van_hove_ (int *,
+                      double *,
+                      int *,
+                      int *,
+                      int *);
+
 extern int sphericals_ (int *,
                         int *,
                         int *,
                         int *,
                         int *);
+
+extern int steinhardt_ (int *,
+                        int *,
+                        float *);
 #endif
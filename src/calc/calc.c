@@ -68,7 +68,6 @@ project * qm_proj;
 glwin * qm_view;
 coord_info * qm_coord;
 GtkTextBuffer * qmbuffer[MAXDATAQM+2];
-gboolean force_mol = FALSE;
 int idopt;
 int icalc;
 int ident;
@@ -341,9 +340,7 @@ G_MODULE_EXPORT void create_field (GtkWidget * widg, gpointer data)
     select_unselect_atoms (NULL, & t_data);
 #endif
     // create new project with selection
-    force_mol = TRUE;
     create_new_project_using_data (opengl_project -> modelgl -> anim -> last -> img -> selected[0]);
-    force_mol = FALSE;
     opengl_project -> modelgl -> anim -> last -> img -> step = tmp_s;
     restore_ogl_selection (opengl_project -> modelgl);
     // Set the new project to be use for input creation
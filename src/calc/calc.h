@@ -39,8 +39,6 @@ extern glwin * qm_view;
 extern coord_info * qm_coord;
 extern GtkTextBuffer * qmbuffer[MAXDATAQM+2];
 
-extern gboolean force_mol;
-
 extern int idopt;
 extern int icalc;
 extern int ident;
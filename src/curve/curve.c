@@ -36,6 +36,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void clean_this_curve_window (int cid, int rid);
   void set_curve_data_zero (int rid, int cid, int interv);
   void save_curve_ (int * interv, double datacurve[* interv], int * cid, int * rid);
+  void restore_curve (int rid, int cid, int interv, double * xdata, double * ydata);
   void hide_curves (project * this_proj, int c);
   void remove_this_curve_from_extras (int a, int b, int c);
   void erase_curves (project * this_proj, int c);
@@ -365,6 +366,7 @@ void clean_this_curve_window (int cid, int rid)
     }
   }
   active_project -> analysis[rid] -> curves[cid] -> ndata = 0;
+  clean_curve_decimation (active_project -> analysis[rid] -> curves[cid]);
 }
 
 /*!
@@ -381,7 +383,24 @@ void set_curve_data_zero (int rid, int cid, int interv)
   active_project -> analysis[rid] -> curves[cid] -> ndata = interv;
   active_project -> analysis[rid] -> curves[cid] -> data[0] = allocdouble (interv);
   int i;
-  if (rid != SKT)
+  double dt;
+  if (rid == MSD && cid >= 14*active_project -> nspec + 6)
+  {
+    // VACF in time, then vibrational DOS in frequency
+    dt = active_project -> analysis[MSD] -> delta*active_project -> analysis[MSD] -> num_delta;
+    for (i=0; i<interv; i++)
+    {
+      if (cid < 15*active_project -> nspec + 7)
+      {
+        active_project -> analysis[rid] -> curves[cid] -> data[0][i] = i*dt;
+      }
+      else
+      {
+        active_project -> analysis[rid] -> curves[cid] -> data[0][i] = i/(2.0*interv*dt);
+      }
+    }
+  }
+  else if (rid != SKT)
   {
     for (i=0; i<interv; i++)
     {
@@ -461,6 +480,39 @@ void save_curve_ (int * interv, double datacurve[* interv], int * cid, int * rid
   }
 }
 
+/*!
+  \fn void restore_curve (int rid, int cid, int interv, double * xdata, double * ydata)
+
+  \brief restore calculation results, ex: from the result cache
+
+  \param rid calculation id
+  \param cid curve id
+  \param interv number of data point(s)
+  \param xdata x values
+  \param ydata y values
+*/
+void restore_curve (int rid, int cid, int interv, double * xdata, double * ydata)
+{
+  int i, j;
+  Curve * this_curve = active_project -> analysis[rid] -> curves[cid];
+  clean_this_curve_window (cid, rid);
+  this_curve -> ndata = interv;
+  if (interv)
+  {
+    this_curve -> data[0] = duplicate_double (interv, xdata);
+    this_curve -> data[1] = duplicate_double (interv, ydata);
+    for (i=0; i<2; i++)
+    {
+      j = (this_curve -> extrac) ? this_curve -> extrac -> extras : 0;
+      if (this_curve -> extrac) this_curve -> extrac -> extras = 0;
+      autoscale_axis (active_project, this_curve, rid, cid, i);
+      if (this_curve -> extrac) this_curve -> extrac -> extras = j;
+      this_curve -> majt[i] = scale (this_curve -> axmax[i] - this_curve -> axmin[i]);
+      this_curve -> mint[i] = 2;
+    }
+  }
+}
+
 /*!
   \fn void hide_curves (project * this_proj, int c)
 
@@ -588,6 +640,7 @@ void erase_curves (project * this_proj, int c)
         g_free (this_proj -> analysis[c] -> curves[i] -> title_font);
         this_proj -> analysis[c] -> curves[i] -> title_font = NULL;
       }
+      clean_curve_decimation (this_proj -> analysis[c] -> curves[i]);
       g_free (this_proj -> analysis[c] -> curves[i] -> legend_font);
       g_free (this_proj -> analysis[c] -> curves[i] -> layout);
       g_free (this_proj -> analysis[c] -> curves[i] -> extrac);
@@ -611,13 +664,16 @@ void update_curves ()
     this_proj = get_project_by_id(i);
     for (j=0; j<NCALCS; j++)
     {
-      for (k=0; k<this_proj -> analysis[j] -> numc; k++)
+      if (this_proj -> analysis[j])
       {
-        if (this_proj -> analysis[j] -> curves[k] -> plot != NULL)
+        for (k=0; k<this_proj -> analysis[j] -> numc; k++)
         {
-          if (is_the_widget_visible(this_proj -> analysis[j] -> curves[k] -> plot))
+          if (this_proj -> analysis[j] -> curves[k] -> plot != NULL)
           {
-            gtk_widget_queue_draw (this_proj -> analysis[j] -> curves[k] -> plot);
+            if (is_the_widget_visible(this_proj -> analysis[j] -> curves[k] -> plot))
+            {
+              gtk_widget_queue_draw (this_proj -> analysis[j] -> curves[k] -> plot);
+            }
           }
         }
       }
@@ -161,6 +161,7 @@ extern void curve_window_add_menu_bar (tint * data);
 extern GtkWidget * curve_popup_menu (gpointer data);
 extern void show_curve_popup_menu (GdkEvent * event, gpointer data);
 
+extern void clean_curve_decimation (Curve * this_curve);
 void draw_curve (cairo_t * cr,
                  int cid,
                  int rid,
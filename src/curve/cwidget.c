@@ -116,7 +116,7 @@ DataLayout * curve_default_layout (project * pid, int rid, int cid)
 */
 void curve_default_scale (project * this_proj, int rid, int cid, Curve * this_curve)
 {
-  if (rid < RIN || rid == MSD || rid == SKT)
+  if (rid < RIN || rid >= MSD)
   {
     this_curve -> cmin[0] = this_proj -> analysis[rid] -> min;
     this_curve -> cmax[0] = this_proj ->  analysis[rid] -> max;
@@ -35,9 +35,6 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT gboolean cancel_win (GtkWidget * win, GdkEvent * event, gpointer data);
 
   void get_tree_data (GtkWidget * tree);
-  void save_row (gpointer data, gpointer user_data);
-  void update_first_row (gpointer data, gpointer user_data);
-  void update_first_col ();
   void add_to_last_row (gpointer data, gpointer user_data);
   void add_to_last_col (double cte, gpointer data);
   void multiply_last_row (gpointer data, gpointer user_data);
@@ -58,7 +55,36 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void cancel_changes (GtkWidget * widg, gpointer data);
   void edit_data (gpointer data);
 
-  static void fill_data_model (GtkListStore * store, project * this_proj, int b, int c);
+  static gboolean data_model_set_iter (CurveDataModel * model, GtkTreeIter * iter, int i);
+  static gboolean data_model_get_iter (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreePath * path);
+  static gboolean data_model_iter_next (GtkTreeModel * tree_model, GtkTreeIter * iter);
+  static gboolean data_model_iter_previous (GtkTreeModel * tree_model, GtkTreeIter * iter);
+  static gboolean data_model_iter_nth_child (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent, gint n);
+  static gboolean data_model_iter_children (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent);
+  static gboolean data_model_iter_has_child (GtkTreeModel * tree_model, GtkTreeIter * iter);
+  static gboolean data_model_iter_parent (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * child);
+
+  static gint data_model_get_n_columns (GtkTreeModel * tree_model);
+  static gint data_model_iter_n_children (GtkTreeModel * tree_model, GtkTreeIter * iter);
+
+  static double * data_model_row (CurveDataModel * model, int i);
+
+  static void data_model_get_value (GtkTreeModel * tree_model, GtkTreeIter * iter, gint col, GValue * value);
+  static void curve_data_model_tree_model_init (GtkTreeModelIface * iface);
+  static void curve_data_model_finalize (GObject * object);
+  static void curve_data_model_class_init (CurveDataModelClass * klass);
+  static void curve_data_model_init (CurveDataModel * model);
+  static void curve_data_model_set (GtkTreeModel * tree_model, GtkTreeIter * iter, int col, double val);
+  static void curve_data_model_insert (GtkTreeModel * tree_model, int i);
+  static void curve_data_model_remove (GtkTreeModel * tree_model, int i);
+
+  static GType data_model_get_column_type (GtkTreeModel * tree_model, gint col);
+
+  static GtkTreeModelFlags data_model_get_flags (GtkTreeModel * tree_model);
+
+  static GtkTreePath * data_model_get_path (GtkTreeModel * tree_model, GtkTreeIter * iter);
+
+  static GtkTreeModel * curve_data_model_new (Curve * this_curve);
 
   G_MODULE_EXPORT void edit_cell (GtkCellRendererText * cell, gchar * path_string, gchar * new_text, gpointer user_data);
   G_MODULE_EXPORT void adjust_value (GtkEntry * res, gpointer data);
@@ -104,71 +130,400 @@ GtkTreePath * path;
 GtkTreeIter row;
 gchar * text;
 
+/*! \typedef CurveDataModel
+
+  \brief the curve data tree model: the data are stored in arrays, and the rows
+  are only read by the tree view when displayed, no list store is filled.
+  The first column, the data point id, is the row position.
+*/
+#define CURVE_TYPE_DATA_MODEL (curve_data_model_get_type ())
+G_DECLARE_FINAL_TYPE (CurveDataModel, curve_data_model, CURVE, DATA_MODEL, GObject)
+
+struct _CurveDataModel
+{
+  GObject parent;
+  gint stamp;                   /*!< Stamp of the valid tree iter(s) */
+  GArray * rows;                /*!< The X and Y data, 2 double(s) per row */
+};
+
+static void curve_data_model_tree_model_init (GtkTreeModelIface * iface);
+
+G_DEFINE_TYPE_WITH_CODE (CurveDataModel, curve_data_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_TREE_MODEL, curve_data_model_tree_model_init))
+
 /*!
-  \fn void get_tree_data (GtkWidget * tree)
+  \fn static double * data_model_row (CurveDataModel * model, int i)
 
-  \brief get information on location in a GtkTreeView
+  \brief get the X and Y data of a row of the curve data tree model
 
-  \param tree the GtkTreeView
+  \param model the curve data tree model
+  \param i the row id
 */
-void get_tree_data (GtkWidget * tree)
+static double * data_model_row (CurveDataModel * model, int i)
 {
-  sel = gtk_tree_view_get_selection (GTK_TREE_VIEW(tree));
-  curve_model = gtk_tree_view_get_model(GTK_TREE_VIEW(tree));
-  lrows = gtk_tree_selection_get_selected_rows (sel, & curve_model);
-  nrows = gtk_tree_selection_count_selected_rows (sel);
+  return (double *)model -> rows -> data + 2*i;
 }
 
 /*!
-  \fn void save_row (gpointer data, gpointer user_data)
+  \fn static gboolean data_model_set_iter (CurveDataModel * model, GtkTreeIter * iter, int i)
 
-  \brief save row data and udpate calculation result accordingly
+  \brief set a tree iter on a row of the curve data tree model
 
-  \param data the path in the tree model
-  \param user_data the associated data pointer
+  \param model the curve data tree model
+  \param iter the tree iter to set
+  \param i the row id
 */
-void save_row (gpointer data, gpointer user_data)
+static gboolean data_model_set_iter (CurveDataModel * model, GtkTreeIter * iter, int i)
 {
-  path = data;
-  Curve * this_curve = get_curve_from_pointer (user_data);
-  if (gtk_tree_model_get_iter (curve_model, & row, path))
+  if (i < 0 || i >= model -> rows -> len) return FALSE;
+  iter -> stamp = model -> stamp;
+  iter -> user_data = GINT_TO_POINTER(i);
+  return TRUE;
+}
+
+/*!
+  \fn static GtkTreeModelFlags data_model_get_flags (GtkTreeModel * tree_model)
+
+  \brief get the flags of the curve data tree model
+
+  \param tree_model the curve data tree model
+*/
+static GtkTreeModelFlags data_model_get_flags (GtkTreeModel * tree_model)
+{
+  return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+/*!
+  \fn static gint data_model_get_n_columns (GtkTreeModel * tree_model)
+
+  \brief get the number of columns of the curve data tree model
+
+  \param tree_model the curve data tree model
+*/
+static gint data_model_get_n_columns (GtkTreeModel * tree_model)
+{
+  return 3;
+}
+
+/*!
+  \fn static GType data_model_get_column_type (GtkTreeModel * tree_model, gint col)
+
+  \brief get the type of a column of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param col the column id
+*/
+static GType data_model_get_column_type (GtkTreeModel * tree_model, gint col)
+{
+  return (col) ? G_TYPE_DOUBLE : G_TYPE_INT;
+}
+
+/*!
+  \fn static gboolean data_model_get_iter (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreePath * path)
+
+  \brief get the tree iter of a path in the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter to set
+  \param path the path in the tree model
+*/
+static gboolean data_model_get_iter (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreePath * path)
+{
+  if (gtk_tree_path_get_depth (path) != 1) return FALSE;
+  return data_model_set_iter (CURVE_DATA_MODEL(tree_model), iter, gtk_tree_path_get_indices (path)[0]);
+}
+
+/*!
+  \fn static GtkTreePath * data_model_get_path (GtkTreeModel * tree_model, GtkTreeIter * iter)
+
+  \brief get the path of a tree iter in the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+*/
+static GtkTreePath * data_model_get_path (GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+  return gtk_tree_path_new_from_indices (GPOINTER_TO_INT(iter -> user_data), -1);
+}
+
+/*!
+  \fn static void data_model_get_value (GtkTreeModel * tree_model, GtkTreeIter * iter, gint col, GValue * value)
+
+  \brief get the value of a cell of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+  \param col the column id
+  \param value the value to set
+*/
+static void data_model_get_value (GtkTreeModel * tree_model, GtkTreeIter * iter, gint col, GValue * value)
+{
+  int i = GPOINTER_TO_INT(iter -> user_data);
+  g_value_init (value, data_model_get_column_type (tree_model, col));
+  if (col)
+  {
+    g_value_set_double (value, data_model_row (CURVE_DATA_MODEL(tree_model), i)[col-1]);
+  }
+  else
   {
-    gtk_tree_model_get (curve_model, & row, 1, & this_curve -> data[0][nrows], 2, & this_curve -> data[1][nrows], -1);
+    g_value_set_int (value, i+1);
   }
-  nrows = nrows + 1;
 }
 
 /*!
-  \fn void update_first_row (gpointer data, gpointer user_data)
+  \fn static gboolean data_model_iter_next (GtkTreeModel * tree_model, GtkTreeIter * iter)
 
-  \brief update row in the first column
+  \brief move the tree iter to the next row of the curve data tree model
 
-  \param data the path in the tree model
-  \param user_data the associated data pointer
+  \param tree_model the curve data tree model
+  \param iter the tree iter
 */
-void update_first_row (gpointer data, gpointer user_data)
+static gboolean data_model_iter_next (GtkTreeModel * tree_model, GtkTreeIter * iter)
 {
-  path = data;
-  if (gtk_tree_model_get_iter (curve_model, & row, path))
+  return data_model_set_iter (CURVE_DATA_MODEL(tree_model), iter, GPOINTER_TO_INT(iter -> user_data) + 1);
+}
+
+/*!
+  \fn static gboolean data_model_iter_previous (GtkTreeModel * tree_model, GtkTreeIter * iter)
+
+  \brief move the tree iter to the previous row of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+*/
+static gboolean data_model_iter_previous (GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+  return data_model_set_iter (CURVE_DATA_MODEL(tree_model), iter, GPOINTER_TO_INT(iter -> user_data) - 1);
+}
+
+/*!
+  \fn static gboolean data_model_iter_nth_child (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent, gint n)
+
+  \brief get the nth row of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter to set
+  \param parent the parent tree iter, must be NULL
+  \param n the row id
+*/
+static gboolean data_model_iter_nth_child (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent, gint n)
+{
+  if (parent) return FALSE;
+  return data_model_set_iter (CURVE_DATA_MODEL(tree_model), iter, n);
+}
+
+/*!
+  \fn static gboolean data_model_iter_children (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent)
+
+  \brief get the first row of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter to set
+  \param parent the parent tree iter, must be NULL
+*/
+static gboolean data_model_iter_children (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * parent)
+{
+  return data_model_iter_nth_child (tree_model, iter, parent, 0);
+}
+
+/*!
+  \fn static gboolean data_model_iter_has_child (GtkTreeModel * tree_model, GtkTreeIter * iter)
+
+  \brief the rows of the curve data tree model do not have children
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+*/
+static gboolean data_model_iter_has_child (GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+  return FALSE;
+}
+
+/*!
+  \fn static gint data_model_iter_n_children (GtkTreeModel * tree_model, GtkTreeIter * iter)
+
+  \brief get the number of rows of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter, NULL for the number of rows
+*/
+static gint data_model_iter_n_children (GtkTreeModel * tree_model, GtkTreeIter * iter)
+{
+  return (iter) ? 0 : CURVE_DATA_MODEL(tree_model) -> rows -> len;
+}
+
+/*!
+  \fn static gboolean data_model_iter_parent (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * child)
+
+  \brief the rows of the curve data tree model do not have parent
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+  \param child the child tree iter
+*/
+static gboolean data_model_iter_parent (GtkTreeModel * tree_model, GtkTreeIter * iter, GtkTreeIter * child)
+{
+  return FALSE;
+}
+
+/*!
+  \fn static void curve_data_model_tree_model_init (GtkTreeModelIface * iface)
+
+  \brief initialize the GtkTreeModel interface of the curve data tree model
+
+  \param iface the GtkTreeModel interface
+*/
+static void curve_data_model_tree_model_init (GtkTreeModelIface * iface)
+{
+  iface -> get_flags = data_model_get_flags;
+  iface -> get_n_columns = data_model_get_n_columns;
+  iface -> get_column_type = data_model_get_column_type;
+  iface -> get_iter = data_model_get_iter;
+  iface -> get_path = data_model_get_path;
+  iface -> get_value = data_model_get_value;
+  iface -> iter_next = data_model_iter_next;
+  iface -> iter_previous = data_model_iter_previous;
+  iface -> iter_children = data_model_iter_children;
+  iface -> iter_has_child = data_model_iter_has_child;
+  iface -> iter_n_children = data_model_iter_n_children;
+  iface -> iter_nth_child = data_model_iter_nth_child;
+  iface -> iter_parent = data_model_iter_parent;
+}
+
+/*!
+  \fn static void curve_data_model_finalize (GObject * object)
+
+  \brief free the curve data tree model
+
+  \param object the curve data tree model
+*/
+static void curve_data_model_finalize (GObject * object)
+{
+  g_array_free (CURVE_DATA_MODEL(object) -> rows, TRUE);
+  G_OBJECT_CLASS(curve_data_model_parent_class) -> finalize (object);
+}
+
+/*!
+  \fn static void curve_data_model_class_init (CurveDataModelClass * klass)
+
+  \brief initialize the curve data tree model class
+
+  \param klass the curve data tree model class
+*/
+static void curve_data_model_class_init (CurveDataModelClass * klass)
+{
+  G_OBJECT_CLASS(klass) -> finalize = curve_data_model_finalize;
+}
+
+/*!
+  \fn static void curve_data_model_init (CurveDataModel * model)
+
+  \brief initialize a curve data tree model
+
+  \param model the curve data tree model
+*/
+static void curve_data_model_init (CurveDataModel * model)
+{
+  model -> stamp = g_random_int ();
+  model -> rows = g_array_new (FALSE, TRUE, 2*sizeof(double));
+}
+
+/*!
+  \fn static GtkTreeModel * curve_data_model_new (Curve * this_curve)
+
+  \brief create the curve data tree model, with a copy of the curve data
+
+  \param this_curve the target curve
+*/
+static GtkTreeModel * curve_data_model_new (Curve * this_curve)
+{
+  int i;
+  double * val;
+  CurveDataModel * model = g_object_new (CURVE_TYPE_DATA_MODEL, NULL);
+  g_array_set_size (model -> rows, this_curve -> ndata);
+  for (i=0; i<this_curve -> ndata; i++)
   {
-    nrows = nrows + 1;
-    gtk_list_store_set (GTK_LIST_STORE(curve_model), & row, 0, nrows, -1);
+    val = data_model_row (model, i);
+    val[0] = this_curve -> data[0][i];
+    val[1] = this_curve -> data[1][i];
   }
+  return GTK_TREE_MODEL(model);
 }
 
 /*!
-  \fn void update_first_col ()
+  \fn static void curve_data_model_set (GtkTreeModel * tree_model, GtkTreeIter * iter, int col, double val)
 
-  \brief update all rows in the first column
-*
+  \brief set the value of a cell of the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param iter the tree iter
+  \param col the column id (1 = X, 2 = Y)
+  \param val the new value
 */
-void update_first_col ()
+static void curve_data_model_set (GtkTreeModel * tree_model, GtkTreeIter * iter, int col, double val)
 {
-  gtk_tree_selection_select_all (sel);
+  GtkTreePath * path;
+  if (col < 1 || col > 2) return;
+  data_model_row (CURVE_DATA_MODEL(tree_model), GPOINTER_TO_INT(iter -> user_data))[col-1] = val;
+  path = data_model_get_path (tree_model, iter);
+  gtk_tree_model_row_changed (tree_model, path, iter);
+  gtk_tree_path_free (path);
+}
+
+/*!
+  \fn static void curve_data_model_insert (GtkTreeModel * tree_model, int i)
+
+  \brief insert an empty row in the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param i the position of the new row
+*/
+static void curve_data_model_insert (GtkTreeModel * tree_model, int i)
+{
+  GtkTreeIter iter;
+  GtkTreePath * path;
+  CurveDataModel * model = CURVE_DATA_MODEL(tree_model);
+  double val[2] = {0.0, 0.0};
+  g_array_insert_vals (model -> rows, i, val, 1);
+  model -> stamp ++;
+  data_model_set_iter (model, & iter, i);
+  path = gtk_tree_path_new_from_indices (i, -1);
+  gtk_tree_model_row_inserted (tree_model, path, & iter);
+  gtk_tree_path_free (path);
+}
+
+/*!
+  \fn static void curve_data_model_remove (GtkTreeModel * tree_model, int i)
+
+  \brief remove a row from the curve data tree model
+
+  \param tree_model the curve data tree model
+  \param i the row id
+*/
+static void curve_data_model_remove (GtkTreeModel * tree_model, int i)
+{
+  GtkTreePath * path;
+  CurveDataModel * model = CURVE_DATA_MODEL(tree_model);
+  g_array_remove_index (model -> rows, i);
+  model -> stamp ++;
+  path = gtk_tree_path_new_from_indices (i, -1);
+  gtk_tree_model_row_deleted (tree_model, path);
+  gtk_tree_path_free (path);
+}
+
+/*!
+  \fn void get_tree_data (GtkWidget * tree)
+
+  \brief get information on location in a GtkTreeView
+
+  \param tree the GtkTreeView
+*/
+void get_tree_data (GtkWidget * tree)
+{
+  sel = gtk_tree_view_get_selection (GTK_TREE_VIEW(tree));
+  curve_model = gtk_tree_view_get_model(GTK_TREE_VIEW(tree));
   lrows = gtk_tree_selection_get_selected_rows (sel, & curve_model);
-  nrows = 0;
-  g_list_foreach (lrows, (GFunc)update_first_row, NULL);
-  gtk_tree_selection_unselect_all (sel);
+  nrows = gtk_tree_selection_count_selected_rows (sel);
 }
 
 /*!
@@ -187,7 +542,7 @@ void add_to_last_row (gpointer data, gpointer user_data)
   if (gtk_tree_model_get_iter (curve_model, & row, path))
   {
     gtk_tree_model_get (curve_model, & row, 2, & vold, -1);
-    gtk_list_store_set (GTK_LIST_STORE(curve_model), & row, 2, * cte + vold, -1);
+    curve_data_model_set (curve_model, & row, 2, * cte + vold);
   }
 }
 
@@ -228,7 +583,7 @@ void multiply_last_row (gpointer data, gpointer user_data)
   if (gtk_tree_model_get_iter (curve_model, & row, path))
   {
     gtk_tree_model_get (curve_model, & row, 2, & vold, -1);
-    gtk_list_store_set (GTK_LIST_STORE(curve_model), & row, 2, * cte * vold, -1);
+    curve_data_model_set (curve_model, & row, 2, * cte * vold);
   }
 }
 
@@ -330,18 +685,9 @@ void copy_content (gpointer data)
 */
 void add_row (gpointer data, gpointer user_data)
 {
-  GtkTreeIter newrow;
   if (gtk_tree_model_get_iter (curve_model, & row, path))
   {
-    if (GPOINTER_TO_INT(user_data) == 0)
-    {
-      gtk_list_store_insert_before (GTK_LIST_STORE(curve_model), & newrow, & row);
-    }
-    else
-    {
-      gtk_list_store_insert_after (GTK_LIST_STORE(curve_model), & newrow, & row);
-    }
-    gtk_list_store_set (GTK_LIST_STORE(curve_model), & newrow, 0, 0, 1, 0.00000, 2, 0.00000, -1);
+    curve_data_model_insert (curve_model, gtk_tree_path_get_indices (path)[0] + ((GPOINTER_TO_INT(user_data) == 0) ? 0 : 1));
   }
 }
 
@@ -358,7 +704,7 @@ void delete_row (gpointer data, gpointer user_data)
   path = data;
   if (gtk_tree_model_get_iter (curve_model, & row, path))
   {
-    gtk_list_store_remove (GTK_LIST_STORE(curve_model), & row);
+    curve_data_model_remove (curve_model, gtk_tree_path_get_indices (path)[0]);
   }
 }
 
@@ -380,7 +726,7 @@ void insert_cell (gpointer data)
     path = (GtkTreePath *) g_list_nth_data (lrows, nrows-1);
   }
   g_list_foreach (lrows, (GFunc)add_row, data);
-  update_first_col ();
+  gtk_tree_selection_unselect_all (sel);
 }
 
 /*!
@@ -393,7 +739,7 @@ void insert_cell (gpointer data)
 void delete_cell (gpointer data)
 {
   g_list_foreach (g_list_reverse (lrows), (GFunc)delete_row, NULL);
-  update_first_col ();
+  gtk_tree_selection_unselect_all (sel);
 }
 
 /*!
@@ -413,7 +759,7 @@ G_MODULE_EXPORT void edit_cell (GtkCellRendererText * cell, gchar * path_string,
   curve_model = gtk_tree_view_get_model(GTK_TREE_VIEW(this_proj -> analysis[id -> b] -> curves[id -> c] -> datatree));
   gtk_tree_model_get_iter_from_string (curve_model, & row, path_string);
   double val = string_to_double ((gpointer)new_text);
-  gtk_list_store_set (GTK_LIST_STORE(curve_model), & row, id -> d, val, -1);
+  curve_data_model_set (curve_model, & row, id -> d, val);
 }
 
 GtkWidget * col_entry;
@@ -841,30 +1187,6 @@ G_MODULE_EXPORT gboolean on_data_button_event (GtkWidget * widget, GdkEvent * ev
 }
 #endif
 
-/*!
-  \fn static void fill_data_model (GtkListStore * store, project * this_proj, int b, int c)
-
-  \brief fill curve data list store
-
-  \param store the GtkListStore to fill
-  \param this_proj the target project
-  \param b the calculation id
-  \param c the curve id
-*/
-static void fill_data_model (GtkListStore * store, project * this_proj, int b, int c)
-{
-  GtkTreeIter datalevel;
-  int i;
-  for (i=0; i<this_proj -> analysis[b] -> curves[c] -> ndata; i++)
-  {
-    gtk_list_store_append (store, & datalevel);
-    gtk_list_store_set (store, & datalevel,
-                        0, i+1,
-                        1, this_proj -> analysis[b] -> curves[c] -> data[0][i],
-                        2, this_proj -> analysis[b] -> curves[c] -> data[1][i], -1);
-  }
-}
-
 /*!
   \fn GtkWidget * setview (project * this_proj, int b, int c)
 
@@ -877,8 +1199,7 @@ static void fill_data_model (GtkListStore * store, project * this_proj, int b, i
 GtkWidget * setview (project * this_proj, int b, int c)
 {
   GtkWidget * dataview;
-  GtkListStore * datamodel;
-  GType type[3]={G_TYPE_INT, G_TYPE_DOUBLE, G_TYPE_DOUBLE};
+  GtkTreeModel * datamodel;
   GtkTreeViewColumn * datacol[3];
   GtkCellRenderer * datacel[3];
   GtkTreeSelection * dataselect;
@@ -889,9 +1210,8 @@ GtkWidget * setview (project * this_proj, int b, int c)
   name[0]=g_strdup_printf (" ");
   name[1]=g_strdup_printf ("%s", this_curve -> axis_title[0]);
   name[2]=g_strdup_printf ("%s\n%s", prepare_for_title(this_proj -> name), this_curve -> name);
-  datamodel = gtk_list_store_newv (3, type);
-  fill_data_model (datamodel, this_proj, b, c);
-  dataview = gtk_tree_view_new_with_model (GTK_TREE_MODEL(datamodel));
+  datamodel = curve_data_model_new (this_curve);
+  dataview = gtk_tree_view_new_with_model (datamodel);
   //gtk_tree_view_set_rules_hint (GTK_TREE_VIEW(dataview), TRUE);
   for (i=0; i<3; i++)
   {
@@ -922,12 +1242,19 @@ GtkWidget * setview (project * this_proj, int b, int c)
     datacol[i] = gtk_tree_view_column_new_with_attributes(name[i], datacel[i], "text", i, NULL);
     gtk_tree_view_column_set_alignment (datacol[i], 0.5);
     gtk_tree_view_column_set_resizable (datacol[i], TRUE);
+    if (this_curve -> ndata > GTK_LIMIT)
+    {
+      // Fixed size columns: only the visible rows are measured and rendered
+      gtk_tree_view_column_set_sizing (datacol[i], GTK_TREE_VIEW_COLUMN_FIXED);
+      gtk_tree_view_column_set_fixed_width (datacol[i], (i > 0) ? 150 : 75);
+    }
     gtk_tree_view_append_column(GTK_TREE_VIEW(dataview), datacol[i]);
     if (i > 0)
     {
       gtk_tree_view_column_set_min_width (datacol[i], 100);
     }
   }
+  if (this_curve -> ndata > GTK_LIMIT) gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW(dataview), TRUE);
   g_object_unref (datamodel);
   dataselect = gtk_tree_view_get_selection (GTK_TREE_VIEW(dataview));
   gtk_tree_selection_set_mode (dataselect, GTK_SELECTION_MULTIPLE);
@@ -1009,10 +1336,10 @@ G_MODULE_EXPORT void validate_changes (GtkButton * but, gpointer data)
   tint * id = (tint *)data;
   project * this_proj = get_project_by_id(id -> a);
   Curve * this_curve = this_proj -> analysis[id -> b] -> curves[id -> c];
+  int i;
+  double * val;
   curve_model = gtk_tree_view_get_model(GTK_TREE_VIEW(this_curve -> datatree));
-  sel = gtk_tree_view_get_selection (GTK_TREE_VIEW(this_curve -> datatree));
-  gtk_tree_selection_select_all (sel);
-  get_tree_data (this_curve -> datatree);
+  nrows = gtk_tree_model_iter_n_children (curve_model, NULL);
   if (nrows != this_curve -> ndata)
   {
     this_curve -> ndata = nrows;
@@ -1021,8 +1348,13 @@ G_MODULE_EXPORT void validate_changes (GtkButton * but, gpointer data)
     g_free (this_curve -> data[1]);
     this_curve -> data[1] = allocdouble (nrows);
   }
-  nrows = 0;
-  g_list_foreach (lrows, (GFunc)save_row, data);
+  for (i=0; i<nrows; i++)
+  {
+    val = data_model_row (CURVE_DATA_MODEL(curve_model), i);
+    this_curve -> data[0][i] = val[0];
+    this_curve -> data[1][i] = val[1];
+  }
+  clean_curve_decimation (this_curve);
   cancel_changes (get_top_level(GTK_WIDGET(but)), data);
   update_curves ();
 }
@@ -28,6 +28,34 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 - The function to draw a curve
 
 *
+* List of functions:
+
+  int decimate_curve (double ** plotdata, int * pid, int first, int points);
+
+  gboolean same_curve_view (Curve * this_curve, double * view);
+
+  void clean_curve_decimation (Curve * this_curve);
+  void curve_point (project * this_proj, Curve * this_curve, int rid, int i, int xscale, int yscale, double * pt);
+  void draw_curve (cairo_t * cr,
+                   int cid,
+                   int rid,
+                   project * this_proj,
+                   int points,
+                   ColRGBA withcolor,
+                   int xscale,
+                   int yscale,
+                   int asp,
+                   int vdash,
+                   double thick,
+                   int glyp,
+                   double gize,
+                   int freq,
+                   double hwidth,
+                   double hopac,
+                   int hpos,
+                   int extra,
+                   int pid);
+
 */
 
 #include <gtk/gtk.h>
@@ -39,6 +67,132 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 #include "global.h"
 #include "curve.h"
 
+/*!
+  \fn void clean_curve_decimation (Curve * this_curve)
+
+  \brief free the decimated data points of a curve, to call when the data of the curve change
+
+  \param this_curve the target curve
+*/
+void clean_curve_decimation (Curve * this_curve)
+{
+  if (this_curve -> dec_id)
+  {
+    g_free (this_curve -> dec_id);
+    this_curve -> dec_id = NULL;
+  }
+  this_curve -> dec_points = 0;
+}
+
+/*!
+  \fn gboolean same_curve_view (Curve * this_curve, double * view)
+
+  \brief are the decimated data points of the curve computed for these drawing parameters
+
+  \param this_curve the target curve
+  \param view the drawing parameters: scales, zoom and size of the drawing area
+*/
+gboolean same_curve_view (Curve * this_curve, double * view)
+{
+  int i;
+  if (! this_curve -> dec_points) return FALSE;
+  for (i=0; i<DEC_VIEW; i++)
+  {
+    if (this_curve -> dec_view[i] != view[i]) return FALSE;
+  }
+  return TRUE;
+}
+
+/*!
+  \fn void curve_point (project * this_proj, Curve * this_curve, int rid, int i, int xscale, int yscale, double * pt)
+
+  \brief compute the position of a data point in the drawing context
+
+  \param this_proj the target project
+  \param this_curve the target curve
+  \param rid the target calculation id
+  \param i the data point id
+  \param xscale x axis scale type (0 = linear, 1 = log)
+  \param yscale y axis scale type (0 = linear, 1 = log)
+  \param pt the position in the drawing context, to set
+*/
+void curve_point (project * this_proj, Curve * this_curve, int rid, int i, int xscale, int yscale, double * pt)
+{
+  double x, y;
+  if (xscale == 0)
+  {
+    pt[0] = x_min + XDRAW * (this_curve -> data[0][i] - cxy[0]) / xmax;
+  }
+  else
+  {
+    x = (i+1) * this_proj -> analysis[rid] -> num_delta * this_proj -> analysis[rid] -> delta * pow(10, dxlog);
+    x = log(x) / log(pow(10, xlog));
+    pt[0] = x_min + XDRAW * x;
+  }
+  if (yscale == 0)
+  {
+    pt[1] = y_min + YDRAW * (this_curve -> data[1][i] - cxy[1]) / ymax;
+  }
+  else
+  {
+    y = this_curve -> data[1][i] * pow(10, dylog);
+    y = log(y) / log(pow(10, ylog));
+    pt[1] = y_min + YDRAW * y;
+  }
+#ifdef DEBUG
+  // g_debug ("CURVE: DRAWCURVE: x= %f, y= %f", pt[0], pt[1]);
+#endif
+}
+
+/*!
+  \fn int decimate_curve (double ** plotdata, int * pid, int first, int points)
+
+  \brief min / max decimation of the curve: consecutive data points drawn in the same pixel column
+  are reduced to the first, the lowest, the highest and the last of them, in the original order. \n
+  The line drawn is unchanged, but no more than 4 points are drawn per pixel column, whatever the number of data points.
+
+  \param plotdata the data points in the drawing context, compacted on output
+  \param pid the original id of the data points kept on output
+  \param first the first data point to draw
+  \param points the number of data point(s)
+*/
+int decimate_curve (double ** plotdata, int * pid, int first, int points)
+{
+  int i, j, k, l, m;
+  int keep[4];
+  int col;
+  int npts = 0;
+  i = first;
+  while (i < points)
+  {
+    col = (int)floor(plotdata[i][0]);
+    k = l = j = i;
+    while (j+1 < points && (int)floor(plotdata[j+1][0]) == col)
+    {
+      j ++;
+      if (plotdata[j][1] < plotdata[k][1]) k = j;
+      if (plotdata[j][1] > plotdata[l][1]) l = j;
+    }
+    // Keep the first, min, max and last points of the pixel column, in index order
+    keep[0] = i;
+    keep[1] = min(k, l);
+    keep[2] = max(k, l);
+    keep[3] = j;
+    for (m=0; m<4; m++)
+    {
+      if (! m || keep[m] != keep[m-1])
+      {
+        plotdata[npts][0] = plotdata[keep[m]][0];
+        plotdata[npts][1] = plotdata[keep[m]][1];
+        pid[npts] = keep[m];
+        npts ++;
+      }
+    }
+    i = j + 1;
+  }
+  return npts;
+}
+
 /*!
   \fn void draw_curve (cairo_t * cr,
                       int cid,
@@ -103,42 +257,64 @@ void draw_curve (cairo_t * cr,
                  int pid)
 {
   int i, j, k;
-  double x, y;
+  int npts;
   double x1, x2, y1, y2;
   double dx1, dx2, dy1, dy2;
   double slope, bval;
+  double pt[2];
+  double view[DEC_VIEW];
   double ** plotdata;
   gboolean plot;
-  gboolean dglyp;
   curve_dash * dasht;
   Curve * this_curve = this_proj -> analysis[rid] -> curves[cid];
 
-  plotdata = allocddouble (points, 2);
-  for ( i=0 ; i < points; i++ )
+  j = (rid == RIN) ? 2 : 0;
+  if (asp == 0)
   {
-    if (xscale == 0)
-    {
-      plotdata[i][0] = x_min + XDRAW * (this_curve -> data[0][i] - cxy[0]) / xmax;
-    }
-    else
-    {
-      x = (i+1) * this_proj -> analysis[rid] -> num_delta * this_proj -> analysis[rid] -> delta * pow(10, dxlog);
-      x = log(x) / log(pow(10, xlog));
-      plotdata[i][0] = x_min + XDRAW * x;
-    }
-    if (yscale == 0)
+    // The decimated data points are kept until the data or the drawing parameters change
+    view[0] = xscale;
+    view[1] = yscale;
+    view[2] = j;
+    view[3] = points;
+    view[4] = x_min;
+    view[5] = XDRAW;
+    view[6] = cxy[0];
+    view[7] = xmax;
+    view[8] = y_min;
+    view[9] = YDRAW;
+    view[10] = cxy[1];
+    view[11] = ymax;
+    view[12] = dxlog;
+    view[13] = xlog;
+    view[14] = dylog;
+    view[15] = ylog;
+    view[16] = this_proj -> analysis[rid] -> num_delta * this_proj -> analysis[rid] -> delta;
+    if (same_curve_view (this_curve, view))
     {
-      plotdata[i][1] = y_min + YDRAW * (this_curve -> data[1][i] - cxy[1]) / ymax;
+      npts = this_curve -> dec_points;
+      plotdata = allocddouble (npts, 2);
+      for (i=0; i<npts; i++) curve_point (this_proj, this_curve, rid, this_curve -> dec_id[i], xscale, yscale, plotdata[i]);
     }
     else
     {
-      y = this_curve -> data[1][i] * pow(10, dylog);
-      y = log(y) / log(pow(10, ylog));
-      plotdata[i][1] = y_min + YDRAW * y;
+      clean_curve_decimation (this_curve);
+      npts = points;
+      plotdata = allocddouble (npts, 2);
+      for (i=0; i<npts; i++) curve_point (this_proj, this_curve, rid, i, xscale, yscale, plotdata[i]);
+      this_curve -> dec_id = allocint (points);
+      this_curve -> dec_points = decimate_curve (plotdata, this_curve -> dec_id, j, points);
+      if (this_curve -> dec_points)
+      {
+        this_curve -> dec_id = g_realloc (this_curve -> dec_id, this_curve -> dec_points*sizeof*this_curve -> dec_id);
+      }
+      for (i=0; i<DEC_VIEW; i++) this_curve -> dec_view[i] = view[i];
     }
-#ifdef DEBUG
-    // g_debug ("CURVE: DRAWCURVE: x= %f, y= %f", plotdata[i][0], plotdata[i][1]);
-#endif
+  }
+  else
+  {
+    npts = points;
+    plotdata = allocddouble (npts, 2);
+    for (i=0; i<npts; i++) curve_point (this_proj, this_curve, rid, i, xscale, yscale, plotdata[i]);
   }
   if (vdash > 0)
   {
@@ -157,13 +333,10 @@ void draw_curve (cairo_t * cr,
 
   if (asp == 0)
   {
-    j = 0;
     k = 1;
-    if (rid == RIN) j = 2;
-    for ( i = j ; i < points - k ; i ++)
+    for ( i = 0 ; i < this_curve -> dec_points - k ; i ++)
     {
       plot = TRUE;
-      dglyp = FALSE;
       slope = (plotdata[i+k][1] - plotdata[i][1])/ (plotdata[i+k][0] - plotdata[i][0]);
       bval = plotdata[i][1] - slope*plotdata[i][0];
       dy1 = slope*x_min + bval;
@@ -202,7 +375,6 @@ void draw_curve (cairo_t * cr,
           {
             x1 = plotdata[i][0];
             y1 = plotdata[i][1];
-            dglyp = TRUE;
           }
           else
           {
@@ -236,19 +408,23 @@ void draw_curve (cairo_t * cr,
         cairo_move_to (cr, x1, y1);
         cairo_line_to (cr, x2, y2);
         cairo_stroke (cr);
-        if (i % freq == 0 && dglyp) draw_glyph (cr, glyp, x1, y1, withcolor, gize);
-        if (i == points - 2 && (i+k) % freq == 0 && dglyp)
+      }
+    }
+    if (glyp)
+    {
+      // The glyphs follow the data points, not the decimated line
+      for ( i = ((j + freq - 1) / freq) * freq ; i < points ; i += freq)
+      {
+        curve_point (this_proj, this_curve, rid, i, xscale, yscale, pt);
+        if (pt[0] >= x_min && pt[0] <= x_max && pt[1] >= y_max && pt[1] <= y_min)
         {
-          draw_glyph (cr, glyp, x2, y2, withcolor, gize);
+          draw_glyph (cr, glyp, pt[0], pt[1], withcolor, gize);
         }
       }
     }
   }
   else if (asp == 1)
   {
-    j = 0;
-    k = 1;
-    if (rid == RIN) j = 2;
     // g_debug ("x_min= %f, x_max= %f, y_min= %f, y_max= %f", x_min, x_max, y_min, y_max);
     for ( i = j ; i < points ; i ++)
     {
@@ -327,5 +503,6 @@ void draw_curve (cairo_t * cr,
     }
   }
   cairo_stroke(cr);
+  for (i=0; i<npts; i++) g_free (plotdata[i]);
   g_free (plotdata);
 }
@@ -60,7 +60,7 @@ const gchar * default_title (int ax, gpointer data)
   {
     int rid = pcc -> b;
     int cid = pcc -> c;
-    if (rid == MSD)
+    if (rid == MSD || rid == FSK)
     {
       if (this_proj -> tunit > -1)
       {
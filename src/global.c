@@ -156,6 +156,11 @@ char * untime[5] = {"fs",
                     "µs",
                     "ms"};
 
+char * sqw_windows[4] = {i18n("None"),
+                         "Hann",
+                         "Hamming",
+                         "Blackman"};
+
 gchar * workspacefile = NULL;
 
 int nprojects = 0;
@@ -219,6 +219,8 @@ struct coord_info
 #define EDITC "edit-copy"
 #define EDITF "edit-find"
 #define ECUT "edit-cut"
+#define EDITU "edit-undo"
+#define EDITR "edit-redo"
 #define DPROPERTIES "document-properties"
 #define FNEW "document-new"
 #define FOPEN "document-open"
@@ -283,12 +285,12 @@ enum ImageFormats {
 #define IODEBUG FALSE
 
 /*! \def ATOM_LIMIT
-  \brief atom number limit to compute fragment(s) and molecule(s) analysis automatically
+  \brief atom number above which fragment(s) and molecule(s) information is not saved in the project file
 */
 #define ATOM_LIMIT 100000
 
 /*!< \def STEP_LIMIT
-  \brief MD step number limit to compute fragment(s) and molecule(s) analysis automatically
+  \brief MD step number above which fragment(s) and molecule(s) information is not saved in the project file
 */
 #define STEP_LIMIT 1000
 
@@ -322,14 +324,14 @@ enum ImageFormats {
 #define NDOTS 8
 
 /*!< \def NCALCS
-  \brief number of analysis
+  \brief number of analysis, SKT is not yet available
 */
-#define NCALCS 10
+#define NCALCS 13
 
 /*!< \def NCFORMATS
   \brief number atomic coordinates file formats
 */
-#define NCFORMATS 13
+#define NCFORMATS 16
 
 #define NITEMS 4
 
@@ -345,6 +347,8 @@ enum ImageFormats {
 #define SPH 8
 #define MSD 9
 #define SKT 10
+#define FSK 11
+#define VHF 12
 
 // #define FF 12
 
@@ -423,6 +427,7 @@ extern char * calc_name[];
 extern char * graph_name[];
 extern char * rings_type[5];
 extern char * untime[5];
+extern char * sqw_windows[4];
 extern gchar * workspacefile;
 
 extern int nprojects;
@@ -558,6 +563,10 @@ struct coord_file
   gchar ** label;                          /*!< VAS or TRJ: list of chemical labels, \n CIF: Label list of mis-labelled object(s) */
   // The following line is only used for DL_POLY history files:
   int traj;                                /*!< */
+  // The following lines are only used for binary trajectories (DCD, LAMMPS binary dump, XTC):
+  int first;                               /*!< First MD step to read */
+  int last;                                /*!< Last MD step to read, 0 = up to the end of the file */
+  int stride;                              /*!< Read every 'stride' MD step(s) */
   // The following lines are only used for CIF files:
   int num_sym_pos;                         /*!< Number of symmetry positions, if any */
   gchar *** sym_pos;                       /*!< The symmetry positions, if any */
@@ -642,6 +651,11 @@ struct ExtraSets
   CurveExtra * last;          /*!< Last data set of the list, if any */
 };
 
+/*! \def DEC_VIEW
+  \brief Number of drawing parameters the decimation of a curve depends on
+*/
+#define DEC_VIEW 17
+
 /*! \typedef Curve
 
   \brief curve data structure
@@ -721,6 +735,9 @@ struct Curve
   cairo_surface_t * surface;     /*!< The rendering surface */
   int draw_id;                   /*!< Curve drawing order */
   int bshift;                    /*!< Curve x shift for bar diagram */
+  int dec_points;                /*!< Number of data point(s) kept by the decimation, 0 if not computed */
+  int * dec_id;                  /*!< Id of the data point(s) kept by the decimation */
+  double dec_view[DEC_VIEW];     /*!< Drawing parameters used for the decimation */
 
   gboolean displayed;
   char * cfile;
@@ -749,6 +766,7 @@ struct atomes_analysis
   gboolean requires_md;         /*!< Analysis requires multiple configurations */
   gchar * x_title;              /*!< x axis default title, ex: "r [Å] */
   double calc_time;             /*!< Calculation time */
+  gboolean cached;              /*!< Results retrieved from the result cache */
   int num_delta;                /*!< Number of intervals */
   double delta;                 /*!< Size of an interval */
   double min;                   /*!< Minimum x value */
@@ -1034,6 +1052,8 @@ struct project
   coord_info * coord;                  /*!< Coordination(s) data */
   cell_info cell;                      /*!< Periodicity data */
   atom ** atoms;                       /*!< Atom list: atoms[steps][natomes] */
+  int dyn_data;                        /*!< Dynamics data read with the coordinates: 0 = none, 1 = velocities, 2 = velocities and forces */
+  float * dynamics;                    /*!< Velocities (and forces) for each MD step: dynamics[steps][dyn_data][natomes][3] */
   /*
      Analysis related parameters
   */
@@ -1086,6 +1106,12 @@ struct project
   int sqw_n_data_sets;                 /*!< Number of q vector(s) to compute S(q,w) */
   double * sqw_q_id;                   /*!< List of q vector(s) to compute S(q,w) */
   int sqw_freq;                        /*!< Frequency intervals */
+  int sqw_window;                      /*!< Time window for S(q,w): 0 = None, 1 = Hann, 2 = Hamming, 3 = Blackman */
+  int fsk_n_data_sets;                 /*!< Number of k vector(s) to compute Fs(k,t) */
+  double * fsk_k_id;                   /*!< List of k vector(s) to compute Fs(k,t) */
+  int vhf_n_data_sets;                 /*!< Number of t step(s) to compute G(r,t) */
+  int * vhf_step_id;                   /*!< List of t step(s) to compute G(r,t) */
+  int vhf_stride;                      /*!< Number of MD steps between two time origins when computing G(r,t) */
 
   GtkTextBuffer * text_buffer[NITEMS]; /*!< The text buffer for general information */
 
@@ -1160,6 +1186,10 @@ extern void update_rings_menus (glwin * view);
 extern void clean_rings_data (int rid, glwin * view);
 extern void clean_chains_data (glwin * view);
 extern void clean_volumes_data (glwin * view);
+extern void clean_voxel_grid (glwin * view);
+extern void clean_atom_grid (project * this_proj);
+extern void free_density_maps (glwin * view);
+extern void clean_density_maps (glwin * view);
 
 extern void initcutoffs (chemical_data * chem, int species);
 extern void cutoffsend ();
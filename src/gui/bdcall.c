@@ -517,6 +517,7 @@ void update_glwin_after_bonds (int bonding, int * colm)
     for (i=0; i<2; i++) active_glwin -> atom_win -> adv_bonding[i] = active_glwin -> adv_bonding[i];
   }
   clean_volumes_data (active_glwin);
+  clean_density_maps (active_glwin);
 #ifdef GTK4
   update_menu_bar (active_glwin);
 #endif
@@ -531,8 +532,18 @@ void update_glwin_after_bonds (int bonding, int * colm)
 int update_voisj_and_contj ()
 {
   int i, j, k;
+  int maxn = 0;
+  int totn = 0;
 
-  if (! alloc_contj_voisj_ (& active_project -> natomes, & active_project -> steps)) return 0;
+  for (i=0; i<active_project -> steps; i++)
+  {
+    for (j=0; j<active_project -> natomes; j++)
+    {
+      maxn = max (maxn, active_project -> atoms[i][j].numv);
+      totn += active_project -> atoms[i][j].numv;
+    }
+  }
+  if (! alloc_contj_voisj_ (& active_project -> natomes, & active_project -> steps, & maxn, & totn)) return 0;
 
   for (i=0; i<active_project -> steps; i++)
   {
@@ -628,9 +639,8 @@ G_MODULE_EXPORT void on_calc_bonds_released (GtkWidget * widg, gpointer data)
         bonding = 1;
         if (frag_update)
         {
-          k = active_glwin -> allbonds[0] + active_glwin -> allbonds[1];
           clock_gettime (CLOCK_MONOTONIC, & start_time);
-          if (! molecules_ (& mol_update, & k))
+          if (! molecules_ (& mol_update))
           {
             show_error (_("Unexpected error when looking for isolated fragment(s) and molecule(s)"), 0, (widg) ? widg : MainWindow);
             if (active_glwin)
@@ -37,6 +37,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   gboolean test_sph ();
   gboolean test_msd ();
   gboolean test_skt ();
+  gboolean test_fsk ();
+  gboolean test_vhf ();
 
   void update_omega_max ();
   void calc_sph (GtkWidget * vbox);
@@ -49,10 +51,14 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void add_remove_t_steps_q_vectors (int val, int calc);
   void add_correlations_options (int cid);
   void calc_sk_t (GtkWidget * box);
+  void add_remove_k_vectors_t_steps (int val, int calc);
+  void calc_fs_k_t (GtkWidget * box);
+  void calc_van_hove (GtkWidget * box);
 
   G_MODULE_EXPORT void set_max (GtkEntry * entry, gpointer data);
   G_MODULE_EXPORT void set_delta (GtkEntry * entry, gpointer data);
   G_MODULE_EXPORT void combox_tunit_changed (GtkComboBox * box, gpointer data);
+  G_MODULE_EXPORT void combox_sqw_window_changed (GtkComboBox * box, gpointer data);
   G_MODULE_EXPORT void set_numa (GtkEntry * entry, gpointer data);
   G_MODULE_EXPORT void combox_rings_changed (GtkComboBox * box, gpointer data);
   G_MODULE_EXPORT void toggle_rings (GtkCheckButton * but, gpointer data);
@@ -72,10 +78,15 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void set_correlations (GtkEntry * entry, gpointer data);
   G_MODULE_EXPORT void toggle_skt_all (GtkCheckButton * but, gpointer data);
   G_MODULE_EXPORT void toggle_skt_all (GtkToggleButton * but, gpointer data);
+  G_MODULE_EXPORT void set_fsk_k_id (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_vhf_step_id (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_vhf_stride (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_k_t_spin (GtkSpinButton * res, gpointer data);
   G_MODULE_EXPORT void run_on_calc_activate (GtkDialog * dial, gint response_id, gpointer data);
   G_MODULE_EXPORT void on_calc_activate (GtkWidget * widg, gpointer data);
 
   GtkWidget * calc_window (int i);
+  GtkWidget * k_vectors_t_steps_options (int calc);
   GtkWidget * combox_rings (gchar * str, int num, gchar * list_item[num], int id);
   GtkWidget * hbox_note (int i, double val);
 
@@ -98,6 +109,8 @@ extern G_MODULE_EXPORT void on_calc_rings_released (GtkWidget * widg, gpointer d
 extern G_MODULE_EXPORT void on_calc_chains_released (GtkWidget * widg, gpointer data);
 extern G_MODULE_EXPORT void on_calc_msd_released (GtkWidget * widg, gpointer data);
 extern G_MODULE_EXPORT void on_calc_sph_released (GtkWidget * widg, gpointer data);
+extern G_MODULE_EXPORT void on_calc_fsk_released (GtkWidget * widg, gpointer data);
+extern G_MODULE_EXPORT void on_calc_vhf_released (GtkWidget * widg, gpointer data);
 extern void dyna_parameters (GtkWidget * vbox, int cid);
 
 GtkWidget * calc_win = NULL;
@@ -281,6 +294,26 @@ G_MODULE_EXPORT void combox_tunit_changed (GtkComboBox * box, gpointer data)
   if (omega_max_hbox) update_omega_max ();
 }
 
+/*!
+  \fn G_MODULE_EXPORT void combox_sqw_window_changed (GtkComboBox * box, gpointer data)
+
+  \brief change the time window used to compute S(q,w)
+
+  \param box the GtkComboBox sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void combox_sqw_window_changed (GtkComboBox * box, gpointer data)
+{
+  if (preferences)
+  {
+    tmp_sqw_window = combo_get_active ((GtkWidget *)box);
+  }
+  else
+  {
+    active_project -> sqw_window = combo_get_active ((GtkWidget *)box);
+  }
+}
+
 /*!
   \fn void calc_sph (GtkWidget * vbox)
 
@@ -999,6 +1032,47 @@ gboolean test_skt ()
   }
 }
 
+/*!
+  \fn gboolean test_fsk ()
+
+  \brief is it safe to compute the self intermediate scattering function ?
+*/
+gboolean test_fsk ()
+{
+  if (! test_msd()) return FALSE;
+  if (! active_project -> fsk_n_data_sets || ! active_project -> fsk_k_id)
+  {
+    show_warning (_("You must specify at least one k vector\n"), calc_win);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*!
+  \fn gboolean test_vhf ()
+
+  \brief is it safe to compute the van Hove correlation function ?
+*/
+gboolean test_vhf ()
+{
+  if (active_project -> analysis[VHF] -> num_delta < 1)
+  {
+    show_warning (_("You must specify the number of &#x3b4;r steps\n"), calc_win);
+    return FALSE;
+  }
+  if (active_project -> analysis[VHF] -> max <= 0.0)
+  {
+    show_warning (_("You must specify the maximum distance r<sub>max</sub>\n"), calc_win);
+    return FALSE;
+  }
+  if (! active_project -> vhf_n_data_sets || ! active_project -> vhf_step_id)
+  {
+    show_warning (_("You must specify at least one time step\n"), calc_win);
+    return FALSE;
+  }
+  return TRUE;
+}
+
 /*!
   \fn void calc_bonds (GtkWidget * vbox)
 
@@ -1897,6 +1971,14 @@ void calc_sk_t (GtkWidget * box)
   omega_max_hbox = create_hbox (0);
   add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox_skt[0], omega_max_hbox, FALSE, FALSE, 5);
   update_omega_max ();
+  hbox = create_hbox (0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox_skt[0], hbox, FALSE, FALSE, 5);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Time window for S(q,&#969;)"), 150, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  GtkWidget * wcombo = create_combo ();
+  for (i=0; i<4; i++) combo_text_append (wcombo, _(sqw_windows[i]));
+  combo_set_active (wcombo, (preferences) ? tmp_sqw_window : active_project -> sqw_window);
+  g_signal_connect(G_OBJECT(wcombo), "changed", G_CALLBACK(combox_sqw_window_changed), NULL);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, wcombo, FALSE, FALSE, 10);
   if (! preferences)
   {
     add_advanced_options (SKT, skadv, vbox_skt[0]);
@@ -1957,6 +2039,210 @@ void calc_sk_t (GtkWidget * box)
   }
 }
 
+GtkWidget * fsk_vhf_box[2];
+GtkWidget * fsk_vhf_list[2];
+
+/*!
+  \fn G_MODULE_EXPORT void set_fsk_k_id (GtkEntry * res, gpointer data)
+
+  \brief set k vector to compute Fs(k,t)
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_fsk_k_id (GtkEntry * res, gpointer data)
+{
+  int sid = GPOINTER_TO_INT (data);
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if (v > 0.0) active_project -> fsk_k_id[sid] = v;
+  update_entry_double (res, active_project -> fsk_k_id[sid]);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_vhf_step_id (GtkEntry * res, gpointer data)
+
+  \brief set time step to compute G(r,t)
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_vhf_step_id (GtkEntry * res, gpointer data)
+{
+  int sid = GPOINTER_TO_INT (data);
+  const gchar * m = entry_get_text (res);
+  int v = (int) string_to_double ((gpointer)m);
+  if (v > -1 && v < active_project -> steps) active_project -> vhf_step_id[sid] = v;
+  update_entry_int (res, active_project -> vhf_step_id[sid]);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_vhf_stride (GtkEntry * res, gpointer data)
+
+  \brief set the number of MD steps between two time origins to compute G(r,t)
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_vhf_stride (GtkEntry * res, gpointer data)
+{
+  const gchar * m = entry_get_text (res);
+  int v = (int) string_to_double ((gpointer)m);
+  if (v > 0 && v < active_project -> steps) active_project -> vhf_stride = v;
+  update_entry_int (res, active_project -> vhf_stride);
+}
+
+/*!
+  \fn void add_remove_k_vectors_t_steps (int val, int calc)
+
+  \brief add or remove the k vectors or the t steps to analyze
+
+  \param val total number of k vectors or t steps
+  \param calc 0 = Fs(k,t), 1 = G(r,t)
+*/
+void add_remove_k_vectors_t_steps (int val, int calc)
+{
+  int i, j;
+  int * old_step;
+  double * old_k;
+  GtkWidget * hbox;
+  GtkWidget * entry;
+  fsk_vhf_list[calc] = destroy_this_widget (fsk_vhf_list[calc]);
+  if (! calc)
+  {
+    // Keep the k vector(s) already set
+    old_k = active_project -> fsk_k_id;
+    j = (old_k) ? active_project -> fsk_n_data_sets : 0;
+    active_project -> fsk_n_data_sets = val;
+    active_project -> fsk_k_id = (val) ? allocdouble (val) : NULL;
+    for (i=0; i<val; i++) active_project -> fsk_k_id[i] = (i < j) ? old_k[i] : (i+1)*1.0;
+    if (old_k) g_free (old_k);
+  }
+  else
+  {
+    // Keep the t step(s) already set
+    old_step = active_project -> vhf_step_id;
+    j = (old_step) ? active_project -> vhf_n_data_sets : 0;
+    active_project -> vhf_n_data_sets = val;
+    active_project -> vhf_step_id = (val) ? allocint (val) : NULL;
+    for (i=0; i<val; i++) active_project -> vhf_step_id[i] = (i < j) ? old_step[i] : min (1 + i*((active_project -> steps - 1) / val), active_project -> steps - 1);
+    if (old_step) g_free (old_step);
+  }
+  if (val)
+  {
+    fsk_vhf_list[calc] = create_vbox(0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, fsk_vhf_box[calc], fsk_vhf_list[calc], FALSE, FALSE, 0);
+    for (i=0; i<val; i++)
+    {
+      hbox = create_hbox (0);
+      add_box_child_start (GTK_ORIENTATION_VERTICAL, fsk_vhf_list[calc], hbox, FALSE, FALSE, 0);
+      if (! calc)
+      {
+        add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (g_strdup_printf("%d)\tk= ", i+1), 150, -1, 0.75, 0.5), FALSE, FALSE, 10);
+        entry = create_entry (G_CALLBACK(set_fsk_k_id), 100, 15, FALSE, GINT_TO_POINTER(i));
+        update_entry_double (GTK_ENTRY(entry), active_project -> fsk_k_id[i]);
+      }
+      else
+      {
+        add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (g_strdup_printf("%d)\t&#x3b4;t= ", i+1), 150, -1, 0.75, 0.5), FALSE, FALSE, 10);
+        entry = create_entry (G_CALLBACK(set_vhf_step_id), 100, 15, FALSE, GINT_TO_POINTER(i));
+        update_entry_int (GTK_ENTRY(entry), active_project -> vhf_step_id[i]);
+      }
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 10);
+    }
+    show_the_widgets (fsk_vhf_box[calc]);
+  }
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_k_t_spin (GtkSpinButton * res, gpointer data)
+
+  \brief set the number of k vectors or t steps to analyze - spin button
+
+  \param res the GtkSpinButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_k_t_spin (GtkSpinButton * res, gpointer data)
+{
+  add_remove_k_vectors_t_steps (gtk_spin_button_get_value_as_int(res), GPOINTER_TO_INT(data));
+}
+
+/*!
+  \fn GtkWidget * k_vectors_t_steps_options (int calc)
+
+  \brief create the k vectors or t steps selection widgets
+
+  \param calc 0 = Fs(k,t), 1 = G(r,t)
+*/
+GtkWidget * k_vectors_t_steps_options (int calc)
+{
+  GtkWidget * scroll = create_scroll (NULL, 200, 200, GTK_SHADOW_NONE);
+  fsk_vhf_box[calc] = create_vbox(0);
+  fsk_vhf_list[calc] = NULL;
+  add_container_child (CONTAINER_SCR, scroll, fsk_vhf_box[calc]);
+  GtkWidget * hbox = create_hbox (0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, fsk_vhf_box[calc], hbox, FALSE, FALSE, 5);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                       markup_label ((! calc) ? _("Number of <b>k</b> vectors [&#xC5;<sup>-1</sup>]") : _("Number of <b>&#x3b4;t</b> [MD steps]"), 150, -1, 0.0, 0.5),
+                       FALSE, FALSE, 10);
+  int val = (! calc) ? active_project -> fsk_n_data_sets : active_project -> vhf_n_data_sets;
+  if (! val) val = min (5, active_project -> steps - 1);
+  GtkWidget * spin = spin_button (G_CALLBACK(set_k_t_spin), val, 1.0, 100, 1.0, 0, 100, GINT_TO_POINTER(calc));
+  gtk_widget_set_size_request (spin, 25, -1);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, spin, FALSE, FALSE, 10);
+  add_remove_k_vectors_t_steps (val, calc);
+  return scroll;
+}
+
+/*!
+  \fn void calc_fs_k_t (GtkWidget * box)
+
+  \brief creation of the Fs(k,t) calculation widgets
+
+  \param box GtkWidget that will receive the data
+*/
+void calc_fs_k_t (GtkWidget * box)
+{
+  GtkWidget * vbox = create_vbox (5);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, box, vbox, FALSE, FALSE, 0);
+  calc_msd (vbox, FSK);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, k_vectors_t_steps_options (0), FALSE, FALSE, 5);
+}
+
+/*!
+  \fn void calc_van_hove (GtkWidget * box)
+
+  \brief creation of the G(r,t) calculation widgets
+
+  \param box GtkWidget that will receive the data
+*/
+void calc_van_hove (GtkWidget * box)
+{
+  GtkWidget * hbox;
+  GtkWidget * entry;
+  GtkWidget * vbox = create_vbox (5);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, box, vbox, FALSE, FALSE, 0);
+  hbox = create_hbox (0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Number of &#x3b4;r steps"), 150, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  entry = create_entry (G_CALLBACK(set_delta), 100, 15, FALSE, GINT_TO_POINTER(VHF));
+  update_entry_int (GTK_ENTRY(entry), active_project -> analysis[VHF] -> num_delta);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 10);
+  hbox = create_hbox (0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("r<sub>max</sub> [&#xC5;]"), 150, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  entry = create_entry (G_CALLBACK(set_max), 100, 15, FALSE, GINT_TO_POINTER(VHF));
+  update_entry_double (GTK_ENTRY(entry), active_project -> analysis[VHF] -> max);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 10);
+  hbox = create_hbox (0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Step(s) between time origins"), 150, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  entry = create_entry (G_CALLBACK(set_vhf_stride), 100, 15, FALSE, NULL);
+  update_entry_int (GTK_ENTRY(entry), active_project -> vhf_stride);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 10);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, k_vectors_t_steps_options (1), FALSE, FALSE, 5);
+}
+
 /*!
   \fn G_MODULE_EXPORT void run_on_calc_activate (GtkDialog * dial, gint response_id, gpointer data)
 
@@ -2018,6 +2304,13 @@ G_MODULE_EXPORT void run_on_calc_activate (GtkDialog * dial, gint response_id, g
           break;
         case SKT-1:
           if (test_skt ()) on_calc_skt_released (calc_win, NULL);
+          break;
+        case FSK-1:
+          if (test_fsk ()) on_calc_fsk_released (calc_win, NULL);
+          break;
+        case VHF-1:
+          if (test_vhf ()) on_calc_vhf_released (calc_win, NULL);
+          break;
         default:
           break;
       }
@@ -2031,6 +2324,10 @@ G_MODULE_EXPORT void run_on_calc_activate (GtkDialog * dial, gint response_id, g
         omega_max_hbox = destroy_this_widget (omega_max_hbox);
         skt_all_info = destroy_this_widget (skt_all_info);
       }
+      else if (id == FSK-1 || id == VHF-1)
+      {
+        fsk_vhf_list[id-FSK+1] = NULL;
+      }
       avbox = destroy_this_widget (avbox);
       destroy_this_dialog (dial);
       calc_win = destroy_this_widget (calc_win);
@@ -2074,6 +2371,12 @@ G_MODULE_EXPORT void on_calc_activate (GtkWidget * widg, gpointer data)
     case SKT-1:
       calc_sk_t (box);
       break;
+    case FSK-1:
+      calc_fs_k_t (box);
+      break;
+    case VHF-1:
+      calc_van_hove (box);
+      break;
     default:
       calc_gr_sq (box, id);
       break;
@@ -64,6 +64,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void update_sa (GtkEntry * res, gpointer data);
   G_MODULE_EXPORT void changed_spec_combo (GtkComboBox * box, gpointer data);
   G_MODULE_EXPORT void update_at_sp (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void update_bin_steps (GtkEntry * res, gpointer data);
   G_MODULE_EXPORT void run_to_read_trj_or_vas (GtkDialog * dialog, gint response_id, gpointer data);
   G_MODULE_EXPORT void run_read_npt_data (GtkNativeDialog * info, gint response_id, gpointer data);
   G_MODULE_EXPORT void run_read_npt_data (GtkDialog * info, gint response_id, gpointer data);
@@ -98,10 +99,13 @@ char * coord_files[NCFORMATS+1] = {i18n("XYZ file"),
                                    i18n("Cryst. information (crystal build) - multiple configurations"),
                                    i18n("Cryst. information (symmetry positions) - single configuration"),
                                    i18n("DL-POLY HISTORY file"),
+                                   i18n("DCD trajectory (CHARMM/NAMD)"),
+                                   i18n("LAMMPS binary dump"),
+                                   i18n("XTC trajectory (GROMACS)"),
                                    i18n("ISAACS Project File")};
 
 char * coord_files_ext[NCFORMATS+1]={"xyz", "xyz", "c3d", "trj", "trj", "xdatcar", "xdatcar",
-                                    "pdb", "ent", "cif", "cif", "cif", "hist", "ipf"};
+                                    "pdb", "ent", "cif", "cif", "cif", "hist", "dcd", "bin", "xtc", "ipf"};
 
 char ** las;
 
@@ -112,6 +116,8 @@ extern const gchar * dfi[2];
 extern int open_cif_file (gchar * filename);
 extern int open_coord_file (gchar * filename, int fti);
 extern int open_history_file (gchar * filename);
+extern int bin_file_natomes (gchar * filename, int fti);
+extern int write_bin_file (project * this_proj, gchar * filename, int format, gboolean selection);
 extern int open_cell_file (int format, gchar * filename);
 extern double get_z_from_periodic_table (gchar * lab);
 
@@ -819,8 +825,7 @@ void open_this_isaacs_xml_file (gchar * profile, int ptoc, gboolean visible)
     on_edit_activate (NULL, GINT_TO_POINTER(3));
     on_edit_activate (NULL, GINT_TO_POINTER(5));
     active_project_changed (activep);
-    frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-    mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+    frag_update = mol_update = 1;
     apply_project (TRUE);
     active_project_changed (activep);
     add_project_to_workspace ();
@@ -1197,6 +1202,44 @@ G_MODULE_EXPORT void update_at_sp (GtkEntry * res, gpointer data)
   if (up) prepare_sp_box();
 }
 
+/*!
+  \fn G_MODULE_EXPORT void update_bin_steps (GtkEntry * res, gpointer data)
+
+  \brief reading binary trajectory, set the MD steps to read
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer (int *) 0 = first, 1 = last, 2 = stride
+*/
+G_MODULE_EXPORT void update_bin_steps (GtkEntry * res, gpointer data)
+{
+  int i, v;
+  i = GPOINTER_TO_INT(data);
+  const gchar * m = entry_get_text (res);
+  v = (int)string_to_double ((gpointer)m);
+  switch (i)
+  {
+    case 0:
+      this_reader -> first = (v > 0) ? v : 1;
+      update_entry_int (res, this_reader -> first);
+      break;
+    case 1:
+      this_reader -> last = (v > 0) ? v : 0;
+      if (this_reader -> last)
+      {
+        update_entry_int (res, this_reader -> last);
+      }
+      else
+      {
+        update_entry_text (res, "");
+      }
+      break;
+    case 2:
+      this_reader -> stride = (v > 0) ? v : 1;
+      update_entry_int (res, this_reader -> stride);
+      break;
+  }
+}
+
 int reading_vas_trj;
 
 /*!
@@ -1261,7 +1304,7 @@ G_MODULE_EXPORT void run_to_read_trj_or_vas (GtkDialog * dialog, gint response_i
 /*!
   \fn int to_read_trj_or_vas (int ff)
 
-  \brief reading CPMD/VASP trajectory - prepare the dialog
+  \brief reading CPMD/VASP or binary trajectory - prepare the dialog
 
   \param ff file type
 */
@@ -1269,7 +1312,8 @@ int to_read_trj_or_vas (int ff)
 {
   int i;
   gchar * rlabel[2]={i18n("Total number of atom(s):"), i18n("Number of chemical species:")};
-  GtkWidget * dialog = dialogmodal (_("Reading CPMD / VASP trajectory"), GTK_WINDOW(MainWindow));
+  gchar * slabel[3]={i18n("First MD step:"), i18n("Last MD step (empty = last in file):"), i18n("Read every n MD step(s):")};
+  GtkWidget * dialog = dialogmodal ((ff > 12) ? _("Reading binary trajectory") : _("Reading CPMD / VASP trajectory"), GTK_WINDOW(MainWindow));
   read_this = gtk_dialog_add_button (GTK_DIALOG (dialog), _("Apply"), GTK_RESPONSE_APPLY);
   GtkWidget * vbox = dialog_get_content_area (dialog);
   widget_set_sensitive (read_this, 0);
@@ -1282,8 +1326,35 @@ int to_read_trj_or_vas (int ff)
     add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_(rlabel[i]), 200, -1, 0.0, 0.5), FALSE, FALSE, 5);
     rentry = create_entry (G_CALLBACK(update_at_sp), 100, 15, FALSE, GINT_TO_POINTER(i));
     update_entry_text (GTK_ENTRY(rentry), "");
+    if (ff > 12 && i == 0)
+    {
+      // The number of atoms is stored in the binary file
+      this_reader -> natomes = bin_file_natomes (active_project -> coordfile, ff);
+      if (this_reader -> natomes) update_entry_int (GTK_ENTRY(rentry), this_reader -> natomes);
+    }
     add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, rentry, FALSE, FALSE, 5);
   }
+  if (ff > 12)
+  {
+    this_reader -> first = this_reader -> stride = 1;
+    this_reader -> last = 0;
+    for (i=0; i<3; i++)
+    {
+      hbox = create_hbox(0);
+      add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_(slabel[i]), 200, -1, 0.0, 0.5), FALSE, FALSE, 5);
+      rentry = create_entry (G_CALLBACK(update_bin_steps), 100, 15, FALSE, GINT_TO_POINTER(i));
+      if (i == 1)
+      {
+        update_entry_text (GTK_ENTRY(rentry), "");
+      }
+      else
+      {
+        update_entry_int (GTK_ENTRY(rentry), 1);
+      }
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, rentry, FALSE, FALSE, 5);
+    }
+  }
   read_box = create_hbox(0);
   add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, read_box, FALSE, FALSE, 5);
   run_this_gtk_dialog (dialog, G_CALLBACK(run_to_read_trj_or_vas), GINT_TO_POINTER(ff));
@@ -1476,6 +1547,18 @@ int open_coordinate_file (int id)
       // DL-POLY file
       result = open_coord_file (active_project -> coordfile, 12);
       break;
+    case 13:
+      // DCD file
+      result = to_read_trj_or_vas (id);
+      break;
+    case 14:
+      // LAMMPS binary dump file
+      result = to_read_trj_or_vas (id);
+      break;
+    case 15:
+      // XTC file
+      result = to_read_trj_or_vas (id);
+      break;
     default:
       result = 2;
       break;
@@ -1585,12 +1668,11 @@ void open_this_coordinate_file (int format, gchar * proj_name)
       g_free (str);
     }
     on_edit_activate (NULL, GINT_TO_POINTER(0));
-    if (format != 1 && format != 4 && format != 6 && format != 9 && format != 10 && format != 11 && format != 12) on_edit_activate (NULL, GINT_TO_POINTER(4));
+    if (format != 1 && format != 4 && format != 6 && format != 9 && format != 10 && format != 11 && format != 12 && ! (format > 12 && active_cell -> has_a_box)) on_edit_activate (NULL, GINT_TO_POINTER(4));
     initcutoffs (active_chem, active_project -> nspec);
     on_edit_activate (NULL, GINT_TO_POINTER(2));
     active_project_changed (activep);
-    frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-    mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+    frag_update = mol_update = 1;
     chemistry_ ();
     apply_project (TRUE);
     active_project_changed (activep);
@@ -1687,6 +1769,20 @@ G_MODULE_EXPORT void run_on_coord_port (GtkDialog * info, gint response_id, gpoi
         }
         open_this_coordinate_file (j, NULL);
       }
+      else if (j > 1)
+      {
+        // Binary trajectory: all atoms, or the selected ones
+        k = (active_project -> modelgl) ? active_project -> modelgl -> anim -> last -> img -> selected[0] -> selected : 0;
+        l = (k && k < active_project -> natomes) ? ask_yes_no (_("Export the selection ?"), _("Only export the selected atom(s) ?"), GTK_MESSAGE_QUESTION, MainWindow) : 0;
+        k = write_bin_file (active_project, active_project -> coordfile, j-2, l);
+        if (k)
+        {
+          tmp_str = g_strdup_printf (_("Impossible to export the atomic coordinates\nError code: %d"), k);
+          show_error (tmp_str, 0, MainWindow);
+          g_free (tmp_str);
+        }
+        active_project_changed (pactive);
+      }
       else
       {
         if (j < 2)
@@ -1770,11 +1866,11 @@ G_MODULE_EXPORT void on_coord_port (GtkWidget * widg, gpointer data)
 #endif
   GtkFileChooser * chooser;
   gchar * tmp_str;
-  int num_files[2]={NCFORMATS, 2};
+  int num_files[2]={NCFORMATS, 4};
   const gchar * str[2]= {i18n("Import atomic coordinates"), i18n("Export atomic coordinates")};
   const gchar * res[2]= {i18n("Open"), i18n("Save")};
-  char * out_files[2] = {i18n("XYZ file"), i18n("Chem3D file")};
-  char * out_ext[2]={"xyz", "c3d"};
+  char * out_files[4] = {i18n("XYZ file"), i18n("Chem3D file"), i18n("DCD trajectory (CHARMM/NAMD)"), i18n("XTC trajectory (GROMACS)")};
+  char * out_ext[4]={"xyz", "c3d", "dcd", "xtc"};
   GtkFileChooserAction act[2]={GTK_FILE_CHOOSER_ACTION_OPEN, GTK_FILE_CHOOSER_ACTION_SAVE};
   pactive = activep;
   i = GPOINTER_TO_INT (data);
@@ -798,8 +798,7 @@ G_MODULE_EXPORT void run_on_edit_activate (GtkDialog * win, gint response_id, gp
               run_project ();
               if (active_glwin) active_glwin -> create_shaders[MDBOX] = TRUE;
               bonds_update = 1;
-              frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-              mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+              frag_update = mol_update = 1;
               active_project -> runc[0] = FALSE;
               on_calc_bonds_released (NULL, NULL);
             }
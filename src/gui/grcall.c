@@ -186,6 +186,7 @@ void update_rdf_view (project * this_proj, int rdf)
   g_free (str);
   print_info (" Å\n", "bold", this_proj -> analysis[rdf] -> calc_buffer);
   print_info (calculation_time(TRUE, this_proj -> analysis[rdf] -> calc_time), NULL, this_proj -> analysis[rdf] -> calc_buffer);
+  print_analysis_cache (this_proj, rdf);
 }
 
 /*!
@@ -203,7 +204,15 @@ G_MODULE_EXPORT void on_calc_gr_released (GtkWidget * widg, gpointer data)
   clean_curves_data (GDR, 0, active_project -> analysis[GDR] -> numc);
   active_project -> analysis[GDR] -> delta = active_project -> analysis[GDR] -> max / active_project -> analysis[GDR] -> num_delta;
   prepostcalc (widg, FALSE, GDR, 0, opac);
-  i = g_of_r_ (& active_project -> analysis[GDR] -> num_delta, & active_project -> analysis[GDR] -> delta, & fitc);
+  // Fitting the bond cutoffs modifies the model: the result cache is not used
+  gchar * key = (! fitc) ? analysis_cache_key (active_project, GDR, 0, NULL) : NULL;
+  active_project -> analysis[GDR] -> cached = FALSE;
+  if (! key || ! (i = read_analysis_cache (active_project, GDR, key)))
+  {
+    i = g_of_r_ (& active_project -> analysis[GDR] -> num_delta, & active_project -> analysis[GDR] -> delta, & fitc);
+    if (i && key) write_analysis_cache (active_project, GDR, key);
+  }
+  if (key) g_free (key);
   prepostcalc (widg, TRUE, GDR, i, 1.0);
   if (! i)
   {
@@ -321,9 +330,18 @@ G_MODULE_EXPORT void on_calc_gq_released (GtkWidget * widg, gpointer data)
   clean_curves_data (GDK, 0, active_project -> analysis[GDK] -> numc);
   active_project -> analysis[GDK] -> delta = active_project -> analysis[GDK] -> max / active_project -> analysis[GDK] -> num_delta;
   prepostcalc (widg, FALSE, GDK, 0, opac);
-  i = g_of_r_fft_ (& active_project -> analysis[GDK] -> num_delta,
-                   & active_project -> analysis[GDK] -> delta,
-                   & active_project -> analysis[GDK] -> max);
+  // g(r) FFT is computed from the S(k) curves: the S(k) parameters are part of the key
+  double extra[5] = {active_project -> analysis[SKD] -> num_delta, active_project -> analysis[SKD] -> min, active_project -> analysis[SKD] -> max,
+                     active_project -> sk_advanced[0][0], active_project -> sk_advanced[0][1]};
+  gchar * key = analysis_cache_key (active_project, GDK, 5, extra);
+  if (! (i = read_analysis_cache (active_project, GDK, key)))
+  {
+    i = g_of_r_fft_ (& active_project -> analysis[GDK] -> num_delta,
+                     & active_project -> analysis[GDK] -> delta,
+                     & active_project -> analysis[GDK] -> max);
+    if (i) write_analysis_cache (active_project, GDK, key);
+  }
+  g_free (key);
   prepostcalc (widg, TRUE, GDK, i, 1.0);
   if (! i)
   {
@@ -118,7 +118,9 @@ gchar * calc_name[] = {"g(r)/G(r)",
                        i18n("Chain Statistics"),
                        i18n("Spherical Harmonics"),
                        i18n("Mean Squared Displacement"),
-                       i18n("Dynamic Structure Factor")};
+                       i18n("Dynamic Structure Factor"),
+                       i18n("Self Intermediate Scattering"),
+                       i18n("van Hove Correlation")};
 
 gchar * graph_name[] = {"g(r)/G(r)",
                         i18n("S(q) from FFT[g(r)]"),
@@ -130,7 +132,9 @@ gchar * graph_name[] = {"g(r)/G(r)",
                         i18n("Chain Statistics"),
                         i18n("Spherical Harmonics"),
                         i18n("Mean Squared Displacement"),
-                        i18n("Dynamic Structure Factor")};
+                        i18n("Dynamic Structure Factor"),
+                        i18n("Self Intermediate Scattering"),
+                        i18n("van Hove Correlation")};
 
 gchar * graph_icon[] = {"pixmaps/gr.png",
                         "pixmaps/sq.png",
@@ -142,7 +146,9 @@ gchar * graph_icon[] = {"pixmaps/gr.png",
                         "pixmaps/ch.png",
                         "pixmaps/sp.png",
                         "pixmaps/ms.png",
-                        "pixmaps/sq.png"};
+                        "pixmaps/sq.png",
+                        "pixmaps/ms.png",
+                        "pixmaps/gr.png"};
 
 tint cut_sel;
 dint davect[9];
@@ -998,9 +1004,13 @@ GMenu * create_analyze_menu ()
   int i;
   for (i=0; i<NCALCS-1; i++)
   {
-    str = g_strdup_printf ("app.analyze.%d", i);
-    append_menu_item (menu, _(calc_name[i]), str, NULL, NULL, IMG_FILE, graph_img[(i < ANG) ? i : i+1], FALSE, FALSE, FALSE, NULL);
-    g_free (str);
+    // The dynamic structure factor is not yet available
+    if (i != SKT-1)
+    {
+      str = g_strdup_printf ("app.analyze.%d", i);
+      append_menu_item (menu, _(calc_name[i]), str, NULL, NULL, IMG_FILE, graph_img[(i < ANG) ? i : i+1], FALSE, FALSE, FALSE, NULL);
+      g_free (str);
+    }
   }
   // Append new calculation menu element here
   g_menu_append_section (menu, NULL, (GMenuModel*)tool_box_section());
@@ -15,7 +15,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
 /*!
 * @file initc.c
-* @short Curve data buffer initialization
+* @short Curve data buffer initialization \n
+         On-disk cache of the analysis results
 * @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
 */
 
@@ -26,6 +27,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 *
 
  - Curve data buffer initialization
+ - On-disk cache of the analysis results
 
 *
 * List of functions:
@@ -37,16 +39,32 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void alloc_analysis_curves (int pid, atomes_analysis * this_analysis);
   void init_atomes_analysis (project * this_proj, gboolean apply_defaults);
   void initialize_this_analysis (project * this_proj, int ana);
+  void trim_analysis_cache ();
+  void write_analysis_cache (project * this_proj, int calc, gchar * key);
+  void print_analysis_cache (project * this_proj, int calc);
+
+  gboolean read_analysis_cache (project * this_proj, int calc, gchar * key);
+
+  gchar * analysis_cache_key (project * this_proj, int calc, int nextra, double * extra);
+  gchar * analysis_cache_file (gchar * key, gboolean create);
 
   atomes_analysis * setup_analysis (gchar * name, int analysis, gboolean req_md, gboolean graph, int num_curves, int n_compat, int * compat, gchar * x_title);
 
 */
 
+#include <glib/gstdio.h>
+
 #include "global.h"
 #include "callbacks.h"
 #include "project.h"
 
+/*! \def ANALYSIS_CACHE_SIZE
+  \brief Maximum size of the result cache on disk, in MB
+*/
+#define ANALYSIS_CACHE_SIZE 256
+
 extern void clean_this_curve_window (int cid, int rid);
+extern void restore_curve (int rid, int cid, int interv, double * xdata, double * ydata);
 extern void apply_analysis_default_parameters_to_project (project * this_proj);
 
 /*!
@@ -197,7 +215,7 @@ atomes_analysis * setup_analysis (int pid, gchar * name, int analysis, gboolean
 /*
   From global.h:
 
-  #define NCALCS 11 -> but 10
+  #define NCALCS 13 -> but SKT is not set up
 
   #define GDR 0
   #define SQD 1
@@ -210,6 +228,8 @@ atomes_analysis * setup_analysis (int pid, gchar * name, int analysis, gboolean
   #define SPH 8
   #define MSD 9
   #define SKT 10
+  #define FSK 11
+  #define VHF 12
 */
 
 /*!
@@ -272,12 +292,22 @@ void init_atomes_analysis (project * this_proj, gboolean apply_defaults)
   {
     // Mean square displacement
     comp_list[0] = MSD;
-    this_proj -> analysis[MSD] = setup_analysis (pid, _("Mean Squared Displacement"), MSD, TRUE, TRUE, 14*i+6, 1, comp_list, NULL);
+    this_proj -> analysis[MSD] = setup_analysis (pid, _("Mean Squared Displacement"), MSD, TRUE, TRUE, 14*i+6 + ((this_proj -> dyn_data) ? 2*(i+1) : 0), 1, comp_list, NULL);
 
     // Dynamic structure factor
     // Number of graphs depends on the number of correlation states, not appearing here
     comp_list[0] = SKT;
     // this_proj -> analysis[SKT] = setup_analysis (pid, _("Dynamic Structure Factor"), SKT, TRUE, TRUE, 0, 1, comp_list, NULL);
+
+    // Self intermediate scattering function
+    // Number of graphs depends on the number of k vectors, not appearing here
+    comp_list[0] = FSK;
+    this_proj -> analysis[FSK] = setup_analysis (pid, _("Self Intermediate Scattering"), FSK, TRUE, TRUE, 0, 1, comp_list, NULL);
+
+    // van Hove correlation function
+    // Number of graphs depends on the number of time steps, not appearing here
+    comp_list[0] = VHF;
+    this_proj -> analysis[VHF] = setup_analysis (pid, _("van Hove Correlation"), VHF, TRUE, TRUE, 0, 1, comp_list, "r [Å]");
   }
 
   g_free (comp_list);
@@ -365,7 +395,7 @@ void initialize_this_analysis (project * this_proj, int ana)
       // Mean square displacement
       comp_list = allocint (1);
       comp_list[0] = MSD;
-      if (this_proj -> steps > 1) this_proj -> analysis[MSD] = setup_analysis (this_proj -> id, _("Mean Squared Displacement"), MSD, TRUE, TRUE, 14*i+6, 1, comp_list, NULL);
+      if (this_proj -> steps > 1) this_proj -> analysis[MSD] = setup_analysis (this_proj -> id, _("Mean Squared Displacement"), MSD, TRUE, TRUE, 14*i+6 + ((this_proj -> dyn_data) ? 2*(i+1) : 0), 1, comp_list, NULL);
       break;
     case SKT:
       comp_list = allocint (1);
@@ -373,6 +403,286 @@ void initialize_this_analysis (project * this_proj, int ana)
       // Total number of graphs depends on the number of correlation states, not appearing here
       // if (this_proj -> steps > 1) this_proj -> analysis[SKT] = setup_analysis (this_proj -> id, _("Dynamic Structure Factor"), SKT, TRUE, TRUE, 0, 2, comp_list, NULL);
       break;
+    case FSK:
+      comp_list = allocint (1);
+      comp_list[0] = FSK;
+      // Total number of graphs depends on the number of k vectors, not appearing here
+      if (this_proj -> steps > 1) this_proj -> analysis[FSK] = setup_analysis (this_proj -> id, _("Self Intermediate Scattering"), FSK, TRUE, TRUE, 0, 1, comp_list, NULL);
+      break;
+    case VHF:
+      comp_list = allocint (1);
+      comp_list[0] = VHF;
+      // Total number of graphs depends on the number of time steps, not appearing here
+      if (this_proj -> steps > 1) this_proj -> analysis[VHF] = setup_analysis (this_proj -> id, _("van Hove Correlation"), VHF, TRUE, TRUE, 0, 1, comp_list, "r [Å]");
+      break;
   }
   g_free (comp_list);
 }
+
+/*!
+  \fn gchar * analysis_cache_key (project * this_proj, int calc, int nextra, double * extra)
+
+  \brief compute the key of an analysis in the result cache: \n
+  SHA-256 hash of the atomic coordinates and the cell for all MD steps, \n
+  of the chemical data, of the bond cutoffs and of the analysis parameters
+
+  \param this_proj the target project
+  \param calc the analysis id
+  \param nextra the number of extra analysis parameters
+  \param extra the extra analysis parameters, if any
+*/
+gchar * analysis_cache_key (project * this_proj, int calc, int nextra, double * extra)
+{
+  int i, j;
+  int head[8];
+  double params[5];
+  double * pos;
+  gchar * key;
+  atomes_analysis * this_analysis = this_proj -> analysis[calc];
+  GChecksum * sum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  // Cache format version, the analysis and the model
+  head[0] = 1;
+  head[1] = calc;
+  head[2] = this_proj -> natomes;
+  head[3] = this_proj -> nspec;
+  head[4] = this_proj -> steps;
+  head[5] = this_proj -> cell.pbc;
+  head[6] = this_proj -> xcor;
+  head[7] = this_proj -> tunit;
+  g_checksum_update (sum, (guchar *)head, sizeof(head));
+  for (i=0; i<this_proj -> nspec; i++)
+  {
+    for (j=0; j<CHEM_PARAMS; j++) g_checksum_update (sum, (guchar *)& this_proj -> chemistry -> chem_prop[j][i], sizeof(double));
+    g_checksum_update (sum, (guchar *)this_proj -> chemistry -> cutoffs[i], this_proj -> nspec*sizeof(double));
+  }
+  g_checksum_update (sum, (guchar *)& this_proj -> chemistry -> grtotcutoff, sizeof(double));
+  if (this_proj -> cell.has_a_box)
+  {
+    j = (this_proj -> cell.npt) ? this_proj -> steps : 1;
+    for (i=0; i<j; i++) g_checksum_update (sum, (guchar *)this_proj -> cell.box[i].vect, 9*sizeof(double));
+  }
+  pos = allocdouble (3*this_proj -> natomes);
+  for (i=0; i<this_proj -> steps; i++)
+  {
+    for (j=0; j<this_proj -> natomes; j++)
+    {
+      pos[3*j] = this_proj -> atoms[i][j].x;
+      pos[3*j+1] = this_proj -> atoms[i][j].y;
+      pos[3*j+2] = this_proj -> atoms[i][j].z;
+      if (! i) g_checksum_update (sum, (guchar *)& this_proj -> atoms[0][j].sp, sizeof(int));
+    }
+    g_checksum_update (sum, (guchar *)pos, 3*this_proj -> natomes*sizeof(double));
+  }
+  g_free (pos);
+
+  // The analysis parameters
+  g_checksum_update (sum, (guchar *)& this_analysis -> num_delta, sizeof(int));
+  params[0] = this_analysis -> delta;
+  params[1] = this_analysis -> min;
+  params[2] = this_analysis -> max;
+  params[3] = this_analysis -> fact;
+  params[4] = this_analysis -> numc;
+  g_checksum_update (sum, (guchar *)params, sizeof(params));
+  if (this_analysis -> other_params) g_checksum_update (sum, (guchar *)this_analysis -> o_params, this_analysis -> other_params*sizeof(double));
+  if (nextra) g_checksum_update (sum, (guchar *)extra, nextra*sizeof(double));
+  key = g_strdup (g_checksum_get_string (sum));
+  g_checksum_free (sum);
+  return key;
+}
+
+/*!
+  \fn gchar * analysis_cache_file (gchar * key, gboolean create)
+
+  \brief get the name of the file of the result cache for a key
+
+  \param key the analysis key in the result cache
+  \param create create the cache directory, if required
+*/
+gchar * analysis_cache_file (gchar * key, gboolean create)
+{
+  gchar * cdir = g_build_filename (g_get_user_cache_dir (), "atomes", NULL);
+  gchar * str = g_strdup_printf ("%s.dat", key);
+  gchar * cfile = NULL;
+  if (! create || g_mkdir_with_parents (cdir, 0755) == 0) cfile = g_build_filename (cdir, str, NULL);
+  g_free (str);
+  g_free (cdir);
+  return cfile;
+}
+
+/*!
+  \fn gboolean read_analysis_cache (project * this_proj, int calc, gchar * key)
+
+  \brief retrieve the results of an analysis from the result cache, if any
+
+  \param this_proj the target project
+  \param calc the analysis id
+  \param key the analysis key in the result cache
+*/
+gboolean read_analysis_cache (project * this_proj, int calc, gchar * key)
+{
+  int i, numc, ndata;
+  long fsize;
+  double * xdata = NULL;
+  double * ydata = NULL;
+  atomes_analysis * this_analysis = this_proj -> analysis[calc];
+  gchar * cfile = analysis_cache_file (key, FALSE);
+  FILE * fp = fopen (cfile, "rb");
+  this_analysis -> cached = FALSE;
+  if (! fp)
+  {
+    g_free (cfile);
+    return FALSE;
+  }
+  if (fread (& numc, sizeof(int), 1, fp) != 1 || numc != this_analysis -> numc) goto end;
+  // Check the entire file first, to avoid loading a partial set of curves
+  fsize = sizeof(int);
+  for (i=0; i<numc; i++)
+  {
+    if (fread (& ndata, sizeof(int), 1, fp) != 1 || ndata < 0) goto end;
+    fsize += sizeof(int) + 2*ndata*sizeof(double);
+    if (fseek (fp, fsize, SEEK_SET)) goto end;
+  }
+  if (fseek (fp, 0, SEEK_END) || ftell (fp) != fsize) goto end;
+  if (fseek (fp, sizeof(int), SEEK_SET)) goto end;
+  for (i=0; i<numc; i++)
+  {
+    if (fread (& ndata, sizeof(int), 1, fp) != 1) goto end;
+    if (ndata)
+    {
+      xdata = allocdouble (ndata);
+      ydata = allocdouble (ndata);
+      if (fread (xdata, sizeof(double), ndata, fp) != ndata || fread (ydata, sizeof(double), ndata, fp) != ndata) goto end;
+    }
+    restore_curve (calc, i, ndata, xdata, ydata);
+    if (xdata) g_free (xdata);
+    if (ydata) g_free (ydata);
+    xdata = ydata = NULL;
+  }
+  this_analysis -> cached = TRUE;
+  end:
+  if (xdata) g_free (xdata);
+  if (ydata) g_free (ydata);
+  fclose (fp);
+  // The modification time of the file is the last use of the result, see 'trim_analysis_cache'
+  if (this_analysis -> cached) g_utime (cfile, NULL);
+  g_free (cfile);
+  return this_analysis -> cached;
+}
+
+/*!
+  \fn void trim_analysis_cache ()
+
+  \brief remove the least recently used results from the result cache, until the cache is below ANALYSIS_CACHE_SIZE MB
+*/
+void trim_analysis_cache ()
+{
+  int i, j;
+  int num = 0;
+  gint64 total = 0;
+  const gchar * name;
+  gchar ** files = NULL;
+  gint64 * size = NULL;
+  gint64 * used = NULL;
+  GStatBuf info;
+  gchar * cdir = g_build_filename (g_get_user_cache_dir (), "atomes", NULL);
+  GDir * dir = g_dir_open (cdir, 0, NULL);
+  if (dir)
+  {
+    while ((name = g_dir_read_name (dir)))
+    {
+      if (g_str_has_suffix (name, ".dat"))
+      {
+        files = g_realloc (files, (num+1)*sizeof*files);
+        size = g_realloc (size, (num+1)*sizeof*size);
+        used = g_realloc (used, (num+1)*sizeof*used);
+        files[num] = g_build_filename (cdir, name, NULL);
+        if (g_stat (files[num], & info) == 0)
+        {
+          size[num] = info.st_size;
+          used[num] = info.st_mtime;
+          total += size[num];
+          num ++;
+        }
+        else
+        {
+          g_free (files[num]);
+        }
+      }
+    }
+    g_dir_close (dir);
+    while (num && total > (gint64)ANALYSIS_CACHE_SIZE*1048576)
+    {
+      j = 0;
+      for (i=1; i<num; i++) if (used[i] < used[j]) j = i;
+      g_remove (files[j]);
+      total -= size[j];
+      g_free (files[j]);
+      num --;
+      files[j] = files[num];
+      size[j] = size[num];
+      used[j] = used[num];
+    }
+    for (i=0; i<num; i++) g_free (files[i]);
+    g_free (files);
+    g_free (size);
+    g_free (used);
+  }
+  g_free (cdir);
+}
+
+/*!
+  \fn void write_analysis_cache (project * this_proj, int calc, gchar * key)
+
+  \brief store the results of an analysis in the result cache
+
+  \param this_proj the target project
+  \param calc the analysis id
+  \param key the analysis key in the result cache
+*/
+void write_analysis_cache (project * this_proj, int calc, gchar * key)
+{
+  int i, ndata;
+  gboolean done = FALSE;
+  atomes_analysis * this_analysis = this_proj -> analysis[calc];
+  gchar * cfile = analysis_cache_file (key, TRUE);
+  if (! cfile) return;
+  FILE * fp = fopen (cfile, "wb");
+  if (fp)
+  {
+    if (fwrite (& this_analysis -> numc, sizeof(int), 1, fp) != 1) goto end;
+    for (i=0; i<this_analysis -> numc; i++)
+    {
+      ndata = this_analysis -> curves[i] -> ndata;
+      if (fwrite (& ndata, sizeof(int), 1, fp) != 1) goto end;
+      if (ndata)
+      {
+        if (fwrite (this_analysis -> curves[i] -> data[0], sizeof(double), ndata, fp) != ndata) goto end;
+        if (fwrite (this_analysis -> curves[i] -> data[1], sizeof(double), ndata, fp) != ndata) goto end;
+      }
+    }
+    done = TRUE;
+    end:
+    fclose (fp);
+    // Never leave an incomplete file in the cache
+    if (! done) g_remove (cfile);
+  }
+  g_free (cfile);
+  if (done) trim_analysis_cache ();
+}
+
+/*!
+  \fn void print_analysis_cache (project * this_proj, int calc)
+
+  \brief print in the analysis text buffer if the results were retrieved from the result cache
+
+  \param this_proj the target project
+  \param calc the analysis id
+*/
+void print_analysis_cache (project * this_proj, int calc)
+{
+  if (this_proj -> analysis[calc] -> cached)
+  {
+    print_info (_("\n \tResults retrieved from the cache, no calculation performed"), "bold_green", this_proj -> analysis[calc] -> calc_buffer);
+  }
+}
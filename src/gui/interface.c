@@ -976,6 +976,7 @@ void lattice_info_ (int * bid, double * volume, double * density,
     if (active_project -> analysis)
     {
       active_project -> analysis[GDR] -> max = fdmax_ (& active_cell -> pbc);
+      if (active_project -> analysis[VHF]) active_project -> analysis[VHF] -> max = active_project -> analysis[GDR] -> max;
       active_project -> analysis[SQD] -> min = active_project -> analysis[SKD] -> min = fkmin_ (& active_cell -> pbc);
       // if (active_project -> analysis[SKT]) active_project -> analysis[SKT] -> min = active_project -> analysis[SKD] -> min;
     }
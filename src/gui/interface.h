@@ -60,6 +60,10 @@ void update_after_calc (int calc);
 
 // In init.c:
 void prepostcalc (GtkWidget * widg, gboolean status, int run, int adv, double opc);
+gchar * analysis_cache_key (project * this_proj, int calc, int nextra, double * extra);
+gboolean read_analysis_cache (project * this_proj, int calc, gchar * key);
+void write_analysis_cache (project * this_proj, int calc, gchar * key);
+void print_analysis_cache (project * this_proj, int calc);
 void prep_calc_actions ();
 
 void init_atomes_analysis (project * this_proj, gboolean apply_defaults);
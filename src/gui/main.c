@@ -41,8 +41,11 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   int get_gradient_from_string (gchar * grad_string);
   int check_for_atomes_file_options (int start, int end, char *argv[]);
   int parse_command_line (int argc, char *argv[])
+  int run_render_jobs (int argc, char ** args);
   int main (int argc, char *argv[]);
 
+  int * get_frames_from_string (gchar * frames_string);
+
   ColRGBA * get_color_from_hexa_string (gchar * color_string);
 
   gboolean destroy_func (gpointer user_data);
@@ -141,6 +144,9 @@ void print_help()
             "  PDB coordinates                   : .pdb, .ent\n"
             "  Crystallographic Information File : .cif\n"
             "  DL-POLY history file              : .hist\n"
+            "  DCD trajectory (CHARMM/NAMD)      : .dcd\n"
+            "  LAMMPS binary dump                : .bin\n"
+            "  XTC trajectory (GROMACS)          : .xtc\n"
             "  ISAACS project file               : .ipf\n\n"
             " alternatively specify the file format using:\n\n"
             " -awf [FILE]\n"
@@ -152,6 +158,9 @@ void print_help()
             " -pdb [FILE], or, -ent [FILE]\n"
             " -cif [FILE]\n"
             " -hist [FILE]\n"
+            " -dcd [FILE]\n"
+            " -lmpbin [FILE]\n"
+            " -xtc [FILE]\n"
             " -ipf [FILE]\n\n"
             "ex:\n\n"
             " atomes -pdb this.f file.awf -cif that.f *.xyz\n\n"
@@ -174,10 +183,15 @@ void print_help()
             "  -D, --back_dir=[DIR]       background gradient direction\n"
             "  -P, --back_pos=[POS]       colors mixed position\n"
             "  -U, --grad_col_a=[COL]     gradient initial color\n"
-            "  -V, --grad_col_b=[COL]     gradient final color\n\n"
+            "  -V, --grad_col_b=[COL]     gradient final color\n"
+            "  -f, --frames=[RANGE]       render MD steps FIRST[:LAST[:STRIDE]], one numbered image each\n"
+            "  -m, --movie                encode the MD steps as a movie, codec from file extension\n"
+            "  -J, --jobs=[N]             render images using N parallel processes\n\n"
             "ex:\n\n"
             " atomes --render-png --width=1920 -H 1024 --output=image.png project.apf -s ball_and_stick\n"
-            " atomes --jpg --style=vdw -r ortho -e pc -t pc\n\n"));
+            " atomes --jpg --style=vdw -r ortho -e pc -t pc\n"
+            " atomes --png --frames=1:1000:10 --jobs=4 -o step.png traj.xyz\n"
+            " atomes --movie --frames=::2 -o traj.mp4 traj.xyz\n\n"));
   printf ("%s", _("\nReport a bug to <"));
   printf ("%s>\n\n", PACKAGE_BUGREPORT);
 }
@@ -275,8 +289,8 @@ int test_this_ext (int len, gchar * arg)
 {
   int i;
   gchar * aext = g_strdup_printf ("%c%c%c%c", arg[len-4], arg[len-3], arg[len-2], arg[len-1]);
-  char * eext[15]={".awf", ".apf", ".xyz", "NULL", ".c3d", ".trj", "NULL", "tcar", "NULL", ".pdb", ".ent", ".cif", "NULL", "hist", ".ipf"};
-  for (i=0; i<15; i++) if (g_strcmp0 (aext, eext[i]) == 0)
+  char * eext[19]={".awf", ".apf", ".xyz", "NULL", ".c3d", ".trj", "NULL", "tcar", "NULL", ".pdb", ".ent", ".cif", "NULL", "NULL", "hist", ".dcd", ".bin", ".xtc", ".ipf"};
+  for (i=0; i<19; i++) if (g_strcmp0 (aext, eext[i]) == 0)
   {
     g_free (aext);
     return -(i+1);
@@ -294,11 +308,11 @@ int test_this_ext (int len, gchar * arg)
 */
 int test_this_arg (gchar * arg)
 {
-  char * fext[15]={"-awf", "-apf", " -xyz", "NULL", "-c3d", "-trj", "NULL", "-xdatcar", "NULL", "-pdb", "-ent", "-cif", "NULL", "-hist", "-ipf"};
+  char * fext[19]={"-awf", "-apf", " -xyz", "NULL", "-c3d", "-trj", "NULL", "-xdatcar", "NULL", "-pdb", "-ent", "-cif", "NULL", "NULL", "-hist", "-dcd", "-lmpbin", "-xtc", "-ipf"};
   int i, j;
   i = strlen(arg);
   gchar * str = g_ascii_strdown (arg, i);
-  for (j=0; j<15; j++)
+  for (j=0; j<19; j++)
   {
     if (g_strcmp0 (str, fext[j]) == 0)
     {
@@ -483,6 +497,79 @@ int get_gradient_from_string (gchar * grad_string)
   return NONE;
 }
 
+/*!
+  \fn int * get_frames_from_string (gchar * frames_string)
+
+  \brief retrieve the range of MD steps to render from command line string
+
+  \param frames_string the range from command line (format: FIRST[:LAST[:STRIDE]], any field can be left empty)
+*/
+int * get_frames_from_string (gchar * frames_string)
+{
+  int * frames = allocint (3);
+  gchar ** fields = g_strsplit (frames_string, ":", 3);
+  int i;
+  double v;
+  for (i=0; i<3 && fields[i]; i++)
+  {
+    if (strlen(fields[i]))
+    {
+      v = string_to_double(fields[i]);
+      frames[i] = (v > 0.0) ? (int)v : 0;
+    }
+  }
+  // A single value is a single MD step
+  if (! fields[1]) frames[1] = frames[0];
+  g_strfreev (fields);
+  return frames;
+}
+
+/*!
+  \fn int run_render_jobs (int argc, char ** args)
+
+  \brief render images from the command line using several atomes processes: \n
+          each process has its own OpenGL context, and renders one image every 'render_image_jobs'
+
+  \param argc number of argument(s) on the command line
+  \param args copy of the initial list of argument(s) on the command line
+*/
+int run_render_jobs (int argc, char ** args)
+{
+  int i, res = 0;
+  GError * error = NULL;
+  GSubprocess ** jobs = g_malloc0 (render_image_jobs*sizeof*jobs);
+  gchar ** job_args = g_malloc0 ((argc+2)*sizeof*job_args);
+  for (i=0; i<argc; i++) job_args[i] = args[i];
+  for (i=0; i<render_image_jobs; i++)
+  {
+    job_args[argc] = g_strdup_printf ("--job=%d", i);
+    jobs[i] = g_subprocess_newv ((const gchar * const *)job_args, G_SUBPROCESS_FLAGS_NONE, & error);
+    g_free (job_args[argc]);
+    if (! jobs[i])
+    {
+      g_warning ("%s", error -> message);
+      g_clear_error (& error);
+      res = 1;
+    }
+  }
+  for (i=0; i<render_image_jobs; i++)
+  {
+    if (jobs[i])
+    {
+      if (! g_subprocess_wait_check (jobs[i], NULL, & error))
+      {
+        g_warning ("%s", error -> message);
+        g_clear_error (& error);
+        res = 1;
+      }
+      g_object_unref (jobs[i]);
+    }
+  }
+  g_free (job_args);
+  g_free (jobs);
+  return res;
+}
+
 /*!
   \fn int check_for_atomes_file_options (int start, int end, char *argv[])
 
@@ -559,6 +646,10 @@ int parse_command_line (int argc, char *argv[])
                                     {"grad_col_a", required_argument, 0, 'U'},
                                     {"grad_col_b", required_argument, 0, 'V'},
                                     {"rep", required_argument, 0, 'r'},
+                                    {"frames", required_argument, 0, 'f'},
+                                    {"movie", no_argument, 0, 'm'},
+                                    {"jobs", required_argument, 0, 'J'},
+                                    {"job", required_argument, 0, 'I'},
                                     // {"debug", no_argument, 0, 'd'},
                                     {0, 0, 0, 0}};
   int opt;
@@ -579,7 +670,7 @@ int parse_command_line (int argc, char *argv[])
   /* Letter follow by : means that the command requires an argument
      No letter if the option is only in long format, ex : --width
      If the long name is empty the command is only in short format */
-  while ((opt = getopt_long(argc, argv, "hvlpjdW:H:o:s:a:b:r:e:t:B:C:G:D:P:U:V:", atomes_options, & index)) != -1)
+  while ((opt = getopt_long(argc, argv, "hvlpjmdW:H:o:s:a:b:r:e:t:B:C:G:D:P:U:V:f:J:I:", atomes_options, & index)) != -1)
   {
     switch (opt)
     {
@@ -619,6 +710,28 @@ int parse_command_line (int argc, char *argv[])
         render_image_format = 1;
         img_opt ++;
         break;
+      case 'm':
+        atomes_render_image = TRUE;
+        render_image_movie = TRUE;
+        img_opt ++;
+        break;
+      case 'f':
+        render_image_frames = get_frames_from_string (optarg);
+        img_opt ++;
+        img_opt += (index == -1) ? 1 : 0;
+        break;
+      case 'J':
+        v = string_to_double(optarg);
+        render_image_jobs = (v > 1.0) ? (int)v : 1;
+        img_opt ++;
+        img_opt += (index == -1) ? 1 : 0;
+        break;
+      case 'I':
+        v = string_to_double(optarg);
+        render_image_job = (v >= 0.0) ? (int)v : NONE;
+        img_opt ++;
+        img_opt += (index == -1) ? 1 : 0;
+        break;
       case 'o':
         render_image_output = g_strdup_printf ("%s", optarg);
         img_opt ++;
@@ -699,8 +812,24 @@ int parse_command_line (int argc, char *argv[])
   if (atomes_from_libreoffice) atomes_render_image = FALSE;
   if (atomes_render_image)
   {
-    if (! render_image_output) render_image_output = g_strdup_printf ("%s", (render_image_format) ? "image.jpg" : "image.png");
-    if (argc == img_opt + 2)
+    if (! render_image_output)
+    {
+      if (render_image_movie)
+      {
+        render_image_output = g_strdup_printf ("%s", "movie.mkv");
+      }
+      else
+      {
+        render_image_output = g_strdup_printf ("%s", (render_image_format) ? "image.jpg" : "image.png");
+      }
+    }
+    if (render_image_movie || render_image_job >= render_image_jobs)
+    {
+      // Movie encoding uses a single video stream, so a single process
+      render_image_jobs = 1;
+      render_image_job = NONE;
+    }
+    if (argc >= img_opt + 2)
     {
       if (image_x || image_y)
       {
@@ -750,7 +879,8 @@ int parse_command_line (int argc, char *argv[])
     }
   }
 
-  return (atomes_render_image && files_to_read == 1) ? TRUE : (atomes_render_image) ? FALSE : TRUE;
+  render_image_files = files_to_read;
+  return (atomes_render_image && files_to_read > 0) ? TRUE : (atomes_render_image) ? FALSE : TRUE;
 }
 
 /*!
@@ -934,7 +1064,7 @@ void open_this_data_file (int file_type, gchar * file_name)
         read_this_file (2, file_name);
       }
       break;
-    case 15:
+    case 19:
       init_project (TRUE);
       open_this_isaacs_xml_file (g_strdup_printf ("%s", file_name), activep, FALSE);
       break;
@@ -1240,6 +1370,8 @@ int main (int argc, char *argv[])
   PACKAGE_SGMI = g_build_filename (PACKAGE_PREFIX, "pixmaps/bravais/Monoclinic-I.png", NULL);
   PACKAGE_SGTC = g_build_filename (PACKAGE_PREFIX, "pixmaps/bravais/Triclinic.png", NULL);
 
+  // getopt and the file options re-arrange the command line, keep a copy for parallel rendering
+  gchar ** args = g_strdupv (argv);
   switch (argc)
   {
     case 1:
@@ -1249,6 +1381,13 @@ int main (int argc, char *argv[])
       RUNC = parse_command_line (argc, argv);
       break;
   }
+  if (RUNC && atomes_render_image && render_image_jobs > 1 && render_image_job == NONE)
+  {
+    int res = run_render_jobs (argc, args);
+    g_strfreev (args);
+    return res;
+  }
+  g_strfreev (args);
 
   if (RUNC)
   {
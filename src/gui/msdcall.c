@@ -34,6 +34,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void update_dynamic_view (project * this_proj, GtkTextBuffer * calc_buffer);
   void update_msd_view (project * this_proj);
 
+  gchar * msd_cache_key (project * this_proj, gboolean vel);
+
   G_MODULE_EXPORT void on_calc_msd_released (GtkWidget * widg, gpointer data);
 
 */
@@ -108,6 +110,23 @@ void init_msd (project * this_proj)
   this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s[y]", _("Drift"));
   j=j+1;
   this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s[z]", _("Drift"));
+  if (this_proj -> analysis[MSD] -> numc > 14*this_proj -> nspec + 6)
+  {
+    for ( i = 0 ; i < this_proj -> nspec ; i++ )
+    {
+      j=j+1;
+      this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s[%s]", _("VACF"), active_chem -> label[i]);
+    }
+    j=j+1;
+    this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s", _("VACF"));
+    for ( i = 0 ; i < this_proj -> nspec ; i++ )
+    {
+      j=j+1;
+      this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s[%s]", _("VDOS"), active_chem -> label[i]);
+    }
+    j=j+1;
+    this_proj -> analysis[MSD] -> curves[j] -> name = g_strdup_printf ("%s", _("VDOS"));
+  }
 
   add_curve_widgets (this_proj, MSD);
   this_proj -> analysis[MSD] -> init_ok = TRUE;
@@ -153,8 +172,44 @@ void update_msd_view (project * this_proj)
   print_info (_("\n\nMean Square Displacement\n\n"), "heading", this_proj -> analysis[MSD] -> calc_buffer);
   print_info (_("Calculation details:\n\n"), NULL, this_proj -> analysis[MSD] -> calc_buffer);
   update_dynamic_view (this_proj, this_proj -> analysis[MSD] -> calc_buffer);
+  if (this_proj -> analysis[MSD] -> numc > 14*this_proj -> nspec + 6)
+  {
+    print_info (_("\n\n\t - Velocity autocorrelation function and vibrational density of states computed using the velocities read in the trajectory"), "bold", this_proj -> analysis[MSD] -> calc_buffer);
+  }
   print_info ("\n", NULL, this_proj -> analysis[MSD] -> calc_buffer);
   print_info (calculation_time(TRUE, this_proj -> analysis[MSD] -> calc_time), NULL, this_proj -> analysis[MSD] -> calc_buffer);
+  print_analysis_cache (this_proj, MSD);
+}
+
+/*!
+  \fn gchar * msd_cache_key (project * this_proj, gboolean vel)
+
+  \brief compute the key of the MSD in the result cache, \n
+  if the VACF is also computed the velocities of each MD step are hashed as well
+
+  \param this_proj the target project
+  \param vel compute the VACF (1/0)
+*/
+gchar * msd_cache_key (project * this_proj, gboolean vel)
+{
+  double extra = (double)this_proj -> dyn_data;
+  gchar * key = analysis_cache_key (this_proj, MSD, (vel) ? 1 : 0, (vel) ? & extra : NULL);
+  if (vel)
+  {
+    int i;
+    gsize vsize = 3*this_proj -> natomes;
+    GChecksum * sum = g_checksum_new (G_CHECKSUM_SHA256);
+    g_checksum_update (sum, (guchar *)key, -1);
+    // dynamics[steps][dyn_data][natomes][3], the forces are not used by the VACF
+    for (i=0; i<this_proj -> steps; i++)
+    {
+      g_checksum_update (sum, (guchar *)& this_proj -> dynamics[(gsize)i*this_proj -> dyn_data*vsize], vsize*sizeof(float));
+    }
+    g_free (key);
+    key = g_strdup (g_checksum_get_string (sum));
+    g_checksum_free (sum);
+  }
+  return key;
 }
 
 /*!
@@ -173,7 +228,15 @@ G_MODULE_EXPORT void on_calc_msd_released (GtkWidget * widg, gpointer data)
   prepostcalc (widg, FALSE, MSD, 0, opac);
   active_project -> analysis[MSD] -> min = active_project -> analysis[MSD] -> delta*active_project -> analysis[MSD] -> num_delta;
   active_project -> analysis[MSD] -> max = (active_project -> steps - 1)*active_project -> analysis[MSD] -> delta*active_project -> analysis[MSD] -> num_delta;
-  i = msd_ (& active_project -> analysis[MSD] -> delta, & active_project -> analysis[MSD] -> num_delta);
+  gboolean vel = (active_project -> dyn_data && active_project -> dynamics && active_project -> analysis[MSD] -> numc > 14*active_project -> nspec + 6);
+  gchar * key = msd_cache_key (active_project, vel);
+  if (! (i = read_analysis_cache (active_project, MSD, key)))
+  {
+    i = msd_ (& active_project -> analysis[MSD] -> delta, & active_project -> analysis[MSD] -> num_delta);
+    if (i && vel) i = vacf_ (& active_project -> analysis[MSD] -> delta, & active_project -> analysis[MSD] -> num_delta, & active_project -> dyn_data, active_project -> dynamics);
+    if (i) write_analysis_cache (active_project, MSD, key);
+  }
+  g_free (key);
   prepostcalc (widg, TRUE, MSD, i, 1.0);
   if (! i)
   {
@@ -222,10 +222,12 @@ gboolean default_skt_sets;        /*!< Output calculation results for all t step
 int default_skt_n_sets;           /*!< Number of configuration(s) to save when computing S(k,t) */
 int default_sqw_n_sets;           /*!< Number of q vector(s) to compute S(q,w) */
 int default_sqw_freq;             /*!< Frequency intervals */
+int default_sqw_window;           /*!< Time window for S(q,w) */
 gboolean tmp_skt_sets;
 int tmp_skt_n_sets;
 int tmp_sqw_n_sets;
 int tmp_sqw_freq;
+int tmp_sqw_window;
 
 // 5+3 styles + 5+3 cloned styles
 element_radius * default_atomic_rad[16];
@@ -477,10 +479,11 @@ int save_preferences_to_xml_file ()
                               i18n("Only search for ABAB chains"),
                               i18n("No homopolar bonds in the chains (A-A, B-B ...)"),
                               i18n("Only search for 1-(2)n-1 chains")};
-  gchar * xml_skt_leg[4] = {i18n("Analyze all correlated δt steps"),
+  gchar * xml_skt_leg[5] = {i18n("Analyze all correlated δt steps"),
                             i18n("Number of analyzed δt steps"),
                             i18n("Number of analyzed q points"),
-                            i18n("Number of frequency points")};
+                            i18n("Number of frequency points"),
+                            i18n("Time window")};
   gchar * xml_opengl_leg[5] = {i18n("Default style"),
                                i18n("Atom(s) color map"),
                                i18n("Polyhedra color map"),
@@ -636,6 +639,10 @@ int save_preferences_to_xml_file ()
   rc = xml_save_parameter_to_file (writer, _(xml_skt_leg[2]), "default_sqw_freq", FALSE, i, str);
   g_free (str);
   if (! rc) return 0;
+  str = g_strdup_printf ("%d", default_sqw_window);
+  rc = xml_save_parameter_to_file (writer, _(xml_skt_leg[4]), "default_sqw_window", FALSE, i, str);
+  g_free (str);
+  if (! rc) return 0;
 
   // End analysis
   rc = xmlTextWriterEndElement (writer);
@@ -1324,6 +1331,12 @@ void set_parameter (xmlChar * content, gchar * key, int vid, dint * bond, vec3_t
   {
     default_sqw_freq = (int)xml_string_to_double(content);
   }
+  else if (g_strcmp0(key, "default_sqw_window") == 0)
+  {
+    default_sqw_window = (int)xml_string_to_double(content);
+    // Index in 'sqw_windows', the file might be edited by hand
+    default_sqw_window = min (max (default_sqw_window, 0), 3);
+  }
   else if (g_strcmp0(key, "default_opengl") == 0)
   {
     default_opengl[vid] = (int)xml_string_to_double(content);
@@ -2181,6 +2194,7 @@ void set_atomes_defaults ()
   default_skt_n_sets = 5;
   default_sqw_n_sets = 5;
   default_sqw_freq = 1000;
+  default_sqw_window = 0;
 
   for (i=0; i<3; i++) default_opengl[i] = 0;
   default_opengl[3] = QUALITY;
@@ -4583,6 +4597,7 @@ void prepare_tmp_default ()
   tmp_skt_n_sets = default_skt_n_sets;
   tmp_sqw_n_sets = default_sqw_n_sets;
   tmp_sqw_freq = default_sqw_freq;
+  tmp_sqw_window = default_sqw_window;
 
   tmp_opengl = duplicate_int (5, default_opengl);
   duplicate_material (& tmp_material, & default_material);
@@ -4707,8 +4722,7 @@ G_MODULE_EXPORT void update_projects (GtkDialog * proj_sel, gint response_id, gp
 #endif
               }
               bonds_update = 1;
-              frag_update = (this_proj -> natomes > ATOM_LIMIT) ? 0 : 1;
-              mol_update = (frag_update) ? ((this_proj -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+              frag_update = mol_update = 1;
               this_proj -> runc[0] = FALSE;
               this_proj -> dmtx = FALSE;
               if (this_proj -> id != activep)
@@ -4803,6 +4817,7 @@ void save_preferences ()
   default_skt_n_sets = tmp_skt_n_sets;
   default_sqw_n_sets = tmp_sqw_n_sets;
   default_sqw_freq = tmp_sqw_freq;
+  default_sqw_window = tmp_sqw_window;
 
   default_opengl = duplicate_int (5, tmp_opengl);
   duplicate_material (& default_material, & tmp_material);
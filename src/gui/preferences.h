@@ -121,10 +121,12 @@ extern gboolean default_skt_sets;
 extern int default_skt_n_sets;
 extern int default_sqw_n_sets;
 extern int default_sqw_freq;
+extern int default_sqw_window;
 extern gboolean tmp_skt_sets;
 extern int tmp_skt_n_sets;
 extern int tmp_sqw_n_sets;
 extern int tmp_sqw_freq;
+extern int tmp_sqw_window;
 
 // OpenGL
 extern int * default_opengl;
@@ -312,6 +312,9 @@ void update_skt_view (project * this_proj)
     print_info ("-1", "sup_bold", this_proj -> analysis[SKT] -> calc_buffer);
     print_info ("\n", "bold", this_proj -> analysis[SKT] -> calc_buffer);
   }
+  print_info (_("\n\t - Time window: "), "bold", this_proj -> analysis[SKT] -> calc_buffer);
+  print_info (_(sqw_windows[this_proj -> sqw_window]), "bold_blue", this_proj -> analysis[SKT] -> calc_buffer);
+  print_info ("\n", NULL, this_proj -> analysis[SKT] -> calc_buffer);
   print_info (calculation_time(TRUE, this_proj -> analysis[SKT] -> calc_time), NULL, this_proj -> analysis[SKT] -> calc_buffer);
 }
 
@@ -355,7 +358,8 @@ G_MODULE_EXPORT void on_calc_skt_released (GtkWidget * widg, gpointer data)
                              & detla_t,
                              & active_project -> sqw_n_data_sets,
                              active_project -> sqw_q_id,
-                             & active_project -> sqw_freq);
+                             & active_project -> sqw_freq,
+                             & active_project -> sqw_window);
     g_free (xsk);
     xsk = NULL;
     prepostcalc (widg, TRUE, SKT, res_skt, 1.0);
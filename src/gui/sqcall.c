@@ -193,6 +193,7 @@ void update_sq_view (project * this_proj, int sqk)
   if (sqk != SKT)
   {
     print_info (calculation_time(TRUE, this_proj -> analysis[sqk] -> calc_time), NULL, this_proj -> analysis[sqk] -> calc_buffer);
+    print_analysis_cache (this_proj, sqk);
   }
 }
 
@@ -211,9 +212,17 @@ G_MODULE_EXPORT void on_calc_sq_released (GtkWidget * widg, gpointer data)
   clean_curves_data (SQD, 0, active_project -> analysis[SQD] -> numc);
   active_project -> analysis[SQD] -> delta = (active_project -> analysis[SQD] -> max - active_project -> analysis[SQD] -> min) / active_project -> analysis[SQD] -> num_delta;
   prepostcalc (widg, FALSE, SQD, 0, opac);
-  i = s_of_q_ (& active_project -> analysis[SQD] -> max,
-               & active_project -> analysis[SQD] -> min,
-               & active_project -> analysis[SQD] -> num_delta);
+  // S(q) is computed from the g(r) curves: the g(r) parameters are part of the key
+  double extra[2] = {active_project -> analysis[GDR] -> num_delta, active_project -> analysis[GDR] -> delta};
+  gchar * key = analysis_cache_key (active_project, SQD, 2, extra);
+  if (! (i = read_analysis_cache (active_project, SQD, key)))
+  {
+    i = s_of_q_ (& active_project -> analysis[SQD] -> max,
+                 & active_project -> analysis[SQD] -> min,
+                 & active_project -> analysis[SQD] -> num_delta);
+    if (i) write_analysis_cache (active_project, SQD, key);
+  }
+  g_free (key);
   prepostcalc (widg, TRUE, SQD, i, 1.0);
   if (! i)
   {
@@ -260,20 +269,27 @@ G_MODULE_EXPORT void on_calc_sk_released (GtkWidget * widg, gpointer data)
   clean_curves_data (SKD, 0, active_project -> analysis[SKD] -> numc);
   active_project -> analysis[SKD] -> delta = (active_project -> analysis[SKD] -> max - active_project -> analysis[SKD] -> min) / active_project -> analysis[SKD] -> num_delta;
   prepostcalc (widg, FALSE, SKD, 0, opac);
-  i = cqvf_ (& active_project -> analysis[SKD] -> max,
-             & active_project -> analysis[SKD] -> min,
-             & active_project -> analysis[SKD] -> num_delta,
-             & active_project -> sk_advanced[0][0],
-             & active_project -> sk_advanced[0][1]);
+  gchar * key = analysis_cache_key (active_project, SKD, 2, active_project -> sk_advanced[0]);
+  j = read_analysis_cache (active_project, SKD, key);
+  i = (j) ? 1 : cqvf_ (& active_project -> analysis[SKD] -> max,
+                       & active_project -> analysis[SKD] -> min,
+                       & active_project -> analysis[SKD] -> num_delta,
+                       & active_project -> sk_advanced[0][0],
+                       & active_project -> sk_advanced[0][1]);
   if (i == 1)
   {
-    for (i=0; i<active_project -> analysis[SKD] -> numc; i++)
+    if (! j)
     {
-      active_project -> analysis[SKD] -> curves[i] -> ndata = 0;
+      for (i=0; i<active_project -> analysis[SKD] -> numc; i++)
+      {
+        active_project -> analysis[SKD] -> curves[i] -> ndata = 0;
+      }
+      j = s_of_k_ (& active_project -> analysis[SKD] -> num_delta, & active_project -> xcor);
+      g_free (xsk);
+      xsk = NULL;
+      if (j) write_analysis_cache (active_project, SKD, key);
     }
-    j = s_of_k_ (& active_project -> analysis[SKD] -> num_delta, & active_project -> xcor);
-    g_free (xsk);
-    xsk = NULL;
+    g_free (key);
     prepostcalc (widg, TRUE, SKD, j, 1.0);
     active_project -> analysis[GDK] -> avail_ok = j;
 
@@ -291,6 +307,7 @@ G_MODULE_EXPORT void on_calc_sk_released (GtkWidget * widg, gpointer data)
   }
   else
   {
+    g_free (key);
     prepostcalc (widg, TRUE, SKD, i, 1.0);
     show_error (_("Problem during the selection of the k-points\nused to sample the reciprocal lattice"), 0, widg);
   }
@@ -98,7 +98,7 @@ void fill_tool_model ()
 
   if (active_project)
   {
-    i = (active_project -> steps > 1) ? 45 : 0;
+    i = (active_project -> steps > 1) ? 135 : 0;
     gtk_window_set_resizable (GTK_WINDOW (curvetoolbox), TRUE);
 #ifdef GTK4
     gtk_window_set_default_size (GTK_WINDOW (curvetoolbox), 300, 250+i);
@@ -110,10 +110,14 @@ void fill_tool_model ()
   gtk_tree_store_clear (tool_model);
   for (i=0; i<NCALCS; i++)
   {
-    if (i != MSD && i != SKT)
+    if (i < MSD)
     {
       append = TRUE;
     }
+    else if (i == SKT)
+    {
+      append = FALSE;
+    }
     else
     {
       if (active_project)
@@ -0,0 +1,302 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file vhfcall.c
+* @short Callbacks for the self intermediate scattering Fs(k,t) and van Hove G(r,t) calculation dialogs
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'vhfcall.c'
+*
+* Contains:
+*
+
+ - The callbacks for the self intermediate scattering Fs(k,t) calculation dialog
+ - The callbacks for the van Hove correlation G(r,t) calculation dialog
+
+*
+* List of functions:
+
+  void init_fsk (project * this_proj);
+  void init_vhf (project * this_proj);
+  void update_fsk_view (project * this_proj);
+  void update_vhf_view (project * this_proj);
+
+  G_MODULE_EXPORT void on_calc_fsk_released (GtkWidget * widg, gpointer data);
+  G_MODULE_EXPORT void on_calc_vhf_released (GtkWidget * widg, gpointer data);
+
+*/
+
+#include <gtk/gtk.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "global.h"
+#include "bind.h"
+#include "interface.h"
+#include "callbacks.h"
+#include "curve.h"
+#include "project.h"
+
+extern void alloc_analysis_curves (int pid, atomes_analysis * this_analysis);
+extern void update_dynamic_view (project * this_proj, GtkTextBuffer * calc_buffer);
+
+/*!
+  \fn void init_fsk (project * this_proj)
+
+  \brief initialize the curve widgets for the Fs(k,t) calculation
+
+  \param this_proj the target project
+*/
+void init_fsk (project * this_proj)
+{
+  int h, i, j;
+  if (this_proj -> analysis[FSK] -> curves)
+  {
+    for (i=0; i<this_proj -> analysis[FSK] -> numc; i++)
+    {
+      hide_the_widgets (this_proj -> analysis[FSK] -> curves[i] -> window);
+    }
+  }
+  this_proj -> analysis[FSK] -> numc = this_proj -> fsk_n_data_sets*(this_proj -> nspec + 1);
+  alloc_analysis_curves (this_proj -> id, this_proj -> analysis[FSK]);
+  j = 0;
+  for (h=0; h<this_proj -> fsk_n_data_sets; h++)
+  {
+    for (i=0; i<this_proj -> nspec; i++)
+    {
+      this_proj -> analysis[FSK] -> curves[j] -> name = g_strdup_printf ("Fs(k,ẟt)[%s] - k= %f", active_chem -> label[i], this_proj -> fsk_k_id[h]);
+      j ++;
+    }
+    this_proj -> analysis[FSK] -> curves[j] -> name = g_strdup_printf ("Fs(k,ẟt) - k= %f", this_proj -> fsk_k_id[h]);
+    j ++;
+  }
+  add_curve_widgets (this_proj, FSK);
+  this_proj -> analysis[FSK] -> init_ok = TRUE;
+}
+
+/*!
+  \fn void init_vhf (project * this_proj)
+
+  \brief initialize the curve widgets for the G(r,t) calculation
+
+  \param this_proj the target project
+*/
+void init_vhf (project * this_proj)
+{
+  int h, i, j, k;
+  if (this_proj -> analysis[VHF] -> curves)
+  {
+    for (i=0; i<this_proj -> analysis[VHF] -> numc; i++)
+    {
+      hide_the_widgets (this_proj -> analysis[VHF] -> curves[i] -> window);
+    }
+  }
+  this_proj -> analysis[VHF] -> numc = this_proj -> vhf_n_data_sets*(2 + this_proj -> nspec + this_proj -> nspec*this_proj -> nspec);
+  alloc_analysis_curves (this_proj -> id, this_proj -> analysis[VHF]);
+  k = 0;
+  for (h=0; h<this_proj -> vhf_n_data_sets; h++)
+  {
+    for (i=0; i<this_proj -> nspec; i++)
+    {
+      this_proj -> analysis[VHF] -> curves[k] -> name = g_strdup_printf ("Gs(r,ẟt)[%s] - ẟt= %d", active_chem -> label[i], this_proj -> vhf_step_id[h]);
+      k ++;
+    }
+    this_proj -> analysis[VHF] -> curves[k] -> name = g_strdup_printf ("Gs(r,ẟt) - ẟt= %d", this_proj -> vhf_step_id[h]);
+    k ++;
+    for (i=0; i<this_proj -> nspec; i++)
+    {
+      for (j=0; j<this_proj -> nspec; j++)
+      {
+        this_proj -> analysis[VHF] -> curves[k] -> name = g_strdup_printf ("Gd(r,ẟt)[%s,%s] - ẟt= %d", active_chem -> label[i], active_chem -> label[j], this_proj -> vhf_step_id[h]);
+        k ++;
+      }
+    }
+    this_proj -> analysis[VHF] -> curves[k] -> name = g_strdup_printf ("Gd(r,ẟt) - ẟt= %d", this_proj -> vhf_step_id[h]);
+    k ++;
+  }
+  add_curve_widgets (this_proj, VHF);
+  this_proj -> analysis[VHF] -> init_ok = TRUE;
+}
+
+/*!
+  \fn void update_fsk_view (project * this_proj)
+
+  \brief update the project text view for the Fs(k,t) calculation
+
+  \param this_proj the target project
+*/
+void update_fsk_view (project * this_proj)
+{
+  int i;
+  gchar * str;
+  if (this_proj -> analysis[FSK] -> calc_buffer == NULL) this_proj -> analysis[FSK] -> calc_buffer = add_buffer (NULL, NULL, NULL);
+  view_buffer (this_proj -> analysis[FSK] -> calc_buffer);
+  print_info (_("\n\nSelf Intermediate Scattering Function - Fs(k,δt)\n\n"), "heading", this_proj -> analysis[FSK] -> calc_buffer);
+  print_info (_("Calculation details:\n\n"), NULL, this_proj -> analysis[FSK] -> calc_buffer);
+  update_dynamic_view (this_proj, this_proj -> analysis[FSK] -> calc_buffer);
+  print_info ("\n\n\t - ", "bold", this_proj -> analysis[FSK] -> calc_buffer);
+  str = g_strdup_printf ("%d", this_proj -> fsk_n_data_sets);
+  print_info (str, "bold_blue", this_proj -> analysis[FSK] -> calc_buffer);
+  g_free (str);
+  print_info (_(" k vectors were analyzed:\n\n"), "bold", this_proj -> analysis[FSK] -> calc_buffer);
+  for (i=0; i<this_proj -> fsk_n_data_sets; i++)
+  {
+    print_info (" \t\t ", NULL, this_proj -> analysis[FSK] -> calc_buffer);
+    str = g_strdup_printf ("%d", i);
+    print_info (str, NULL, this_proj -> analysis[FSK] -> calc_buffer);
+    g_free (str);
+    print_info (") k\t=\t", NULL, this_proj -> analysis[FSK] -> calc_buffer);
+    str = g_strdup_printf ("%f", this_proj -> fsk_k_id[i]);
+    print_info (str, "bold_red", this_proj -> analysis[FSK] -> calc_buffer);
+    g_free (str);
+    print_info (" Å", "bold", this_proj -> analysis[FSK] -> calc_buffer);
+    print_info ("-1", "sup_bold", this_proj -> analysis[FSK] -> calc_buffer);
+    print_info ("\n", "bold", this_proj -> analysis[FSK] -> calc_buffer);
+  }
+  print_info ("\n", NULL, this_proj -> analysis[FSK] -> calc_buffer);
+  print_info (calculation_time(TRUE, this_proj -> analysis[FSK] -> calc_time), NULL, this_proj -> analysis[FSK] -> calc_buffer);
+}
+
+/*!
+  \fn void update_vhf_view (project * this_proj)
+
+  \brief update the project text view for the G(r,t) calculation
+
+  \param this_proj the target project
+*/
+void update_vhf_view (project * this_proj)
+{
+  int i;
+  gchar * str;
+  if (this_proj -> analysis[VHF] -> calc_buffer == NULL) this_proj -> analysis[VHF] -> calc_buffer = add_buffer (NULL, NULL, NULL);
+  view_buffer (this_proj -> analysis[VHF] -> calc_buffer);
+  print_info (_("\n\nvan Hove Correlation Function - G(r,δt)\n\n"), "heading", this_proj -> analysis[VHF] -> calc_buffer);
+  print_info (_("Calculation details:\n\n"), NULL, this_proj -> analysis[VHF] -> calc_buffer);
+  print_info (_("\t - Number of δr steps: "), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  str = g_strdup_printf ("%d", this_proj -> analysis[VHF] -> num_delta);
+  print_info (str, "bold_blue", this_proj -> analysis[VHF] -> calc_buffer);
+  g_free (str);
+  print_info (_("\n\n\t - δr = "), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  str = g_strdup_printf ("%f", this_proj -> analysis[VHF] -> delta);
+  print_info (str, "bold_blue", this_proj -> analysis[VHF] -> calc_buffer);
+  g_free (str);
+  print_info (" Å\n\n", "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  update_dynamic_view (this_proj, this_proj -> analysis[VHF] -> calc_buffer);
+  print_info (_("\n\n\t - Number of MD steps between two time origins: "), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  str = g_strdup_printf ("%d", this_proj -> vhf_stride);
+  print_info (str, "bold_blue", this_proj -> analysis[VHF] -> calc_buffer);
+  g_free (str);
+  print_info (_("\n\n\t - Results saved for "), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  str = g_strdup_printf ("%d", this_proj -> vhf_n_data_sets);
+  print_info (str, "bold_blue", this_proj -> analysis[VHF] -> calc_buffer);
+  g_free (str);
+  print_info (_(" correlated calculations:\n\n"), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  for (i=0; i<this_proj -> vhf_n_data_sets; i++)
+  {
+    print_info (" \t\t ", NULL, this_proj -> analysis[VHF] -> calc_buffer);
+    str = g_strdup_printf ("%d", i);
+    print_info (str, NULL, this_proj -> analysis[VHF] -> calc_buffer);
+    g_free (str);
+    print_info (") δt\t=\t", NULL, this_proj -> analysis[VHF] -> calc_buffer);
+    str = g_strdup_printf ("%d\n", this_proj -> vhf_step_id[i]);
+    print_info (str, "bold_green", this_proj -> analysis[VHF] -> calc_buffer);
+    g_free (str);
+  }
+  if (! this_proj -> cell.pbc)
+  {
+    print_info (_("\n\t - No periodic boundary conditions: distinct part Gd(r,δt) not computed\n"), "bold", this_proj -> analysis[VHF] -> calc_buffer);
+  }
+  print_info ("\n", NULL, this_proj -> analysis[VHF] -> calc_buffer);
+  print_info (calculation_time(TRUE, this_proj -> analysis[VHF] -> calc_time), NULL, this_proj -> analysis[VHF] -> calc_buffer);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void on_calc_fsk_released (GtkWidget * widg, gpointer data)
+
+  \brief compute Fs(k,t)
+
+  \param widg the GtkWidget sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void on_calc_fsk_released (GtkWidget * widg, gpointer data)
+{
+  int i;
+  if (! active_project -> fsk_n_data_sets || ! active_project -> fsk_k_id)
+  {
+    show_error (_("Please select at least one k vector"), 0, widg);
+    return;
+  }
+  init_fsk (active_project);
+  clean_curves_data (FSK, 0, active_project -> analysis[FSK] -> numc);
+  prepostcalc (widg, FALSE, FSK, 0, opac);
+  active_project -> analysis[FSK] -> min = 0.0;
+  active_project -> analysis[FSK] -> delta = active_project -> analysis[MSD] -> delta*active_project -> analysis[MSD] -> num_delta;
+  active_project -> analysis[FSK] -> max = (active_project -> steps - 1)*active_project -> analysis[FSK] -> delta;
+  i = fs_of_k_t_ (& active_project -> fsk_n_data_sets, active_project -> fsk_k_id);
+  prepostcalc (widg, TRUE, FSK, i, 1.0);
+  if (! i)
+  {
+    show_error (_("The self intermediate scattering calculation has failed"), 0, widg);
+  }
+  else
+  {
+    update_fsk_view (active_project);
+    show_the_widgets (curvetoolbox);
+  }
+  fill_tool_model ();
+}
+
+/*!
+  \fn G_MODULE_EXPORT void on_calc_vhf_released (GtkWidget * widg, gpointer data)
+
+  \brief compute G(r,t)
+
+  \param widg the GtkWidget sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void on_calc_vhf_released (GtkWidget * widg, gpointer data)
+{
+  int i;
+  if (! active_project -> vhf_n_data_sets || ! active_project -> vhf_step_id)
+  {
+    show_error (_("Please select at least one time step"), 0, widg);
+    return;
+  }
+  init_vhf (active_project);
+  clean_curves_data (VHF, 0, active_project -> analysis[VHF] -> numc);
+  prepostcalc (widg, FALSE, VHF, 0, opac);
+  active_project -> analysis[VHF] -> min = 0.0;
+  active_project -> analysis[VHF] -> delta = active_project -> analysis[VHF] -> max / active_project -> analysis[VHF] -> num_delta;
+  if (active_project -> vhf_stride < 1) active_project -> vhf_stride = 1;
+  i = van_hove_ (& active_project -> analysis[VHF] -> num_delta,
+                 & active_project -> analysis[VHF] -> delta,
+                 & active_project -> vhf_n_data_sets,
+                 active_project -> vhf_step_id,
+                 & active_project -> vhf_stride);
+  prepostcalc (widg, TRUE, VHF, i, 1.0);
+  if (! i)
+  {
+    show_error (_("The van Hove correlation calculation has failed"), 0, widg);
+  }
+  else
+  {
+    update_vhf_view (active_project);
+    show_the_widgets (curvetoolbox);
+  }
+  fill_tool_model ();
+}
@@ -34,6 +34,10 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   int sphere_indices (int qual);
   int find_atom_vertices (gboolean to_pick);
   int find_clone_vertices (gboolean to_pick);
+  int get_level_of_detail ();
+  int compare_clone_images (const void * a, const void * b);
+
+  gboolean find_clone_images ();
 
   float get_sphere_radius (int style, int sp, int ac, int sel);
 
@@ -42,7 +46,9 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void setup_atom_vertices (int style, gboolean to_pick, float * vertices);
   void prepare_clone (int style, gboolean to_pick, int picked, atom at, atom bt, float x, float y, float z, float * vertices);
   void setup_clone_vertices (int style, gboolean to_pick, float * vertices);
+  void setup_clone_images (int style, object_3d * clone);
   void atom_positions_colors_and_sizes (int style, gboolean to_pick, float * instances);
+  void create_atom_shader (int sid, int num, gboolean to_pick, gboolean clones, int shid);
   void create_atom_lists (gboolean to_pick);
 
   ColRGBA get_atom_color (int i, int j, double al, int picked, gboolean to_pick);
@@ -60,6 +66,12 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 int atom_id;
 int gColorID[3];
 int all_styles[NUM_STYLES];
+int clone_styles[NUM_STYLES];
+gboolean clones_in_cells;
+int num_clone_images;
+gint64 * clone_images = NULL;
+
+extern gboolean glsl_base_instance ();
 
 /*!
   \fn ColRGBA get_atom_color (int i, int j, double al, int picked, gboolean to_pick)
@@ -92,6 +104,7 @@ ColRGBA get_atom_color (int i, int j, double al, int picked, gboolean to_pick)
       }
     }
     wingl -> color_to_pick[wingl -> to_be_picked] = gColorID[0] + 256*gColorID[1] + 256*256*gColorID[2];
+    wingl -> pick_to_object[wingl -> to_be_picked] = j;
     colo.red = gColorID[0]/255.0;
     colo.green = gColorID[1]/255.0;
     colo.blue = gColorID[2]/255.0;
@@ -292,6 +305,48 @@ object_3d * draw_billboard_quad ()
   return quad;
 }
 
+int lod_quality;
+float lod_scale;
+
+/*!
+  \fn int get_level_of_detail ()
+
+  \brief find the level of detail to render the atom(s) and the bond(s),
+  according to the number of objects and their size on screen:
+  0 = full quality, 1 = low poly meshes (vertex budget), 2 = lowest poly meshes, 3 = points
+*/
+int get_level_of_detail ()
+{
+  int i, j;
+  float rad, r_px;
+
+  lod_quality = plot -> quality;
+  if (atomes_render_image || in_movie_encoding) return 0;
+  if (plot -> style == WIREFRAME || plot -> style == PUNT) return 0;
+  j = proj_at;
+  if (plot -> draw_clones) j += 2 * wingl -> bonds[step][1];
+  if (j < LOD_MIN_OBJECTS) return 0;
+
+  rad = 0.0;
+  for (i=0; i<proj_sp; i++) rad += get_sphere_radius (plot -> style, i, 0, 0);
+  rad /= proj_sp;
+  // Number of pixels per Angstrom at the center of the scene
+  lod_scale = wingl -> projection_matrix.m[1][1] * wingl -> pixels[1] / 2.0;
+  if (plot -> rep == PERSPECTIVE) lod_scale /= plot -> p_depth;
+  r_px = rad * lod_scale;
+  // Impostors: a single quad for each instance, whatever the quality
+  if (r_px < LOD_MESH_PIXELS && ! plot -> ray_tracing) lod_quality = min (plot -> quality, LOD_MIN_QUALITY);
+  if (r_px < LOD_POINT_PIXELS) return 3;
+  if (plot -> ray_tracing) return 0;
+  if (r_px < LOD_MESH_PIXELS) return 2;
+  if ((double)j * sphere_vertices (plot -> quality) > LOD_VERTEX_BUDGET)
+  {
+    lod_quality = max (LOD_MIN_QUALITY, (int)sqrt ((double)LOD_VERTEX_BUDGET / j));
+    return 1;
+  }
+  return 0;
+}
+
 /*!
   \fn float get_sphere_radius (int style, int sp, int ac, int sel)
 
@@ -372,28 +427,14 @@ void setup_sphere_vertice (float * vertices, vec3_t pos, ColRGBA col, float rad,
 */
 void setup_this_atom (int style, gboolean to_pick, gboolean picked, atom * at, int ac, float * vert, float al)
 {
-  int i, j, k;
-  float alpha = 1.0;
-  float shift[3];
   ColRGBA col = get_atom_color (at -> sp, at -> id, 1.0, picked, to_pick);
   if (at -> sp > proj_sp - 1) at -> sp -= proj_sp;
-  float rad = get_sphere_radius ((style == NONE) ? plot -> style : style, at -> sp, ac, (picked) ? 1 : 0);
-  for (i=0; i<plot -> abc -> extra_cell[0]+1;i++)
-  {
-    for (j=0; j<plot -> abc -> extra_cell[1]+1; j++)
-    {
-      for (k=0; k<plot -> abc -> extra_cell[2]+1; k++)
-      {
-        shift[0]=i*box_gl -> vect[0][0]+j*box_gl -> vect[1][0]+k*box_gl -> vect[2][0];
-        shift[1]=i*box_gl -> vect[0][1]+j*box_gl -> vect[1][1]+k*box_gl -> vect[2][1];
-        shift[2]=i*box_gl -> vect[0][2]+j*box_gl -> vect[1][2]+k*box_gl -> vect[2][2];
-        at_shift (at, shift);
-        setup_sphere_vertice (vert, vec3(at -> x, at -> y, at -> z), col, rad, (to_pick) ? 1.0 : alpha*al);
-        at_unshift (at, shift);
-        alpha = 0.5;
-      }
-    }
-  }
+  int sty = (style == NONE) ? plot -> style : style;
+  float rad = get_sphere_radius (sty, at -> sp, ac, (picked) ? 1 : 0);
+  // Spheres rendered as points: the size is the diameter in pixels
+  if (wingl -> lod == 3 && ! to_pick && sty != WIREFRAME && sty != PUNT) rad *= 2.0 * lod_scale;
+  // Extra cell(s), if any, are rendered by translating this instance, see 'draw_cell_replicas'
+  setup_sphere_vertice (vert, vec3(at -> x, at -> y, at -> z), col, rad, (to_pick) ? 1.0 : al);
 }
 
 /*!
@@ -613,6 +654,143 @@ void setup_clone_vertices (int style, gboolean to_pick, float * vertices)
   }
 }
 
+/*!
+  \fn int compare_clone_images (const void * a, const void * b)
+
+  \brief compare two periodic images of cloned atoms
+
+  \param a the 1st image
+  \param b the 2nd image
+*/
+int compare_clone_images (const void * a, const void * b)
+{
+  gint64 u = * (const gint64 *) a;
+  gint64 v = * (const gint64 *) b;
+  return (u < v) ? -1 : (u > v);
+}
+
+/*!
+  \fn gboolean find_clone_images ()
+
+  \brief find the periodic image(s) of the cloned atom(s): the atom id and the lattice translation,
+  an image involved in several clone bonds is stored once. \n
+  The images are sorted by lattice translation, and rendered by translating the atom(s) of the model,
+  see 'draw_translated_instances'. \n
+  Return FALSE, and the clones are computed as before, if a clone is not a lattice translation
+  or if a range of instances cannot be drawn.
+*/
+gboolean find_clone_images ()
+{
+  int i, j, k, l, m;
+  int n[3];
+  int at[2];
+  vec3_t lat, frac, trans;
+
+  if (clone_images != NULL)
+  {
+    g_free (clone_images);
+    clone_images = NULL;
+  }
+  num_clone_images = 0;
+  for (i=0; i<NUM_STYLES; i++) clone_styles[i] = 0;
+  l = wingl -> bonds[step][1];
+  if (! l || ! glsl_base_instance ()) return FALSE;
+  m = 2*CLONE_CELLS + 1;
+  clone_images = g_malloc0 (2*l*sizeof*clone_images);
+  for (i=0; i<l; i++)
+  {
+    at[0] = wingl -> bondid[step][1][i][0];
+    at[1] = wingl -> bondid[step][1][i][1];
+    // The clone of 'at[0]' is rendered at the position of 'at[1]' + clones[i], see 'setup_clone_vertices'
+    lat.x = proj_gl -> atoms[step][at[1]].x + wingl -> clones[step][i].x - proj_gl -> atoms[step][at[0]].x;
+    lat.y = proj_gl -> atoms[step][at[1]].y + wingl -> clones[step][i].y - proj_gl -> atoms[step][at[0]].y;
+    lat.z = proj_gl -> atoms[step][at[1]].z + wingl -> clones[step][i].z - proj_gl -> atoms[step][at[0]].z;
+    frac = m4_mul_coord (box_gl -> cart_to_frac, lat);
+    n[0] = (int) round (frac.x);
+    n[1] = (int) round (frac.y);
+    n[2] = (int) round (frac.z);
+    for (j=0; j<3; j++) if (abs(n[j]) > CLONE_CELLS) goto failed;
+    trans.x = n[0]*box_gl -> vect[0][0] + n[1]*box_gl -> vect[1][0] + n[2]*box_gl -> vect[2][0];
+    trans.y = n[0]*box_gl -> vect[0][1] + n[1]*box_gl -> vect[1][1] + n[2]*box_gl -> vect[2][1];
+    trans.z = n[0]*box_gl -> vect[0][2] + n[1]*box_gl -> vect[1][2] + n[2]*box_gl -> vect[2][2];
+    if (v3_length (v3_sub (trans, lat)) > 0.01) goto failed;
+    // Image code: translation first, then atom id
+    clone_images[2*i] = (gint64)(((n[0]+CLONE_CELLS)*m + n[1]+CLONE_CELLS)*m + n[2]+CLONE_CELLS)*proj_at + at[0];
+    // The clone of 'at[1]' is translated the other way
+    clone_images[2*i+1] = (gint64)(((CLONE_CELLS-n[0])*m + CLONE_CELLS-n[1])*m + CLONE_CELLS-n[2])*proj_at + at[1];
+  }
+  qsort (clone_images, 2*l, sizeof*clone_images, compare_clone_images);
+  k = 0;
+  for (i=0; i<2*l; i++)
+  {
+    if (i && clone_images[i] == clone_images[i-1]) continue;
+    j = clone_images[i] % proj_at;
+    if (in_movie_encoding && plot -> at_data != NULL)
+    {
+      if (! plot -> at_data[j].show[1]) continue;
+      clone_styles[plot -> at_data[j].style + 1] ++;
+    }
+    else
+    {
+      if (! proj_gl -> atoms[step][j].show[1]) continue;
+      clone_styles[proj_gl -> atoms[step][j].style + 1] ++;
+    }
+    clone_images[k] = clone_images[i];
+    k ++;
+  }
+  num_clone_images = k;
+  return TRUE;
+
+failed:
+  g_free (clone_images);
+  clone_images = NULL;
+  return FALSE;
+}
+
+/*!
+  \fn void setup_clone_images (int style, object_3d * clone)
+
+  \brief prepare the OpenGL rendering data of the periodic image(s) of the cloned atom(s): \n
+  the instances are the atom(s) of the model, sorted by lattice translation
+
+  \param style the rendering style
+  \param clone the 3D object to fill
+*/
+void setup_clone_images (int style, object_3d * clone)
+{
+  int i, j, l, m;
+  int sty;
+  gint64 code, prev;
+  atom * tmp_a;
+
+  m = 2*CLONE_CELLS + 1;
+  clone -> translations = allocint (5*num_clone_images);
+  clone -> num_translations = 0;
+  prev = -1;
+  for (i=0; i<num_clone_images; i++)
+  {
+    j = clone_images[i] % proj_at;
+    sty = (in_movie_encoding && plot -> at_data != NULL) ? plot -> at_data[j].style : proj_gl -> atoms[step][j].style;
+    if (sty != style) continue;
+    code = clone_images[i] / proj_at;
+    if (code != prev)
+    {
+      l = 5*clone -> num_translations;
+      clone -> translations[l] = code/(m*m) - CLONE_CELLS;
+      clone -> translations[l+1] = (code/m)%m - CLONE_CELLS;
+      clone -> translations[l+2] = code%m - CLONE_CELLS;
+      clone -> translations[l+3] = nbl;
+      clone -> num_translations ++;
+      prev = code;
+    }
+    clone -> translations[5*clone -> num_translations-1] ++;
+    tmp_a = duplicate_atom (& proj_gl -> atoms[step][j]);
+    tmp_a -> sp += proj_sp;
+    setup_this_atom (style, FALSE, 0, tmp_a, 1, clone -> instances, 0.5);
+    tmp_a = free_atom (tmp_a);
+  }
+}
+
 /*!
   \fn void atom_positions_colors_and_sizes (int style, gboolean to_pick, float * instances)
 
@@ -626,13 +804,82 @@ void atom_positions_colors_and_sizes (int style, gboolean to_pick, float * insta
 {
   setup_atom_vertices (style, to_pick, instances);
   if (to_pick) wingl -> atoms_to_be_picked = wingl -> clones_to_be_picked = wingl -> to_be_picked;
-  if (plot -> draw_clones)
+  if (plot -> draw_clones && ! clones_in_cells)
   {
     setup_clone_vertices (style, to_pick, instances);
     if (to_pick) wingl -> clones_to_be_picked = wingl -> to_be_picked;
   }
 }
 
+/*!
+  \fn void create_atom_shader (int sid, int num, gboolean to_pick, gboolean clones, int shid)
+
+  \brief create the OpenGL shader for the atom(s) or the clone image(s) of a rendering style
+
+  \param sid the rendering style + 1
+  \param num the number of atom(s) or clone image(s) to render
+  \param to_pick to pick (1) or to draw (0)
+  \param clones atom(s) (0) or clone image(s) (1)
+  \param shid the shader id
+*/
+void create_atom_shader (int sid, int num, gboolean to_pick, gboolean clones, int shid)
+{
+  object_3d * atos;
+  gboolean sphere = TRUE;
+
+  if (! sid)
+  {
+    if (plot -> style == WIREFRAME || plot -> style == PUNT) sphere = FALSE;
+  }
+  else
+  {
+    if (sid-1 == WIREFRAME || sid-1 == PUNT) sphere = FALSE;
+  }
+  if (wingl -> lod == 3 && ! to_pick) sphere = FALSE;
+  if (sphere)
+  {
+    /* Ray: billboard quad proxy; classic: tessellated sphere */
+    atos = plot -> ray_tracing ? draw_billboard_quad () : draw_sphere (lod_quality);
+  }
+  else
+  {
+    atos = g_malloc0(sizeof*atos);
+    atos -> vert_buffer_size = 3;
+    atos -> num_vertices = 1;
+    atos -> vertices = allocfloat (3);
+    atos -> vertices[0] = atos -> vertices[1] = atos -> vertices[2] = 0.0;
+  }
+  atos -> num_instances = num;
+  atos -> inst_buffer_size = ATOM_BUFF_SIZE;
+  allocate_instances (atos);
+  nbl = 0;
+  if (clones)
+  {
+    setup_clone_images (sid-1, atos);
+  }
+  else
+  {
+    atom_positions_colors_and_sizes (sid-1, to_pick, atos -> instances);
+  }
+  if (! to_pick)
+  {
+    if (sphere)
+    {
+      const GLchar * vs_atom = (plot -> ray_tracing) ? sphere_vertex_ray : sphere_vertex;
+      const GLchar * fs_atom = (plot -> ray_tracing) ? full_color_ray : full_color;
+      wingl -> ogl_glsl[ATOMS][step][shid] = init_shader_program (ATOMS, GLSL_SPHERES, vs_atom, NULL, fs_atom, GL_TRIANGLE_STRIP, 4, 1, TRUE, atos);
+    }
+    else
+    {
+      wingl -> ogl_glsl[ATOMS][step][shid] = init_shader_program (ATOMS, GLSL_POINTS, point_vertex, NULL, point_color, GL_POINTS, 4, 1, FALSE, atos);
+    }
+  }
+  else
+  {
+    wingl -> ogl_glsl[PICKS][0][0] = init_shader_program (PICKS, GLSL_SPHERES, sphere_vertex, NULL, full_color, GL_TRIANGLE_STRIP, 4, 1, FALSE, atos);
+  }
+}
+
 /*!
   \fn void create_atom_lists (gboolean to_pick)
 
@@ -643,8 +890,6 @@ void atom_positions_colors_and_sizes (int style, gboolean to_pick, float * insta
 void create_atom_lists (gboolean to_pick)
 {
   int i, j, k;
-  object_3d * atos;
-  gboolean sphere = TRUE;
 
   if (! to_pick)
   {
@@ -654,72 +899,51 @@ void create_atom_lists (gboolean to_pick)
 
   for (i=0; i<NUM_STYLES; i++) all_styles[i] = 0;
   j = find_atom_vertices (to_pick);
-  if (plot -> draw_clones) j += find_clone_vertices (to_pick);
+  // Clone(s) to draw: periodic image(s) of the atom(s) if possible, otherwise 2 clones per clone bond
+  clones_in_cells = (plot -> draw_clones && ! to_pick) ? find_clone_images () : FALSE;
+  if (clones_in_cells)
+  {
+    j += num_clone_images;
+  }
+  else if (plot -> draw_clones)
+  {
+    j += find_clone_vertices (to_pick);
+  }
 #ifdef DEBUG
   g_debug ("Atom LIST:: to_pick= %s, Atom(s) to render= %d", (to_pick) ? "true" : "false", j);
 #endif
   if (j > 0)
   {
     // Render atom(s)
-    j = (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
     if (! to_pick)
     {
       wingl -> n_shaders[ATOMS][step] = 0;
-      for (i=0; i<NUM_STYLES; i++) if (all_styles[i]) wingl -> n_shaders[ATOMS][step] ++;
+      for (i=0; i<NUM_STYLES; i++)
+      {
+        if (all_styles[i]) wingl -> n_shaders[ATOMS][step] ++;
+        if (clones_in_cells && clone_styles[i]) wingl -> n_shaders[ATOMS][step] ++;
+      }
       wingl -> ogl_glsl[ATOMS][step] = g_malloc0(wingl -> n_shaders[ATOMS][step]*sizeof*wingl -> ogl_glsl[ATOMS][step]);
     }
     k = 0;
     for (i=0; i<NUM_STYLES; i++)
     {
-      sphere = TRUE;
       if (all_styles[i] || to_pick)
       {
-        if (! i)
-        {
-          if (plot -> style == WIREFRAME || plot -> style == PUNT) sphere = FALSE;
-        }
-        else
-        {
-          if (i-1 == WIREFRAME || i-1 == PUNT) sphere = FALSE;
-        }
-        if (sphere)
-        {
-          /* Ray: billboard quad proxy; classic: tessellated sphere */
-          atos = plot -> ray_tracing ? draw_billboard_quad () : draw_sphere (plot -> quality);
-        }
-        else
-        {
-          atos = g_malloc0(sizeof*atos);
-          atos -> vert_buffer_size = 3;
-          atos -> num_vertices = 1;
-          atos -> vertices = allocfloat (3);
-          atos -> vertices[0] = atos -> vertices[1] = atos -> vertices[2] = 0.0;
-        }
-        atos -> num_instances = j*all_styles[i];
-        atos -> inst_buffer_size = ATOM_BUFF_SIZE;
-        allocate_instances (atos);
-        nbl = 0;
-        atom_positions_colors_and_sizes (i-1, to_pick, atos -> instances);
-        if (! to_pick)
-        {
-          if (sphere)
-          {
-            const GLchar * vs_atom = (plot -> ray_tracing) ? sphere_vertex_ray : sphere_vertex;
-            const GLchar * fs_atom = (plot -> ray_tracing) ? full_color_ray : full_color;
-            wingl -> ogl_glsl[ATOMS][step][k] = init_shader_program (ATOMS, GLSL_SPHERES, vs_atom, NULL, fs_atom, GL_TRIANGLE_STRIP, 4, 1, TRUE, atos);
-          }
-          else
-          {
-            wingl -> ogl_glsl[ATOMS][step][k] = init_shader_program (ATOMS, GLSL_POINTS, point_vertex, NULL, point_color, GL_POINTS, 4, 1, FALSE, atos);
-          }
-        }
-        else
-        {
-          wingl -> ogl_glsl[PICKS][0][0] = init_shader_program (PICKS, GLSL_SPHERES, sphere_vertex, NULL, full_color, GL_TRIANGLE_STRIP, 4, 1, FALSE, atos);
-        }
+        create_atom_shader (i, all_styles[i], to_pick, FALSE, k);
         k ++;
       }
       if (to_pick) break;
+      if (clones_in_cells && clone_styles[i])
+      {
+        create_atom_shader (i, clone_styles[i], FALSE, TRUE, k);
+        k ++;
+      }
     }
   }
+  if (clone_images != NULL)
+  {
+    g_free (clone_images);
+    clone_images = NULL;
+  }
 }
@@ -61,6 +61,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 extern object_3d * draw_billboard_quad (void);
 /* Sphere radius function (declared in d_atoms.c) — needed to fill clip radii */
 extern float get_sphere_radius (int style, int sp, int ac, int sel);
+extern int lod_quality;
 
 extern ColRGBA get_atom_color (int i, int j, double al, int picked, gboolean to_picked);
 extern vec3_t model_position;
@@ -373,10 +374,7 @@ int vs_bid;
 */
 void setup_this_bond (int sty, gboolean to_pick, gboolean picked, int cap, int bi, int pi, atom * at, atom * bt, float al, float * vertices)
 {
-  float alpha = 1.0;
   float delta = 0.0;
-  float shift[3];
-  int p, q, r;
   vec3_t pos_a, pos_b;
   ColRGBA col = get_atom_color (at -> sp, at -> id, 1.0, (picked) ? pi + 1 : 0, to_pick);
   float rad = get_bond_radius ((to_pick) ? BALL_AND_STICK : (sty == NONE) ? plot -> style : sty, bi, at -> sp, bt -> sp, (picked) ? 1.0 : 0.0);
@@ -400,41 +398,25 @@ void setup_this_bond (int sty, gboolean to_pick, gboolean picked, int cap, int b
     }
     delta = ((show_a && show_b) && (sta == stb)) ? 0.0 : 0.1;
   }
-  for (p=0; p<plot -> abc -> extra_cell[0]+1;p++)
+  // Extra cell(s), if any, are rendered by translating this instance, see 'draw_cell_replicas'
+  pos_a = vec3(at -> x, at -> y, at -> z);
+  pos_b = vec3((at -> x + bt -> x)/2.0, (at -> y + bt -> y)/2.0, (at -> z + bt -> z)/2.0);
+  if (to_pick || ((sty == NONE && (plot -> style == BALL_AND_STICK || plot -> style == CYLINDERS)) || sty == BALL_AND_STICK || sty == CYLINDERS))
   {
-    for (q=0; q<plot -> abc -> extra_cell[1]+1; q++)
+    if (cap)
     {
-      for (r=0; r<plot -> abc -> extra_cell[2]+1; r++)
-      {
-        shift[0]=p*box_gl -> vect[0][0]+q*box_gl -> vect[1][0]+r*box_gl -> vect[2][0];
-        shift[1]=p*box_gl -> vect[0][1]+q*box_gl -> vect[1][1]+r*box_gl -> vect[2][1];
-        shift[2]=p*box_gl -> vect[0][2]+q*box_gl -> vect[1][2]+r*box_gl -> vect[2][2];
-        at_shift (at, shift);
-        at_shift (bt, shift);
-        pos_a = vec3(at -> x, at -> y, at -> z);
-        pos_b = vec3((at -> x + bt -> x)/2.0, (at -> y + bt -> y)/2.0, (at -> z + bt -> z)/2.0);
-        if (to_pick || ((sty == NONE && (plot -> style == BALL_AND_STICK || plot -> style == CYLINDERS)) || sty == BALL_AND_STICK || sty == CYLINDERS))
-        {
-          if (cap)
-          {
-            setup_cap_vertice (vertices, pos_a, pos_b, col, rad, alpha*al, (plot -> ray_tracing && delta > 0.0) ? TRUE : FALSE);
-          }
-          else
-          {
-            float r_sph = (plot -> ray_tracing) ? get_sphere_radius ((sty == NONE) ? plot -> style : sty, at -> sp, bi, 0) : 0.0f;
-            setup_cylinder_vertice (vertices, pos_a, pos_b, col, rad, (to_pick) ? 1.0 : alpha*al, delta, r_sph, 0.0f);
-          }
-        }
-        else
-        {
-          setup_line_vertice (vertices, pos_a, col, alpha*al);
-          setup_line_vertice (vertices, pos_b, col, alpha*al);
-        }
-        at_unshift (at, shift);
-        at_unshift (bt, shift);
-        alpha = 0.5;
-      }
+      setup_cap_vertice (vertices, pos_a, pos_b, col, rad, al, (plot -> ray_tracing && delta > 0.0) ? TRUE : FALSE);
     }
+    else
+    {
+      float r_sph = (plot -> ray_tracing) ? get_sphere_radius ((sty == NONE) ? plot -> style : sty, at -> sp, bi, 0) : 0.0f;
+      setup_cylinder_vertice (vertices, pos_a, pos_b, col, rad, (to_pick) ? 1.0 : al, delta, r_sph, 0.0f);
+    }
+  }
+  else
+  {
+    setup_line_vertice (vertices, pos_a, col, al);
+    setup_line_vertice (vertices, pos_b, col, al);
   }
 }
 
@@ -579,10 +561,11 @@ int find_bond_vertices (gboolean to_pick, int sty, int sa, int sb, int bi, int c
 */
 void setup_all_cylinder_vertices (int style, gboolean to_pick, int cap, int bi, float * vertices)
 {
-  int i, j, k, l, m;
+  int i, j, k, l, m, n;
   gboolean show_a, show_b;
   for (i=0; i < wingl -> bonds[step][bi]; i++)
   {
+    n = wingl -> to_be_picked;
     j = wingl -> bondid[step][bi][i][0];
     k = wingl -> bondid[step][bi][i][1];
     if (in_movie_encoding && plot -> at_data != NULL)
@@ -621,6 +604,11 @@ void setup_all_cylinder_vertices (int style, gboolean to_pick, int cap, int bi,
         prepare_bond (style, to_pick, FALSE, cap, bi, 0, i, & proj_gl -> atoms[step][k], & proj_gl -> atoms[step][j], vertices);
       }
     }
+    if (to_pick)
+    {
+      // The pick id(s) of this bond decode directly to the bond id
+      for (; n < wingl -> to_be_picked; n++) wingl -> pick_to_object[n] = i;
+    }
   }
 }
 
@@ -755,8 +743,8 @@ int create_bond_lists (gboolean to_pick)
     {
       if (to_pick || (! f && (plot -> style == BALL_AND_STICK || plot -> style == CYLINDERS)) || (f && (f-1 == BALL_AND_STICK || f-1 == CYLINDERS)))
       {
-        cyl = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder (plot -> quality, 1.0, 1.0);
-        cyl -> num_instances =  (nbds[f]/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+        cyl = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder (lod_quality, 1.0, 1.0);
+        cyl -> num_instances =  (nbds[f]/2);
         /* Unreal mode: extend instance buffer by 2 floats per instance for sphere clip radii */
         cyl -> inst_buffer_size = (plot -> ray_tracing) ? CYLI_BUFF_SIZE + 2 : CYLI_BUFF_SIZE;
         allocate_instances (cyl);
@@ -776,8 +764,8 @@ int create_bond_lists (gboolean to_pick)
           l ++;
           if (ncap[f] > 0)
           {
-            cap = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder_cap (plot -> quality, 1.0, FALSE);
-            cap -> num_instances =  (ncap[f]/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+            cap = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder_cap (lod_quality, 1.0, FALSE);
+            cap -> num_instances =  (ncap[f]/2);
             cap -> inst_buffer_size = CAPS_BUFF_SIZE;
             allocate_instances (cap);
             nbs = 0;
@@ -808,7 +796,7 @@ int create_bond_lists (gboolean to_pick)
               {
                 cyl = g_malloc0(sizeof*cyl);
                 cyl -> vert_buffer_size = LINE_BUFF_SIZE;
-                cyl -> num_vertices = nbonds[f][h][i][j] * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+                cyl -> num_vertices = nbonds[f][h][i][j];
                 cyl -> vertices = allocfloat (cyl -> vert_buffer_size*cyl -> num_vertices);
                 nbs = 0;
                 setup_line_vertices (f-1, 0, h, i, j, cyl -> vertices);
@@ -68,6 +68,8 @@ extern void setup_cylinder_vertice (float * vertices, vec3_t pos_a, vec3_t pos_b
 extern void setup_cap_vertice (float * vertices, vec3_t pos_a, vec3_t pos_b, ColRGBA col, float rad, float alpha, gboolean sel);
 extern void create_slab_info (project * this_proj);
 extern void process_selected_atom (project * this_proj, glwin * view, int id, int ac, int se, int pi);
+extern object_3d * voxel_surface (project * this_proj, int sid);
+extern object_3d * density_isosurface (project * this_proj, int map, int sid);
 extern ColRGBA pcol;
 
 int BOX_BUFF_SIZE;
@@ -948,8 +950,27 @@ void create_volumes_lists ()
 {
   cleaning_shaders (wingl, VOLMS);
   int i, j, k, l, m;
+  object_3d * surf = NULL;
+  object_3d ** dsurf = NULL;
   wingl -> n_shaders[VOLMS][step] = 0;
   for (i=0; i<FILLED_STYLES; i++) if (plot -> show_vol[i]) wingl -> n_shaders[VOLMS][step] ++;
+  if (wingl -> show_voxel && wingl -> voxel_volume)
+  {
+    surf = voxel_surface (proj_gl, step);
+    if (surf) wingl -> n_shaders[VOLMS][step] ++;
+  }
+  if (wingl -> dmap)
+  {
+    dsurf = g_malloc0(wingl -> dmap -> nmaps*sizeof*dsurf);
+    for (i=0; i<wingl -> dmap -> nmaps; i++)
+    {
+      if (wingl -> dmap -> show[i])
+      {
+        dsurf[i] = density_isosurface (proj_gl, i, step);
+        if (dsurf[i]) wingl -> n_shaders[VOLMS][step] ++;
+      }
+    }
+  }
   if (wingl -> adv_bonding[0])
   {
     for (i=0; i<FILLED_STYLES; i++)
@@ -1050,6 +1071,23 @@ void create_volumes_lists ()
         m ++;
       }
     }
+    if (surf)
+    {
+      wingl -> ogl_glsl[VOLMS][step][m] = init_shader_program (VOLMS, GLSL_POLYEDRA, full_vertex, NULL, full_color, GL_TRIANGLES, 3, 1, TRUE, surf);
+      m ++;
+    }
+    if (dsurf)
+    {
+      for (i=0; i<wingl -> dmap -> nmaps; i++)
+      {
+        if (dsurf[i])
+        {
+          wingl -> ogl_glsl[VOLMS][step][m] = init_shader_program (VOLMS, GLSL_POLYEDRA, full_vertex, NULL, full_color, GL_TRIANGLES, 3, 1, TRUE, dsurf[i]);
+          m ++;
+        }
+      }
+    }
   }
+  if (dsurf) g_free (dsurf);
   wingl -> create_shaders[VOLMS] = FALSE;
 }
@@ -255,11 +255,8 @@ int create_label_lists ()
   if (plot -> labels[0].list != NULL || plot -> labels[1].list != NULL)
   {
     nshaders = 0;
-    if (plot -> labels[0].list != NULL) nshaders += (plot -> labels[0].render + 1) * (plot -> labels[0].list -> last -> id + 1);
-    if (plot -> draw_clones && plot -> labels[1].list != NULL)
-    {
-      nshaders += (plot -> labels[1].render + 1) * (plot -> labels[1].list -> last -> id + 1);
-    }
+    nshaders += label_shaders (0);
+    if (plot -> draw_clones) nshaders += label_shaders (1);
     wingl -> ogl_glsl[LABEL][0] = g_malloc0(nshaders*sizeof*wingl -> ogl_glsl[LABEL][0]);
     for (i=0; i<2; i++) render_all_strings (LABEL, i);
   }
@@ -505,13 +505,13 @@ int render_selected (int style, gboolean cylinder, int caps, int bonds, int ncap
   if (cylinder)
   {
     cyl = plot -> ray_tracing ? draw_billboard_quad () : draw_cylinder (plot -> quality, 1.0, 1.0);
-    cyl -> num_instances =  (bonds/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+    cyl -> num_instances =  (bonds/2);
     cyl -> inst_buffer_size = plot -> ray_tracing ? CYLI_BUFF_SIZE + 2 : CYLI_BUFF_SIZE;
     allocate_instances (cyl);
     if (caps)
     {
       cap = plot -> ray_tracing ? draw_billboard_quad () : draw_cylinder_cap (plot -> quality, 1.0, TRUE);
-      cap -> num_instances =  (ncaps/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+      cap -> num_instances =  (ncaps/2);
       cap -> inst_buffer_size = CAPS_BUFF_SIZE;
       allocate_instances (cap);
     }
@@ -557,7 +557,7 @@ int render_selected (int style, gboolean cylinder, int caps, int bonds, int ncap
           {
             cyl = g_malloc0(sizeof*cyl);
             cyl -> vert_buffer_size = LINE_BUFF_SIZE;
-            cyl -> num_vertices = sbonds[style][type][h][i][j] * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+            cyl -> num_vertices = sbonds[style][type][h][i][j];
             cyl -> vertices = allocfloat (cyl -> vert_buffer_size*cyl -> num_vertices);
             nbs = 0;
             sel = plot -> selected[type] -> first;
@@ -602,13 +602,13 @@ int render_picked (int style, gboolean cylinder, int caps, int bonds, int ncaps,
   if (cylinder)
   {
     cyl = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder (plot -> quality, 1.0, 1.0);
-    cyl -> num_instances =  (bonds/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+    cyl -> num_instances =  (bonds/2);
     cyl -> inst_buffer_size = plot -> ray_tracing ? CYLI_BUFF_SIZE + 2 : CYLI_BUFF_SIZE;
     allocate_instances (cyl);
     if (caps)
     {
       cap = (plot -> ray_tracing) ? draw_billboard_quad () : draw_cylinder_cap (plot -> quality, 1.0, TRUE);
-      cap -> num_instances =  (ncaps/2) * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+      cap -> num_instances =  (ncaps/2);
       cap -> inst_buffer_size = CAPS_BUFF_SIZE;
       allocate_instances (cap);
     }
@@ -654,7 +654,7 @@ int render_picked (int style, gboolean cylinder, int caps, int bonds, int ncaps,
           {
             cyl = g_malloc0(sizeof*cyl);
             cyl -> vert_buffer_size = LINE_BUFF_SIZE;
-            cyl -> num_vertices = sbonds[style][type][h][i][j] * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+            cyl -> num_vertices = sbonds[style][type][h][i][j];
             cyl -> vertices = allocfloat (cyl -> vert_buffer_size*cyl -> num_vertices);
             nbs = 0;
             for (k=0; k<proj_at; k++)
@@ -712,7 +712,7 @@ int prepare_selection_shaders (int style, int shaders, int clone, int type, gboo
     atos -> vertices[0] = atos -> vertices[1] = atos -> vertices[2] = 0.0;
   }
 
-  atos -> num_instances = atoms[style][type] * (plot -> abc -> extra_cell[0]+1)*(plot -> abc -> extra_cell[1]+1)*(plot -> abc -> extra_cell[2]+1);
+  atos -> num_instances = atoms[style][type];
   atos -> inst_buffer_size = ATOM_BUFF_SIZE;
   allocate_instances (atos);
 
@@ -1021,8 +1021,14 @@ int create_pick_lists ()
     g_free (wingl -> color_to_pick);
     wingl -> color_to_pick = NULL;
   }
+  if (wingl -> pick_to_object != NULL)
+  {
+    g_free (wingl -> pick_to_object);
+    wingl -> pick_to_object = NULL;
+  }
   wingl -> to_be_picked = 0;
   wingl -> color_to_pick = allocint (i);
+  wingl -> pick_to_object = allocint (i);
 
   wingl -> n_shaders[PICKS][0] = nshaders;
   wingl -> ogl_glsl[PICKS][0] = g_malloc0(nshaders*sizeof*wingl -> ogl_glsl[PICKS][0]);
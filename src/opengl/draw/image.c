@@ -30,7 +30,13 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 *
 * List of functions:
 
+  gboolean save_rendered_image (glwin * view, video_options * iopts, gchar * file);
+
+  gchar * batch_file_name (project * this_proj, int stp);
+
+  void init_image_rendering (project * this_proj, video_options * iopts);
   void render_image (glwin * view, video_options * iopts);
+  void batch_image_render (project * this_proj, video_options * vopts);
   void simple_image_render ();
 
   G_MODULE_EXPORT void run_render_image (GtkNativeDialog * info, gint response_id, gpointer data);
@@ -59,6 +65,7 @@ extern GdkPixbuf * pixbuf;
 extern void fill_image (VideoStream * vs, int width, int height, glwin * view);
 extern void init_frame_buffer (int x, int y);
 extern void close_frame_buffer ();
+extern char * codec_list[VIDEO_CODECS];
 
 char * image_name[IMAGE_FORMATS] = {"PNG",
                                     "JPG/JPEG",
@@ -87,6 +94,59 @@ ColRGBA * render_image_grad_color[2];
 ColRGBA * render_image_box_color = NULL;
 int * render_image_pixels = NULL;
 gchar * render_image_output = NULL;
+int * render_image_frames = NULL;
+int render_image_files = 0;
+int render_image_jobs = 1;
+int render_image_job = NONE;
+gboolean render_image_movie = FALSE;
+int render_image_count = 0;
+
+/*!
+  \fn void init_image_rendering (project * this_proj, video_options * iopts)
+
+  \brief prepare the off-screen frame buffer and the OpenGL shaders to render image(s)
+
+  \param this_proj the target project
+  \param iopts the rendering options
+*/
+void init_image_rendering (project * this_proj, video_options * iopts)
+{
+  glwin * view = this_proj -> modelgl;
+  int i;
+  // On macOS, the CoreAnimation layer may invalidate the current GL context
+  // between the file dialog callback and the OpenGL calls. Without explicitly
+  // making the context current, FBO creation and rendering silently fail or
+  // operate on the wrong context, causing partial or missing image captures.
+  gtk_gl_area_make_current ((GtkGLArea *)view -> plot);
+  init_frame_buffer (iopts -> video_res[0], iopts -> video_res[1]);
+  init_opengl ();
+  for (i=0; i<NGLOBAL_SHADERS; i++)
+  {
+    if (in_md_shaders (this_proj, i)) view -> n_shaders[i][step] = -1;
+  }
+  recreate_all_shaders (view);
+  in_movie_encoding = TRUE;
+}
+
+/*!
+  \fn gboolean save_rendered_image (glwin * view, video_options * iopts, gchar * file)
+
+  \brief render the OpenGL window off-screen and save the image
+
+  \param view the target glwin
+  \param iopts the rendering options
+  \param file the image file name
+*/
+gboolean save_rendered_image (glwin * view, video_options * iopts, gchar * file)
+{
+  fill_image (NULL, iopts -> video_res[0], iopts -> video_res[1], view);
+  GError * error = NULL;
+  gboolean res = gdk_pixbuf_savev (pixbuf, file, image_list[iopts -> codec], NULL, NULL, & error);
+  g_clear_error (& error);
+  g_object_unref (pixbuf);
+  pixbuf = NULL;
+  return res;
+}
 
 #ifdef GTK4
 /*!
@@ -134,20 +194,8 @@ G_MODULE_EXPORT void run_render_image (GtkDialog * info, gint response_id, gpoin
     }
     project * this_proj = get_project_by_id (iopts -> proj);
     glwin * view = this_proj -> modelgl;
-    // On macOS, the CoreAnimation layer may invalidate the current GL context
-    // between the file dialog callback and the OpenGL calls. Without explicitly
-    // making the context current, FBO creation and rendering silently fail or
-    // operate on the wrong context, causing partial or missing image captures.
-    gtk_gl_area_make_current ((GtkGLArea *)view -> plot);
-    init_frame_buffer (iopts -> video_res[0], iopts -> video_res[1]);
-    init_opengl ();
+    init_image_rendering (this_proj, iopts);
     int i, x, y, q;
-    for (i=0; i<NGLOBAL_SHADERS; i++)
-    {
-      if (in_md_shaders (this_proj, i)) view -> n_shaders[i][step] = -1;
-    }
-    recreate_all_shaders (view);
-    in_movie_encoding = TRUE;
     if (iopts -> oglquality != 0)
     {
       q = view -> anim -> last -> img -> quality;
@@ -158,10 +206,7 @@ G_MODULE_EXPORT void run_render_image (GtkDialog * info, gint response_id, gpoin
     y = view -> pixels[1] - 100;
     view -> pixels[0] = iopts -> video_res[0];
     view -> pixels[1] = iopts -> video_res[1];
-    fill_image (NULL, iopts -> video_res[0], iopts -> video_res[1], view);
-    GError * error = NULL;
-    gboolean res = gdk_pixbuf_savev (pixbuf, videofile, image_list[iopts -> codec], NULL, NULL, & error);
-    if (! res && ! atomes_from_libreoffice)
+    if (! save_rendered_image (view, iopts, videofile) && ! atomes_from_libreoffice)
     {
       show_warning (_("An error occurred when exporting an image\nyou might want to try again\nsorry for the trouble"), view -> win);
     }
@@ -233,6 +278,90 @@ void render_image (glwin * view, video_options * iopts)
 #endif
 }
 
+/*!
+  \fn gchar * batch_file_name (project * this_proj, int stp)
+
+  \brief build the name of a file rendered from the command line: \n
+         the project name is appended when several files are rendered, \n
+         and the MD step number when a range of steps is rendered
+
+  \param this_proj the target project
+  \param stp the MD step, or NONE
+*/
+gchar * batch_file_name (project * this_proj, int stp)
+{
+  gchar * ext = strrchr (render_image_output, '.');
+  gchar * sep = strrchr (render_image_output, G_DIR_SEPARATOR);
+  if (ext && sep && ext < sep) ext = NULL;
+  gchar * base = (ext) ? g_strndup (render_image_output, ext - render_image_output) : g_strdup_printf ("%s", render_image_output);
+  gchar * name = (render_image_files > 1) ? g_strdup_printf ("-%s", this_proj -> name) : g_strdup_printf ("%s", "");
+  gchar * frame = (stp != NONE) ? g_strdup_printf ("-%06d", stp+1) : g_strdup_printf ("%s", "");
+  gchar * file = g_strdup_printf ("%s%s%s%s", base, name, frame, (ext) ? ext : "");
+  g_free (base);
+  g_free (name);
+  g_free (frame);
+  return file;
+}
+
+/*!
+  \fn void batch_image_render (project * this_proj, video_options * vopts)
+
+  \brief render a range of MD steps, as images or as a movie, from the command line: \n
+         the frame buffer and the OpenGL shaders are prepared once for the whole range
+
+  \param this_proj the target project
+  \param vopts the rendering options
+*/
+void batch_image_render (project * this_proj, video_options * vopts)
+{
+  glwin * view = this_proj -> modelgl;
+  int i, frames[3];
+  gchar * file;
+
+  if (render_image_frames)
+  {
+    frames[1] = (render_image_frames[1] > 0) ? min (render_image_frames[1], this_proj -> steps) - 1 : this_proj -> steps - 1;
+    frames[0] = (render_image_frames[0] > 0) ? min (render_image_frames[0] - 1, frames[1]) : 0;
+    frames[2] = max (render_image_frames[2], 1);
+  }
+  else
+  {
+    frames[0] = frames[1] = view -> anim -> last -> img -> step;
+    frames[2] = 1;
+  }
+  init_image_rendering (this_proj, vopts);
+  if (frames[1] > frames[0]) re_create_all_md_shaders (view);
+  if (render_image_movie)
+  {
+    file = batch_file_name (this_proj, NONE);
+    if (! create_trajectory_movie (view, vopts, file, frames))
+    {
+      g_warning (_("Error when encoding movie '%s'"), file);
+    }
+    g_free (file);
+  }
+  else
+  {
+    for (i=frames[0]; i<=frames[1]; i+=frames[2])
+    {
+      // With parallel jobs, each process renders one image every 'render_image_jobs'
+      if (render_image_job == NONE || render_image_count % render_image_jobs == render_image_job)
+      {
+        set_rendering_step (view, i);
+        file = batch_file_name (this_proj, (render_image_frames) ? i : NONE);
+        if (! save_rendered_image (view, vopts, file))
+        {
+          g_warning (_("Error when rendering image '%s'"), file);
+        }
+        g_free (file);
+      }
+      render_image_count ++;
+    }
+  }
+  close_frame_buffer ();
+  in_movie_encoding = FALSE;
+}
+
 /*!
   \fn void simple_image_render ()
 
@@ -247,6 +376,22 @@ void simple_image_render ()
   int h, i, j, k, l, m;
   for (i=0; i<2; i++) active_glwin -> pixels[i] = vopts -> video_res[i];
   vopts -> codec = render_image_format;
+  if (render_image_movie)
+  {
+    // Video codec from the movie file extension, default is H264
+    vopts -> codec = 2;
+    gchar * ext = strrchr (render_image_output, '.');
+    if (ext)
+    {
+      for (i=0; i<VIDEO_CODECS; i++)
+      {
+        if (g_strcmp0 (ext+1, codec_list[i]) == 0) vopts -> codec = i;
+      }
+    }
+    vopts -> framesec = 24;
+    vopts -> extraframes = 10;
+    vopts -> bitrate = 5000;
+  }
   if (render_image_style != NONE)
   {
     if (render_image_style < OGL_STYLES)
@@ -330,7 +475,14 @@ void simple_image_render ()
       active_image -> back -> gradient_color[i] = * render_image_grad_color[i];
     }
   }
-  run_render_image (NULL, GTK_RESPONSE_ACCEPT, vopts);
+  if (atomes_from_libreoffice || (! render_image_frames && ! render_image_movie && render_image_files < 2 && render_image_job == NONE))
+  {
+    run_render_image (NULL, GTK_RESPONSE_ACCEPT, vopts);
+  }
+  else
+  {
+    batch_image_render (active_project, vopts);
+  }
   g_free (vopts);
   if (! atomes_from_libreoffice) to_close_this_project (0, active_project);
 }
@@ -32,17 +32,21 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   gboolean check_to_update_shaders (glwin * view, image * img_a, image * img_b, int ogl_q);
   gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile);
+  gboolean create_trajectory_movie (glwin * view, video_options * vopts, gchar * videofile, int * frames);
 
   void convert_rgb_pixbuf_to_yuv (GdkPixbuf * pixbuf, AVFrame * picture, int w, int h);
   void fill_image (VideoStream * vs, int width, int height, glwin * view);
   void set_old_cmap (image * img, int stp, int id);
   void init_frame_buffer (int x, int y);
   void close_frame_buffer ();
+  void set_rendering_step (glwin * view, int stp);
   void save_movie (glwin * view, video_options * vopts);
 
   static void ffmpeg_encoder_set_frame_yuv_from_rgb (uint8_t * rgb, VideoStream * vs);
   static void write_video_frame (AVFormatContext * f_context, VideoStream * vs, int frame_id, glwin * view);
   static void close_stream (AVFormatContext * fc, VideoStream * vs);
+  static void close_movie_file (AVFormatContext * fc, VideoStream * vs);
+  static void write_initial_frames (AVFormatContext * fc, VideoStream * vs, glwin * view, int codec);
 
   G_MODULE_EXPORT void run_save_movie (GtkNativeDialog * info, gint response_id, gpointer data);
   G_MODULE_EXPORT void run_save_movie (GtkDialog * info, gint response_id, gpointer data);
@@ -54,6 +58,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   VideoStream * add_video_stream (AVFormatContext * fc, const AVCodec * vc, video_options * vopts);
 
+  static AVFormatContext * open_movie_file (video_options * vopts, gchar * videofile, VideoStream ** vs);
+
 */
 
 #include "global.h"
@@ -996,18 +1002,16 @@ typedef struct{
 */
 
 /*!
-  \fn gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
+  \fn static AVFormatContext * open_movie_file (video_options * vopts, gchar * videofile, VideoStream ** vs)
 
-  \brief render a movie from the saved animation parameters
+  \brief open a movie file and prepare the video stream to encode
 
-  \param view the target glwin
   \param vopts the video encoding options
   \param videofile video file name
+  \param vs the pointer to store the video stream
 */
-gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
+static AVFormatContext * open_movie_file (video_options * vopts, gchar * videofile, VideoStream ** vs)
 {
-  int q;
-  const AVOutputFormat * output_format = NULL;
   AVFormatContext * format_context = NULL;
   VideoStream * video_stream = NULL;
   const AVCodec * video_codec = NULL;
@@ -1022,7 +1026,6 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
   g_debug ("VIDEO ENCODING:: codec:: %d, name= %s, ext= %s", vopts -> codec, codec_name[vopts -> codec], codec_list[vopts -> codec]);
 #endif // DEBUG
 
-  num_frames = view -> anim -> frames;
 #if LIBAVCODEC_VERSION_MAJOR < 57
   av_register_all ();
   avcodec_register_all ();
@@ -1031,23 +1034,21 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
   if (! (format_context = avformat_alloc_context()))
   {
     g_warning (_("Error in movie encoding : impossible to allocate AV format context"));
-    return FALSE;
+    return NULL;
   }
 
   // Guess the desired container format based on file extension
   if (! (format_context -> oformat = av_guess_format (NULL, videofile, NULL)))
   {
     g_warning (_("Error in movie encoding : impossible to guess container format : change file name"));
-    return FALSE;
+    return NULL;
   }
 
-  output_format = format_context -> oformat;
-
   video_stream = add_video_stream (format_context, video_codec, vopts);
   if (video_stream == NULL)
   {
     g_warning (_("Error in movie encoding : impossible to create video stream"));
-    return FALSE;
+    return NULL;
   }
 
   /* open the codec */
@@ -1055,7 +1056,7 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
   {
     // Can not open codec
     g_warning (_("Error in movie encoding : impossible to open codec, error= %s"), av_err2str(error));
-    return FALSE;
+    return NULL;
   }
 
   avcodec_parameters_from_context (video_stream -> st -> codecpar, video_stream -> cc);
@@ -1073,7 +1074,7 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
   {
   // error impossible to open output file
     g_warning (_("Error in movie encoding : impossible to open video file '%s'"), videofile);
-    return FALSE;
+    return NULL;
   }
 
 #if LIBAVCODEC_VERSION_MAJOR > 52
@@ -1083,31 +1084,94 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
 #endif
   {
     g_warning (_("Error in movie encoding : impossible to write the AV format header"));
-    return FALSE;
+    return NULL;
   }
+  * vs = video_stream;
+  return format_context;
+}
 
-  view -> anim -> last = view -> anim -> first;
-  if (vopts -> oglquality != 0)
+/*!
+  \fn static void close_movie_file (AVFormatContext * fc, VideoStream * vs)
+
+  \brief write the movie trailer, close the movie file and the video stream
+
+  \param fc the format context to close
+  \param vs the video stream to close
+*/
+static void close_movie_file (AVFormatContext * fc, VideoStream * vs)
+{
+  av_write_trailer (fc);
+
+  if (!(fc -> oformat -> flags & AVFMT_NOFILE))
   {
-    q = view -> anim -> last -> img -> quality;
-    view -> anim -> last -> img -> quality = vopts -> oglquality;
+    /* close the output file */
+#if LIBAVCODEC_VERSION_MAJOR > 52
+    avio_closep (& fc -> pb);
+#else
+    url_fclose (av_format_context -> pb);
+#endif
   }
 
+  close_stream (fc, vs);
+}
+
+/*!
+  \fn static void write_initial_frames (AVFormatContext * fc, VideoStream * vs, glwin * view, int codec)
+
+  \brief write the initial frame(s) some codecs require before the actual animation
+
+  \param fc the format context to use
+  \param vs the video stream
+  \param view the target glwin
+  \param codec the video codec
+*/
+static void write_initial_frames (AVFormatContext * fc, VideoStream * vs, glwin * view, int codec)
+{
   int frame_id;
   frame_start = 0;
-  if (vopts -> codec == 0)
+  if (codec == 0)
   {
     frame_start = 1;
-    write_video_frame (format_context, video_stream, 0, view);
+    write_video_frame (fc, vs, 0, view);
   }
-  else if (vopts -> codec == 2)
+  else if (codec == 2)
   {
     frame_start = 24;
     for (frame_id = 0; frame_id < frame_start; frame_id ++)
     {
-      write_video_frame (format_context, video_stream, frame_id, view);
+      write_video_frame (fc, vs, frame_id, view);
     }
   }
+}
+
+/*!
+  \fn gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
+
+  \brief render a movie from the saved animation parameters
+
+  \param view the target glwin
+  \param vopts the video encoding options
+  \param videofile video file name
+*/
+gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
+{
+  int q;
+  AVFormatContext * format_context = NULL;
+  VideoStream * video_stream = NULL;
+
+  num_frames = view -> anim -> frames;
+  format_context = open_movie_file (vopts, videofile, & video_stream);
+  if (! format_context) return FALSE;
+
+  view -> anim -> last = view -> anim -> first;
+  if (vopts -> oglquality != 0)
+  {
+    q = view -> anim -> last -> img -> quality;
+    view -> anim -> last -> img -> quality = vopts -> oglquality;
+  }
+
+  int frame_id;
+  write_initial_frames (format_context, video_stream, view, vopts -> codec);
   re_create_all_md_shaders (view);
   recreate_all_shaders (view);
   for (frame_id=0; frame_id<2; frame_id++)
@@ -1151,19 +1215,65 @@ gboolean create_movie (glwin * view, video_options * vopts, gchar * videofile)
     view -> anim -> last -> img -> quality = q;
   }
 
-  av_write_trailer (format_context);
+  close_movie_file (format_context, video_stream);
+
+  return TRUE;
+}
+
+/*!
+  \fn void set_rendering_step (glwin * view, int stp)
+
+  \brief select the MD step to render, and flag the MD dependent shaders to build for it
 
-  if (!(output_format -> flags & AVFMT_NOFILE))
+  \param view the target glwin
+  \param stp the MD step to render
+*/
+void set_rendering_step (glwin * view, int stp)
+{
+  image * img = view -> anim -> last -> img;
+  if (img -> step == stp) return;
+  img -> step = stp;
+  if (view -> n_shaders[ATOMS][stp] < 0) view -> create_shaders[ATOMS] = TRUE;
+  if (view -> n_shaders[BONDS][stp] < 0) view -> create_shaders[BONDS] = TRUE;
+  if (view -> n_shaders[POLYS][stp] < 0) view -> create_shaders[POLYS] = TRUE;
+  if (view -> n_shaders[RINGS][stp] < 0) view -> create_shaders[RINGS] = TRUE;
+  if (view -> n_shaders[VOLMS][stp] < 0) view -> create_shaders[VOLMS] = TRUE;
+  if (view -> n_shaders[SELEC][stp] < 0) view -> create_shaders[SELEC] = TRUE;
+  view -> create_shaders[LABEL] = TRUE;
+  view -> create_shaders[MEASU] = TRUE;
+}
+
+/*!
+  \fn gboolean create_trajectory_movie (glwin * view, video_options * vopts, gchar * videofile, int * frames)
+
+  \brief render a movie from a range of MD steps, using the current image parameters
+
+  \param view the target glwin
+  \param vopts the video encoding options
+  \param videofile video file name
+  \param frames the first step, the last step and the stride
+*/
+gboolean create_trajectory_movie (glwin * view, video_options * vopts, gchar * videofile, int * frames)
+{
+  AVFormatContext * format_context = NULL;
+  VideoStream * video_stream = NULL;
+  int frame_id, stp;
+  int init_step = view -> anim -> last -> img -> step;
+
+  num_frames = (frames[1] - frames[0]) / frames[2] + 1;
+  format_context = open_movie_file (vopts, videofile, & video_stream);
+  if (! format_context) return FALSE;
+
+  set_rendering_step (view, frames[0]);
+  write_initial_frames (format_context, video_stream, view, vopts -> codec);
+  for (frame_id = frame_start; frame_id < num_frames+frame_start; frame_id ++)
   {
-    /* close the output file */
-#if LIBAVCODEC_VERSION_MAJOR > 52
-    avio_closep (& format_context -> pb);
-#else
-    url_fclose (av_format_context -> pb);
-#endif
+    stp = frames[0] + (frame_id - frame_start) * frames[2];
+    set_rendering_step (view, stp);
+    write_video_frame (format_context, video_stream, frame_id, view);
   }
-
-  close_stream (format_context, video_stream);
+  close_movie_file (format_context, video_stream);
+  set_rendering_step (view, init_step);
 
   return TRUE;
 }
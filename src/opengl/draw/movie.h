@@ -71,6 +71,8 @@ struct video_options
 
 extern void render_image (glwin * view, video_options * iopts);
 extern void save_movie (glwin * view, video_options * vopts);
+extern void set_rendering_step (glwin * view, int stp);
+extern gboolean create_trajectory_movie (glwin * view, video_options * vopts, gchar * videofile, int * frames);
 
 // Image rendering options from the command line
 extern int render_image_format;
@@ -90,5 +92,10 @@ extern ColRGBA * render_image_grad_color[2];
 extern ColRGBA * render_image_box_color;
 extern int * render_image_pixels;
 extern gchar * render_image_output;
+extern int * render_image_frames;
+extern int render_image_files;
+extern int render_image_jobs;
+extern int render_image_job;
+extern gboolean render_image_movie;
 
 #endif
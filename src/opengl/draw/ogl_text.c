@@ -31,20 +31,30 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 * List of functions:
 
   int * paint_bitmap (vec4_t color, GLfloat a, int cw, int ch, unsigned char * buff);
+  int label_shaders (int id);
+
+  gboolean use_glyph_atlas (int id);
 
   void render_string (int glsl, int id, screen_string * this_string);
+  void render_glyph_atlas (int glsl, int id);
   void debug_string (screen_string  * this_string);
   void render_all_strings (int glsl, int id);
   void add_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3], atom * at, atom * bt, atom * ct);
   void prepare_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3], atom * at, atom * bt, atom * ct);
 
   static void normalize_text_size (GLenum texture,  int * width, int * height);
+  static void set_glyph_layout (PangoLayout * layout, gunichar glyph);
+
+  static gchar * next_glyph (gchar * str, gboolean * sub, gunichar * glyph);
 
   screen_string * was_not_rendered_already (char * word, screen_string * list);
 
   ColRGBA * opposite_color (ColRGBA col);
 
+  PangoFontDescription * label_font (int id);
+
   object_3d * create_string_texture (int cwidth, int cheight, int * pixels);
+  object_3d * create_label_texture (int id, int cwidth, int cheight, int * pixels);
   object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id, screen_string * this_string);
 
 */
@@ -54,6 +64,11 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
 #define PANGO_TEXT_SIZE 500
 #define OUTLINE_WIDTH 3
+// Above this number of different atomic labels, labels are drawn using a glyph atlas
+#define ATLAS_MIN_STRINGS 32
+#define ATLAS_MIN_WIDTH 256
+// Flag for the subscript glyphs in the atlas, above the last Unicode code point
+#define GLYPH_SUB 0x200000
 
 #ifndef GL_CLAMP_TO_EDGE
 #  define GL_CLAMP_TO_EDGE 0x812F
@@ -66,6 +81,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 extern int measures_drawing;
 extern int type_of_measure;
 extern void update_string_instances (glsl_program * glsl, object_3d * obj);
+extern object_3d * duplicate_object_3d (object_3d * old_obj);
 
 GLuint textures_id[2];
 
@@ -288,42 +304,18 @@ object_3d * create_string_texture (int cwidth, int cheight, int * pixels)
 }
 
 /*!
-  \fn object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id, screen_string * this_string)
+  \fn object_3d * create_label_texture (int id, int cwidth, int cheight, int * pixels)
 
-  \brief OpenGL 3D pango layout object rendering
+  \brief create the OpenGL texture(s) for a painted text bitmap
 
-  \param layout the Pango layout
-  \param texture the OpenGL texture type
   \param id the label id
-  \param this_string the screen string
+  \param cwidth width
+  \param cheight height
+  \param pixels the data to render
 */
-object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id, screen_string * this_string)
+object_3d * create_label_texture (int id, int cwidth, int cheight, int * pixels)
 {
-  FT_Bitmap bitmap;
-  PangoRectangle prect;
   object_3d * new_string;
-
-  int * pixels;
-  int cwidth, cheight;
-  int csize;
-
-  pango_layout_get_extents (layout, NULL, & prect);
-  if (prect.width == 0 || prect.height == 0) return NULL;
-  cheight = bitmap.rows = PANGO_PIXELS (prect.height) + 2*OUTLINE_WIDTH;
-  cwidth = bitmap.width = PANGO_PIXELS (prect.width) + 2*OUTLINE_WIDTH;
-
-  normalize_text_size (ogl_texture, & cwidth, & cheight);
-
-  bitmap.pitch = cwidth;
-  csize = cheight*cwidth;
-  bitmap.buffer = g_malloc0(csize);
-  memset (bitmap.buffer, 0, csize);
-
-  bitmap.num_grays = 256;
-  bitmap.pixel_mode = ft_pixel_mode_grays;
-  pango_ft2_render_layout (& bitmap, layout, PANGO_PIXELS (-prect.x)+OUTLINE_WIDTH, OUTLINE_WIDTH);
-  pixels = paint_bitmap (vec4(1.0,0.0,0.0,0.0), 1.0, cwidth, cheight, bitmap.buffer);
-  g_free (bitmap.buffer);
   if (! plot -> labels[id].render)
   {
     new_string = g_malloc0(sizeof*new_string);
@@ -354,6 +346,47 @@ object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id
     new_string = create_string_texture (cwidth, cheight, pixels);
   }
 
+  return new_string;
+}
+
+/*!
+  \fn object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id, screen_string * this_string)
+
+  \brief OpenGL 3D pango layout object rendering
+
+  \param layout the Pango layout
+  \param texture the OpenGL texture type
+  \param id the label id
+  \param this_string the screen string
+*/
+object_3d * gl_pango_render_layout (PangoLayout * layout, GLenum texture, int id, screen_string * this_string)
+{
+  FT_Bitmap bitmap;
+  PangoRectangle prect;
+  object_3d * new_string;
+
+  int * pixels;
+  int cwidth, cheight;
+  int csize;
+
+  pango_layout_get_extents (layout, NULL, & prect);
+  if (prect.width == 0 || prect.height == 0) return NULL;
+  cheight = bitmap.rows = PANGO_PIXELS (prect.height) + 2*OUTLINE_WIDTH;
+  cwidth = bitmap.width = PANGO_PIXELS (prect.width) + 2*OUTLINE_WIDTH;
+
+  normalize_text_size (ogl_texture, & cwidth, & cheight);
+
+  bitmap.pitch = cwidth;
+  csize = cheight*cwidth;
+  bitmap.buffer = g_malloc0(csize);
+  memset (bitmap.buffer, 0, csize);
+
+  bitmap.num_grays = 256;
+  bitmap.pixel_mode = ft_pixel_mode_grays;
+  pango_ft2_render_layout (& bitmap, layout, PANGO_PIXELS (-prect.x)+OUTLINE_WIDTH, OUTLINE_WIDTH);
+  pixels = paint_bitmap (vec4(1.0,0.0,0.0,0.0), 1.0, cwidth, cheight, bitmap.buffer);
+  g_free (bitmap.buffer);
+  new_string = create_label_texture (id, cwidth, cheight, pixels);
   g_free (pixels);
 
   new_string -> num_vertices = 4;
@@ -409,6 +442,30 @@ ColRGBA * opposite_color (ColRGBA col)
   return ocol;
 }
 
+/*!
+  \fn PangoFontDescription * label_font (int id)
+
+  \brief create the Pango font description to render a label list
+
+  \param id the label id
+*/
+PangoFontDescription * label_font (int id)
+{
+  int l;
+  double font_size;
+  PangoFontDescription * pfont = pango_font_description_from_string (plot -> labels[id].font);
+  font_size = pango_font_description_get_size (pfont) / PANGO_SCALE;
+
+  if (plot -> labels[id].scale) font_size *= ((ZOOM/plot -> zoom)*(plot -> gnear/6.0)*(wingl -> p_moy/plot -> p_depth));
+  if (in_movie_encoding)
+  {
+    l = (wingl -> pixels[0] > wingl -> pixels[1]) ? 1 : 0;
+    font_size *= ((float)wingl -> pixels[l]/(float)tmp_pixels[l]);
+  }
+  pango_font_description_set_absolute_size (pfont, font_size*PANGO_SCALE);
+  return pfont;
+}
+
 /*!
   \fn void render_string (int glsl, int id, screen_string * this_string)
 
@@ -420,8 +477,7 @@ ColRGBA * opposite_color (ColRGBA col)
 */
 void render_string (int glsl, int id, screen_string * this_string)
 {
-  int j, k, l;
-  double font_size;
+  int j, k;
   // Pango elements for labels
   PangoContext * pcontext;
   PangoLayout * playout;
@@ -433,17 +489,7 @@ void render_string (int glsl, int id, screen_string * this_string)
   pcontext = pango_font_map_create_context (pango_ft2_font_map_new ());
   playout = pango_layout_new (pcontext);
   pango_layout_set_alignment (playout, PANGO_ALIGN_CENTER);
-  pfont = pango_font_description_from_string (plot -> labels[id].font);
-  j = pango_font_description_get_size (pfont);
-  font_size = j / PANGO_SCALE;
-
-  if (plot -> labels[id].scale) font_size *= ((ZOOM/plot -> zoom)*(plot -> gnear/6.0)*(wingl -> p_moy/plot -> p_depth));
-  if (in_movie_encoding)
-  {
-    l = (wingl -> pixels[0] > wingl -> pixels[1]) ? 1 : 0;
-    font_size *= ((float)wingl -> pixels[l]/(float)tmp_pixels[l]);
-  }
-  pango_font_description_set_absolute_size (pfont, font_size*PANGO_SCALE);
+  pfont = label_font (id);
   pango_layout_set_font_description (playout, pfont);
   pango_layout_set_markup (playout, this_string -> word, strlen(this_string -> word));
   string_to_render = gl_pango_render_layout (playout, ogl_texture, id, this_string);
@@ -458,10 +504,7 @@ void render_string (int glsl, int id, screen_string * this_string)
     string_to_render -> quality = this_string -> type;
     j = this_string -> id;
     j *= (plot -> labels[id].render + 1);
-    if (id == 1 && plot -> labels[0].list != NULL)
-    {
-      j += (plot -> labels[0].render + 1) * (plot -> labels[0].list -> last -> id + 1);
-    }
+    if (id == 1) j += label_shaders (0);
     if (id == 2)
     {
       j += (plot -> xyz -> axis == WIREFRAME) ? 2 : 4;
@@ -541,6 +584,330 @@ void debug_string (screen_string  * this_string)
   g_debug ("STRING:: show :: %f",  this_string -> shift[3]);
 }
 
+/*!
+  \fn static gchar * next_glyph (gchar * str, gboolean * sub, gunichar * glyph)
+
+  \brief read the next glyph of a label for the glyph atlas, \n
+  the '<sub>' and '</sub>' tags are skipped, subscript glyphs are flagged using GLYPH_SUB
+
+  \param str the position in the label text
+  \param sub is the text in a subscript, updated by the tags read
+  \param glyph the glyph read, 0 at the end of the text
+*/
+static gchar * next_glyph (gchar * str, gboolean * sub, gunichar * glyph)
+{
+  while (* str == '<')
+  {
+    if (g_str_has_prefix (str, "<sub>"))
+    {
+      * sub = TRUE;
+      str += 5;
+    }
+    else if (g_str_has_prefix (str, "</sub>"))
+    {
+      * sub = FALSE;
+      str += 6;
+    }
+    else
+    {
+      break;
+    }
+  }
+  if (! * str)
+  {
+    * glyph = 0;
+    return str;
+  }
+  * glyph = g_utf8_get_char (str) | ((* sub) ? GLYPH_SUB : 0);
+  return g_utf8_next_char (str);
+}
+
+/*!
+  \fn static void set_glyph_layout (PangoLayout * layout, gunichar glyph)
+
+  \brief set the Pango layout to render a glyph of the atlas
+
+  \param layout the Pango layout
+  \param glyph the glyph, possibly flagged using GLYPH_SUB
+*/
+static void set_glyph_layout (PangoLayout * layout, gunichar glyph)
+{
+  gchar utf8[8];
+  gchar * str;
+  utf8[g_unichar_to_utf8 (glyph & ~GLYPH_SUB, utf8)] = '\0';
+  if (glyph & GLYPH_SUB)
+  {
+    // The zero width space keeps the baseline of the regular glyphs
+    str = g_markup_printf_escaped ("\xe2\x80\x8b<sub>%s</sub>", utf8);
+    pango_layout_set_markup (layout, str, -1);
+    g_free (str);
+  }
+  else
+  {
+    pango_layout_set_text (layout, utf8, -1);
+  }
+}
+
+/*!
+  \fn gboolean use_glyph_atlas (int id)
+
+  \brief should this label list be rendered using a glyph atlas: \n
+  many different atomic labels, that use no Pango markup but subscripts
+
+  \param id the label id
+*/
+gboolean use_glyph_atlas (int id)
+{
+  gchar * str;
+  if (id > 1 || plot -> labels[id].list == NULL) return FALSE;
+  if (plot -> labels[id].list -> last -> id + 1 < ATLAS_MIN_STRINGS) return FALSE;
+  screen_string * this_string = plot -> labels[id].list -> last;
+  while (this_string != NULL)
+  {
+    if (strchr (this_string -> word, '&')) return FALSE;
+    for (str = strchr (this_string -> word, '<'); str; str = strchr (str + 1, '<'))
+    {
+      if (! g_str_has_prefix (str, "<sub>") && ! g_str_has_prefix (str, "</sub>")) return FALSE;
+    }
+    this_string = this_string -> prev;
+  }
+  return TRUE;
+}
+
+/*!
+  \fn int label_shaders (int id)
+
+  \brief number of shaders required to render a label list
+
+  \param id the label id
+*/
+int label_shaders (int id)
+{
+  if (plot -> labels[id].list == NULL) return 0;
+  if (use_glyph_atlas (id)) return plot -> labels[id].render + 1;
+  return (plot -> labels[id].render + 1) * (plot -> labels[id].list -> last -> id + 1);
+}
+
+/*!
+  \fn void render_glyph_atlas (int glsl, int id)
+
+  \brief render a label list using a glyph atlas: \n
+  each character is rendered once by Pango in a single texture, \n
+  then each character of each string is an instance of a single shader
+
+  \param glsl the shader id
+  \param id the label id
+*/
+void render_glyph_atlas (int glsl, int id)
+{
+  int i, j, k, l, m, n;
+  int num_glyphs, num_inst;
+  int cwidth, cheight, awidth, aheight;
+  int pen_x, pen_y, swidth, wmax;
+  int * pixels;
+  int * glyph_width;
+  int * glyph_pos;
+  gunichar * glyph_char;
+  gunichar glyph;
+  gboolean sub;
+  gchar * str;
+  float tw, th;
+  float * inst;
+  ColRGBA * ocol;
+  FT_Bitmap bitmap;
+  PangoRectangle prect;
+  PangoContext * pcontext;
+  PangoLayout * playout;
+  PangoFontDescription * pfont;
+  GHashTable * glyphs;
+  screen_string * this_string;
+  object_3d * atlas;
+
+  pcontext = pango_font_map_create_context (pango_ft2_font_map_new ());
+  playout = pango_layout_new (pcontext);
+  pfont = label_font (id);
+  pango_layout_set_font_description (playout, pfont);
+
+  // List the different characters, and the number of glyph instances
+  glyphs = g_hash_table_new (g_direct_hash, g_direct_equal);
+  num_glyphs = num_inst = 0;
+  this_string = plot -> labels[id].list -> last;
+  while (this_string != NULL)
+  {
+    sub = FALSE;
+    for (str = next_glyph (this_string -> word, & sub, & glyph); glyph; str = next_glyph (str, & sub, & glyph))
+    {
+      if (! g_hash_table_contains (glyphs, GUINT_TO_POINTER(glyph)))
+      {
+        num_glyphs ++;
+        g_hash_table_insert (glyphs, GUINT_TO_POINTER(glyph), GINT_TO_POINTER(num_glyphs));
+      }
+      num_inst += this_string -> num_instances;
+    }
+    this_string = this_string -> prev;
+  }
+  glyph_char = g_malloc0 (num_glyphs*sizeof*glyph_char);
+  glyph_width = allocint (num_glyphs);
+  glyph_pos = allocint (2*num_glyphs);
+  GHashTableIter iter;
+  gpointer key, value;
+  g_hash_table_iter_init (& iter, glyphs);
+  while (g_hash_table_iter_next (& iter, & key, & value))
+  {
+    glyph_char[GPOINTER_TO_INT(value)-1] = GPOINTER_TO_UINT(key);
+  }
+
+  // Measure the glyphs, all cells share the same height
+  cheight = wmax = 0;
+  n = 0;
+  for (i=0; i<num_glyphs; i++)
+  {
+    set_glyph_layout (playout, glyph_char[i]);
+    pango_layout_get_extents (playout, NULL, & prect);
+    glyph_width[i] = PANGO_PIXELS (prect.width);
+    cheight = max (cheight, PANGO_PIXELS (prect.height));
+    wmax = max (wmax, glyph_width[i]);
+    n += glyph_width[i] + 2*OUTLINE_WIDTH;
+  }
+  cheight += 2*OUTLINE_WIDTH;
+  wmax += 2*OUTLINE_WIDTH;
+
+  // Pack the glyph cells in rows, the atlas is at least as wide as the widest cell
+  for (awidth = ATLAS_MIN_WIDTH; awidth < wmax || awidth*awidth < n*cheight; awidth = awidth << 1);
+  pen_x = pen_y = 0;
+  for (i=0; i<num_glyphs; i++)
+  {
+    cwidth = glyph_width[i] + 2*OUTLINE_WIDTH;
+    if (pen_x + cwidth > awidth)
+    {
+      pen_x = 0;
+      pen_y += cheight;
+    }
+    glyph_pos[2*i] = pen_x;
+    glyph_pos[2*i+1] = pen_y;
+    pen_x += cwidth;
+  }
+  aheight = pen_y + cheight;
+  normalize_text_size (ogl_texture, & awidth, & aheight);
+
+  bitmap.rows = aheight;
+  bitmap.width = bitmap.pitch = awidth;
+  bitmap.buffer = g_malloc0(awidth*aheight);
+  bitmap.num_grays = 256;
+  bitmap.pixel_mode = ft_pixel_mode_grays;
+  for (i=0; i<num_glyphs; i++)
+  {
+    set_glyph_layout (playout, glyph_char[i]);
+    pango_layout_get_extents (playout, NULL, & prect);
+    pango_ft2_render_layout (& bitmap, playout, glyph_pos[2*i] + PANGO_PIXELS (-prect.x) + OUTLINE_WIDTH, glyph_pos[2*i+1] + OUTLINE_WIDTH);
+  }
+  pixels = paint_bitmap (vec4(1.0,0.0,0.0,0.0), 1.0, awidth, aheight, bitmap.buffer);
+  g_free (bitmap.buffer);
+  atlas = create_label_texture (id, awidth, aheight, pixels);
+  g_free (pixels);
+  if (atlas == NULL)
+  {
+    g_warning (_("Error in text rendering : for some reason it is impossible to render the glyph atlas using this font: %s"), plot -> labels[id].font);
+    goto end;
+  }
+
+  // The unit quad, scaled and positioned in the instances
+  atlas -> num_vertices = 4;
+  atlas -> vert_buffer_size = 2;
+  atlas -> vertices = allocfloat (8);
+  atlas -> vertices[1] = atlas -> vertices[4] = atlas -> vertices[5] = atlas -> vertices[6] = 1.0;
+  atlas -> shift[3] = (float) plot -> labels[id].position;
+  atlas -> quality = 3;
+  atlas -> num_instances = num_inst;
+  atlas -> inst_buffer_size = GLYPH_BUFF_SIZE;
+  atlas -> instances = allocfloat (num_inst*GLYPH_BUFF_SIZE);
+  tw = (ogl_texture == GL_TEXTURE_2D) ? (float) awidth : 1.0;
+  th = (ogl_texture == GL_TEXTURE_2D) ? (float) aheight : 1.0;
+  // The quad of each glyph, the string being centered as for 'render_string'
+  l = 0;
+  this_string = plot -> labels[id].list -> last;
+  while (this_string != NULL)
+  {
+    swidth = 2*OUTLINE_WIDTH;
+    sub = FALSE;
+    for (str = next_glyph (this_string -> word, & sub, & glyph); glyph; str = next_glyph (str, & sub, & glyph))
+    {
+      swidth += glyph_width[GPOINTER_TO_INT(g_hash_table_lookup (glyphs, GUINT_TO_POINTER(glyph)))-1];
+    }
+    pen_x = 0;
+    sub = FALSE;
+    for (str = next_glyph (this_string -> word, & sub, & glyph); glyph; str = next_glyph (str, & sub, & glyph))
+    {
+      i = GPOINTER_TO_INT(g_hash_table_lookup (glyphs, GUINT_TO_POINTER(glyph)))-1;
+      cwidth = glyph_width[i] + 2*OUTLINE_WIDTH;
+      for (j=0; j<this_string -> num_instances; j++, l++)
+      {
+        inst = & atlas -> instances[l*GLYPH_BUFF_SIZE];
+        for (k=0; k<3; k++)
+        {
+          inst[k] = this_string -> instances[3*j+k];
+          inst[k+3] = this_string -> shift[k];
+        }
+        inst[6] = (float) (2*pen_x - swidth);
+        inst[7] = (float) (- cheight);
+        inst[8] = (float) (2*cwidth);
+        inst[9] = (float) (2*cheight);
+        // The bitmap rows were reversed by 'paint_bitmap'
+        inst[10] = (float) glyph_pos[2*i] / tw;
+        inst[11] = (float) (aheight - glyph_pos[2*i+1] - cheight) / th;
+        inst[12] = (float) cwidth / tw;
+        inst[13] = (float) cheight / th;
+        inst[14] = this_string -> col.red;
+        inst[15] = this_string -> col.green;
+        inst[16] = this_string -> col.blue;
+        inst[17] = this_string -> col.alpha;
+      }
+      pen_x += glyph_width[i];
+    }
+    this_string = this_string -> prev;
+  }
+
+  j = (id == 1) ? label_shaders (0) : 0;
+  if (! plot -> labels[id].render)
+  {
+    wingl -> ogl_glsl[glsl][0][j] = init_shader_program (glsl, GLSL_GLYPHS, glyph_vertex, NULL, (ogl_texture == GL_TEXTURE_RECTANGLE_ARB) ? glyph_color : glyph_color_2d,
+                                                         GL_TRIANGLE_STRIP, 6, 7, FALSE, atlas);
+    wingl -> ogl_glsl[glsl][0][j] -> col = duplicate_color(1, & (plot -> labels[id].list -> last -> col));
+  }
+  else
+  {
+    // The outline is drawn first, using the opposite color of each string
+    object_3d * outline = duplicate_object_3d (atlas);
+    outline -> texture = textures_id[0];
+    for (l=0; l<num_inst; l++)
+    {
+      inst = & outline -> instances[l*GLYPH_BUFF_SIZE];
+      ocol = opposite_color ((ColRGBA){inst[14], inst[15], inst[16], inst[17]});
+      inst[14] = ocol -> red;
+      inst[15] = ocol -> green;
+      inst[16] = ocol -> blue;
+      inst[17] = ocol -> alpha;
+      g_free (ocol);
+    }
+    wingl -> ogl_glsl[glsl][0][j] = init_shader_program (glsl, GLSL_GLYPHS, glyph_vertex, NULL, (ogl_texture == GL_TEXTURE_RECTANGLE_ARB) ? glyph_color : glyph_color_2d,
+                                                         GL_TRIANGLE_STRIP, 6, 7, FALSE, outline);
+    wingl -> ogl_glsl[glsl][0][j] -> col = opposite_color (plot -> labels[id].list -> last -> col);
+    atlas -> texture = textures_id[1];
+    wingl -> ogl_glsl[glsl][0][j+1] = init_shader_program (glsl, GLSL_GLYPHS, glyph_vertex, NULL, (ogl_texture == GL_TEXTURE_RECTANGLE_ARB) ? glyph_color : glyph_color_2d,
+                                                           GL_TRIANGLE_STRIP, 6, 7, FALSE, atlas);
+    wingl -> ogl_glsl[glsl][0][j+1] -> col = duplicate_color(1, & (plot -> labels[id].list -> last -> col));
+  }
+
+end:
+  g_hash_table_destroy (glyphs);
+  g_free (glyph_char);
+  g_free (glyph_width);
+  g_free (glyph_pos);
+  pango_font_description_free (pfont);
+  g_clear_object (& pcontext);
+  g_clear_object (& playout);
+}
+
 /*!
   \fn void render_all_strings (int glsl, int id)
 
@@ -551,7 +918,11 @@ void debug_string (screen_string  * this_string)
 */
 void render_all_strings (int glsl, int id)
 {
-  if (plot -> labels[id].list != NULL)
+  if (glsl == LABEL && use_glyph_atlas (id))
+  {
+    render_glyph_atlas (glsl, id);
+  }
+  else if (plot -> labels[id].list != NULL)
   {
     screen_string  * this_string = plot -> labels[id].list -> last;
     while (this_string != NULL)
@@ -590,6 +961,10 @@ screen_string * was_not_rendered_already (char * word, screen_string * list)
   return NULL;
 }
 
+// Hash table of the screen strings, by text, for the list it was created for
+GHashTable * string_table[5] = {NULL, NULL, NULL, NULL, NULL};
+screen_string * string_table_list[5] = {NULL, NULL, NULL, NULL, NULL};
+
 /*!
   \fn void add_string_instance (screen_string * string, vec3_t pos, atom * at, atom * bt, atom * ct)
 
@@ -604,22 +979,14 @@ screen_string * was_not_rendered_already (char * word, screen_string * list)
 void add_string_instance (screen_string * string, vec3_t pos, atom * at, atom * bt, atom * ct)
 {
   int i, j;
-  i = 0;
   j = (string -> type == 3) ? 1 : (type_of_measure == 6) ? 3 : 4;
-  if (string -> num_instances > 0)
-  {
-    float * instances = duplicate_float (3*j*string -> num_instances, string -> instances);
-    g_free (string -> instances);
-    string -> instances = allocfloat (3*j*(string -> num_instances+1));
-    for (i=0; i<3*j*string -> num_instances; i++)
-    {
-      string -> instances[i] = instances[i];
-    }
-  }
-  else
+  // The storage is doubled when full, so that adding instances remains linear
+  if (string -> num_instances == string -> max_instances)
   {
-    string -> instances = allocfloat (3*j);
+    string -> max_instances = (string -> max_instances) ? 2*string -> max_instances : 1;
+    string -> instances = g_realloc (string -> instances, 3*j*string -> max_instances*sizeof*string -> instances);
   }
+  i = 3*j*string -> num_instances;
   string -> num_instances ++;
   string -> instances[i] = pos.x;
   string -> instances[i+1] = pos.y;
@@ -661,6 +1028,9 @@ void add_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3],
   {
     plot -> labels[id].list = g_malloc0(sizeof*plot -> labels[id].list);
     plot -> labels[id].list -> last = plot -> labels[id].list;
+    if (string_table[id] != NULL) g_hash_table_destroy (string_table[id]);
+    string_table[id] = g_hash_table_new (g_str_hash, g_str_equal);
+    string_table_list[id] = plot -> labels[id].list;
   }
   else
   {
@@ -670,6 +1040,10 @@ void add_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3],
     plot -> labels[id].list -> last = s_tring;
   }
   plot -> labels[id].list -> last -> word = g_strdup_printf ("%s", text);
+  if (string_table_list[id] == plot -> labels[id].list)
+  {
+    g_hash_table_insert (string_table[id], plot -> labels[id].list -> last -> word, plot -> labels[id].list -> last);
+  }
   plot -> labels[id].list -> last -> col = col;
   plot -> labels[id].list -> last -> type = (id < 3) ? 3 : (type_of_measure == 6) ? 4 : 5;
   int i;
@@ -693,7 +1067,15 @@ void add_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3],
 */
 void prepare_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3], atom * at, atom * bt, atom * ct)
 {
-  screen_string * this_string = was_not_rendered_already (text, plot -> labels[id].list);
+  screen_string * this_string;
+  if (plot -> labels[id].list != NULL && string_table_list[id] == plot -> labels[id].list)
+  {
+    this_string = g_hash_table_lookup (string_table[id], text);
+  }
+  else
+  {
+    this_string = was_not_rendered_already (text, plot -> labels[id].list);
+  }
   if (this_string == NULL)
   {
     add_string (text, id, col, pos, lshift, at, bt, ct);
@@ -234,7 +234,8 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
     this_proj -> modelgl -> anim -> last -> img -> xyz -> axis = default_axis.axis;
   }
   gboolean passivate = FALSE;
-  if (asearch -> action == REMOVE)
+  // No passivation when a removal is undone / redone
+  if (asearch -> action == REMOVE && ! is_edit_replay (this_proj))
   {
     if (this_proj -> modelgl -> cell_win)
     {
@@ -407,6 +408,19 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
   if ((asearch -> action == INSERT || asearch -> action == REPLACE) && extra == 0) return extra;
   if (asearch -> action == REMOVE && remove > this_proj -> natomes) return -1;
 
+  if (asearch -> action == REMOVE && ! is_edit_replay (this_proj))
+  {
+    if (passivate || remove == this_proj -> natomes)
+    {
+      // Passivation and removal of all atoms are not recorded
+      clean_edit_journal (this_proj);
+    }
+    else
+    {
+      record_edit_removal (this_proj, asearch -> todo);
+    }
+  }
+
   if ((asearch -> action != DISPL && asearch -> action != RANMOVE)
   || (asearch -> passivating && asearch -> filter < 3)
   || (asearch -> action == RANMOVE && asearch -> passivating && asearch -> object < 2)
@@ -488,6 +502,7 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
 #endif
   }
   clean_volumes_data (this_proj -> modelgl);
+  clean_density_maps (this_proj -> modelgl);
 
   if (asearch -> action == REMOVE && remove == this_proj -> natomes)
   {
@@ -917,6 +932,13 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
     g_free (tmpgeo[j]);
   }
 
+  // The velocities and forces read with the coordinates no longer match the model
+  if (active_project -> dynamics)
+  {
+    g_free (active_project -> dynamics);
+    active_project -> dynamics = NULL;
+  }
+  active_project -> dyn_data = 0;
   init_curves_and_calc (active_project);
   if (active_box)
   {
@@ -941,8 +963,7 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
   {
     active_project_changed (activep);
     bonds_update = 1;
-    frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-    mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+    frag_update = mol_update = 1;
     active_project -> runc[0] = FALSE;
     on_calc_bonds_released (NULL, NULL);
   }
@@ -972,6 +993,8 @@ int action_atoms_from_project (project * this_proj, atom_search * asearch, gbool
   for (i=0; i<2; i++) update_all_selections (this_proj -> modelgl, i);
   if (to_add != NULL) free_dummies (to_add);
 
+  if (asearch -> action == INSERT || asearch -> action == REPLACE) record_edit_insertion (this_proj, extra);
+  clean_atom_grid (this_proj);
   if (visible && (asearch -> action != DISPL && asearch -> action != RANMOVE))
   {
     for (i=0; i<3; i++)
@@ -1122,6 +1145,8 @@ void apply_action (project * this_proj, atom_search * asearch)
   int k, l;
   l = 0;
   gboolean visible = (this_proj -> modelgl -> atom_win) ? this_proj -> modelgl -> atom_win -> visible : FALSE;
+  // A replacement is a removal followed by an insertion, both are undone / redone together
+  begin_edit_batch (this_proj);
   if (asearch -> action == REPLACE || asearch -> action == REMOVE)
   {
     to_remove_this_list_of_objects (this_proj, asearch);
@@ -1130,6 +1155,7 @@ void apply_action (project * this_proj, atom_search * asearch)
     remove_search = NULL;
   }
   k = (asearch -> action == REMOVE) ? l : action_atoms_from_project (this_proj, asearch, visible);
+  end_edit_batch (this_proj);
   if (asearch -> action != DISPL && asearch -> action != RANMOVE)
   {
     switch (k)
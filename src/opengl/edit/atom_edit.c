@@ -187,6 +187,8 @@ void clean_atom_win (project * this_proj)
       this_proj -> modelgl -> saved_coord[i] = NULL;
     }
   }
+  clean_edit_journal (this_proj);
+  clean_atom_grid (this_proj);
   clean_other_window_after_edit (this_proj);
   update (this_proj -> modelgl);
 }
@@ -301,6 +303,7 @@ G_MODULE_EXPORT void set_reset_transformation (GtkToggleButton * but, gpointer d
         reset_coordinates (this_proj, h);
         init_coordinates (this_proj, h, TRUE, FALSE);
       }
+      clean_edit_journal (this_proj);
       init_default_shaders (this_proj -> modelgl);
       update (this_proj -> modelgl);
     }
@@ -446,6 +449,10 @@ GtkWidget * create_edition_window (project * this_proj)
   add_box_child_end (hbox, but, FALSE, FALSE, 5);
   but = create_button (_("Close"), IMG_STOCK, FCLOSE, -1, -1, GTK_RELIEF_NORMAL, G_CALLBACK(close_edit), GINT_TO_POINTER(this_proj -> id));
   add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, but, FALSE, FALSE, 5);
+  but = create_button (_("Undo"), IMG_STOCK, EDITU, -1, -1, GTK_RELIEF_NORMAL, G_CALLBACK(undo_edit), GINT_TO_POINTER(this_proj -> id));
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, but, FALSE, FALSE, 5);
+  but = create_button (_("Redo"), IMG_STOCK, EDITR, -1, -1, GTK_RELIEF_NORMAL, G_CALLBACK(redo_edit), GINT_TO_POINTER(this_proj -> id));
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, but, FALSE, FALSE, 5);
   return win;
 }
 
@@ -477,6 +484,9 @@ void prepare_atom_edition (gpointer data, gboolean visible)
     this_proj -> modelgl -> atom_win -> msd = allocfloat (this_proj -> natomes);
     this_proj -> modelgl -> atom_win -> msd_all = allocfloat (this_proj -> nspec);
     this_proj -> modelgl -> atom_win -> repeat_move = 1;
+    this_proj -> modelgl -> atom_win -> overlap = 2.0;
+    this_proj -> modelgl -> atom_win -> pack_copies = 1;
+    this_proj -> modelgl -> atom_win -> pack_density = 1.0;
   }
   this_proj -> modelgl -> atom_win -> visible = visible;
   if (visible)
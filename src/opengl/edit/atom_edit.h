@@ -44,6 +44,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 #define IDCOL 0
 #define TOLAB 3
 #define TOPIC 4
+#define MAX_EDIT_STEPS 100
 
 extern GtkWidget * selection_tab (atom_search * asearch, int nats);
 extern G_MODULE_EXPORT void set_show_axis_toggle (GtkToggleButton * but, gpointer data);
@@ -136,6 +137,37 @@ extern void rotate (project * this_proj, int i, int j, int k, float param);
 extern void random_move (project * this_proj, atom_search * asearch);
 extern void update_coordinates (project * this_proj, int status, int axis, int action);
 extern G_MODULE_EXPORT void repeat_move (GtkSpinButton * res, gpointer data);
+extern void trigger_refresh (project * this_proj, atom_search * asearch);
+
+extern int action_atoms_from_project (project * this_proj, atom_search * asearch, gboolean visible);
+extern atom_search * allocate_atom_search (int proj, int action, int searchid, int tsize);
+extern int * duplicate_z (int species, double * old_z);
+extern void clean_object_bonds (project * proj, int o_step, atomic_object * object, int * new_id, gboolean movtion);
+
+extern void clean_edit_journal (project * this_proj);
+extern gboolean is_edit_replay (project * this_proj);
+extern void record_edit_removal (project * this_proj, int * todo);
+extern void record_edit_insertion (project * this_proj, int atoms);
+extern void begin_edit_batch (project * this_proj);
+extern gboolean end_edit_batch (project * this_proj);
+extern void recompute_edit_bonding (project * this_proj);
+extern void open_edit_step (project * this_proj, int action);
+extern void record_edit_atom (project * this_proj, int aid);
+extern void close_edit_step (project * this_proj, gboolean bonding);
+extern int undo_edit_steps (project * this_proj, int steps);
+extern int redo_edit_steps (project * this_proj, int steps);
+extern G_MODULE_EXPORT void undo_edit (GtkButton * but, gpointer data);
+extern G_MODULE_EXPORT void redo_edit (GtkButton * but, gpointer data);
+
+extern void move_grid_point (atom_grid * grid, int id, double * pos);
+extern void update_atom_grid (project * this_proj, int aid);
+extern void update_object_grid (project * this_proj, atomic_object * object);
+extern atom_grid * overlap_grid (project * this_proj);
+extern gboolean grid_clash (atom_grid * grid, double * pos, double * old, double tol, int from, int self, gboolean * skip);
+extern double * save_object_position (project * this_proj, atomic_object * object);
+extern void restore_object_position (project * this_proj, atomic_object * object, double * saved);
+extern gboolean object_creates_overlap (project * this_proj, atomic_object * object, double * saved);
+extern int pack_object_copies (project * this_proj, atomic_object * object, int copies, double density, double tol, double ** placed);
 
 #ifdef GTK4
 extern G_MODULE_EXPORT void to_set_move (GtkEditable * widg, gpointer data);
@@ -0,0 +1,785 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file atom_grid.c
+* @short Functions to maintain a cell list of the atomic positions \n
+         Functions to detect atomic overlaps during the model edition \n
+         Functions to pack copies of an object at a target density
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'atom_grid.c'
+*
+* Contains:
+*
+
+ - The functions to maintain a cell list of the atomic positions
+ - The functions to detect atomic overlaps during the model edition
+ - The functions to pack copies of an object at a target density
+
+ The grid is kept with the model while it is edited, atoms moved by the
+ model edition are relinked one by one, and the grid is only rebuilt when
+ the atoms, the box or the overlap distance change.
+
+*
+* List of functions:
+
+  int grid_cell_id (atom_grid * grid, double * pos);
+  int add_grid_point (atom_grid * grid, double * pos);
+  int pack_object_copies (project * this_proj, atomic_object * object, int copies, double density, double tol, double ** placed);
+
+  gboolean grid_clash (atom_grid * grid, double * pos, double * old, double tol, int from, int self, gboolean * skip);
+  gboolean object_creates_overlap (project * this_proj, atomic_object * object, double * saved);
+
+  double grid_distance (atom_grid * grid, double * a, double * b);
+  double object_mass (atomic_object * object);
+  double pack_random (guint64 * state);
+
+  double * save_object_position (project * this_proj, atomic_object * object);
+
+  void free_atom_grid (atom_grid * grid);
+  void clean_atom_grid (project * this_proj);
+  void link_grid_point (atom_grid * grid, int id);
+  void unlink_grid_point (atom_grid * grid, int id);
+  void move_grid_point (atom_grid * grid, int id, double * pos);
+  void update_atom_grid (project * this_proj, int aid);
+  void update_object_grid (project * this_proj, atomic_object * object);
+  void restore_object_position (project * this_proj, atomic_object * object, double * saved);
+
+  atom_grid * create_atom_grid (project * this_proj, double cut, int hint, double * center, double edge);
+  atom_grid * get_atom_grid (project * this_proj, double cut);
+  atom_grid * overlap_grid (project * this_proj);
+
+*/
+
+#include "atom_edit.h"
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+
+/*! \def PACK_CHUNK
+  \brief number of packed insertion trials per thread, tested in parallel against the cell list before the accepted ones are added
+*/
+#define PACK_CHUNK 64
+
+/*!
+  \fn void free_atom_grid (atom_grid * grid)
+
+  \brief free a cell list
+
+  \param grid the cell list to free
+*/
+void free_atom_grid (atom_grid * grid)
+{
+  if (! grid) return;
+  g_free (grid -> pos);
+  g_free (grid -> head);
+  g_free (grid -> next);
+  g_free (grid -> prev);
+  g_free (grid -> cell);
+  g_free (grid -> skip);
+  g_free (grid);
+}
+
+/*!
+  \fn void clean_atom_grid (project * this_proj)
+
+  \brief free the cell list of a project, if any, \n
+  called when the coordinates change, the cached voxel grid is also freed
+
+  \param this_proj the target project
+*/
+void clean_atom_grid (project * this_proj)
+{
+  if (! this_proj -> modelgl) return;
+  free_atom_grid (this_proj -> modelgl -> grid);
+  this_proj -> modelgl -> grid = NULL;
+  clean_voxel_grid (this_proj -> modelgl);
+}
+
+/*!
+  \fn int grid_cell_id (atom_grid * grid, double * pos)
+
+  \brief find the cell of a position
+
+  \param grid the target cell list
+  \param pos the position
+*/
+int grid_cell_id (atom_grid * grid, double * pos)
+{
+  int i, j;
+  int c[3];
+  double f;
+  double d[3] = {pos[0] - grid -> org[0], pos[1] - grid -> org[1], pos[2] - grid -> org[2]};
+  for (i=0; i<3; i++)
+  {
+    f = grid -> inv[0][i]*d[0] + grid -> inv[1][i]*d[1] + grid -> inv[2][i]*d[2];
+    if (grid -> pbc) f -= floor(f);
+    j = (int)floor(f*grid -> n[i]);
+    // Clamping keeps two close positions in neighboring cells
+    c[i] = (j < 0) ? 0 : (j >= grid -> n[i]) ? grid -> n[i] - 1 : j;
+  }
+  return (c[0]*grid -> n[1] + c[1])*grid -> n[2] + c[2];
+}
+
+/*!
+  \fn void link_grid_point (atom_grid * grid, int id)
+
+  \brief add a point to the list of its cell
+
+  \param grid the target cell list
+  \param id the point id
+*/
+void link_grid_point (atom_grid * grid, int id)
+{
+  int c = grid_cell_id (grid, & grid -> pos[3*id]);
+  grid -> cell[id] = c;
+  grid -> prev[id] = -1;
+  grid -> next[id] = grid -> head[c];
+  if (grid -> head[c] > -1) grid -> prev[grid -> head[c]] = id;
+  grid -> head[c] = id;
+}
+
+/*!
+  \fn void unlink_grid_point (atom_grid * grid, int id)
+
+  \brief remove a point from the list of its cell
+
+  \param grid the target cell list
+  \param id the point id
+*/
+void unlink_grid_point (atom_grid * grid, int id)
+{
+  if (grid -> prev[id] > -1)
+  {
+    grid -> next[grid -> prev[id]] = grid -> next[id];
+  }
+  else
+  {
+    grid -> head[grid -> cell[id]] = grid -> next[id];
+  }
+  if (grid -> next[id] > -1) grid -> prev[grid -> next[id]] = grid -> prev[id];
+}
+
+/*!
+  \fn int add_grid_point (atom_grid * grid, double * pos)
+
+  \brief add a point to a cell list, return its id
+
+  \param grid the target cell list
+  \param pos the position of the point
+*/
+int add_grid_point (atom_grid * grid, double * pos)
+{
+  int i = grid -> points;
+  if (i == grid -> size)
+  {
+    grid -> size = 2*grid -> size + 64;
+    grid -> pos = g_realloc (grid -> pos, 3*grid -> size*sizeof*grid -> pos);
+    grid -> next = g_realloc (grid -> next, grid -> size*sizeof*grid -> next);
+    grid -> prev = g_realloc (grid -> prev, grid -> size*sizeof*grid -> prev);
+    grid -> cell = g_realloc (grid -> cell, grid -> size*sizeof*grid -> cell);
+  }
+  grid -> pos[3*i] = pos[0];
+  grid -> pos[3*i+1] = pos[1];
+  grid -> pos[3*i+2] = pos[2];
+  link_grid_point (grid, i);
+  grid -> points ++;
+  return i;
+}
+
+/*!
+  \fn void move_grid_point (atom_grid * grid, int id, double * pos)
+
+  \brief update the position of a point in a cell list
+
+  \param grid the target cell list
+  \param id the point id
+  \param pos the new position
+*/
+void move_grid_point (atom_grid * grid, int id, double * pos)
+{
+  int i;
+  for (i=0; i<3; i++) grid -> pos[3*id+i] = pos[i];
+  if (grid_cell_id (grid, pos) != grid -> cell[id])
+  {
+    unlink_grid_point (grid, id);
+    link_grid_point (grid, id);
+  }
+}
+
+/*!
+  \fn atom_grid * create_atom_grid (project * this_proj, double cut, int hint, double * center, double edge)
+
+  \brief create the cell list of the atoms of a project
+
+  \param this_proj the target project
+  \param cut the minimum size of a cell
+  \param hint the number of point(s) expected in the grid
+  \param center the center of a cubic region the grid must cover, if any (isolated model only)
+  \param edge the edge of that cubic region
+*/
+atom_grid * create_atom_grid (project * this_proj, double cut, int hint, double * center, double edge)
+{
+  int i, j;
+  double vmin[3], vmax[3], pos[3];
+  atom_grid * grid = g_malloc0(sizeof*grid);
+  grid -> natomes = this_proj -> natomes;
+  grid -> cut = cut;
+  grid -> pbc = (this_proj -> cell.pbc && this_proj -> cell.has_a_box) ? TRUE : FALSE;
+  if (grid -> pbc)
+  {
+    for (i=0; i<3; i++)
+    {
+      grid -> org[i] = 0.0;
+      for (j=0; j<3; j++) grid -> vect[i][j] = this_proj -> cell.box[0].vect[i][j];
+    }
+  }
+  else
+  {
+    for (i=0; i<3; i++)
+    {
+      vmin[i] = (center) ? center[i] - 0.5*edge : 0.0;
+      vmax[i] = (center) ? center[i] + 0.5*edge : 0.0;
+    }
+    for (j=0; j<this_proj -> natomes; j++)
+    {
+      pos[0] = this_proj -> atoms[0][j].x;
+      pos[1] = this_proj -> atoms[0][j].y;
+      pos[2] = this_proj -> atoms[0][j].z;
+      for (i=0; i<3; i++)
+      {
+        if ((! j && ! center) || pos[i] < vmin[i]) vmin[i] = pos[i];
+        if ((! j && ! center) || pos[i] > vmax[i]) vmax[i] = pos[i];
+      }
+    }
+    for (i=0; i<3; i++)
+    {
+      grid -> org[i] = vmin[i] - cut;
+      for (j=0; j<3; j++) grid -> vect[i][j] = (i == j) ? vmax[i] - vmin[i] + 2.0*cut : 0.0;
+    }
+  }
+  double (* v)[3] = grid -> vect;
+  double det = v[0][0]*(v[1][1]*v[2][2]-v[1][2]*v[2][1])
+             - v[0][1]*(v[1][0]*v[2][2]-v[1][2]*v[2][0])
+             + v[0][2]*(v[1][0]*v[2][1]-v[1][1]*v[2][0]);
+  if (fabs(det) < 1e-12)
+  {
+    g_free (grid);
+    return NULL;
+  }
+  grid -> inv[0][0] = (v[1][1]*v[2][2]-v[1][2]*v[2][1])/det;
+  grid -> inv[0][1] = (v[0][2]*v[2][1]-v[0][1]*v[2][2])/det;
+  grid -> inv[0][2] = (v[0][1]*v[1][2]-v[0][2]*v[1][1])/det;
+  grid -> inv[1][0] = (v[1][2]*v[2][0]-v[1][0]*v[2][2])/det;
+  grid -> inv[1][1] = (v[0][0]*v[2][2]-v[0][2]*v[2][0])/det;
+  grid -> inv[1][2] = (v[0][2]*v[1][0]-v[0][0]*v[1][2])/det;
+  grid -> inv[2][0] = (v[1][0]*v[2][1]-v[1][1]*v[2][0])/det;
+  grid -> inv[2][1] = (v[0][1]*v[2][0]-v[0][0]*v[2][1])/det;
+  grid -> inv[2][2] = (v[0][0]*v[1][1]-v[0][1]*v[1][0])/det;
+  // Cells must be at least 'cut' wide between opposite faces,
+  // and their number is kept proportional to the number of points
+  double width[3];
+  double ncells;
+  double cmax = max (1000.0, 4.0*max(hint, this_proj -> natomes));
+  for (i=0; i<3; i++)
+  {
+    width[i] = 1.0 / sqrt(grid -> inv[0][i]*grid -> inv[0][i] + grid -> inv[1][i]*grid -> inv[1][i] + grid -> inv[2][i]*grid -> inv[2][i]);
+  }
+  do
+  {
+    ncells = 1.0;
+    for (i=0; i<3; i++)
+    {
+      grid -> n[i] = max (1, (int)floor(width[i] / cut));
+      ncells *= grid -> n[i];
+    }
+    cut *= 1.25;
+  } while (ncells > cmax);
+  grid -> head = allocint (grid -> n[0]*grid -> n[1]*grid -> n[2]);
+  for (i=0; i<grid -> n[0]*grid -> n[1]*grid -> n[2]; i++) grid -> head[i] = -1;
+  grid -> skip = allocbool (this_proj -> natomes);
+  for (j=0; j<this_proj -> natomes; j++)
+  {
+    pos[0] = this_proj -> atoms[0][j].x;
+    pos[1] = this_proj -> atoms[0][j].y;
+    pos[2] = this_proj -> atoms[0][j].z;
+    add_grid_point (grid, pos);
+  }
+  return grid;
+}
+
+/*!
+  \fn atom_grid * get_atom_grid (project * this_proj, double cut)
+
+  \brief get the cell list of a project, (re)build it if required
+
+  \param this_proj the target project
+  \param cut the minimum size of a cell
+*/
+atom_grid * get_atom_grid (project * this_proj, double cut)
+{
+  atom_grid * grid = this_proj -> modelgl -> grid;
+  int i, j;
+  gboolean pbc = (this_proj -> cell.pbc && this_proj -> cell.has_a_box) ? TRUE : FALSE;
+  if (grid)
+  {
+    gboolean rebuild = (grid -> natomes != this_proj -> natomes || grid -> points != grid -> natomes
+                        || grid -> cut != cut || grid -> pbc != pbc) ? TRUE : FALSE;
+    if (! rebuild && pbc)
+    {
+      for (i=0; i<3; i++)
+      {
+        for (j=0; j<3; j++)
+        {
+          if (grid -> vect[i][j] != this_proj -> cell.box[0].vect[i][j]) rebuild = TRUE;
+        }
+      }
+    }
+    if (! rebuild) return grid;
+    clean_atom_grid (this_proj);
+  }
+  this_proj -> modelgl -> grid = create_atom_grid (this_proj, cut, 0, NULL, 0.0);
+  return this_proj -> modelgl -> grid;
+}
+
+/*!
+  \fn atom_grid * overlap_grid (project * this_proj)
+
+  \brief get the cell list to use to reject overlapping moves, if any
+
+  \param this_proj the target project
+*/
+atom_grid * overlap_grid (project * this_proj)
+{
+  if (this_proj -> modelgl -> atom_win)
+  {
+    if (this_proj -> modelgl -> atom_win -> reject_overlap && this_proj -> modelgl -> atom_win -> overlap > 0.0)
+    {
+      return get_atom_grid (this_proj, this_proj -> modelgl -> atom_win -> overlap);
+    }
+  }
+  return this_proj -> modelgl -> grid;
+}
+
+/*!
+  \fn void update_atom_grid (project * this_proj, int aid)
+
+  \brief update the cell list of a project after an atom was moved
+
+  \param this_proj the target project
+  \param aid the atom id
+*/
+void update_atom_grid (project * this_proj, int aid)
+{
+  atom_grid * grid = this_proj -> modelgl -> grid;
+  if (! grid) return;
+  if (grid -> natomes != this_proj -> natomes || aid >= grid -> natomes)
+  {
+    clean_atom_grid (this_proj);
+    return;
+  }
+  double pos[3] = {this_proj -> atoms[0][aid].x, this_proj -> atoms[0][aid].y, this_proj -> atoms[0][aid].z};
+  move_grid_point (grid, aid, pos);
+}
+
+/*!
+  \fn double grid_distance (atom_grid * grid, double * a, double * b)
+
+  \brief distance between two positions, using the minimum image convention if periodic
+
+  \param grid the target cell list
+  \param a the 1st position
+  \param b the 2nd position
+*/
+double grid_distance (atom_grid * grid, double * a, double * b)
+{
+  int i;
+  double d[3] = {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+  if (grid -> pbc)
+  {
+    double f[3];
+    for (i=0; i<3; i++)
+    {
+      f[i] = grid -> inv[0][i]*d[0] + grid -> inv[1][i]*d[1] + grid -> inv[2][i]*d[2];
+      f[i] -= round(f[i]);
+    }
+    for (i=0; i<3; i++) d[i] = f[0]*grid -> vect[0][i] + f[1]*grid -> vect[1][i] + f[2]*grid -> vect[2][i];
+  }
+  return sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]);
+}
+
+/*!
+  \fn gboolean grid_clash (atom_grid * grid, double * pos, double * old, double tol, int from, int self, gboolean * skip)
+
+  \brief is there a point closer than 'tol' from a position ?
+
+  \param grid the target cell list
+  \param pos the position to test
+  \param old the previous position, if any: points already closer than 'tol' from it are ignored
+  \param tol the overlap distance
+  \param from only test the point(s) with an id greater or equal to this value
+  \param self the id of the point to ignore, if any
+  \param skip the atom(s) to ignore, if any
+*/
+gboolean grid_clash (atom_grid * grid, double * pos, double * old, double tol, int from, int self, gboolean * skip)
+{
+  int c = grid_cell_id (grid, pos);
+  int cid[3] = {c / (grid -> n[1]*grid -> n[2]), (c / grid -> n[2]) % grid -> n[1], c % grid -> n[2]};
+  int lo[3], hi[3];
+  int h, i, j, k, l, m, p;
+  for (i=0; i<3; i++)
+  {
+    if (grid -> pbc && grid -> n[i] < 3)
+    {
+      // Every cell is a neighbor: visit each of them once
+      lo[i] = 0;
+      hi[i] = grid -> n[i] - 1;
+    }
+    else if (grid -> pbc)
+    {
+      lo[i] = cid[i] - 1;
+      hi[i] = cid[i] + 1;
+    }
+    else
+    {
+      lo[i] = max (0, cid[i] - 1);
+      hi[i] = min (grid -> n[i] - 1, cid[i] + 1);
+    }
+  }
+  for (i=lo[0]; i<=hi[0]; i++)
+  {
+    for (j=lo[1]; j<=hi[1]; j++)
+    {
+      for (k=lo[2]; k<=hi[2]; k++)
+      {
+        l = (i + grid -> n[0]) % grid -> n[0];
+        m = (j + grid -> n[1]) % grid -> n[1];
+        h = (k + grid -> n[2]) % grid -> n[2];
+        p = grid -> head[(l*grid -> n[1] + m)*grid -> n[2] + h];
+        while (p > -1)
+        {
+          if (p >= from && p != self && ! (skip && p < grid -> natomes && skip[p]))
+          {
+            if (grid_distance (grid, pos, & grid -> pos[3*p]) < tol)
+            {
+              if (! old) return TRUE;
+              if (grid_distance (grid, old, & grid -> pos[3*p]) >= tol) return TRUE;
+            }
+          }
+          p = grid -> next[p];
+        }
+      }
+    }
+  }
+  return FALSE;
+}
+
+/*!
+  \fn double * save_object_position (project * this_proj, atomic_object * object)
+
+  \brief save the position of an object: atomic coordinates, relative coordinates, then barycenter
+
+  \param this_proj the target project
+  \param object the target object
+*/
+double * save_object_position (project * this_proj, atomic_object * object)
+{
+  double * saved = allocdouble (6*object -> atoms + 3);
+  int i, j;
+  for (i=0; i<object -> atoms; i++)
+  {
+    j = object -> at_list[i].id;
+    saved[3*i] = this_proj -> atoms[0][j].x;
+    saved[3*i+1] = this_proj -> atoms[0][j].y;
+    saved[3*i+2] = this_proj -> atoms[0][j].z;
+    j = 3*(object -> atoms + i);
+    saved[j] = object -> at_list[i].x;
+    saved[j+1] = object -> at_list[i].y;
+    saved[j+2] = object -> at_list[i].z;
+  }
+  for (i=0; i<3; i++) saved[6*object -> atoms+i] = object -> baryc[i];
+  return saved;
+}
+
+/*!
+  \fn void restore_object_position (project * this_proj, atomic_object * object, double * saved)
+
+  \brief restore the position of an object
+
+  \param this_proj the target project
+  \param object the target object
+  \param saved the position saved using 'save_object_position'
+*/
+void restore_object_position (project * this_proj, atomic_object * object, double * saved)
+{
+  int i, j;
+  for (i=0; i<object -> atoms; i++)
+  {
+    j = object -> at_list[i].id;
+    this_proj -> atoms[0][j].x = saved[3*i];
+    this_proj -> atoms[0][j].y = saved[3*i+1];
+    this_proj -> atoms[0][j].z = saved[3*i+2];
+    j = 3*(object -> atoms + i);
+    object -> at_list[i].x = saved[j];
+    object -> at_list[i].y = saved[j+1];
+    object -> at_list[i].z = saved[j+2];
+  }
+  for (i=0; i<3; i++) object -> baryc[i] = saved[6*object -> atoms+i];
+}
+
+/*!
+  \fn void update_object_grid (project * this_proj, atomic_object * object)
+
+  \brief update the cell list of a project after an object was moved
+
+  \param this_proj the target project
+  \param object the target object
+*/
+void update_object_grid (project * this_proj, atomic_object * object)
+{
+  int i;
+  for (i=0; i<object -> atoms; i++) update_atom_grid (this_proj, object -> at_list[i].id);
+}
+
+/*!
+  \fn gboolean object_creates_overlap (project * this_proj, atomic_object * object, double * saved)
+
+  \brief did the motion of an object create new overlap(s) with the rest of the model ?
+
+  \param this_proj the target project
+  \param object the target object
+  \param saved the position of the object before the motion
+*/
+gboolean object_creates_overlap (project * this_proj, atomic_object * object, double * saved)
+{
+  atom_grid * grid = this_proj -> modelgl -> grid;
+  int i, j;
+  double pos[3];
+  gboolean clash = FALSE;
+  for (i=0; i<object -> atoms; i++) grid -> skip[object -> at_list[i].id] = TRUE;
+  for (i=0; i<object -> atoms; i++)
+  {
+    j = object -> at_list[i].id;
+    pos[0] = this_proj -> atoms[0][j].x;
+    pos[1] = this_proj -> atoms[0][j].y;
+    pos[2] = this_proj -> atoms[0][j].z;
+    if (grid_clash (grid, pos, & saved[3*i], this_proj -> modelgl -> atom_win -> overlap, 0, -1, grid -> skip))
+    {
+      clash = TRUE;
+      break;
+    }
+  }
+  for (i=0; i<object -> atoms; i++) grid -> skip[object -> at_list[i].id] = FALSE;
+  return clash;
+}
+
+/*!
+  \fn double object_mass (atomic_object * object)
+
+  \brief molar mass of an object, in g/mol
+
+  \param object the target object
+*/
+double object_mass (atomic_object * object)
+{
+  int i, z;
+  double mass = 0.0;
+  for (i=0; i<object -> atoms; i++)
+  {
+    z = object -> old_z[object -> at_list[i].sp];
+    if (z > 0 && z < 119) mass += set_mass_ (& z);
+  }
+  return mass;
+}
+
+/*!
+  \fn double pack_random (guint64 * state)
+
+  \brief xorshift pseudo random number in [0, 1), thread safe
+
+  \param state the state of the generator
+*/
+double pack_random (guint64 * state)
+{
+  * state ^= * state >> 12;
+  * state ^= * state << 25;
+  * state ^= * state >> 27;
+  return (double)((* state * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
+}
+
+/*!
+  \fn int pack_object_copies (project * this_proj, atomic_object * object, int copies, double density, double tol, double ** placed)
+
+  \brief pack copies of an object, randomly oriented, avoiding overlaps, return the number of copies placed
+
+  \param this_proj the target project
+  \param object the object to pack
+  \param copies the number of copies to pack
+  \param density the target density in g/cm3: \n
+                 periodic model: packing stops when the density of the box is reached, \n
+                 isolated model: the copies are packed in a cube of matching volume, \n
+                 centered on the model, or on the object if the model is empty
+  \param tol the minimum distance between inserted atom(s) and any other atom
+  \param placed the atomic coordinates of the copies placed, 3 x object -> atoms per copy
+*/
+int pack_object_copies (project * this_proj, atomic_object * object, int copies, double density, double tol, double ** placed)
+{
+  int h, i, j, k, l;
+  int nat = object -> atoms;
+  double mass = object_mass (object);
+  double center[3] = {0.0, 0.0, 0.0};
+  double edge = 0.0;
+  * placed = NULL;
+  if (nat < 1 || density <= 0.0 || copies < 1) return 0;
+  double * local = allocdouble (3*nat);
+  for (i=0; i<nat; i++)
+  {
+    local[3*i] = object -> at_list[i].x + object -> baryc[0];
+    local[3*i+1] = object -> at_list[i].y + object -> baryc[1];
+    local[3*i+2] = object -> at_list[i].z + object -> baryc[2];
+    for (j=0; j<3; j++) center[j] += local[3*i+j] / nat;
+  }
+  for (i=0; i<nat; i++)
+  {
+    for (j=0; j<3; j++) local[3*i+j] -= center[j];
+  }
+  if (! (this_proj -> cell.pbc && this_proj -> cell.has_a_box) && this_proj -> natomes)
+  {
+    // Isolated model: the copies surround the model
+    for (j=0; j<3; j++) center[j] = 0.0;
+    for (i=0; i<this_proj -> natomes; i++)
+    {
+      center[0] += this_proj -> atoms[0][i].x / this_proj -> natomes;
+      center[1] += this_proj -> atoms[0][i].y / this_proj -> natomes;
+      center[2] += this_proj -> atoms[0][i].z / this_proj -> natomes;
+    }
+  }
+  // 1 g/cm3 = 0.602214 g/mol/A3
+  if (this_proj -> cell.pbc && this_proj -> cell.has_a_box)
+  {
+    double mod = 0.0;
+    for (i=0; i<this_proj -> nspec; i++) mod += this_proj -> chemistry -> nsps[i] * this_proj -> chemistry -> chem_prop[CHEM_M][i];
+    if (mass > 0.0)
+    {
+      i = (int)floor((density*0.602214*this_proj -> cell.box[0].vol - mod) / mass);
+      copies = min (copies, max (0, i));
+    }
+    if (! copies)
+    {
+      g_free (local);
+      return 0;
+    }
+  }
+  else
+  {
+    edge = (mass > 0.0) ? cbrt(copies*mass / (density*0.602214)) : cbrt((double)copies)*(object -> dim + tol);
+  }
+  atom_grid * grid = create_atom_grid (this_proj, tol, this_proj -> natomes + copies*nat, (edge > 0.0) ? center : NULL, edge);
+  if (! grid)
+  {
+    g_free (local);
+    return 0;
+  }
+
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+#else
+  int numth = 1;
+#endif
+  int nchunk = PACK_CHUNK * numth;
+  int done = 0;
+  gint64 trials = 0;
+  gint64 max_trials = 200*(gint64)copies + 20000;
+  guint64 seed = (guint64)g_get_monotonic_time () ^ ((guint64)this_proj -> id << 32);
+  double * trial = allocdouble (3*nat*nchunk);
+  gboolean * fit = allocbool (nchunk);
+  * placed = allocdouble (3*nat*copies);
+  guint64 state;
+  double q[4], r[3][3], u[3], pos[3];
+  double * at;
+  while (done < copies && trials < max_trials)
+  {
+    // Random orientation and position for each trial, tested against the grid in parallel
+#ifdef OPENMP
+    #pragma omp parallel for num_threads(numth) private(i,j,k,state,q,r,u,pos,at) shared(nchunk,nat,seed,trials,grid,local,trial,fit,center,edge,tol)
+#endif
+    for (i=0; i<nchunk; i++)
+    {
+      state = seed + (guint64)(trials + i + 1)*0x9E3779B97F4A7C15ULL;
+      if (! state) state = 1;
+      pack_random (& state);
+      for (j=0; j<3; j++) u[j] = pack_random (& state);
+      q[0] = sqrt(1.0-u[0])*sin(2.0*pi*u[1]);
+      q[1] = sqrt(1.0-u[0])*cos(2.0*pi*u[1]);
+      q[2] = sqrt(u[0])*sin(2.0*pi*u[2]);
+      q[3] = sqrt(u[0])*cos(2.0*pi*u[2]);
+      r[0][0] = 1.0 - 2.0*(q[1]*q[1] + q[2]*q[2]);
+      r[0][1] = 2.0*(q[0]*q[1] - q[2]*q[3]);
+      r[0][2] = 2.0*(q[0]*q[2] + q[1]*q[3]);
+      r[1][0] = 2.0*(q[0]*q[1] + q[2]*q[3]);
+      r[1][1] = 1.0 - 2.0*(q[0]*q[0] + q[2]*q[2]);
+      r[1][2] = 2.0*(q[1]*q[2] - q[0]*q[3]);
+      r[2][0] = 2.0*(q[0]*q[2] - q[1]*q[3]);
+      r[2][1] = 2.0*(q[1]*q[2] + q[0]*q[3]);
+      r[2][2] = 1.0 - 2.0*(q[0]*q[0] + q[1]*q[1]);
+      for (j=0; j<3; j++) u[j] = pack_random (& state);
+      for (j=0; j<3; j++)
+      {
+        if (grid -> pbc)
+        {
+          pos[j] = u[0]*grid -> vect[0][j] + u[1]*grid -> vect[1][j] + u[2]*grid -> vect[2][j];
+        }
+        else
+        {
+          pos[j] = center[j] + (u[j] - 0.5)*edge;
+        }
+      }
+      fit[i] = TRUE;
+      for (j=0; j<nat; j++)
+      {
+        at = & trial[3*(i*nat+j)];
+        for (k=0; k<3; k++) at[k] = pos[k] + r[k][0]*local[3*j] + r[k][1]*local[3*j+1] + r[k][2]*local[3*j+2];
+        if (fit[i] && grid_clash (grid, at, NULL, tol, 0, -1, NULL)) fit[i] = FALSE;
+      }
+    }
+    // Accepted trials only need to be tested against the copies placed during this round
+    h = grid -> points;
+    for (i=0; i<nchunk && done < copies; i++)
+    {
+      if (! fit[i]) continue;
+      for (j=0; j<nat; j++)
+      {
+        if (grid_clash (grid, & trial[3*(i*nat+j)], NULL, tol, h, -1, NULL)) break;
+      }
+      if (j < nat) continue;
+      for (j=0; j<nat; j++)
+      {
+        l = 3*(done*nat+j);
+        for (k=0; k<3; k++) (* placed)[l+k] = trial[3*(i*nat+j)+k];
+        add_grid_point (grid, & trial[3*(i*nat+j)]);
+      }
+      done ++;
+    }
+    trials += nchunk;
+  }
+  g_free (trial);
+  g_free (fit);
+  g_free (local);
+  free_atom_grid (grid);
+  return done;
+}
@@ -15,7 +15,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
 /*!
 * @file atom_insert.c
-* @short Functions to insert bond(s) in a project
+* @short Functions to insert bond(s) in a project \n
+         Functions to pack copies of the object to insert
 * @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
 */
 
@@ -26,12 +27,14 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 *
 
  - The functions to insert bond(s) in a project
+ - The functions to pack copies of the object to insert
 
 *
 * List of functions:
 
   void add_bonds_to_project (project * this_proj, int removed, int nbd, int ** new_bond_list);
   void add_bonds_to_list (int ** new_bond_list, int nat, int nbd, atomic_object * object);
+  void pack_inserted_object (project * this_proj, atom_search * asearch);
   void prepare_to_instert (gchar * key, project * this_proj, atom_search * asearch, gboolean visible);
 
   G_MODULE_EXPORT void set_atoms_to_insert (GtkComboBox * box, gpointer data);
@@ -91,6 +94,71 @@ void add_bonds_to_list (int ** new_bond_list, int nat, int nbd, atomic_object *
   }
 }
 
+/*!
+  \fn void pack_inserted_object (project * this_proj, atom_search * asearch)
+
+  \brief replace the last object to insert by copies packed at the target density
+
+  \param this_proj the target project
+  \param asearch the target atom search
+*/
+void pack_inserted_object (project * this_proj, atom_search * asearch)
+{
+  atom_edition * edit = this_proj -> modelgl -> atom_win;
+  atomic_object * object = edit -> to_be_inserted[1];
+  if (! object) return;
+  while (object -> next) object = object -> next;
+  int i, j, k;
+  double * placed = NULL;
+  int copies = pack_object_copies (this_proj, object, edit -> pack_copies, edit -> pack_density, edit -> overlap, & placed);
+  gchar * str;
+  if (copies)
+  {
+    int old_size = asearch -> todo_size;
+    int * atid = duplicate_int (old_size, asearch -> todo);
+    atomic_object * obj = object;
+    for (i=0; i<copies; i++)
+    {
+      if (i)
+      {
+        obj -> next = duplicate_atomic_object (object);
+        obj -> next -> prev = obj;
+        obj = obj -> next;
+        obj -> id = obj -> prev -> id + 1;
+        asearch -> in_selection ++;
+      }
+      for (j=0; j<3; j++)
+      {
+        obj -> baryc[j] = 0.0;
+        for (k=0; k<obj -> atoms; k++) obj -> baryc[j] += placed[3*(i*obj -> atoms+k)+j] / obj -> atoms;
+      }
+      for (k=0; k<obj -> atoms; k++)
+      {
+        obj -> at_list[k].x = placed[3*(i*obj -> atoms+k)] - obj -> baryc[0];
+        obj -> at_list[k].y = placed[3*(i*obj -> atoms+k)+1] - obj -> baryc[1];
+        obj -> at_list[k].z = placed[3*(i*obj -> atoms+k)+2] - obj -> baryc[2];
+      }
+    }
+    g_free (asearch -> todo);
+    allocate_todo (asearch, obj -> id+1);
+    for (i=0; i<min(old_size, obj -> id+1); i++) asearch -> todo[i] = atid[i];
+    g_free (atid);
+    update_search_tree (asearch);
+  }
+  if (copies < edit -> pack_copies)
+  {
+    str = g_strdup_printf (_("%d out of %d copies of '%s' packed:\n"
+                             "target density reached, or no room left without overlap !"), copies, edit -> pack_copies, object -> name);
+  }
+  else
+  {
+    str = g_strdup_printf (_("%d copies of '%s' packed !"), copies, object -> name);
+  }
+  show_info (str, 0, edit -> win);
+  g_free (str);
+  if (placed) g_free (placed);
+}
+
 /*!
   \fn void prepare_to_instert (gchar * key, project * this_proj, atom_search * asearch, gboolean visible)
 
@@ -104,7 +172,11 @@ void add_bonds_to_list (int ** new_bond_list, int nat, int nbd, atomic_object *
 void prepare_to_instert (gchar * key, project * this_proj, atom_search * asearch, gboolean visible)
 {
   int i = get_selected_object_id (visible, this_proj -> id, key, asearch);
-  if (i == FROM_PROJECT || i == FROM_DATA || i > 0) to_insert_in_project (i, -1, this_proj, asearch, visible);
+  if (i == FROM_PROJECT || i == FROM_DATA || i > 0)
+  {
+    to_insert_in_project (i, -1, this_proj, asearch, visible);
+    if (visible && asearch -> action == INSERT && this_proj -> modelgl -> atom_win -> pack_copies > 1) pack_inserted_object (this_proj, asearch);
+  }
 }
 
 /*!
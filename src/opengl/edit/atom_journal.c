@@ -0,0 +1,861 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file atom_journal.c
+* @short Functions to record the atomic displacements, removals and insertions of the model edition \n
+         Functions to undo / redo the model edition steps
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'atom_journal.c'
+*
+* Contains:
+*
+
+ - The functions to record the atomic displacements, removals and insertions of the model edition
+ - The functions to undo / redo the model edition steps
+
+ Each step only stores the atom(s) it changed: for a motion the coordinates,
+ before and after the step, of the moved atom(s), for a removal or an insertion
+ the atom(s) removed or inserted, with their chemical species and bonds.
+ Undo / redo are therefore proportional to the number of atom(s) changed.
+ Atoms are identified by a journal key that does not change when atom(s)
+ are removed or inserted, and that is converted to the atom ID on replay.
+ Undoing a removal inserts the atom(s) back at the end of the atom list.
+ Steps opened while a batch is running are undone / redone together,
+ successive steps of the same kind are folded into a single step,
+ and the bonding is only recomputed once, when the batch is closed.
+
+*
+* List of functions:
+
+  gboolean end_edit_batch (project * this_proj);
+  gboolean is_edit_replay (project * this_proj);
+  gboolean replay_edit_step (project * this_proj, edit_delta * step, int way);
+
+  int new_edit_key (edit_journal * journal);
+  int undo_edit_steps (project * this_proj, int steps);
+  int redo_edit_steps (project * this_proj, int steps);
+
+  void free_edit_object (atomic_object * object);
+  void free_edit_steps (edit_delta * step);
+  void clean_edit_journal (project * this_proj);
+  void reset_edit_slots (edit_journal * journal);
+  void remove_edit_keys (edit_journal * journal, int * todo);
+  void append_edit_keys (edit_journal * journal, int atoms, int * keys);
+  void record_edit_removal (project * this_proj, int * todo);
+  void record_edit_insertion (project * this_proj, int atoms);
+  void replay_edit_removal (project * this_proj, edit_delta * step);
+  void replay_edit_insertion (project * this_proj, edit_delta * step);
+  void begin_edit_batch (project * this_proj);
+  void recompute_edit_bonding (project * this_proj);
+  void open_edit_step (project * this_proj, int action);
+  void record_edit_atom (project * this_proj, int aid);
+  void close_edit_step (project * this_proj, gboolean bonding);
+  void seal_edit_step (edit_journal * journal);
+  void refresh_after_journal (project * this_proj, gboolean bonding);
+
+  G_MODULE_EXPORT void undo_edit (GtkButton * but, gpointer data);
+  G_MODULE_EXPORT void redo_edit (GtkButton * but, gpointer data);
+
+  edit_journal * get_edit_journal (project * this_proj);
+
+  atomic_object * create_edit_object (project * this_proj, int atoms, int * list);
+
+*/
+
+#include "atom_edit.h"
+
+/*!
+  \fn void free_edit_object (atomic_object * object)
+
+  \brief free the atom(s) removed or inserted during a step
+
+  \param object the object to free
+*/
+void free_edit_object (atomic_object * object)
+{
+  if (! object) return;
+  int i;
+  for (i=0; i<object -> atoms; i++) g_free (object -> at_list[i].vois);
+  for (i=0; i<object -> bonds; i++) g_free (object -> ibonds[i]);
+  g_free (object -> ibonds);
+  g_free (object -> at_list);
+  g_free (object -> old_z);
+  g_free (object -> coord);
+  g_free (object -> baryc);
+  g_free (object -> bcid);
+  g_free (object -> name);
+  g_free (object);
+}
+
+/*!
+  \fn void free_edit_steps (edit_delta * step)
+
+  \brief free a step and all the following steps of the journal
+
+  \param step the first step to free
+*/
+void free_edit_steps (edit_delta * step)
+{
+  edit_delta * next;
+  while (step)
+  {
+    next = step -> next;
+    g_free (step -> aid);
+    g_free (step -> xyz[0]);
+    g_free (step -> xyz[1]);
+    free_edit_object (step -> object);
+    g_free (step);
+    step = next;
+  }
+}
+
+/*!
+  \fn void clean_edit_journal (project * this_proj)
+
+  \brief free the model edition journal
+
+  \param this_proj the target project
+*/
+void clean_edit_journal (project * this_proj)
+{
+  if (! this_proj -> modelgl) return;
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (journal)
+  {
+    free_edit_steps (journal -> first);
+    g_free (journal -> slot);
+    g_free (journal -> key);
+    g_free (journal -> pos);
+    g_free (journal);
+    this_proj -> modelgl -> journal = NULL;
+  }
+}
+
+/*!
+  \fn edit_journal * get_edit_journal (project * this_proj)
+
+  \brief get the model edition journal, create it if required
+
+  \param this_proj the target project
+*/
+edit_journal * get_edit_journal (project * this_proj)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  int batch = 0;
+  int group = 0;
+  gboolean pending = FALSE;
+  if (journal && journal -> natomes != this_proj -> natomes)
+  {
+    // The atom IDs recorded in the journal are no longer valid
+    batch = journal -> batch;
+    group = journal -> group;
+    pending = journal -> pending;
+    clean_edit_journal (this_proj);
+    journal = NULL;
+  }
+  if (! journal)
+  {
+    int i;
+    journal = g_malloc0(sizeof*journal);
+    journal -> natomes = journal -> keys = this_proj -> natomes;
+    journal -> slot = allocint (this_proj -> natomes);
+    journal -> key = allocint (this_proj -> natomes);
+    journal -> pos = allocint (this_proj -> natomes);
+    for (i=0; i<this_proj -> natomes; i++)
+    {
+      journal -> slot[i] = -1;
+      journal -> key[i] = journal -> pos[i] = i;
+    }
+    journal -> batch = batch;
+    journal -> group = group;
+    journal -> pending = pending;
+    this_proj -> modelgl -> journal = journal;
+  }
+  return journal;
+}
+
+/*!
+  \fn gboolean is_edit_replay (project * this_proj)
+
+  \brief is an undo / redo in progress, nothing to record then
+
+  \param this_proj the target project
+*/
+gboolean is_edit_replay (project * this_proj)
+{
+  if (! this_proj -> modelgl) return FALSE;
+  if (! this_proj -> modelgl -> journal) return FALSE;
+  return this_proj -> modelgl -> journal -> replay;
+}
+
+/*!
+  \fn void reset_edit_slots (edit_journal * journal)
+
+  \brief reset the open step positions after the number of atom(s) changed
+
+  \param journal the target journal
+*/
+void reset_edit_slots (edit_journal * journal)
+{
+  int i;
+  g_free (journal -> slot);
+  journal -> slot = allocint (journal -> natomes);
+  for (i=0; i<journal -> natomes; i++) journal -> slot[i] = -1;
+}
+
+/*!
+  \fn int new_edit_key (edit_journal * journal)
+
+  \brief create a journal key for a new atom
+
+  \param journal the target journal
+*/
+int new_edit_key (edit_journal * journal)
+{
+  journal -> pos = g_realloc (journal -> pos, (journal -> keys+1)*sizeof*journal -> pos);
+  journal -> pos[journal -> keys] = -1;
+  journal -> keys ++;
+  return journal -> keys - 1;
+}
+
+/*!
+  \fn void remove_edit_keys (edit_journal * journal, int * todo)
+
+  \brief remove atom(s) from the journal keys, the other atom(s) keep their order
+
+  \param journal the target journal
+  \param todo for each atom, 1 if removed, 0 otherwise
+*/
+void remove_edit_keys (edit_journal * journal, int * todo)
+{
+  int i, j;
+  j = 0;
+  for (i=0; i<journal -> natomes; i++)
+  {
+    if (todo[i])
+    {
+      journal -> pos[journal -> key[i]] = -1;
+    }
+    else
+    {
+      journal -> key[j] = journal -> key[i];
+      journal -> pos[journal -> key[j]] = j;
+      j ++;
+    }
+  }
+  journal -> natomes = j;
+  reset_edit_slots (journal);
+}
+
+/*!
+  \fn void append_edit_keys (edit_journal * journal, int atoms, int * keys)
+
+  \brief add atom(s) at the end of the journal keys
+
+  \param journal the target journal
+  \param atoms the number of atom(s) to add
+  \param keys the journal key(s) of the atom(s) to add
+*/
+void append_edit_keys (edit_journal * journal, int atoms, int * keys)
+{
+  int i;
+  journal -> key = g_realloc (journal -> key, (journal -> natomes+atoms)*sizeof*journal -> key);
+  for (i=0; i<atoms; i++)
+  {
+    journal -> key[journal -> natomes+i] = keys[i];
+    journal -> pos[keys[i]] = journal -> natomes+i;
+  }
+  journal -> natomes += atoms;
+  reset_edit_slots (journal);
+}
+
+/*!
+  \fn void begin_edit_batch (project * this_proj)
+
+  \brief start a batch of edition(s), undone / redone together, the bonding is recomputed once at the end
+
+  \param this_proj the target project
+*/
+void begin_edit_batch (project * this_proj)
+{
+  edit_journal * journal = get_edit_journal (this_proj);
+  if (! journal -> batch) journal -> group ++;
+  journal -> batch ++;
+}
+
+/*!
+  \fn void recompute_edit_bonding (project * this_proj)
+
+  \brief recompute the bonding, or postpone it if a batch is running
+
+  \param this_proj the target project
+*/
+void recompute_edit_bonding (project * this_proj)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (journal && journal -> batch)
+  {
+    journal -> pending = TRUE;
+  }
+  else
+  {
+    int i = activep;
+    active_project_changed (activep);
+    bonds_update = 1;
+    frag_update = mol_update = 1;
+    active_project -> runc[0] = FALSE;
+    on_calc_bonds_released (NULL, NULL);
+    active_project_changed (i);
+  }
+}
+
+/*!
+  \fn void seal_edit_step (edit_journal * journal)
+
+  \brief close the step being recorded, if any
+
+  \param journal the target journal
+*/
+void seal_edit_step (edit_journal * journal)
+{
+  edit_delta * step = journal -> open;
+  if (! step) return;
+  int i;
+  if (step -> action == DISPL || step -> action == RANMOVE)
+  {
+    for (i=0; i<step -> atoms; i++) journal -> slot[journal -> pos[step -> aid[i]]] = -1;
+  }
+  journal -> open = NULL;
+  if (! step -> atoms)
+  {
+    // Nothing was moved, drop the step
+    journal -> last = step -> prev;
+    if (journal -> last)
+    {
+      journal -> last -> next = NULL;
+    }
+    else
+    {
+      journal -> first = NULL;
+    }
+    journal -> steps --;
+    free_edit_steps (step);
+  }
+}
+
+/*!
+  \fn gboolean end_edit_batch (project * this_proj)
+
+  \brief end a batch of edition(s), return TRUE if the bonding was recomputed
+
+  \param this_proj the target project
+*/
+gboolean end_edit_batch (project * this_proj)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (! journal || ! journal -> batch) return FALSE;
+  journal -> batch --;
+  if (journal -> batch) return FALSE;
+  seal_edit_step (journal);
+  if (journal -> pending)
+  {
+    journal -> pending = FALSE;
+    recompute_edit_bonding (this_proj);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/*!
+  \fn void open_edit_step (project * this_proj, int action)
+
+  \brief start recording a new edition step
+
+  \param this_proj the target project
+  \param action the edition action: DISPL, RANMOVE, REMOVE or INSERT
+*/
+void open_edit_step (project * this_proj, int action)
+{
+  edit_journal * journal = get_edit_journal (this_proj);
+  if (journal -> open)
+  {
+    // Within a batch, successive steps of the same kind are folded together
+    if (journal -> open -> action == action) return;
+    seal_edit_step (journal);
+  }
+  // A new step invalidates the step(s) previously undone
+  if (journal -> last)
+  {
+    free_edit_steps (journal -> last -> next);
+    journal -> last -> next = NULL;
+  }
+  else
+  {
+    free_edit_steps (journal -> first);
+    journal -> first = NULL;
+  }
+  journal -> steps = 0;
+  edit_delta * step = journal -> first;
+  while (step)
+  {
+    journal -> steps ++;
+    step = step -> next;
+  }
+  if (journal -> steps == MAX_EDIT_STEPS)
+  {
+    step = journal -> first;
+    journal -> first = step -> next;
+    journal -> first -> prev = NULL;
+    step -> next = NULL;
+    free_edit_steps (step);
+    journal -> steps --;
+  }
+  step = g_malloc0(sizeof*step);
+  step -> action = action;
+  step -> group = (journal -> batch) ? journal -> group : 0;
+  step -> prev = journal -> last;
+  if (journal -> last)
+  {
+    journal -> last -> next = step;
+  }
+  else
+  {
+    journal -> first = step;
+  }
+  journal -> last = journal -> open = step;
+  journal -> steps ++;
+}
+
+/*!
+  \fn void record_edit_atom (project * this_proj, int aid)
+
+  \brief record the coordinates of an atom before it is moved
+
+  \param this_proj the target project
+  \param aid the atom id
+*/
+void record_edit_atom (project * this_proj, int aid)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (! journal || ! journal -> open || journal -> slot[aid] > -1) return;
+  edit_delta * step = journal -> open;
+  int i;
+  if (step -> atoms == step -> size)
+  {
+    step -> size = (step -> size) ? 2*step -> size : 64;
+    step -> aid = g_realloc (step -> aid, step -> size*sizeof*step -> aid);
+    for (i=0; i<2; i++) step -> xyz[i] = g_realloc (step -> xyz[i], 3*step -> size*sizeof*step -> xyz[i]);
+  }
+  i = step -> atoms;
+  step -> aid[i] = journal -> key[aid];
+  step -> xyz[0][3*i] = this_proj -> atoms[0][aid].x;
+  step -> xyz[0][3*i+1] = this_proj -> atoms[0][aid].y;
+  step -> xyz[0][3*i+2] = this_proj -> atoms[0][aid].z;
+  journal -> slot[aid] = i;
+  step -> atoms ++;
+}
+
+/*!
+  \fn void close_edit_step (project * this_proj, gboolean bonding)
+
+  \brief record the coordinates of the atom(s) moved during the step
+
+  \param this_proj the target project
+  \param bonding was the bonding recomputed
+*/
+void close_edit_step (project * this_proj, gboolean bonding)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (! journal || ! journal -> open) return;
+  edit_delta * step = journal -> open;
+  int i, j;
+  for (i=0; i<step -> atoms; i++)
+  {
+    j = journal -> pos[step -> aid[i]];
+    step -> xyz[1][3*i] = this_proj -> atoms[0][j].x;
+    step -> xyz[1][3*i+1] = this_proj -> atoms[0][j].y;
+    step -> xyz[1][3*i+2] = this_proj -> atoms[0][j].z;
+    update_atom_grid (this_proj, j);
+  }
+  if (bonding) step -> bonding = TRUE;
+  if (! journal -> batch) seal_edit_step (journal);
+}
+
+/*!
+  \fn void refresh_after_journal (project * this_proj, gboolean bonding)
+
+  \brief refresh the model after undo / redo
+
+  \param this_proj the target project
+  \param bonding recompute the bonding
+*/
+void refresh_after_journal (project * this_proj, gboolean bonding)
+{
+  if (bonding)
+  {
+    recompute_edit_bonding (this_proj);
+#ifdef GTK3
+    // GTK3 Menu Action To Check
+    set_advanced_bonding_menus (this_proj -> modelgl);
+#endif
+    if (is_atom_win_active (this_proj -> modelgl))
+    {
+      trigger_refresh (this_proj, this_proj -> modelgl -> search_widg[2]);
+      trigger_refresh (this_proj, this_proj -> modelgl -> search_widg[6]);
+    }
+  }
+  this_proj -> modelgl -> was_moved = TRUE;
+  init_default_shaders (this_proj -> modelgl);
+  update (this_proj -> modelgl);
+}
+
+/*!
+  \fn atomic_object * create_edit_object (project * this_proj, int atoms, int * list)
+
+  \brief create the object that stores the atom(s) of a removal or an insertion
+
+  \param this_proj the target project
+  \param atoms the number of atom(s)
+  \param list the list of atom ID(s), in increasing order
+*/
+atomic_object * create_edit_object (project * this_proj, int atoms, int * list)
+{
+  int i, j;
+  gboolean bonding = FALSE;
+  atomic_object * object = g_malloc0(sizeof*object);
+  object -> name = g_strdup_printf ("%s", this_proj -> name);
+  object -> type = FROM_DATA;
+  object -> origin = this_proj -> id;
+  object -> atoms = atoms;
+  object -> at_list = g_malloc0(object -> atoms*sizeof*object -> at_list);
+  object -> occ = 1.0;
+  object -> coord = duplicate_coord_info (this_proj -> coord);
+  object -> species = this_proj -> nspec;
+  object -> old_z = duplicate_z (this_proj -> nspec, this_proj -> chemistry -> chem_prop[CHEM_Z]);
+  int * new_id = allocint (this_proj -> natomes);
+  for (i=0; i<atoms; i++)
+  {
+    j = list[i];
+    new_id[j] = i+1;
+    if (this_proj -> atoms[0][j].numv) bonding = TRUE;
+    object -> at_list[i] = * duplicate_atom (& this_proj -> atoms[0][j]);
+    if (i)
+    {
+      object -> at_list[i].prev = & object -> at_list[i-1];
+      object -> at_list[i-1].next = & object -> at_list[i];
+    }
+  }
+  // Only the bonds between atoms of the object are kept, the coordinates are not modified using PBC
+  if (bonding) clean_object_bonds (this_proj, 0, object, new_id, FALSE);
+  correct_pos_and_get_dim (object, TRUE);
+  if (bonding) check_coord_modification (this_proj, NULL, & object -> at_list[0], object, FALSE, FALSE);
+  g_free (new_id);
+  return object;
+}
+
+/*!
+  \fn void record_edit_removal (project * this_proj, int * todo)
+
+  \brief record the atom(s) to be removed, before the removal
+
+  \param this_proj the target project
+  \param todo for each atom, 1 if to be removed, 0 otherwise
+*/
+void record_edit_removal (project * this_proj, int * todo)
+{
+  if (! this_proj -> modelgl || is_edit_replay (this_proj)) return;
+  int i, j;
+  j = 0;
+  for (i=0; i<this_proj -> natomes; i++) if (todo[i]) j ++;
+  if (! j) return;
+  edit_journal * journal = get_edit_journal (this_proj);
+  int * list = allocint (j);
+  j = 0;
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    if (todo[i])
+    {
+      list[j] = i;
+      j ++;
+    }
+  }
+  seal_edit_step (journal);
+  open_edit_step (this_proj, REMOVE);
+  edit_delta * step = journal -> open;
+  step -> atoms = step -> size = j;
+  step -> aid = allocint (j);
+  for (i=0; i<j; i++) step -> aid[i] = journal -> key[list[i]];
+  step -> object = create_edit_object (this_proj, j, list);
+  step -> bonding = TRUE;
+  journal -> open = NULL;
+  remove_edit_keys (journal, todo);
+  g_free (list);
+}
+
+/*!
+  \fn void record_edit_insertion (project * this_proj, int atoms)
+
+  \brief record the atom(s) inserted at the end of the atom list, after the insertion
+
+  \param this_proj the target project
+  \param atoms the number of atom(s) inserted
+*/
+void record_edit_insertion (project * this_proj, int atoms)
+{
+  if (! this_proj -> modelgl || is_edit_replay (this_proj)) return;
+  if (! atoms) return;
+  if (atoms == this_proj -> natomes)
+  {
+    // Nothing to go back to
+    clean_edit_journal (this_proj);
+    return;
+  }
+  int i;
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (journal && journal -> natomes == this_proj -> natomes - atoms)
+  {
+    int * keys = allocint (atoms);
+    for (i=0; i<atoms; i++) keys[i] = new_edit_key (journal);
+    append_edit_keys (journal, atoms, keys);
+    g_free (keys);
+  }
+  else
+  {
+    // Keys are created for all atom(s), including the new one(s)
+    journal = get_edit_journal (this_proj);
+  }
+  int * list = allocint (atoms);
+  for (i=0; i<atoms; i++) list[i] = this_proj -> natomes - atoms + i;
+  seal_edit_step (journal);
+  open_edit_step (this_proj, INSERT);
+  edit_delta * step = journal -> open;
+  step -> atoms = step -> size = atoms;
+  step -> aid = allocint (atoms);
+  for (i=0; i<atoms; i++) step -> aid[i] = journal -> key[list[i]];
+  step -> object = create_edit_object (this_proj, atoms, list);
+  step -> bonding = TRUE;
+  journal -> open = NULL;
+  g_free (list);
+}
+
+/*!
+  \fn void replay_edit_removal (project * this_proj, edit_delta * step)
+
+  \brief remove the atom(s) of a removal or insertion step
+
+  \param this_proj the target project
+  \param step the target step
+*/
+void replay_edit_removal (project * this_proj, edit_delta * step)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  int i;
+  atom_search * asearch = allocate_atom_search (this_proj -> id, REMOVE, REMOVE, this_proj -> natomes);
+  for (i=0; i<step -> atoms; i++) asearch -> todo[journal -> pos[step -> aid[i]]] = 1;
+  asearch -> in_selection = step -> atoms;
+  asearch -> recompute_bonding = step -> bonding;
+  action_atoms_from_project (this_proj, asearch, this_proj -> modelgl -> atom_win -> visible);
+  remove_edit_keys (journal, asearch -> todo);
+  if (this_proj -> modelgl -> atom_win -> visible) clean_all_trees (asearch, this_proj);
+  clean_other_window_after_edit (this_proj);
+  g_free (asearch -> todo);
+  g_free (asearch -> lab);
+  g_free (asearch -> pick);
+  g_free (asearch);
+}
+
+/*!
+  \fn void replay_edit_insertion (project * this_proj, edit_delta * step)
+
+  \brief insert the atom(s) of a removal or insertion step, at the end of the atom list
+
+  \param this_proj the target project
+  \param step the target step
+*/
+void replay_edit_insertion (project * this_proj, edit_delta * step)
+{
+  atom_edition * edit = this_proj -> modelgl -> atom_win;
+  // Object(s) waiting to be inserted by the user, if any
+  atomic_object * waiting = edit -> to_be_inserted[1];
+  atom_search * asearch = allocate_atom_search (this_proj -> id, INSERT, 5, 0);
+  allocate_todo (asearch, 1);
+  asearch -> todo[0] = 1;
+  asearch -> in_selection = 1;
+  asearch -> recompute_bonding = step -> bonding;
+  edit -> to_be_inserted[1] = duplicate_atomic_object (step -> object);
+  edit -> to_be_inserted[1] -> id = 0;
+  action_atoms_from_project (this_proj, asearch, edit -> visible);
+  edit -> to_be_inserted[1] = waiting;
+  append_edit_keys (this_proj -> modelgl -> journal, step -> atoms, step -> aid);
+  if (edit -> visible) clean_all_trees (asearch, this_proj);
+  clean_other_window_after_edit (this_proj);
+  g_free (asearch -> todo);
+  g_free (asearch -> lab);
+  g_free (asearch -> pick);
+  g_free (asearch);
+}
+
+/*!
+  \fn gboolean replay_edit_step (project * this_proj, edit_delta * step, int way)
+
+  \brief undo or redo a step, return TRUE if the bonding needs to be recomputed
+
+  \param this_proj the target project
+  \param step the target step
+  \param way 0 = undo, 1 = redo
+*/
+gboolean replay_edit_step (project * this_proj, edit_delta * step, int way)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  int i, j;
+  switch (step -> action)
+  {
+    case REMOVE:
+      if (way)
+      {
+        replay_edit_removal (this_proj, step);
+      }
+      else
+      {
+        replay_edit_insertion (this_proj, step);
+      }
+      return FALSE;
+      break;
+    case INSERT:
+      if (way)
+      {
+        replay_edit_insertion (this_proj, step);
+      }
+      else
+      {
+        replay_edit_removal (this_proj, step);
+      }
+      return FALSE;
+      break;
+    default:
+      for (i=0; i<step -> atoms; i++)
+      {
+        j = journal -> pos[step -> aid[i]];
+        this_proj -> atoms[0][j].x = step -> xyz[way][3*i];
+        this_proj -> atoms[0][j].y = step -> xyz[way][3*i+1];
+        this_proj -> atoms[0][j].z = step -> xyz[way][3*i+2];
+        update_atom_grid (this_proj, j);
+      }
+      return step -> bonding;
+      break;
+  }
+}
+
+/*!
+  \fn int undo_edit_steps (project * this_proj, int steps)
+
+  \brief undo edition step(s), return the number of step(s) undone
+
+  \param this_proj the target project
+  \param steps the number of step(s) to undo
+*/
+int undo_edit_steps (project * this_proj, int steps)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (! journal || journal -> natomes != this_proj -> natomes) return 0;
+  // Atom(s) are removed / inserted using the model edition window
+  if (! this_proj -> modelgl -> atom_win) return 0;
+  seal_edit_step (journal);
+  int i, group;
+  gboolean bonding = FALSE;
+  edit_delta * step;
+  journal -> replay = TRUE;
+  for (i=0; i<steps && journal -> last; i++)
+  {
+    group = journal -> last -> group;
+    do
+    {
+      step = journal -> last;
+      if (replay_edit_step (this_proj, step, 0)) bonding = TRUE;
+      journal -> last = step -> prev;
+    } while (group && journal -> last && journal -> last -> group == group);
+  }
+  journal -> replay = FALSE;
+  if (i) refresh_after_journal (this_proj, bonding);
+  return i;
+}
+
+/*!
+  \fn int redo_edit_steps (project * this_proj, int steps)
+
+  \brief redo edition step(s), return the number of step(s) redone
+
+  \param this_proj the target project
+  \param steps the number of step(s) to redo
+*/
+int redo_edit_steps (project * this_proj, int steps)
+{
+  edit_journal * journal = this_proj -> modelgl -> journal;
+  if (! journal || journal -> natomes != this_proj -> natomes) return 0;
+  // Atom(s) are removed / inserted using the model edition window
+  if (! this_proj -> modelgl -> atom_win) return 0;
+  seal_edit_step (journal);
+  int i, group;
+  gboolean bonding = FALSE;
+  edit_delta * step;
+  journal -> replay = TRUE;
+  for (i=0; i<steps; i++)
+  {
+    step = (journal -> last) ? journal -> last -> next : journal -> first;
+    if (! step) break;
+    group = step -> group;
+    do
+    {
+      if (replay_edit_step (this_proj, step, 1)) bonding = TRUE;
+      journal -> last = step;
+      step = step -> next;
+    } while (group && step && step -> group == group);
+  }
+  journal -> replay = FALSE;
+  if (i) refresh_after_journal (this_proj, bonding);
+  return i;
+}
+
+/*!
+  \fn G_MODULE_EXPORT void undo_edit (GtkButton * but, gpointer data)
+
+  \brief undo the last edition step callback
+
+  \param but the GtkButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void undo_edit (GtkButton * but, gpointer data)
+{
+  project * this_proj = get_project_by_id (GPOINTER_TO_INT(data));
+  undo_edit_steps (this_proj, 1);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void redo_edit (GtkButton * but, gpointer data)
+
+  \brief redo the last edition step undone callback
+
+  \param but the GtkButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void redo_edit (GtkButton * but, gpointer data)
+{
+  project * this_proj = get_project_by_id (GPOINTER_TO_INT(data));
+  redo_edit_steps (this_proj, 1);
+}
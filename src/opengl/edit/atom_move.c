@@ -146,6 +146,7 @@ void reset_coordinates (project * this_proj, int status)
   i = 0;
   if (this_proj -> modelgl -> saved_coord[status] != NULL)
   {
+    clean_atom_grid (this_proj);
     for (j=0; j<this_proj -> natomes; j++)
     {
       if (this_proj -> atoms[0][j].pick[0] == status || status > 1)
@@ -231,6 +232,7 @@ void translate (project * this_proj, int status, int axis, vec3_t trans)
 {
   int i, j;
   vec3_t c_old, c_new;
+  clean_atom_grid (this_proj);
   for (i=0; i<this_proj -> steps; i++)
   {
     for (j=0; j<this_proj -> natomes; j++)
@@ -271,6 +273,7 @@ void rotate_quat (project * this_proj, vec4_t q, int status, int axis)
   int j;
   mat4_t rot = m4_quat_rotation (q);
   vec3_t c_old, c_new;
+  clean_atom_grid (this_proj);
   for (j=0; j<this_proj -> natomes; j++)
   {
     if (this_proj -> atoms[0][j].pick[0] == status)
@@ -328,6 +331,8 @@ void rotate (project * this_proj, int status, int axis, int raxis, float param)
 void random_move_this_atom (project * this_proj, int aid)
 {
   int i, j, k, l;
+  atom_grid * grid = overlap_grid (this_proj);
+  double old[3] = {this_proj -> atoms[0][aid].x, this_proj -> atoms[0][aid].y, this_proj -> atoms[0][aid].z};
   // Using CPU time to randomize
   clock_t begin = clock();
   double prob;
@@ -352,6 +357,21 @@ void random_move_this_atom (project * this_proj, int aid)
         break;
     }
   }
+  if (grid)
+  {
+    double pos[3] = {this_proj -> atoms[0][aid].x, this_proj -> atoms[0][aid].y, this_proj -> atoms[0][aid].z};
+    if (this_proj -> modelgl -> atom_win -> reject_overlap && grid_clash (grid, pos, old, this_proj -> modelgl -> atom_win -> overlap, 0, aid, NULL))
+    {
+      // The move creates an overlap: rejected
+      this_proj -> atoms[0][aid].x = old[0];
+      this_proj -> atoms[0][aid].y = old[1];
+      this_proj -> atoms[0][aid].z = old[2];
+    }
+    else
+    {
+      move_grid_point (grid, aid, pos);
+    }
+  }
 }
 
 /*!
@@ -528,6 +548,7 @@ gboolean rebuild_selection (project * this_proj, atom_search * asearch, int filt
   i = (asearch -> action == DISPL) ? 0 : 1;
   if (asearch -> object && this_proj -> modelgl -> rebuild[0][i])
   {
+    clean_atom_grid (this_proj);
     int * saved_todo = duplicate_int (asearch -> todo_size, asearch -> todo);
     int old_tds = asearch -> todo_size;
     g_free (asearch -> todo);
@@ -614,6 +635,8 @@ gboolean rebuild_selection (project * this_proj, atom_search * asearch, int filt
 gboolean random_move_objects (project * this_proj, atom_search * asearch, int numo, int filter, int obj)
 {
   atomic_object * object = this_proj -> modelgl -> atom_win -> to_be_moved[1];
+  atom_grid * grid;
+  double * saved;
   float v;
   int i, j, k;
   gboolean recons = FALSE;
@@ -629,9 +652,25 @@ gboolean random_move_objects (project * this_proj, atom_search * asearch, int nu
       v  =  (obj && filter > 2) ? this_proj -> modelgl -> atom_win -> msd_all[i] : this_proj -> modelgl -> atom_win -> msd[i];
       if (v > 0.0)
       {
+        for (j=0; j<object -> atoms; j++) record_edit_atom (this_proj, object -> at_list[j].id);
+        grid = overlap_grid (this_proj);
         for (j=0; j<this_proj -> modelgl -> atom_win -> repeat_move; j++)
         {
+          saved = (grid) ? save_object_position (this_proj, object) : NULL;
           random_move_this_object (this_proj, object, asearch -> todo[i], v);
+          if (saved)
+          {
+            if (this_proj -> modelgl -> atom_win -> reject_overlap && object_creates_overlap (this_proj, object, saved))
+            {
+              // The move creates an overlap: rejected
+              restore_object_position (this_proj, object, saved);
+            }
+            else
+            {
+              update_object_grid (this_proj, object);
+            }
+            g_free (saved);
+          }
         }
         for (j=0; j<object -> atoms; j++)
         {
@@ -660,6 +699,8 @@ void random_move (project * this_proj, atom_search * asearch)
   int filter = get_asearch_filter (asearch);
   int i, j;
   gboolean recons = FALSE;
+  begin_edit_batch (this_proj);
+  open_edit_step (this_proj, RANMOVE);
   if (this_proj -> modelgl -> atom_win -> to_be_moved[1])
   {
     recons = random_move_objects (this_proj, asearch, asearch -> todo_size, filter, obj);
@@ -675,22 +716,14 @@ void random_move (project * this_proj, atom_search * asearch)
     {
       if (asearch -> todo[i] && this_proj -> modelgl -> atom_win -> msd[i] > 0.0)
       {
+        record_edit_atom (this_proj, i);
         for (j=0; j<this_proj -> modelgl -> atom_win -> repeat_move; j++) random_move_this_atom (this_proj, i);
       }
     }
   }
-  if (asearch -> recompute_bonding)
-  {
-    i = activep;
-    active_project_changed (activep);
-    bonds_update = 1;
-    frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-    mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
-    active_project -> runc[0] = FALSE;
-    on_calc_bonds_released (NULL, NULL);
-    active_project_changed (i);
-    recons = TRUE;
-  }
+  if (asearch -> recompute_bonding) recompute_edit_bonding (this_proj);
+  close_edit_step (this_proj, asearch -> recompute_bonding);
+  if (end_edit_batch (this_proj)) recons = TRUE;
   this_proj -> modelgl -> was_moved = TRUE;
   init_default_shaders (this_proj -> modelgl);
 #ifdef GTK3
@@ -846,6 +879,7 @@ gboolean move_objects (project * this_proj, atom_search * asearch, int action, i
   int i, j;
   while (object)
   {
+    for (i=0; i<object -> atoms; i++) record_edit_atom (this_proj, object -> at_list[i].id);
     if (action < 3)
     {
       translate_this_object (this_proj, object, axis, trans);
@@ -886,6 +920,8 @@ void move_selection (project * this_proj, int action, int axis, vec3_t trans, fl
   if (move_it)
   {
     int i;
+    begin_edit_batch (this_proj);
+    open_edit_step (this_proj, DISPL);
     if (this_proj -> modelgl -> atom_win -> to_be_moved[0])
     {
       recons = move_objects (this_proj, asearch, action, axis, trans, ang);
@@ -901,22 +937,14 @@ void move_selection (project * this_proj, int action, int axis, vec3_t trans, fl
       {
         if (asearch -> todo[i])
         {
+          record_edit_atom (this_proj, i);
           translate_this_atom (this_proj, i, axis, trans);
         }
       }
     }
-    if (asearch -> recompute_bonding)
-    {
-      i = activep;
-      active_project_changed (activep);
-      bonds_update = 1;
-      frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-      mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
-      active_project -> runc[0] = FALSE;
-      on_calc_bonds_released (NULL, NULL);
-      active_project_changed (i);
-      recons = TRUE;
-    }
+    if (asearch -> recompute_bonding) recompute_edit_bonding (this_proj);
+    close_edit_step (this_proj, asearch -> recompute_bonding);
+    if (end_edit_batch (this_proj)) recons = TRUE;
     init_default_shaders (this_proj -> modelgl);
 #ifdef GTK3
     // GTK3 Menu Action To Check
@@ -34,9 +34,15 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void turn_rebuild_on (GtkToggleButton * but, gpointer data);
   G_MODULE_EXPORT void turn_bonding_on (GtkCheckButton * but, gpointer data);
   G_MODULE_EXPORT void turn_bonding_on (GtkToggleButton * but, gpointer data);
+  G_MODULE_EXPORT void turn_overlap_on (GtkCheckButton * but, gpointer data);
+  G_MODULE_EXPORT void turn_overlap_on (GtkToggleButton * but, gpointer data);
+  G_MODULE_EXPORT void set_overlap_distance (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_pack_density (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_pack_copies (GtkSpinButton * res, gpointer data);
   G_MODULE_EXPORT void set_atoms_for_action (GtkComboBox * box, gpointer data);
   G_MODULE_EXPORT void expanding_atoms (GtkWidget * exp, gpointer data);
 
+  GtkWidget * overlap_entry (project * this_proj, atom_search * asearch);
   GtkWidget * create_search_box (int aid, project * this_proj);
   GtkWidget * create_action_combo (int id, project * this_proj);
   GtkWidget * action_tab (int aid, project * this_proj);
@@ -101,6 +107,97 @@ G_MODULE_EXPORT void turn_bonding_on (GtkToggleButton * but, gpointer data)
   asearch -> recompute_bonding = button_get_status ((GtkWidget *)but);
 }
 
+#ifdef GTK4
+/*!
+  \fn G_MODULE_EXPORT void turn_overlap_on (GtkCheckButton * but, gpointer data)
+
+  \brief reject overlapping moves toggle callback GTK4
+
+  \param but the GtkCheckButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void turn_overlap_on (GtkCheckButton * but, gpointer data)
+#else
+/*!
+  \fn G_MODULE_EXPORT void turn_overlap_on (GtkToggleButton * but, gpointer data)
+
+  \brief reject overlapping moves toggle callback GTK3
+
+  \param but the GtkToggleButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void turn_overlap_on (GtkToggleButton * but, gpointer data)
+#endif
+{
+  atom_search * asearch = (atom_search *) data;
+  get_project_by_id(asearch -> proj) -> modelgl -> atom_win -> reject_overlap = button_get_status ((GtkWidget *)but);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_overlap_distance (GtkEntry * res, gpointer data)
+
+  \brief set the overlap distance callback
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_overlap_distance (GtkEntry * res, gpointer data)
+{
+  atom_search * asearch = (atom_search *) data;
+  atom_edition * edit = get_project_by_id(asearch -> proj) -> modelgl -> atom_win;
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if (v > 0.0) edit -> overlap = v;
+  update_entry_double (res, edit -> overlap);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_pack_density (GtkEntry * res, gpointer data)
+
+  \brief set the packing density callback
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_pack_density (GtkEntry * res, gpointer data)
+{
+  atom_search * asearch = (atom_search *) data;
+  atom_edition * edit = get_project_by_id(asearch -> proj) -> modelgl -> atom_win;
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if (v > 0.0) edit -> pack_density = v;
+  update_entry_double (res, edit -> pack_density);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_pack_copies (GtkSpinButton * res, gpointer data)
+
+  \brief set the number of copies to pack callback
+
+  \param res the GtkSpinButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_pack_copies (GtkSpinButton * res, gpointer data)
+{
+  atom_search * asearch = (atom_search *) data;
+  get_project_by_id(asearch -> proj) -> modelgl -> atom_win -> pack_copies = gtk_spin_button_get_value_as_int(res);
+}
+
+/*!
+  \fn GtkWidget * overlap_entry (project * this_proj, atom_search * asearch)
+
+  \brief create the overlap distance entry
+
+  \param this_proj the target project
+  \param asearch the target atom search
+*/
+GtkWidget * overlap_entry (project * this_proj, atom_search * asearch)
+{
+  GtkWidget * entry = create_entry (G_CALLBACK(set_overlap_distance), 60, 15, FALSE, asearch);
+  update_entry_double (GTK_ENTRY(entry), this_proj -> modelgl -> atom_win -> overlap);
+  return entry;
+}
+
 /*!
   \fn GtkWidget * create_search_box (int aid, project * this_proj)
 
@@ -147,6 +244,32 @@ GtkWidget * create_search_box (int aid, project * this_proj)
                         -1, 25, this_proj -> modelgl -> search_widg[aid+1] -> recompute_bonding, G_CALLBACK(turn_bonding_on),  this_proj -> modelgl -> search_widg[aid+1]);
     add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, widg, FALSE, FALSE, 50);
   }
+  if (aid == 5)
+  {
+    hbox = create_hbox (0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 0);
+    widg = check_button(_("Reject move(s) bringing atoms closer than"),
+                        -1, 25, this_proj -> modelgl -> atom_win -> reject_overlap, G_CALLBACK(turn_overlap_on), this_proj -> modelgl -> search_widg[aid+1]);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, widg, FALSE, FALSE, 50);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, overlap_entry (this_proj, this_proj -> modelgl -> search_widg[aid+1]), FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label("&#xC5;", -1, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  }
+  else if (aid == 4)
+  {
+    hbox = create_hbox (0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_("Pack"), -1, -1, 0.0, 0.5), FALSE, FALSE, 50);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                         spin_button (G_CALLBACK(set_pack_copies), this_proj -> modelgl -> atom_win -> pack_copies, 1, 100000, 1, 0, 100, this_proj -> modelgl -> search_widg[aid+1]),
+                         FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_("cop(y/ies) of the object to insert, up to"), -1, -1, 0.0, 0.5), FALSE, FALSE, 5);
+    widg = create_entry (G_CALLBACK(set_pack_density), 60, 15, FALSE, this_proj -> modelgl -> search_widg[aid+1]);
+    update_entry_double (GTK_ENTRY(widg), this_proj -> modelgl -> atom_win -> pack_density);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, widg, FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_("g/cm<sup>3</sup>, atoms at least"), -1, -1, 0.0, 0.5), FALSE, FALSE, 5);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, overlap_entry (this_proj, this_proj -> modelgl -> search_widg[aid+1]), FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label(_("&#xC5; apart"), -1, -1, 0.0, 0.5), FALSE, FALSE, 5);
+  }
 
   if (aid > 1 && aid < 6)
   {
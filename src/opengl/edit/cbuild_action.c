@@ -32,13 +32,18 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   int occupancy (double occ);
   int test_lattice (builder_edition * cbuilder, cell_info * cif_cell);
-  int pos_not_saved (vec3_t * all_pos, int num_pos, vec3_t pos);
+  int frac_bin (float f);
+  int pos_not_saved (GHashTable * pos_hash, int * pos_next, vec3_t * all_pos, int num_pos, vec3_t pos);
+  int build_wyckoff_orbit (vec3_t insert, int multi, mat4_t * wpos, int npoints, vec3_t * points, vec3_t * coord, int * at_type);
+  int remove_overlapping_positions (crystal_data * cryst, box_info * box, GtkWidget * widg);
   int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean to_wrap, gboolean show_clones, cell_info * cell, GtkWidget * widg);
 
   double get_val_from_setting (gchar * pos, gchar * sval);
   double get_value_from_pos (gchar * pos);
   double get_val_from_wyckoff (gchar * pos, gchar * wval);
 
+  guint frac_key (int bx, int by, int bz);
+
   gboolean same_coords (float a, float b);
   gboolean are_equal_vectors (vec3_t u, vec3_t v);
   gboolean pos_not_taken (int pos, int dim, int * tab);
@@ -66,6 +71,9 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 #include "cbuild_edit.h"
 #include "readers.h"
 #include <ctype.h>
+#ifdef OPENMP
+#  include <omp.h>
+#endif
 
 extern int get_crystal_id (int spg);
 extern atomic_object * cif_object;
@@ -567,25 +575,290 @@ gboolean are_equal_vectors (vec3_t u, vec3_t v)
   return FALSE;
 }
 
+/*! \def FRAC_BINS
+  \brief Number of bins, per fractional axis, of the hash used to find symmetry equivalent positions
+*/
+#define FRAC_BINS 1024
+
+/*! \def OVERLAP_CUT
+  \brief Inter-object distance (in Å) under which positions are considered overlapping
+*/
+#define OVERLAP_CUT 0.5
+
 /*!
-  \fn int pos_not_saved (vec3_t * all_pos, int num_pos, vec3_t pos)
+  \fn int frac_bin (float f)
+
+  \brief get the hash bin of a fractional coordinate, wrapped in [0, 1[
+
+  \param f the fractional coordinate
+*/
+int frac_bin (float f)
+{
+  int b = (int)floor((f - floor(f))*FRAC_BINS);
+  return (b < FRAC_BINS) ? ((b < 0) ? 0 : b) : FRAC_BINS-1;
+}
+
+/*!
+  \fn guint frac_key (int bx, int by, int bz)
+
+  \brief get the hash key of a bin, with periodic wrapping
+
+  \param bx bin on x
+  \param by bin on y
+  \param bz bin on z
+*/
+guint frac_key (int bx, int by, int bz)
+{
+  bx = (bx + FRAC_BINS) % FRAC_BINS;
+  by = (by + FRAC_BINS) % FRAC_BINS;
+  bz = (bz + FRAC_BINS) % FRAC_BINS;
+  return (guint)((bx*FRAC_BINS + by)*FRAC_BINS + bz) + 1;
+}
+
+/*!
+  \fn int pos_not_saved (GHashTable * pos_hash, int * pos_next, vec3_t * all_pos, int num_pos, vec3_t pos)
 
   \brief was this position already saved ?
 
+  \param pos_hash the hash table of the saved positions: bin key to first position in the bin (+1)
+  \param pos_next the list of next position (+1) in the same bin
   \param all_pos the list of saved atomic coordinates
   \param num_pos the number of saved atomic coordinates
   \param pos the vector to test
 */
-int pos_not_saved (vec3_t * all_pos, int num_pos, vec3_t pos)
+int pos_not_saved (GHashTable * pos_hash, int * pos_next, vec3_t * all_pos, int num_pos, vec3_t pos)
 {
-  int i;
-  for (i=0; i<num_pos; i++)
+  int i, j, k, l;
+  int b[3];
+  b[0] = frac_bin (pos.x);
+  b[1] = frac_bin (pos.y);
+  b[2] = frac_bin (pos.z);
+  // Equivalent positions differ by less than 0.0001, that is less than one bin
+  for (i=-1; i<2; i++)
   {
-    if (are_equal_vectors(all_pos[i], pos)) return -(i+1);
+    for (j=-1; j<2; j++)
+    {
+      for (k=-1; k<2; k++)
+      {
+        l = GPOINTER_TO_INT(g_hash_table_lookup (pos_hash, GUINT_TO_POINTER(frac_key (b[0]+i, b[1]+j, b[2]+k))));
+        while (l)
+        {
+          if (are_equal_vectors(all_pos[l-1], pos)) return -l;
+          l = pos_next[l-1];
+        }
+      }
+    }
   }
+  l = frac_key (b[0], b[1], b[2]);
+  pos_next[num_pos] = GPOINTER_TO_INT(g_hash_table_lookup (pos_hash, GUINT_TO_POINTER(l)));
+  g_hash_table_insert (pos_hash, GUINT_TO_POINTER(l), GINT_TO_POINTER(num_pos+1));
   return 1;
 }
 
+/*!
+  \fn int build_wyckoff_orbit (vec3_t insert, int multi, mat4_t * wpos, int npoints, vec3_t * points, vec3_t * coord, int * at_type)
+
+  \brief generate the symmetry equivalent positions of a site, without duplicates
+
+  \param insert the fractional coordinates of the site
+  \param multi the number of symmetry operations
+  \param wpos the symmetry operations
+  \param npoints the number of centering points
+  \param points the centering points
+  \param coord the list of positions to fill
+  \param at_type the number of times each position was generated
+*/
+int build_wyckoff_orbit (vec3_t insert, int multi, mat4_t * wpos, int npoints, vec3_t * points, vec3_t * coord, int * at_type)
+{
+  int n, o, p, q;
+  vec3_t pos;
+  GHashTable * pos_hash = g_hash_table_new (g_direct_hash, g_direct_equal);
+  int * pos_next = allocint (multi*npoints);
+  n = 0;
+  for (o=0; o<npoints; o++)
+  {
+    for (p=0; p<multi; p++)
+    {
+      pos = v3_add (m4_mul_coord (wpos[p], insert), points[o]);
+      q = pos_not_saved (pos_hash, pos_next, coord, n, pos);
+      if (q > 0)
+      {
+        coord[n].x = pos.x;
+        coord[n].y = pos.y;
+        coord[n].z = pos.z;
+#ifdef DEBUG
+        // g_debug ("      c.x= %f, c.y= %f, c.z= %f", coord[n].x, coord[n].y, coord[n].z);
+#endif
+        at_type[n] = 1;
+        n ++;
+      }
+      else if (q < 0)
+      {
+        at_type[-(q+1)] ++;
+      }
+    }
+  }
+  g_hash_table_destroy (pos_hash);
+  g_free (pos_next);
+  return n;
+}
+
+/*!
+  \fn int remove_overlapping_positions (crystal_data * cryst, box_info * box, GtkWidget * widg)
+
+  \brief find overlapping positions using a cell list of the positions, and remove duplicates
+
+  \param cryst the crystal data
+  \param box the box of the crystal, including extra cells
+  \param widg the GtkWidget sending the signal
+*/
+int remove_overlapping_positions (crystal_data * cryst, box_info * box, GtkWidget * widg)
+{
+  int i, j, k, l, m, n, c;
+  int nb[3], cb[3], sb[3], lb[3];
+  double width[3];
+  vec3_t va, vb, f;
+  atom at, bt;
+  distance dist;
+  int npos = 0;
+  for (i=0; i<cryst -> objects; i++) if (! cryst -> holes[i]) npos += cryst -> pos_by_object[i];
+  if (! npos) return 1;
+
+  // Bin width is at least OVERLAP_CUT along the normal to each pair of lattice vectors
+  for (i=0; i<3; i++)
+  {
+    va = vec3(box -> vect[(i+1)%3][0], box -> vect[(i+1)%3][1], box -> vect[(i+1)%3][2]);
+    vb = vec3(box -> vect[(i+2)%3][0], box -> vect[(i+2)%3][1], box -> vect[(i+2)%3][2]);
+    width[i] = fabs(v3_dot(vec3(box -> vect[i][0], box -> vect[i][1], box -> vect[i][2]), v3_cross(va, vb))) / v3_length(v3_cross(va, vb));
+    nb[i] = max(1, (int)(width[i]/OVERLAP_CUT));
+  }
+  while ((double)nb[0]*nb[1]*nb[2] > 8.0*npos + 27.0)
+  {
+    i = (nb[0] >= nb[1] && nb[0] >= nb[2]) ? 0 : ((nb[1] >= nb[2]) ? 1 : 2);
+    nb[i] = max(1, nb[i]/2);
+  }
+  int ncells = nb[0]*nb[1]*nb[2];
+  int * pos_obj = allocint (npos);
+  int * pos_id = allocint (npos);
+  int * pos_cell = allocint (npos);
+  int * cell_start = allocint (ncells+1);
+  int * cell_pos = allocint (npos);
+  gboolean * removed = allocbool (npos);
+  n = 0;
+  for (i=0; i<cryst -> objects; i++)
+  {
+    if (! cryst -> holes[i])
+    {
+      for (j=0; j<cryst -> pos_by_object[i]; j++)
+      {
+        f = m4_mul_coord (box -> cart_to_frac, cryst -> coord[i][j]);
+        cb[0] = (int)floor((f.x - floor(f.x))*nb[0]) % nb[0];
+        cb[1] = (int)floor((f.y - floor(f.y))*nb[1]) % nb[1];
+        cb[2] = (int)floor((f.z - floor(f.z))*nb[2]) % nb[2];
+        pos_obj[n] = i;
+        pos_id[n] = j;
+        pos_cell[n] = (cb[0]*nb[1] + cb[1])*nb[2] + cb[2];
+        cell_start[pos_cell[n]+1] ++;
+        n ++;
+      }
+    }
+  }
+  for (i=0; i<ncells; i++) cell_start[i+1] += cell_start[i];
+  int * cell_fill = duplicate_int (ncells, cell_start);
+  // Positions are sorted by increasing order in each cell
+  for (i=0; i<npos; i++)
+  {
+    cell_pos[cell_fill[pos_cell[i]]] = i;
+    cell_fill[pos_cell[i]] ++;
+  }
+  g_free (cell_fill);
+
+  int res = 1;
+  for (i=0; i<npos; i++)
+  {
+    if (removed[i]) continue;
+    at.x = cryst -> coord[pos_obj[i]][pos_id[i]].x;
+    at.y = cryst -> coord[pos_obj[i]][pos_id[i]].y;
+    at.z = cryst -> coord[pos_obj[i]][pos_id[i]].z;
+    cb[0] = pos_cell[i] / (nb[1]*nb[2]);
+    cb[1] = (pos_cell[i] / nb[2]) % nb[1];
+    cb[2] = pos_cell[i] % nb[2];
+    for (j=0; j<3; j++)
+    {
+      // Avoid visiting twice the same cell if there are less than 3 cells on this axis
+      sb[j] = (nb[j] < 3) ? 0 : cb[j] - 1;
+      lb[j] = (nb[j] < 3) ? nb[j] - 1 : cb[j] + 1;
+    }
+    for (j=sb[0]; j<=lb[0] && res; j++)
+    {
+      for (k=sb[1]; k<=lb[1] && res; k++)
+      {
+        for (l=sb[2]; l<=lb[2] && res; l++)
+        {
+          c = (((j+nb[0])%nb[0])*nb[1] + (k+nb[1])%nb[1])*nb[2] + (l+nb[2])%nb[2];
+          for (n=cell_start[c]; n<cell_start[c+1]; n++)
+          {
+            m = cell_pos[n];
+            if (m > i && ! removed[m])
+            {
+              bt.x = cryst -> coord[pos_obj[m]][pos_id[m]].x;
+              bt.y = cryst -> coord[pos_obj[m]][pos_id[m]].y;
+              bt.z = cryst -> coord[pos_obj[m]][pos_id[m]].z;
+              dist = distance_3d (active_cell, 0, & at, & bt);
+              if (dist.length < OVERLAP_CUT)
+              {
+                if (crystal_dist_chk)
+                {
+                  res = 3;
+                  if (ask_yes_no (_("Inter-object distance(s) < 0.5 Ang. !"),
+                                  _("Inter-object distance(s) &lt; 0.5 &#xC5; !\n\n\t\tContinue and leave a single object at each position ?"), GTK_MESSAGE_WARNING, widg))
+                  {
+                    crystal_dist_chk = FALSE;
+                  }
+                  else
+                  {
+                    res = 0;
+                    break;
+                  }
+                }
+                if (! crystal_dist_chk && dist.length < 0.1) removed[m] = TRUE;
+              }
+            }
+          }
+        }
+      }
+    }
+    if (! res) break;
+  }
+
+  // Compact the list of positions for each object
+  n = 0;
+  for (i=0; i<cryst -> objects && res; i++)
+  {
+    if (! cryst -> holes[i])
+    {
+      k = 0;
+      for (j=0; j<cryst -> pos_by_object[i]; j++)
+      {
+        if (! removed[n])
+        {
+          cryst -> coord[i][k] = cryst -> coord[i][j];
+          k ++;
+        }
+        n ++;
+      }
+      cryst -> pos_by_object[i] = k;
+    }
+  }
+  g_free (pos_obj);
+  g_free (pos_id);
+  g_free (pos_cell);
+  g_free (cell_start);
+  g_free (cell_pos);
+  g_free (removed);
+  return res;
+}
+
 /*!
   \fn space_group * duplicate_space_group (space_group * spg)
 
@@ -971,7 +1244,7 @@ gboolean crystal_dist_chk;
 */
 int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean to_wrap, gboolean show_clones, cell_info * cell, GtkWidget * widg)
 {
-  int h, i, j, k, l, m, n, o, p, q;
+  int h, i, j, k, l, m, n, o, p;
   int build_res = 1;
   space_group * sp_group = cell -> sp_group;
   box_info * box = & cell -> box[c_step];
@@ -1044,7 +1317,6 @@ int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean t
     npoints = 1;
   }
 
-  vec3_t pos;
   atomic_object * object = NULL;
   gboolean done;
   crystal_data * cdata = NULL;
@@ -1150,31 +1422,6 @@ int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean t
           // g_debug ("at_orig= %d, pos.x= %f, pos.y= %f, pos.z= %f", i+1, object -> baryc[0], object -> baryc[1], object -> baryc[2]);
           // g_debug ("at_calc= %d, pos.x= %f, pos.y= %f, pos.z= %f", i+1, cdata -> insert[i].x, cdata -> insert[i].y, cdata -> insert[i].z);
 #endif
-          n = 0;
-          for (o=0; o<npoints; o++)
-          {
-            for (p=0; p<sp_group -> wyckoff[0].multi; p++)
-            {
-              pos = v3_add (m4_mul_coord (wyckpos[0][p], cdata -> insert[i]), points[o]);
-              q = pos_not_saved (cdata -> coord[i], n, pos);
-              if (q > 0)
-              {
-                cdata -> coord[i][n].x = pos.x;
-                cdata -> coord[i][n].y = pos.y;
-                cdata -> coord[i][n].z = pos.z;
-#ifdef DEBUG
-                // g_debug ("      c.x= %f, c.y= %f, c.z= %f", cdata -> coord[i][n].x, cdata -> coord[i][n].y, cdata -> coord[i][n].z);
-#endif
-                cdata -> at_type[i][n] = 1;
-                n ++;
-              }
-              else if (q < 0)
-              {
-                cdata -> at_type[i][-(q+1)] ++;
-              }
-            }
-          }
-          cdata -> pos_by_object[i] = n;
           cdata -> occupancy[i] = object -> occ;
           if (! cdata -> holes[i]) cdata -> lot[i] = allocint (object -> atoms);
           cdata -> position[i] = g_malloc0(object -> atoms*sizeof*cdata -> position[i]);
@@ -1259,6 +1506,16 @@ int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean t
     }
   }
 
+  // Symmetry equivalent positions: each Wyckoff orbit is independent
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+  #pragma omp parallel for num_threads(numth) private(i) shared(cdata,sp_group,wyckpos,npoints,points)
+#endif
+  for (i=0; i<cdata -> objects; i++)
+  {
+    cdata -> pos_by_object[i] = build_wyckoff_orbit (cdata -> insert[i], sp_group -> wyckoff[0].multi, wyckpos[0],
+                                                     npoints, points, cdata -> coord[i], cdata -> at_type[i]);
+  }
   if (points) g_free (points);
   if (wyckpos) g_free (wyckpos);
 
@@ -1453,74 +1710,18 @@ int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean t
   }
   cdata = free_crystal_data (cdata);
   gboolean low_occ = adjust_object_occupancy (cryst, occupying, rounding, tot_cell);
-  atom at, bt;
-  distance dist;
-
   if (! cryst -> overlapping)
   {
-    for (i=0; i<cryst -> objects; i++)
+    i = remove_overlapping_positions (cryst, active_box, widg);
+    if (! i)
     {
-      if (! cryst -> holes[i])
-      {
-        for (j=0; j<cryst -> pos_by_object[i]; j++)
-        {
-          at.x = cryst -> coord[i][j].x;
-          at.y = cryst -> coord[i][j].y;
-          at.z = cryst -> coord[i][j].z;
-          for (k=i; k<cryst -> objects; k++)
-          {
-            if (! cryst -> holes[k])
-            {
-              if (k != i || j < cryst -> pos_by_object[i]-1)
-              {
-                l = (k == i) ? j+1 : 0;
-                for (m=l; m<cryst -> pos_by_object[k]; m++)
-                {
-                  bt.x = cryst -> coord[k][m].x;
-                  bt.y = cryst -> coord[k][m].y;
-                  bt.z = cryst -> coord[k][m].z;
-                  dist = distance_3d (active_cell, 0, & at, & bt);
-                  if (dist.length < 0.5)
-                  {
-                    // g_print ("i= %d, j= %d, k= %d, m= %d, d= %f\n", i, j, k, m, dist.length);
-                    if (crystal_dist_chk)
-                    {
-                      build_res = 3;
-                      if (ask_yes_no (_("Inter-object distance(s) < 0.5 Ang. !"),
-                                      _("Inter-object distance(s) &lt; 0.5 &#xC5; !\n\n\t\tContinue and leave a single object at each position ?"), GTK_MESSAGE_WARNING, widg))
-                      {
-                        crystal_dist_chk = FALSE;
-                      }
-                      else
-                      {
-                        clean_this_proj (active_project, new_proj);
-                        cryst = free_crystal_data (cryst);
-                        return 0;
-                      }
-                    }
-                    if (! crystal_dist_chk)
-                    {
-                      if (dist.length < 0.1)
-                      {
-                        cryst -> at_type[i][j] += cryst -> at_type[k][m];
-                        for (n=m; n<cryst -> pos_by_object[k]-1; n++)
-                        {
-                          cryst -> coord[k][n].x = cryst -> coord[k][n+1].x;
-                          cryst -> coord[k][n].y = cryst -> coord[k][n+1].y;
-                          cryst -> coord[k][n].z = cryst -> coord[k][n+1].z;
-                          cryst -> at_type[k][n] += cryst -> at_type[k][n+1];
-                        }
-                        cryst -> pos_by_object[k] --;
-                        m --;
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
-        }
-      }
+      clean_this_proj (active_project, new_proj);
+      cryst = free_crystal_data (cryst);
+      return 0;
+    }
+    else if (i == 3)
+    {
+      build_res = 3;
     }
   }
 
@@ -1705,8 +1906,7 @@ int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean t
 #endif
       prepare_opengl_menu_bar (active_glwin);
       active_glwin -> labelled = check_label_numbers (active_project, 0);
-      frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-      mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+      frag_update = mol_update = 1;
       bonds_update = 1;
       active_project -> runc[0] = FALSE;
       on_calc_bonds_released (NULL, NULL);
@@ -78,4 +78,5 @@ extern G_MODULE_EXPORT void super_cell (GtkWidget * widg, gpointer data);
 extern G_MODULE_EXPORT void edition_win (GtkWidget * widg, gpointer data);
 #endif
 extern atom_search * allocate_atom_search (int proj, int action, int searchid, int tsize);
+extern void clean_edit_journal (project * this_proj);
 #endif
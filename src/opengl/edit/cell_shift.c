@@ -131,6 +131,9 @@ void modify_coordinates_in_lattice (project * this_proj, mat4_t * dlat, mat4_t *
       }
     }
   }
+  // All atoms were moved: the coordinates recorded in the edition journal and the cell list no longer apply
+  clean_edit_journal (this_proj);
+  clean_atom_grid (this_proj);
   if (refresh)
   {
     i = activep;
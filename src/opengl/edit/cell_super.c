@@ -285,8 +285,7 @@ void super_celling (glwin * view)
       active_project -> dmtx = FALSE;
       bonds_update = 1;
       active_project -> runc[0] = FALSE;
-      frag_update = (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-      mol_update = (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+      frag_update = mol_update = 1;
       gboolean ** cshow = duplicate_geom_info (active_project);
       gboolean ** pshow = duplicate_poly_info (active_project);
       coord_info * ocoord = duplicate_coord_info (active_coord);
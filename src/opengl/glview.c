@@ -104,6 +104,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 extern vec3_t arc_ball_init;
 extern vec4_t old_rotation_quaternion;
 extern void process_the_hits (glwin * view, gint event_button, double ptx, double pty);
+extern void add_region_point (glwin * view, double x, double y, int region);
+extern void process_the_region (glwin * view);
 extern void arc_ball_rotation (glwin * view, int x, int y);
 extern vec3_t get_arc_ball_vector (glwin * view, int x, int y);
 extern Light * init_light_source (int type, float size);
@@ -653,6 +655,12 @@ void motion (glwin * view, gint x, gint y, GdkModifierType state)
 
   if (state & GDK_BUTTON1_MASK)
   {
+    if ((state & GDK_SHIFT_MASK) && (view -> selection_mode == ATOMS || view -> selection_mode == NSELECTION-1 || is_atom_win_active(view)))
+    {
+      // Shift: rectangle selection, Shift + Ctrl: lasso selection
+      add_region_point (view, x, y, (state & GDK_CONTROL_MASK) ? 2 : 1);
+      return;
+    }
     arc_ball_rotation (view, x, y);
   }
   else if (state & GDK_BUTTON2_MASK)
@@ -795,7 +803,14 @@ void render_this_gl_window (glwin * view, GtkWidget * widg, gint button)
     draw (view);
     if (view -> to_pick)
     {
-      if (view -> mouseButton) process_the_hits (view, view -> mouseButton, view -> mouseX, view -> mouseY);
+      if (view -> pick_region)
+      {
+        process_the_region (view);
+      }
+      else if (view -> mouseButton)
+      {
+        process_the_hits (view, view -> mouseButton, view -> mouseX, view -> mouseY);
+      }
       view -> to_pick = FALSE;
       reshape (view, view -> pixels[0], view -> pixels[1], TRUE);
       draw (view);
@@ -936,7 +951,17 @@ void glwin_button_event (double event_x, double event_y, guint event_button, gui
       view -> mouseStatus = RELEASED;
       view -> mouseButton = 0;
       clock_gettime (CLOCK_MONOTONIC, & stop_time);
-      if (get_calc_time (start_time, stop_time) < 0.4)
+      if (view -> pick_region)
+      {
+        // Render the picking scene once, and read back the entire region
+        view -> to_pick = TRUE;
+#ifdef GTKGLAREA
+        update (view);
+#else
+        render_this_gl_window (view, plot, event_button);
+#endif
+      }
+      else if (get_calc_time (start_time, stop_time) < 0.4)
       {
 #ifdef GTKGLAREA
         update (view);
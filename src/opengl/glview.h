@@ -287,6 +287,7 @@ extern void prepare_cuboid (vec3_t position, int id);
 extern void prepare_axis ();
 extern void draw (glwin * view);
 extern void render_all_strings (int glsl, int id);
+extern int label_shaders (int id);
 extern void prepare_string (char * text, int id, ColRGBA col, vec3_t pos, float lshift[3],
                             atom * at, atom * bt, atom * ct);
 
@@ -104,6 +104,7 @@ enum shaders {
 };
 
 #define FILLED_STYLES 4
+#define VOXEL_DATA 5
 #define OGL_STYLES 6
 
 extern char * text_styles[OGL_STYLES];
@@ -252,6 +253,7 @@ struct screen_string
   ColRGBA col;                    /*!< Color of the string */
   float shift[4];                 /*!< The shifts (if any) on x, y, z, then visibility */
   int num_instances;              /*!< The number of instances for that string */
+  int max_instances;              /*!< The number of instances allocated for that string */
   float * instances;              /*!< The list of instances for that string */
   screen_string * prev;
   screen_string * last;
@@ -782,6 +784,94 @@ struct atom_edition
   coord_info * coord;
   int add_spec;
   double * new_z;
+  gboolean reject_overlap;
+  double overlap;
+  int pack_copies;
+  double pack_density;
+};
+
+/*! \typedef edit_delta
+
+  \brief a structure to store the atomic displacements of a single edition step
+*/
+typedef struct edit_delta edit_delta;
+struct edit_delta
+{
+  int action;                   /*!< Edition action: DISPL, RANMOVE, REMOVE or INSERT */
+  int atoms;                    /*!< Number of atom(s) moved, removed or inserted during this step */
+  int size;                     /*!< Allocated size of the lists */
+  int * aid;                    /*!< List of the journal key(s) of the atom(s) */
+  double * xyz[2];              /*!< Atomic coordinates: 0 = before, 1 = after the step (DISPL and RANMOVE) */
+  atomic_object * object;       /*!< Atom(s) removed or inserted, with species and bonds (REMOVE and INSERT) */
+  gboolean bonding;             /*!< Was the bonding recomputed after this step */
+  int group;                    /*!< Batch of edition(s) the step belongs to, 0 if none, undone / redone together */
+  edit_delta * prev;
+  edit_delta * next;
+};
+
+/*! \typedef edit_journal
+
+  \brief a structure to store the undo/redo history of the model edition
+*/
+typedef struct edit_journal edit_journal;
+struct edit_journal
+{
+  int natomes;                  /*!< Number of atom(s) in the model */
+  int * slot;                   /*!< Position of each atom in the open step, -1 if not recorded */
+  int keys;                     /*!< Number of journal key(s) */
+  int * key;                    /*!< Journal key of each atom, it does not change when atoms are removed or inserted */
+  int * pos;                    /*!< Atom ID for each journal key, -1 if the atom is not in the model */
+  gboolean replay;              /*!< Undo / redo in progress: nothing to record */
+  int steps;                    /*!< Number of step(s) in the journal */
+  int batch;                    /*!< Depth of the current batch of edition(s), if any */
+  int group;                    /*!< ID of the last batch of edition(s) */
+  gboolean pending;             /*!< Bonding to be recomputed when the batch is closed */
+  edit_delta * open;            /*!< Step being recorded, if any */
+  edit_delta * first;           /*!< First step in the journal */
+  edit_delta * last;            /*!< Last step applied to the model, NULL if all undone */
+};
+
+/*! \typedef atom_grid
+
+  \brief a structure to store a cell list of the atomic positions, for overlap queries
+*/
+typedef struct atom_grid atom_grid;
+struct atom_grid
+{
+  int natomes;                  /*!< Number of atom(s) of the model in the grid */
+  int points;                   /*!< Number of point(s) in the grid, atom(s) first */
+  int size;                     /*!< Allocated size of the point lists */
+  gboolean pbc;                 /*!< Periodic grid, the grid vectors are the box vectors */
+  double cut;                   /*!< Minimum size of a cell */
+  int n[3];                     /*!< Number of cells along each grid vector */
+  double org[3];                /*!< Grid origin */
+  double vect[3][3];            /*!< Grid vectors */
+  double inv[3][3];             /*!< Inverse of the grid vectors matrix: cartesian to fractional */
+  double * pos;                 /*!< Point coordinates */
+  int * head;                   /*!< First point in each cell, -1 if empty */
+  int * next;                   /*!< Next point in the same cell, -1 if none */
+  int * prev;                   /*!< Previous point in the same cell, -1 if none */
+  int * cell;                   /*!< Cell of each point */
+  gboolean * skip;              /*!< Temporary mask of the atom(s) to ignore */
+};
+
+/*! \typedef voxel_grid
+
+  \brief a structure to store a voxel grid, to compute volumes and surfaces
+*/
+typedef struct voxel_grid voxel_grid;
+struct voxel_grid
+{
+  int n[3];                     /*!< Number of voxels along each grid vector */
+  gboolean pbc;                 /*!< Periodic grid, the grid vectors are the box vectors */
+  double org[3];                /*!< Grid origin */
+  double vect[3][3];            /*!< Grid vectors */
+  double inv[3][3];             /*!< Inverse of the grid vectors matrix: cartesian to fractional */
+  double vvol;                  /*!< Voxel volume */
+  unsigned char * vox;          /*!< Voxel flags */
+  int sid;                      /*!< MD step of a cached grid */
+  int rid;                      /*!< Type of atomic radius of a cached grid */
+  double param[2];              /*!< Grid spacing and probe radius of a cached grid */
 };
 
 typedef struct cell_edition cell_edition;
@@ -898,6 +988,44 @@ struct volumes
   GtkWidget * fm_vvbox[2];
   int ngeov[2];
   int * geov_id[2];
+  // Voxel grid
+  GtkWidget * vox_lab;
+  GtkWidget * vox_show;
+};
+
+/*! \typedef density_map
+
+  \brief 3D density map(s) accumulated over the MD trajectory
+*/
+typedef struct density_map density_map;
+struct density_map
+{
+  int n[3];               /*!< Number of grid points along each grid vector */
+  gboolean pbc;           /*!< Periodic grid (0 = no, 1 = yes) */
+  int weight;             /*!< Density type: 0 = number, 1 = atomic number, 2 = neutrons, 3 = X-rays */
+  int nref;               /*!< Number of atom(s) in the reference fragment, 0 = no alignment */
+  int * ref_list;         /*!< List of the atom(s) in the reference fragment */
+  int nmaps;              /*!< Number of maps: one by chemical species + total */
+  double org[3];          /*!< Grid origin */
+  double vect[3][3];      /*!< Grid vectors */
+  double inv[3][3];       /*!< Inverse of the grid vectors matrix */
+  double ** rho;          /*!< Density maps, (map, grid point) */
+  double * rmax;          /*!< Maximum density by map */
+  double * iso;           /*!< Isosurface level by map */
+  gboolean * show;        /*!< Show (1) or hide (0) the isosurface by map */
+  ColRGBA * col;          /*!< Isosurface color by map */
+};
+
+typedef struct density_window density_window;
+struct density_window
+{
+  GtkWidget * win;
+  GtkWidget * info;
+  GtkWidget * maps_box;
+  GtkWidget * maps_vbox;
+  int weight;
+  int ref;
+  double param[2];        /*!< Grid spacing, half size of the grid for aligned maps */
 };
 
 typedef struct model_edition model_edition;
@@ -1034,6 +1162,7 @@ struct glwin
   GLXContext glcontext;
 #endif
   int pixels[2];
+  int lod;                                   /*!< Level of detail used to render the atom(s) and bond(s), see 'get_level_of_detail' */
 
   int mouseX;
   int mouseY;
@@ -1068,6 +1197,8 @@ struct glwin
   int cmap[ATOM_MAPS];
   atom_edition * atom_win;
   double ** saved_coord[3];
+  edit_journal * journal;
+  atom_grid * grid;
   cell_edition * cell_win;
   // 0 = atoms
   // 1 = clones
@@ -1146,6 +1277,16 @@ struct glwin
   double ** frag_mol_ppvolume[2][FILLED_STYLES];
   double *** frag_box[FILLED_STYLES];
   gboolean ** fm_comp_vol[2][FILLED_STYLES];
+  // Voxel grid volumes, [VOXEL_DATA] : vdW volume, solvent excluded volume, solvent accessible surface, free volume, porosity
+  double ** voxel_volume;                    /*!< Model voxel grid data (MD step, data) */
+  double *** fm_voxel_volume[2];             /*!< Fragment(s) and molecule(s) voxel grid data (MD step, id, data) */
+  int voxel_dim[3];                          /*!< Allocated sizes of the voxel grid data: MD steps, fragment(s), molecule(s) */
+  voxel_grid * voxel_cache;                  /*!< Last model voxel grid, kept until the coordinates or the grid parameters change */
+  double voxel_param[2];                     /*!< Voxel grid spacing, probe radius */
+  int voxel_radius;                          /*!< Type of atomic radius for the voxel grid */
+  gboolean show_voxel;                       /*!< Show (1) or hide (0) the solvent excluded surface */
+  ColRGBA voxel_col;                         /*!< Solvent excluded surface color */
+  density_map * dmap;                        /*!< 3D density map(s) */
 
   int labelled;
   int picked;
@@ -1156,6 +1297,10 @@ struct glwin
   int clones_to_be_picked;                   /*!< Number of clones that can be picked */
   int bonds_to_be_picked;                    /*!< Number of bonds that can be picked (do not include clones) */
   int * color_to_pick;                       /*!< The different colors that can be picked */
+  int * pick_to_object;                      /*!< For each pick id: the atom id (atoms and clones) or the bond id (bonds) */
+  int pick_region;                           /*!< Region selection in progress: 0 = no, 1 = rectangle, 2 = lasso */
+  int region_points;                         /*!< Number of points in the region selection path */
+  double * region_path;                      /*!< Region selection path, window coordinates (x,y) */
 
   // Spinner, player
   sequencer * player;
@@ -1177,6 +1322,7 @@ struct glwin
 
   measures * measure_win;
   volumes * volume_win;
+  density_window * density_win;
 
   float zoom_factor;
   GLdouble p_moy;
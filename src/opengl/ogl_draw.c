@@ -84,6 +84,7 @@ extern void create_ring_lists ();
 extern int create_box_lists (int b_step);
 extern int create_axis_lists ();
 extern int create_pick_lists ();
+extern int get_level_of_detail ();
 extern int create_label_lists ();
 extern void create_measures_lists ();
 extern void create_light_lists ();
@@ -550,12 +551,20 @@ void draw (glwin * view)
   // First, if needed, we prepare the display lists
   if (proj_at)
   {
+    int lod = get_level_of_detail ();
+    if (lod != wingl -> lod)
+    {
+      // The level of detail changed: rebuild the atom(s) and bond(s)
+      wingl -> lod = lod;
+      int shaders[2] = {ATOMS, BONDS};
+      re_create_md_shaders (2, shaders, proj_gl);
+    }
     if (wingl -> create_shaders[ATOMS] && wingl -> n_shaders[ATOMS][step] < 0) create_atom_lists (FALSE);
     if (wingl -> create_shaders[BONDS] && wingl -> n_shaders[BONDS][step] < 0) wingl -> n_shaders[BONDS][step] = create_bond_lists (FALSE);
     if (wingl -> create_shaders[SELEC] && wingl -> n_shaders[SELEC][step] < 0) wingl -> n_shaders[SELEC][step] = create_selection_lists ();
     if (wingl -> create_shaders[POLYS] && wingl -> n_shaders[POLYS][step] < 0) create_poly_lists ();
     if (wingl -> create_shaders[RINGS] && wingl -> n_shaders[RINGS][step] < 0) create_ring_lists ();
-    if (wingl -> create_shaders[PICKS] && ! atomes_render_image) wingl -> n_shaders[PICKS][0] = create_pick_lists ();
+    if (wingl -> create_shaders[PICKS] && wingl -> to_pick && ! atomes_render_image) wingl -> n_shaders[PICKS][0] = create_pick_lists ();
     if (wingl -> create_shaders[SLABS]) create_slab_lists (proj_gl);
     if (wingl -> create_shaders[VOLMS] && wingl -> n_shaders[VOLMS][step] < 0) create_volumes_lists ();
     if (wingl -> create_shaders[LABEL]) wingl -> n_shaders[LABEL][0] = create_label_lists ();
@@ -633,6 +633,66 @@ const GLchar * string_vertex = GLSL(
   }
 );
 
+/*
+   Glyph atlas labels: each instance is one glyph of a string,
+   the quad and the atlas coordinates of the glyph are provided with the instance
+*/
+const GLchar * glyph_vertex = GLSL(
+  uniform mat4 mvp;
+  uniform mat4 un_view;
+  uniform mat4 text_proj;
+  uniform vec4 viewp;
+  uniform vec4 pos_shift;
+  in vec2 vert;
+  in vec3 offset;
+  in vec3 shift;
+  in vec4 glyph;
+  in vec4 tglyph;
+  in vec4 vertColor;
+
+  out vec2 text_coords;
+  out vec4 text_color;
+  mat4 translate_this (in vec3 coord)
+  {
+    mat4 translate;
+    translate[0] = vec4(1.0, 0.0, 0.0, 0.0);
+    translate[1] = vec4(0.0, 1.0, 0.0, 0.0);
+    translate[2] = vec4(0.0, 0.0, 1.0, 0.0);
+    translate[3][0] = coord.x;
+    translate[3][1] = coord.y;
+    translate[3][2] = coord.z;
+    translate[3][3] = 1.0;
+
+    return translate;
+  }
+
+  vec4 project (in vec3 coord)
+  {
+    mat4 n_mvp = ((mvp * translate_this (coord)) * un_view) * translate_this (shift);
+    vec4 res = n_mvp * vec4(vec3(0.0), 1.0);
+    if (res.w != 0.0)
+    {
+      res.w = 1.0 / res.w;
+      res.x = res.w * res.x + 1.0;
+      res.y = res.w * res.y + 1.0;
+      res.z = res.w * res.z + 1.0;
+      return vec4 (res.x*viewp.z+viewp.x, res.y*viewp.w+viewp.y, pos_shift.w*res.z, 1.0);
+    }
+    else
+    {
+      return vec4 (0.0, 0.0, -1.0, 0.0);
+    }
+  }
+
+  void main()
+  {
+    text_coords = tglyph.xy + vert*tglyph.zw;
+    text_color = vertColor;
+    vec4 pos = project (offset) + vec4(glyph.xy + vert*glyph.zw, 0.0, 1.0);
+    gl_Position = text_proj * pos;
+  }
+);
+
 const GLchar * full_color = GLSL(
 
   int PHONG           = 1;
@@ -2150,6 +2210,32 @@ const GLchar * string_color_2d = GLSL(
   }
 );
 
+const GLchar * glyph_color = GLSL(
+  uniform sampler2DRect tex;
+  in vec2 text_coords;
+  in vec4 text_color;
+
+  out vec4 fragment_color;
+  void main()
+  {
+    vec4 color = text_color * vec4(1.0, 1.0, 1.0, texture (tex, text_coords).r);
+    fragment_color = vec4(color.rgb * color.a, color.a);
+  }
+);
+
+const GLchar * glyph_color_2d = GLSL(
+  uniform sampler2D tex;
+  in vec2 text_coords;
+  in vec4 text_color;
+
+  out vec4 fragment_color;
+  void main()
+  {
+    vec4 color = text_color * vec4(1.0, 1.0, 1.0, texture (tex, text_coords).r);
+    fragment_color = vec4(color.rgb * color.a, color.a);
+  }
+);
+
 const GLchar * background_vertex = GLSL(
   in vec2 vert;
 
@@ -39,6 +39,9 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   gboolean in_md_shaders (project * this_proj, int id);
   gboolean glsl_disable_cull_face (glsl_program * glsl);
+  gboolean glsl_base_instance ();
+  gboolean glsl_in_chunks (glsl_program * glsl);
+  gboolean glsl_in_cell_replicas (int object);
 
   void allocate_instances (object_3d * object);
   void set_light_uniform_location (GLuint * lightning, int id, int j, int k, char * string);
@@ -51,6 +54,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void glsl_bind_background (glsl_program * glsl, object_3d * obj);
   void update_string_instances (glsl_program * glsl, object_3d * obj);
   void glsl_bind_string (glsl_program * glsl, object_3d * obj);
+  void glsl_bind_glyphs (glsl_program * glsl, object_3d * obj);
   void re_create_all_md_shaders (glwin * view);
   void re_create_md_shaders (int nshaders, int shaders[nshaders], project * this_proj);
   void cleaning_shaders (glwin * view, int shader);
@@ -60,6 +64,13 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void set_lights_data (glsl_program * glsl);
   void shading_glsl_text (glsl_program * glsl);
   void update_ray_instances (glsl_program * glsl);
+  void item_bounds (glsl_program * glsl, float * data, int id, float * bounds);
+  void sort_in_chunks (glsl_program * glsl);
+  void draw_this_range (glsl_program * glsl, int first, int count);
+  void draw_visible_chunks (glsl_program * glsl);
+  void draw_translated_instances (glsl_program * glsl);
+  void draw_this_glsl (glsl_program * glsl);
+  void draw_cell_replicas (glsl_program * glsl);
   void render_this_shader (glsl_program * glsl, int ids);
   void draw_vertices (int id);
 
@@ -536,6 +547,51 @@ void glsl_bind_string (glsl_program * glsl, object_3d * obj)
   update_string_instances (glsl, obj);
 }
 
+/*!
+  \fn void glsl_bind_glyphs (glsl_program * glsl, object_3d * obj)
+
+  \brief bind a 3D object glyph atlas text to an OpenGL shader program
+
+  \param glsl the target glsl
+  \param obj the 3D object glyph atlas text to bind
+*/
+void glsl_bind_glyphs (glsl_program * glsl, object_3d * obj)
+{
+  int i;
+  char * attrib[5] = {"offset", "shift", "glyph", "tglyph", "vertColor"};
+  int size[5] = {3, 3, 4, 4, 4};
+  int pos;
+
+  glActiveTexture (GL_TEXTURE0);
+  glBindTexture (ogl_texture, obj -> texture);
+  glsl -> uniform_loc[1] = glGetUniformLocation (glsl -> id, "tex");
+  glUniform1i (glsl -> uniform_loc[1], 0);
+  glsl -> uniform_loc[2] = glGetUniformLocation (glsl -> id, "text_proj");
+  glsl -> uniform_loc[3] = glGetUniformLocation (glsl -> id, "un_view");
+  glsl -> uniform_loc[4] = glGetUniformLocation (glsl -> id, "viewp");
+  glsl -> uniform_loc[5] = glGetUniformLocation (glsl -> id, "pos_shift");
+  glsl -> uniform_loc[6] = glGetUniformLocation (glsl -> id, "vert_color");
+
+  // The glyph quad (rendered using triangles, textures and colors)
+  glBindBuffer(GL_ARRAY_BUFFER, glsl -> vbo[0]);
+  glBufferData(GL_ARRAY_BUFFER, obj -> vert_buffer_size * obj -> num_vertices*sizeof(GLfloat), obj -> vertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(glsl -> array_pointer[0]);
+  glVertexAttribPointer(glsl -> array_pointer[0], 2, GL_FLOAT, GL_FALSE, obj -> vert_buffer_size*sizeof(GLfloat), (GLvoid*) 0);
+
+  // The instances, one per glyph
+  glBindBuffer(GL_ARRAY_BUFFER, glsl -> vbo[1]);
+  glBufferData(GL_ARRAY_BUFFER, obj -> inst_buffer_size * obj -> num_instances * sizeof(GLfloat), obj -> instances, GL_STATIC_DRAW);
+  pos = 0;
+  for (i=0; i<5; i++)
+  {
+    glsl -> array_pointer[i+1] = glGetAttribLocation (glsl -> id, attrib[i]);
+    glEnableVertexAttribArray (glsl -> array_pointer[i+1]);
+    glVertexAttribPointer (glsl -> array_pointer[i+1], size[i], GL_FLOAT, GL_FALSE, obj -> inst_buffer_size*sizeof(GLfloat), (GLvoid*) (pos*sizeof(GLfloat)));
+    glVertexAttribDivisor (glsl -> array_pointer[i+1], 1);
+    pos += size[i];
+  }
+}
+
 /*!
   \fn object_3d * duplicate_object_3d (object_3d * old_obj)
 
@@ -566,6 +622,12 @@ object_3d * duplicate_object_3d (object_3d * old_obj)
     new_obj -> instances = duplicate_float (new_obj -> num_instances*old_obj -> inst_buffer_size, old_obj -> instances);
   }
   new_obj -> texture = old_obj -> texture;
+  // Lattice translations
+  new_obj -> num_translations = old_obj -> num_translations;
+  if (old_obj -> translations != NULL)
+  {
+    new_obj -> translations = duplicate_int (5*new_obj -> num_translations, old_obj -> translations);
+  }
   int i;
   for (i=0; i<5; i++) new_obj -> shift[i] = old_obj -> shift[i];
   return new_obj;
@@ -583,6 +645,7 @@ object_3d * free_object_3d (object_3d * obj)
   if (obj -> vertices) g_free (obj -> vertices);
   if (obj -> indices) g_free (obj -> indices);
   if (obj -> instances) g_free (obj -> instances);
+  if (obj -> translations) g_free (obj -> translations);
   g_free (obj);
   return NULL;
 }
@@ -600,11 +663,204 @@ glsl_program * free_this_glsl_program (glsl_program * glsl)
   if (glsl -> uniform_loc) g_free (glsl -> uniform_loc);
   if (glsl -> light_uniform) g_free (glsl -> light_uniform);
   if (glsl -> vbo) g_free (glsl -> vbo);
+  if (glsl -> chunk_start) g_free (glsl -> chunk_start);
+  if (glsl -> chunk_size) g_free (glsl -> chunk_size);
+  if (glsl -> chunk_bounds) g_free (glsl -> chunk_bounds);
   glsl -> obj = free_object_3d (glsl -> obj);
   g_free (glsl);
   return NULL;
 }
 
+int ogl_base_instance = -1;
+
+/*!
+  \fn gboolean glsl_base_instance ()
+
+  \brief can a range of instances be drawn, ie. is 'glDraw*InstancedBaseInstance' available
+*/
+gboolean glsl_base_instance ()
+{
+  if (ogl_base_instance < 0) ogl_base_instance = (epoxy_gl_version() >= 42 || epoxy_has_gl_extension ("GL_ARB_base_instance"));
+  return ogl_base_instance;
+}
+
+/*!
+  \fn gboolean glsl_in_chunks (glsl_program * glsl)
+
+  \brief can this OpenGL object be divided in spatial chunks for the view frustum culling
+
+  \param glsl the target glsl
+*/
+gboolean glsl_in_chunks (glsl_program * glsl)
+{
+  int object = glsl -> object;
+  if (object != ATOMS && object != BONDS && object != POLYS && object != RINGS && object != SELEC && object != PICKS) return FALSE;
+  if (glsl -> draw_type == GLSL_POLYEDRA) return (glsl -> vert_type == GL_TRIANGLES);
+  // Instances drawn by lattice translation are sorted by translation
+  if (glsl -> obj -> num_translations) return FALSE;
+  if (glsl -> draw_type == GLSL_POINTS || glsl -> draw_type == GLSL_SPHERES || glsl -> draw_type == GLSL_CYLINDERS || glsl -> draw_type == GLSL_CAPS)
+  {
+    // Drawing a range of instances requires 'glDraw*InstancedBaseInstance'
+    return (glsl -> draw_instanced && glsl_base_instance ());
+  }
+  return FALSE;
+}
+
+/*!
+  \fn void item_bounds (glsl_program * glsl, float * data, int id, float * bounds)
+
+  \brief compute the bounding sphere of an instance (or a triangle)
+
+  \param glsl the target glsl
+  \param data the instances (or the vertices)
+  \param id the instance (or triangle) id
+  \param bounds the bounding sphere to fill: center (x,y,z) and radius
+*/
+void item_bounds (glsl_program * glsl, float * data, int id, float * bounds)
+{
+  int i, j;
+  float * item;
+  vec3_t cent;
+  if (glsl -> draw_type == GLSL_POLYEDRA)
+  {
+    j = glsl -> obj -> vert_buffer_size;
+    item = & data[3*id*j];
+    cent = vec3 ((item[0] + item[j] + item[2*j])/3.0, (item[1] + item[j+1] + item[2*j+1])/3.0, (item[2] + item[j+2] + item[2*j+2])/3.0);
+    bounds[3] = 0.0;
+    for (i=0; i<3; i++) bounds[3] = max (bounds[3], v3_length (v3_sub (vec3 (item[i*j], item[i*j+1], item[i*j+2]), cent)));
+  }
+  else
+  {
+    item = & data[id*glsl -> obj -> inst_buffer_size];
+    cent = vec3 (item[0], item[1], item[2]);
+    // Spheres, points and caps: radius, cylinders: length and radius
+    bounds[3] = (glsl -> draw_type == GLSL_CYLINDERS) ? item[3]/2.0 + item[4] : item[3];
+  }
+  bounds[0] = cent.x;
+  bounds[1] = cent.y;
+  bounds[2] = cent.z;
+}
+
+/*!
+  \fn void sort_in_chunks (glsl_program * glsl)
+
+  \brief sort the instances (or triangles) of an OpenGL object on a uniform grid,
+  each non-empty grid cell is a chunk of consecutive data, with a bounding sphere, for the view frustum culling
+
+  \param glsl the target glsl
+*/
+void sort_in_chunks (glsl_program * glsl)
+{
+  int i, j, k, n;
+  int size, items, cells;
+  float * data;
+  float * bounds;
+  float * sorted;
+  int * cell_id;
+  int * cell_start;
+  float pmin[3], pmax[3];
+
+  if (! glsl_in_chunks (glsl)) return;
+  if (glsl -> draw_type == GLSL_POLYEDRA)
+  {
+    data = glsl -> obj -> vertices;
+    size = 3*glsl -> obj -> vert_buffer_size;
+    items = glsl -> obj -> num_vertices / 3;
+  }
+  else
+  {
+    data = glsl -> obj -> instances;
+    size = glsl -> obj -> inst_buffer_size;
+    items = glsl -> obj -> num_instances;
+  }
+  if (items < CULL_MIN_ITEMS) return;
+
+  bounds = allocfloat (4*items);
+  for (i=0; i<items; i++) item_bounds (glsl, data, i, & bounds[4*i]);
+  for (j=0; j<3; j++) pmin[j] = pmax[j] = bounds[j];
+  for (i=1; i<items; i++)
+  {
+    for (j=0; j<3; j++)
+    {
+      pmin[j] = min (pmin[j], bounds[4*i+j]);
+      pmax[j] = max (pmax[j], bounds[4*i+j]);
+    }
+  }
+  n = max (1, (int)ceil (cbrt ((double)items / CULL_CHUNK_SIZE)));
+  cells = n*n*n;
+  cell_id = allocint (items);
+  cell_start = allocint (cells+1);
+  for (i=0; i<items; i++)
+  {
+    cell_id[i] = 0;
+    for (j=2; j>-1; j--)
+    {
+      k = (pmax[j] > pmin[j]) ? (int)(n * (bounds[4*i+j] - pmin[j]) / (pmax[j] - pmin[j])) : 0;
+      cell_id[i] = n*cell_id[i] + min (k, n-1);
+    }
+    cell_start[cell_id[i]+1] ++;
+  }
+  glsl -> num_chunks = 0;
+  for (i=0; i<cells; i++)
+  {
+    if (cell_start[i+1]) glsl -> num_chunks ++;
+    cell_start[i+1] += cell_start[i];
+  }
+  // Counting sort of the data, by grid cell
+  sorted = allocfloat (items*size);
+  float * sorted_bounds = allocfloat (4*items);
+  for (i=0; i<items; i++)
+  {
+    j = cell_start[cell_id[i]];
+    memcpy (& sorted[j*size], & data[i*size], size*sizeof*data);
+    memcpy (& sorted_bounds[4*j], & bounds[4*i], 4*sizeof*bounds);
+    cell_start[cell_id[i]] ++;
+  }
+  memcpy (data, sorted, items*size*sizeof*data);
+  g_free (sorted);
+  g_free (bounds);
+  g_free (cell_id);
+
+  glsl -> chunk_start = allocint (glsl -> num_chunks);
+  glsl -> chunk_size = allocint (glsl -> num_chunks);
+  glsl -> chunk_bounds = allocfloat (4*glsl -> num_chunks);
+  // After the sort 'cell_start[i]' is the end of the cell i
+  j = k = 0;
+  for (i=0; i<cells; i++)
+  {
+    if (cell_start[i] > j)
+    {
+      glsl -> chunk_start[k] = j;
+      glsl -> chunk_size[k] = cell_start[i] - j;
+      k ++;
+      j = cell_start[i];
+    }
+  }
+  g_free (cell_start);
+  for (i=0; i<glsl -> num_chunks; i++)
+  {
+    float * cb = & glsl -> chunk_bounds[4*i];
+    for (j=0; j<3; j++)
+    {
+      pmin[j] = pmax[j] = sorted_bounds[4*glsl -> chunk_start[i]+j];
+    }
+    for (k=glsl -> chunk_start[i]; k<glsl -> chunk_start[i]+glsl -> chunk_size[i]; k++)
+    {
+      for (j=0; j<3; j++)
+      {
+        pmin[j] = min (pmin[j], sorted_bounds[4*k+j]);
+        pmax[j] = max (pmax[j], sorted_bounds[4*k+j]);
+      }
+    }
+    for (j=0; j<3; j++) cb[j] = (pmin[j] + pmax[j])/2.0;
+    for (k=glsl -> chunk_start[i]; k<glsl -> chunk_start[i]+glsl -> chunk_size[i]; k++)
+    {
+      cb[3] = max (cb[3], v3_length (v3_sub (vec3 (sorted_bounds[4*k], sorted_bounds[4*k+1], sorted_bounds[4*k+2]), vec3 (cb[0], cb[1], cb[2]))) + sorted_bounds[4*k+3]);
+    }
+  }
+  g_free (sorted_bounds);
+}
+
 /*!
   \fn glsl_program * init_shader_program (int object, int object_id,
                                           const GLchar * vertex, const GLchar * geometry, const GLchar * fragment,
@@ -613,7 +869,7 @@ glsl_program * free_this_glsl_program (glsl_program * glsl)
   \brief create an OpenGL shader program
 
   \param object shader id (in enum shaders)
-  \param object_id shader type in: GLSL_SPHERES, GLSL_POINTS, GLSL_LINES, GLSL_CYLINDERS, GLSL_CAPS, GLSL_POLYEDRA, GLSL_STRING, GLSL_BACK
+  \param object_id shader type in: GLSL_SPHERES, GLSL_POINTS, GLSL_LINES, GLSL_CYLINDERS, GLSL_CAPS, GLSL_POLYEDRA, GLSL_STRING, GLSL_BACK, GLSL_GLYPHS
   \param vertex general shader: in the shaders defined in 'ogl_shaders.c'
   \param geometry geometry shader, if any: in the shaders defined in 'ogl_shaders.c'
   \param fragment color shader, if any: in the shaders defined in 'ogl_shaders.c'
@@ -667,6 +923,7 @@ glsl_program * init_shader_program (int object, int object_id,
   if (glsl -> draw_type != GLSL_STRING) obj = free_object_3d (obj);
 
   glsl -> draw_instanced = FALSE;
+  glsl -> cell_replicas = glsl_in_cell_replicas (object);
 
   int nvbo = 1;
   if (glsl -> obj -> num_indices > 0) nvbo ++;
@@ -679,6 +936,8 @@ glsl_program * init_shader_program (int object, int object_id,
   glsl -> vbo = allocgluint (nvbo);
   glGenBuffers (nvbo, glsl -> vbo);
 
+  sort_in_chunks (glsl);
+
   switch (object_id)
   {
     case GLSL_SPHERES:
@@ -707,6 +966,10 @@ glsl_program * init_shader_program (int object, int object_id,
     case GLSL_STRING:
       glsl_bind_string (glsl, glsl -> obj);
       break;
+    case GLSL_GLYPHS:
+      // narray = 6
+      glsl_bind_glyphs (glsl, glsl -> obj);
+      break;
     case GLSL_BACK:
       glsl_bind_background (glsl, glsl -> obj);
       break;
@@ -987,6 +1250,261 @@ void shading_glsl_text (glsl_program * glsl)
   if (glsl -> object == MEASU) glUniform1i (glsl -> uniform_loc[7], this_tilt);
 }
 
+/*!
+  \fn gboolean glsl_in_cell_replicas (int object)
+
+  \brief is this OpenGL object rendered once per extra cell, \n
+  translating the instances of the initial cell, rather than from replicated data
+
+  \param object shader id (in enum shaders)
+*/
+gboolean glsl_in_cell_replicas (int object)
+{
+  return (object == ATOMS || object == BONDS || object == SELEC || object == PICKS);
+}
+
+mat4_t cull_matrix;
+mat4_t cull_model_view;
+
+/*!
+  \fn void draw_this_range (glsl_program * glsl, int first, int count)
+
+  \brief issue the OpenGL draw call for a range of instances (or triangles)
+
+  \param glsl the target glsl
+  \param first the first instance (or triangle)
+  \param count the number of instances (or triangles)
+*/
+void draw_this_range (glsl_program * glsl, int first, int count)
+{
+  if (glsl -> draw_type == GLSL_POLYEDRA)
+  {
+    glDrawArrays (glsl -> vert_type, 3*first, 3*count);
+  }
+  else if (glsl -> draw_type == GLSL_POINTS)
+  {
+    glDrawArraysInstancedBaseInstance (glsl -> vert_type, 0, 3, count, first);
+  }
+  else
+  {
+    glDrawElementsInstancedBaseInstance (glsl -> vert_type, glsl -> obj -> num_indices, GL_UNSIGNED_INT, 0, count, first);
+  }
+}
+
+/*!
+  \fn void draw_visible_chunks (glsl_program * glsl)
+
+  \brief draw the chunks of an OpenGL object that intersect the view frustum,
+  consecutive visible chunks are drawn using a single call
+
+  \param glsl the target glsl
+*/
+void draw_visible_chunks (glsl_program * glsl)
+{
+  int i, j, k;
+  float norm, dist;
+  float plane[6][4];
+  gboolean visible;
+  // Frustum planes from the rows of the clip matrix: (w + x), (w - x), (w + y), (w - y), (w + z), (w - z)
+  for (i=0; i<6; i++)
+  {
+    k = i/2;
+    for (j=0; j<4; j++)
+    {
+      plane[i][j] = (i%2) ? cull_matrix.m[j][3] - cull_matrix.m[j][k] : cull_matrix.m[j][3] + cull_matrix.m[j][k];
+    }
+    norm = sqrt (plane[i][0]*plane[i][0] + plane[i][1]*plane[i][1] + plane[i][2]*plane[i][2]);
+    if (norm > 0.0) for (j=0; j<4; j++) plane[i][j] /= norm;
+  }
+  j = k = 0;
+  for (i=0; i<glsl -> num_chunks; i++)
+  {
+    float * cb = & glsl -> chunk_bounds[4*i];
+    visible = TRUE;
+    for (j=0; j<6; j++)
+    {
+      dist = plane[j][0]*cb[0] + plane[j][1]*cb[1] + plane[j][2]*cb[2] + plane[j][3];
+      if (dist < - cb[3])
+      {
+        visible = FALSE;
+        break;
+      }
+    }
+    if (visible)
+    {
+      k += glsl -> chunk_size[i];
+    }
+    else if (k)
+    {
+      draw_this_range (glsl, glsl -> chunk_start[i] - k, k);
+      k = 0;
+    }
+  }
+  if (k) draw_this_range (glsl, glsl -> chunk_start[i-1] + glsl -> chunk_size[i-1] - k, k);
+}
+
+/*!
+  \fn void draw_translated_instances (glsl_program * glsl)
+
+  \brief draw the instances of an OpenGL object once per lattice translation,
+  the translation being applied to the model view matrix using the cell vectors
+
+  \param glsl the target glsl
+*/
+void draw_translated_instances (glsl_program * glsl)
+{
+  int i;
+  int * trans;
+  vec3_t shift;
+  mat4_t cell_matrix;
+  for (i=0; i<glsl -> obj -> num_translations; i++)
+  {
+    trans = & glsl -> obj -> translations[5*i];
+    shift.x = trans[0]*box_gl -> vect[0][0] + trans[1]*box_gl -> vect[1][0] + trans[2]*box_gl -> vect[2][0];
+    shift.y = trans[0]*box_gl -> vect[0][1] + trans[1]*box_gl -> vect[1][1] + trans[2]*box_gl -> vect[2][1];
+    shift.z = trans[0]*box_gl -> vect[0][2] + trans[1]*box_gl -> vect[1][2] + trans[2]*box_gl -> vect[2][2];
+    cell_matrix = m4_mul (cull_matrix, m4_translation (shift));
+    glUniformMatrix4fv (glsl -> uniform_loc[0], 1, GL_FALSE, & cell_matrix.m00);
+    if (glsl -> light_uniform != NULL)
+    {
+      cell_matrix = m4_mul (cull_model_view, m4_translation (shift));
+      glUniformMatrix4fv (glsl -> light_uniform[0], 1, GL_FALSE, & cell_matrix.m00);
+    }
+    draw_this_range (glsl, trans[3], trans[4]);
+  }
+}
+
+/*!
+  \fn void draw_this_glsl (glsl_program * glsl)
+
+  \brief issue the OpenGL draw call(s) for a shader program, the VAO being bound
+
+  \param glsl the target glsl
+*/
+void draw_this_glsl (glsl_program * glsl)
+{
+  int j;
+  if (glsl -> draw_type == GLSL_SPHERES || glsl -> draw_type == GLSL_CYLINDERS || glsl -> draw_type == GLSL_CAPS)
+  {
+    gboolean poly_offset = (! plot -> ray_tracing && (glsl -> draw_type == GLSL_CYLINDERS || glsl -> draw_type == GLSL_CAPS));
+    if (poly_offset)
+    {
+      glEnable (GL_POLYGON_OFFSET_FILL);
+      glPolygonOffset (1.0, 1.0);
+    }
+    if (glsl -> obj -> num_translations)
+    {
+      draw_translated_instances (glsl);
+    }
+    else if (glsl -> num_chunks)
+    {
+      draw_visible_chunks (glsl);
+    }
+    else if (glsl -> draw_instanced)
+    {
+      glDrawElementsInstanced (glsl -> vert_type, glsl -> obj -> num_indices, GL_UNSIGNED_INT, 0, glsl -> obj -> num_instances);
+    }
+    else
+    {
+      glDrawElements (glsl -> vert_type, glsl -> obj -> num_indices, GL_UNSIGNED_INT, 0);
+    }
+    if (poly_offset)
+    {
+      glDisable (GL_POLYGON_OFFSET_FILL);
+    }
+  }
+  else if (glsl -> draw_type == GLSL_POINTS || glsl -> draw_type == GLSL_LINES || glsl -> draw_type == GLSL_STRING || glsl -> draw_type == GLSL_GLYPHS)
+  {
+    if (glsl -> draw_type == GLSL_STRING || glsl -> draw_type == GLSL_GLYPHS)
+    {
+      glEnable (ogl_texture);
+      glActiveTexture (GL_TEXTURE0);
+      glBindTexture (ogl_texture, glsl -> obj -> texture);
+    }
+#ifdef GTK4
+    else
+    {
+      glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+#endif
+    if (glsl -> obj -> num_translations)
+    {
+      draw_translated_instances (glsl);
+    }
+    else if (glsl -> num_chunks)
+    {
+      draw_visible_chunks (glsl);
+    }
+    else if (glsl -> draw_instanced)
+    {
+      j = (glsl -> draw_type == GLSL_STRING || glsl -> draw_type == GLSL_GLYPHS) ? 4 : 3*(glsl -> draw_type+1);
+      glDrawArraysInstanced (glsl -> vert_type, 0, j, glsl -> obj -> num_instances);
+    }
+    else
+    {
+      glDrawArrays (glsl -> vert_type, 0, glsl -> obj -> num_vertices);
+    }
+#ifdef GTK4
+    if (glsl -> draw_type == GLSL_POINTS || glsl -> draw_type == GLSL_LINES)
+    {
+      glBlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    }
+#endif
+  }
+  else
+  {
+    if (glsl -> draw_type == GLSL_BACK) glDisable (GL_DEPTH_TEST);
+    if (glsl -> num_chunks)
+    {
+      draw_visible_chunks (glsl);
+    }
+    else
+    {
+      glDrawArrays (glsl -> vert_type, 0, glsl -> obj -> num_vertices);
+    }
+    if (glsl -> draw_type == GLSL_BACK) glEnable (GL_DEPTH_TEST);
+  }
+}
+
+/*!
+  \fn void draw_cell_replicas (glsl_program * glsl)
+
+  \brief draw the shader program once per extra cell, the instances of the initial cell
+  are translated using the model view matrix, so that the data is not replicated. \n
+  As in the CPU replication, extra cells are rendered with half opacity.
+
+  \param glsl the target glsl
+*/
+void draw_cell_replicas (glsl_program * glsl)
+{
+  int i, j, k;
+  vec3_t shift;
+  mat4_t cell_matrix;
+  for (i=0; i<plot -> abc -> extra_cell[0]+1; i++)
+  {
+    for (j=0; j<plot -> abc -> extra_cell[1]+1; j++)
+    {
+      for (k=0; k<plot -> abc -> extra_cell[2]+1; k++)
+      {
+        shift.x = i*box_gl -> vect[0][0] + j*box_gl -> vect[1][0] + k*box_gl -> vect[2][0];
+        shift.y = i*box_gl -> vect[0][1] + j*box_gl -> vect[1][1] + k*box_gl -> vect[2][1];
+        shift.z = i*box_gl -> vect[0][2] + j*box_gl -> vect[1][2] + k*box_gl -> vect[2][2];
+        cell_matrix = m4_mul (wingl -> proj_model_view_matrix, m4_translation (shift));
+        glUniformMatrix4fv (glsl -> uniform_loc[0], 1, GL_FALSE, & cell_matrix.m00);
+        cull_matrix = cell_matrix;
+        if (glsl -> light_uniform != NULL)
+        {
+          cell_matrix = m4_mul (wingl -> model_view_matrix, m4_translation (shift));
+          glUniformMatrix4fv (glsl -> light_uniform[0], 1, GL_FALSE, & cell_matrix.m00);
+          cull_model_view = cell_matrix;
+          glUniform1f (glsl -> light_uniform[9], (i || j || k) ? 0.5*plot -> m_terial.param[5] : plot -> m_terial.param[5]);
+        }
+        draw_this_glsl (glsl);
+      }
+    }
+  }
+}
+
 /*!
   \fn void render_this_shader (glsl_program * glsl, int ids)
 
@@ -1096,62 +1614,15 @@ void render_this_shader (glsl_program * glsl, int ids)
     glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
   }
 
-  if (glsl -> draw_type == GLSL_SPHERES || glsl -> draw_type == GLSL_CYLINDERS || glsl -> draw_type == GLSL_CAPS)
+  cull_matrix = wingl -> proj_model_view_matrix;
+  cull_model_view = wingl -> model_view_matrix;
+  if (glsl -> cell_replicas && (plot -> abc -> extra_cell[0] || plot -> abc -> extra_cell[1] || plot -> abc -> extra_cell[2]))
   {
-    gboolean poly_offset = (! plot -> ray_tracing && (glsl -> draw_type == GLSL_CYLINDERS || glsl -> draw_type == GLSL_CAPS));
-    if (poly_offset)
-    {
-      glEnable (GL_POLYGON_OFFSET_FILL);
-      glPolygonOffset (1.0, 1.0);
-    }
-    if (glsl -> draw_instanced)
-    {
-      glDrawElementsInstanced (glsl -> vert_type, glsl -> obj -> num_indices, GL_UNSIGNED_INT, 0, glsl -> obj -> num_instances);
-    }
-    else
-    {
-      glDrawElements (glsl -> vert_type, glsl -> obj -> num_indices, GL_UNSIGNED_INT, 0);
-    }
-    if (poly_offset)
-    {
-      glDisable (GL_POLYGON_OFFSET_FILL);
-    }
-  }
-  else if (glsl -> draw_type == GLSL_POINTS || glsl -> draw_type == GLSL_LINES || glsl -> draw_type == GLSL_STRING)
-  {
-    if (glsl -> draw_type == GLSL_STRING)
-    {
-      glEnable (ogl_texture);
-      glActiveTexture (GL_TEXTURE0);
-      glBindTexture (ogl_texture, glsl -> obj -> texture);
-    }
-#ifdef GTK4
-    else
-    {
-      glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    }
-#endif
-    if (glsl -> draw_instanced)
-    {
-      j = (glsl -> draw_type == GLSL_STRING) ? 4 : 3*(glsl -> draw_type+1);
-      glDrawArraysInstanced (glsl -> vert_type, 0, j, glsl -> obj -> num_instances);
-    }
-    else
-    {
-      glDrawArrays (glsl -> vert_type, 0, glsl -> obj -> num_vertices);
-    }
-#ifdef GTK4
-    if (glsl -> draw_type == GLSL_POINTS || glsl -> draw_type == GLSL_LINES)
-    {
-      glBlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-    }
-#endif
+    draw_cell_replicas (glsl);
   }
   else
   {
-    if (glsl -> draw_type == GLSL_BACK) glDisable (GL_DEPTH_TEST);
-    glDrawArrays (glsl -> vert_type, 0, glsl -> obj -> num_vertices);
-    if (glsl -> draw_type == GLSL_BACK) glEnable (GL_DEPTH_TEST);
+    draw_this_glsl (glsl);
   }
   if (glsl_disable_cull_face (glsl)) glEnable (GL_CULL_FACE);
   glBindVertexArray (0);
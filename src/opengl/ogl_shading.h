@@ -43,7 +43,8 @@ enum glsl_styles {
   GLSL_POLYEDRA  = 5, /*!< 5 */
   GLSL_STRING    = 6, /*!< 6 */
   GLSL_LIGHT     = 7, /*!< 7 */
-  GLSL_BACK      = 8  /*!< 8 */
+  GLSL_BACK      = 8, /*!< 8 */
+  GLSL_GLYPHS    = 9  /*!< 9 */
 };
 
 #define POLY_BUFF_SIZE 10  // p(x,y,z), n(x,y,z), color (r,g,b,a)
@@ -52,6 +53,21 @@ enum glsl_styles {
 #define CAPS_BUFF_SIZE 12  // p(x,y,z), rad, quat(w,x,y,z), color (r,g,b,a)
 #define ATOM_BUFF_SIZE  8  // p(x,y,z), rad, color (r,g,b,a)
 #define CHAR_BUFF_SIZE  4  // p(x,y), t(x,y)
+#define GLYPH_BUFF_SIZE 18 // p(x,y,z), shift(x,y,z), quad(x,y,w,h), atlas(x,y,w,h), color (r,g,b,a)
+
+// View frustum culling, see 'sort_in_chunks'
+#define CULL_MIN_ITEMS  16384  // Below this number of instances (or triangles) the object is not divided in chunks
+#define CULL_CHUNK_SIZE  2048  // Average number of instances (or triangles) in a chunk
+
+// Automatic level of detail, see 'get_level_of_detail'
+#define LOD_MIN_OBJECTS   20000     // Below this number of atom(s) and clone(s) the full quality is always used
+#define LOD_VERTEX_BUDGET 20000000  // Maximum number of sphere mesh vertices to render
+#define LOD_MIN_QUALITY   6         // Quality of the lowest poly meshes
+#define LOD_MESH_PIXELS   4.0       // On screen sphere radius, in pixels, below which the lowest poly meshes are used
+#define LOD_POINT_PIXELS  1.5       // On screen sphere radius, in pixels, below which spheres are rendered as points
+
+// Periodic clones drawn by lattice translation, see 'find_clone_images'
+#define CLONE_CELLS 3  // Largest translation, in cell vector(s), of a clone
 
 // Points
 extern const GLchar * point_vertex;
@@ -88,6 +104,9 @@ extern const GLchar * cap_vertex_ray;
 extern const GLchar * string_vertex;
 extern const GLchar * string_color;
 extern const GLchar * string_color_2d;
+extern const GLchar * glyph_vertex;
+extern const GLchar * glyph_color;
+extern const GLchar * glyph_color_2d;
 
 extern const GLchar * background_vertex;
 extern const GLchar * background_linear;
@@ -111,6 +130,9 @@ struct object_3d
   float shift[4];          /*!< 0 to 2, texture position shift, if any: \n
                              (0 = x_shift, 1 = y_shift, 2 = z_shift), \n
                               3 visibility (0 = normal, 1 = always) */
+  int num_translations;    /*!< Number of lattice translation(s) of the instances, if any */
+  int * translations;      /*!< For each translation: the lattice translation (3 integers), \n
+                                then the first instance and the number of instances to translate */
 };
 
 /*! \typedef glsl_program */
@@ -125,6 +147,7 @@ struct glsl_program
   GLenum vert_type;        /*!< The type of vertex */
   int draw_type;           /*!< In \enum glsl_styles */
   gboolean draw_instanced; /*!< 0 = single instance, 1 = multiple instances */
+  gboolean cell_replicas;  /*!< 0 = draw once, 1 = draw once per extra cell using a translated model view */
   GLuint vao;              /*!< Vertex object array ID */
   GLuint * vbo;            /*!< Binding buffer(s) */
   GLuint * array_pointer;  /*!< Vertex pointer(s) */
@@ -133,6 +156,10 @@ struct glsl_program
   object_3d * obj;         /*!< The 3D object(s) to render */
   float line_width;        /*!< Wireframe line width */
   ColRGBA * col;           /*!< String color */
+  int num_chunks;          /*!< Number of spatial chunks used for the view frustum culling, if any */
+  int * chunk_start;       /*!< First instance (or triangle) of each chunk */
+  int * chunk_size;        /*!< Number of instances (or triangles) in each chunk */
+  float * chunk_bounds;    /*!< Bounding sphere of each chunk: center (x,y,z) and radius */
 };
 
 extern void allocate_instances (object_3d * object);
@@ -30,9 +30,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 *
 * List of functions:
 
-  int find_bond_in_bonds (project * this_proj, int i, int j, int b, int id);
-  int find_selected_bond (project * this_proj, int id);
-  int find_selected_atom (project * this_proj, int id);
+  int get_picked_object (glwin * view, int picked_id);
   int num_bonds (int i);
   int num_angles (int i);
   int num_dihedrals (int i);
@@ -49,6 +47,10 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void process_selected_atom (project * this_proj, glwin * view, int id, int ac, int se, int pi);
   void process_selection (project * this_proj, glwin * view, int id, int ac, int pi);
   void process_the_hits (glwin * view, gint event_button, double ptx, double pty);
+  void add_region_point (glwin * view, double x, double y, int region);
+  void process_the_region (glwin * view);
+
+  gboolean in_region_path (glwin * view, double x, double y);
 
   atom_in_selection * new_atom_in_selection (int id, int sp);
 
@@ -68,107 +70,20 @@ extern int selected_aspec;
 extern int get_to_be_selected (glwin * view);
 
 /*!
-  \fn int find_bond_in_bonds (project * this_proj, int i, int j, int b, int id)
-
-  \brief Find for a bond ID in the bond list using the atoms in the bond
-
-  \param this_proj the target project
-  \param i id tracker
-  \param j the MD step
-  \param b 0 = normal, 1 = clones
-  \param id the id-th visible bond to find
-*/
-int find_bond_in_bonds (project * this_proj, int i, int j, int b, int id)
-{
-  int k, l, m;
-  for (k=0; k < this_proj -> modelgl -> bonds[j][b]; k++)
-  {
-    l = this_proj -> modelgl -> bondid[j][b][k][0];
-    m = this_proj -> modelgl -> bondid[j][b][k][1];
-    if (this_proj -> atoms[j][l].show[b]) i ++;
-    if (i == id) return k;
-    if (b)
-    {
-      if (this_proj -> atoms[j][l].show[b]) i ++;
-      if (i == id) return k;
-    }
-    if (this_proj -> atoms[j][m].show[b]) i ++;
-    if (i == id) return k;
-    if (b)
-    {
-      if (this_proj -> atoms[j][m].show[b]) i ++;
-      if (i == id) return k;
-    }
-  }
-  return -i;
-}
-
-/*!
-  \fn int find_selected_bond (project * this_proj, int id)
+  \fn int get_picked_object (glwin * view, int picked_id)
 
-  \brief find the selected bond based of the picked color id
+  \brief decode a picked color id, return the pick id or -1 if nothing was picked
 
-  \param this_proj the target project
-  \param id the id-th visible bond to find
-*/
-int find_selected_bond (project * this_proj, int id)
-{
-  int i, j, k;
-
-  i = this_proj -> modelgl -> clones_to_be_picked - 1;
-  j = this_proj -> modelgl -> anim -> last -> img -> step;
-  k = find_bond_in_bonds (this_proj, i, j, 0, id);
-  if (k < 0 && this_proj -> modelgl -> anim -> last -> img -> draw_clones)
-  {
-    k = find_bond_in_bonds (this_proj, -k, j, 1, id);
-    if (k < 0)
-    {
-      return -1;
-    }
-    else
-    {
-      return k;
-    }
-  }
-  else if (k < 0)
-  {
-    return -1;
-  }
-  else
-  {
-    return k;
-  }
-}
-
-/*!
-  \fn int find_selected_atom (project * this_proj, int id)
-
-  \brief find the selected atom based of the picked color id
-
-  \param this_proj the target project
-  \param id the id-th visible atom or clone to find
+  \param view the target glwin
+  \param picked_id the color id read in the picking buffer
 */
-int find_selected_atom (project * this_proj, int id)
+int get_picked_object (glwin * view, int picked_id)
 {
-  int i, j, k, l, m;
-  i = -1;
-  j = this_proj -> modelgl -> anim -> last -> img -> step;
-  for (k=0; k<this_proj -> natomes; k++)
+  // Pick colors are attributed sequentially starting from 1, see 'get_atom_color'
+  int i = picked_id - 1;
+  if (i > -1 && i < view -> to_be_picked)
   {
-    if (this_proj -> atoms[j][k].show[0]) i++;
-    if (i == id) return k;
-  }
-  if (this_proj -> modelgl -> anim -> last -> img -> draw_clones)
-  {
-    for (k=0; k < this_proj -> modelgl -> bonds[j][1]; k++)
-    {
-      l = this_proj -> modelgl -> bondid[step][1][k][0];
-      m = this_proj -> modelgl -> bondid[step][1][k][1];
-      if (this_proj -> atoms[j][l].show[1]) i++;
-      if (i == id) return l;
-      if (this_proj -> atoms[j][m].show[1]) i++;
-      if (i == id) return m;
-    }
+    if (view -> color_to_pick[i] == picked_id) return i;
   }
   return -1;
 }
@@ -589,7 +504,7 @@ void process_selection (project * this_proj, glwin * view, int id, int ac, int p
 */
 void process_the_hits (glwin * view, gint event_button, double ptx, double pty)
 {
-  int i, j, k, l, m, n, o, p, q;
+  int j, k, l, m, n, o, p, q;
   view -> picked = FALSE;
   GLubyte pixel[4];
   GLint viewport[4];
@@ -598,16 +513,8 @@ void process_the_hits (glwin * view, gint event_button, double ptx, double pty)
   glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
   glReadPixels (scale * view -> mouseX, viewport[3] - scale * view -> mouseY, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
 
-  int picked_id = pixel[0] + 256*pixel[1] + 256*256*pixel[2];
-  for (i=0; i<view -> to_be_picked; i++)
-  {
-    if (picked_id == view -> color_to_pick[i])
-    {
-      j = i;
-      view -> picked = TRUE;
-      break;
-    }
-  }
+  j = get_picked_object (view, pixel[0] + 256*pixel[1] + 256*256*pixel[2]);
+  view -> picked = (j > -1) ? TRUE : FALSE;
   to_pop.action = 0;
   to_pop.x = 0.0;
   to_pop.y = 0.0;
@@ -619,7 +526,7 @@ void process_the_hits (glwin * view, gint event_button, double ptx, double pty)
     l = view -> anim -> last -> img -> step;
     if (j < view -> clones_to_be_picked)
     {
-      m = find_selected_atom (this_proj, j);
+      m = view -> pick_to_object[j];
       n = (j < view -> atoms_to_be_picked) ? 0 : 1;
       o = m;
       p = -1;
@@ -627,7 +534,7 @@ void process_the_hits (glwin * view, gint event_button, double ptx, double pty)
     }
     else
     {
-      m = find_selected_bond (this_proj, j);
+      m = view -> pick_to_object[j];
       n = (j <  view -> bonds_to_be_picked) ? 0 : 1;
       o = view -> bondid[l][n][m][0];
       p = view -> bondid[l][n][m][1];
@@ -750,3 +657,168 @@ void process_the_hits (glwin * view, gint event_button, double ptx, double pty)
     // popup_main_menu (view, ptx, pty);
   }
 }
+
+/*!
+  \fn void add_region_point (glwin * view, double x, double y, int region)
+
+  \brief add a point to the region selection path
+
+  \param view the target glwin
+  \param x x position
+  \param y y position
+  \param region the type of region: 1 = rectangle, 2 = lasso
+*/
+void add_region_point (glwin * view, double x, double y, int region)
+{
+  int i;
+  if (! view -> pick_region)
+  {
+    // The region starts where the mouse button was pressed
+    if (view -> region_path != NULL) g_free (view -> region_path);
+    view -> region_path = g_malloc0 (64*sizeof*view -> region_path);
+    view -> region_path[0] = view -> mouseX;
+    view -> region_path[1] = view -> mouseY;
+    view -> region_points = 1;
+    view -> pick_region = region;
+  }
+  if (view -> pick_region == 1)
+  {
+    // Rectangle: the path is the diagonal of the rectangle
+    view -> region_path[2] = x;
+    view -> region_path[3] = y;
+    view -> region_points = 2;
+  }
+  else
+  {
+    i = 2*(view -> region_points-1);
+    if (fabs(x - view -> region_path[i]) + fabs(y - view -> region_path[i+1]) < 2.0) return;
+    if (! (view -> region_points % 32))
+    {
+      view -> region_path = g_realloc (view -> region_path, 2*(view -> region_points+32)*sizeof*view -> region_path);
+    }
+    view -> region_path[2*view -> region_points] = x;
+    view -> region_path[2*view -> region_points+1] = y;
+    view -> region_points ++;
+  }
+}
+
+/*!
+  \fn gboolean in_region_path (glwin * view, double x, double y)
+
+  \brief is a point, in window coordinates, inside the lasso path (even-odd rule)
+
+  \param view the target glwin
+  \param x x position
+  \param y y position
+*/
+gboolean in_region_path (glwin * view, double x, double y)
+{
+  int i, j;
+  double * xy = view -> region_path;
+  gboolean in_path = FALSE;
+  j = view -> region_points - 1;
+  for (i=0; i<view -> region_points; i++)
+  {
+    if ((xy[2*i+1] > y) != (xy[2*j+1] > y))
+    {
+      if (x < xy[2*i] + (y - xy[2*i+1]) * (xy[2*j] - xy[2*i]) / (xy[2*j+1] - xy[2*i+1])) in_path = ! in_path;
+    }
+    j = i;
+  }
+  return in_path;
+}
+
+/*!
+  \fn void process_the_region (glwin * view)
+
+  \brief select all atom(s) and clone(s) visible in the rectangle or lasso region,
+  the picking buffer is read back in a single call
+
+  \param view the target glwin
+*/
+void process_the_region (glwin * view)
+{
+  int i, j, k, l, m;
+  int x_min, x_max, y_min, y_max;
+  int width, height;
+  double xmin, xmax, ymin, ymax;
+  GLint viewport[4];
+  project * this_proj = get_project_by_id(view -> proj);
+  int scale = gtk_widget_get_scale_factor (view -> win);
+
+  if (view -> region_points < 2 || ! this_proj -> natomes) goto end;
+  xmin = xmax = view -> region_path[0];
+  ymin = ymax = view -> region_path[1];
+  for (i=1; i<view -> region_points; i++)
+  {
+    xmin = min (xmin, view -> region_path[2*i]);
+    xmax = max (xmax, view -> region_path[2*i]);
+    ymin = min (ymin, view -> region_path[2*i+1]);
+    ymax = max (ymax, view -> region_path[2*i+1]);
+  }
+  glGetIntegerv (GL_VIEWPORT, viewport);
+  x_min = max (0, (int)(scale * xmin));
+  x_max = min (viewport[2] - 1, (int)(scale * xmax));
+  y_min = max (0, viewport[3] - 1 - (int)(scale * ymax));
+  y_max = min (viewport[3] - 1, viewport[3] - 1 - (int)(scale * ymin));
+  width = x_max - x_min + 1;
+  height = y_max - y_min + 1;
+  if (width < 1 || height < 1) goto end;
+
+  GLubyte * pixels = g_malloc0 (4*width*height*sizeof*pixels);
+  glPixelStorei (GL_PACK_ALIGNMENT, 1);
+  glReadPixels (x_min, y_min, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  gboolean * in_region = allocbool (this_proj -> natomes);
+  for (i=0; i<height; i++)
+  {
+    for (j=0; j<width; j++)
+    {
+      k = 4*(i*width + j);
+      l = get_picked_object (view, pixels[k] + 256*pixels[k+1] + 256*256*pixels[k+2]);
+      // Only atoms and clones, bonds are selected through their atoms
+      if (l > -1 && l < view -> clones_to_be_picked)
+      {
+        m = view -> pick_to_object[l];
+        if (! in_region[m])
+        {
+          if (view -> pick_region == 1 || in_region_path (view, (double)(x_min + j)/scale, (double)(viewport[3] - 1 - y_min - i)/scale))
+          {
+            in_region[m] = TRUE;
+          }
+        }
+      }
+    }
+  }
+  g_free (pixels);
+
+  k = (is_atom_win_active(view) || (view -> mode == EDITION && view -> selection_mode == NSELECTION-1)) ? 1 : 0;
+  l = view -> anim -> last -> img -> step;
+  j = 0;
+  save_all_selections (view, k);
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    if (in_region[i] && ! this_proj -> atoms[l][i].pick[k])
+    {
+      process_selection (this_proj, view, i, 0, k);
+      j ++;
+    }
+  }
+  update_all_selections (view, k);
+  g_free (in_region);
+  if (j)
+  {
+    if (view -> mode == EDITION)
+    {
+      init_coordinates (this_proj, 1, FALSE, TRUE);
+      view -> baryc[1] = get_bary (this_proj, 1);
+    }
+    int shaders[1] = {SELEC};
+    re_create_md_shaders (1, shaders, this_proj);
+    view -> create_shaders[LABEL] = TRUE;
+    view -> create_shaders[MEASU] = TRUE;
+    update (view);
+  }
+  end:;
+  view -> pick_region = 0;
+  view -> region_points = 0;
+}
@@ -1533,8 +1533,7 @@ void prep_model (int p)
       }
       else
       {
-        frag_update = (force_mol || trigger_fragment_analysis) ? 1 : (active_project -> natomes > ATOM_LIMIT) ? 0 : 1;
-        mol_update = (force_mol || trigger_molecule_analysis) ? 1 : (frag_update) ? ((active_project -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+        frag_update = mol_update = 1;
         adv_bonding[0] = adv_bonding[1] = TRUE;
       }
       if (active_project -> natomes && adv_bonding[0] && adv_bonding[1])
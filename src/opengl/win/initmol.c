@@ -34,7 +34,11 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 *
 * List of functions:
 
-  int * merge_mol_data (int val_a, int val_b, int table_a[val_a], int table_b[val_b]);
+  int compare_mol_int (const void * a, const void * b);
+  int compare_mol_int64 (const void * a, const void * b);
+
+  guint64 hash_mol_data (guint64 key, gint64 val);
+  guint64 molecule_signature (search_molecule * mol);
 
   gboolean are_identical_molecules (search_molecule * mol_a, search_molecule * mol_b);
 
@@ -42,15 +46,14 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void allocate_mol_for_step_ (int * sid, int * mol_in_step);
   void allocate_mol_data_ ();
   void send_mol_neighbors_ (int * stp, int * mol, int * aid, int * nvs, int neigh[* nvs]);
-  void update_mol_details (search_molecule * mol, int sp, int cp);
   void send_mol_details_ (int * stp, int * mol, int * ats, int * sps, int spec_in_mol[* sps], int atom_in_mol[* ats]);
+  void merge_mol_data (search_molecule * mol_a, search_molecule * mol_b);
   void free_search_molecule_data (search_molecule * smol);
+  void store_molecule_ (int * stepid);
   void setup_molecules_ (int * stepid);
   void setup_menu_molecules_ ();
   void setup_fragments_ (int * sid, int coord[active_project -> natomes]);
 
-  search_molecule * duplicate_search_molecule (search_molecule * old_mol);
-
 */
 
 #include "global.h"
@@ -69,20 +72,33 @@ struct search_molecule
   int * fragments;                        // Fragments list
   int natoms;                             // Number of atoms
   int * atoms;                            // Temporary atom list
+  int msize[2];                           // Allocated size of the fragments and atoms lists
   int nspec;                              // Number of chemical species
   int * species;                          // Number of atom by species
+  int * lgeo;                             // Sorted list of the coordination spheres of the atoms
   int nbonds;                             // Number of chemical bonds
-  int ** pbonds;                          // Number of chemical bonds by geometries
+  int npbonds;                            // Number of chemical bonds seen from the atoms of the molecule
+  gint64 * pbonds;                        // Sorted list of chemical bonds, by pairs of coordination spheres
   int nangles;                            // Number of bond angles
-  int *** pangles;                        // Number of bond angles by geometries
-  int ** lgeo;                            // list of coordination spheres (by species)
+  int npangles;                           // Number of bond angles already received
+  gint64 * pangles;                       // Sorted list of bond angles, by triplets of coordination spheres
+  guint64 key;                            // Topology signature
+  search_molecule * twin;                 // Next unique molecule with the same signature
   search_molecule * next;
-  search_molecule * prev;
+};
+
+typedef struct step_molecules step_molecules;
+struct step_molecules
+{
+  search_molecule current;                // Molecule being received from Fortran90
+  search_molecule * first;                // First unique molecule
+  search_molecule * last;                 // Last unique molecule
+  int num;                                // Number of unique molecule(s)
+  GHashTable * unique;                    // Unique molecules by topology signature
 };
 
 int * pgeo;
-search_molecule * tmp_search = NULL;
-search_molecule ** in_calc_mol = NULL;
+step_molecules * in_calc_mol = NULL;
 extern molecule * tmp_mol;
 
 /*!
@@ -104,64 +120,6 @@ void duplicate_molecule (molecule * new_mol, search_molecule * old_mol)
   new_mol -> species = duplicate_int (active_project -> nspec, old_mol -> species);
 }
 
-/*!
-  \fn search_molecule * duplicate_search_molecule (search_molecule * old_mol)
-
-  \brief create a copy of a search molecule data structure
-
-  \param old_mol the search molecule data structure to copy
-*/
-search_molecule * duplicate_search_molecule (search_molecule * old_mol)
-{
-  search_molecule * new_mol = g_malloc0(sizeof*new_mol);
-  new_mol -> id = old_mol -> id;
-  new_mol -> md = old_mol -> md;
-  new_mol -> multiplicity = old_mol -> multiplicity;
-  new_mol -> fragments = duplicate_int (old_mol -> multiplicity, old_mol -> fragments);
-  new_mol -> natoms = old_mol -> natoms;
-  new_mol -> nspec = old_mol -> nspec;
-  new_mol -> species = duplicate_int (active_project -> nspec, old_mol -> species);
-  int j, k;
-  if (old_mol -> natoms > 1)
-  {
-    new_mol -> pbonds = g_malloc0(active_project -> coord -> totcoord[1]*sizeof*new_mol -> pbonds);
-    if (old_mol -> natoms > 2)
-    {
-      new_mol -> pangles = g_malloc0(active_project -> coord -> totcoord[1]*sizeof*new_mol -> pangles);
-    }
-  }
-  if (old_mol -> atoms)
-  {
-    new_mol -> atoms = duplicate_int (old_mol -> natoms*old_mol -> multiplicity, old_mol -> atoms);
-  }
-  new_mol -> nbonds = old_mol -> nbonds;
-  if (new_mol -> nbonds)
-  {
-    for (j=0; j<active_project -> coord -> totcoord[1]; j++)
-    {
-      new_mol -> pbonds[j] = duplicate_int (active_project -> coord -> totcoord[1], old_mol -> pbonds[j]);
-    }
-    new_mol -> nangles = old_mol -> nangles;
-    if (new_mol -> nangles)
-    {
-      for (j=0; j<active_project -> coord -> totcoord[1]; j++)
-      {
-        new_mol -> pangles[j] = g_malloc0(active_project -> coord -> totcoord[1]*sizeof*new_mol -> pangles[j]);
-        for (k=0; k<active_project -> coord -> totcoord[1]; k++)
-        {
-          new_mol -> pangles[j][k] = duplicate_int (active_project -> coord -> totcoord[1], old_mol -> pangles[j][k]);
-        }
-      }
-    }
-  }
-  new_mol -> lgeo = g_malloc0(active_project -> nspec*sizeof*new_mol -> lgeo);
-  for (j=0; j<active_project -> nspec; j++)
-  {
-    new_mol -> lgeo[j] = duplicate_int (active_project -> coord -> totcoord[1], old_mol -> lgeo[j]);
-  }
-  return new_mol;
-}
-
 /*!
   \fn void allocate_mol_for_step_ (int * sid, int * mol_in_step)
 
@@ -172,7 +130,7 @@ search_molecule * duplicate_search_molecule (search_molecule * old_mol)
 */
 void allocate_mol_for_step_ (int * sid, int * mol_in_step)
 {
-  in_calc_mol[* sid -1] = g_malloc0(* mol_in_step*sizeof*in_calc_mol[* sid -1]);
+  in_calc_mol[* sid -1].unique = g_hash_table_new (g_int64_hash, g_int64_equal);
   active_project -> modelfc -> mol_by_step[* sid - 1] = * mol_in_step;
 }
 
@@ -223,7 +181,8 @@ void allocate_mol_data_ ()
 void send_mol_neighbors_ (int * stp, int * mol, int * aid, int * nvs, int neigh[* nvs])
 {
   int i, j, k, l, m, n, o, p, q, r, s, t, u;
-  search_molecule * tmp_mol = & in_calc_mol[* stp - 1][* mol - 1];
+  search_molecule * tmp_mol = & in_calc_mol[* stp - 1].current;
+  gint64 geo = active_coord -> totcoord[1];
   i = active_project -> atoms[* stp - 1][* aid - 1].sp;
   j = active_project -> atoms[* stp - 1][* aid - 1].coord[1];
   k = pgeo[i] + j;
@@ -233,7 +192,8 @@ void send_mol_neighbors_ (int * stp, int * mol, int * aid, int * nvs, int neigh[
     n = active_project -> atoms[tmp_mol -> md][m].sp;
     o = active_project -> atoms[tmp_mol -> md][m].coord[1];
     p = pgeo[n] + o;
-    tmp_mol -> pbonds[k][p] ++;
+    tmp_mol -> pbonds[tmp_mol -> npbonds] = k*geo + p;
+    tmp_mol -> npbonds ++;
   }
   if (* nvs > 1)
   {
@@ -249,39 +209,9 @@ void send_mol_neighbors_ (int * stp, int * mol, int * aid, int * nvs, int neigh[
         s = active_project -> atoms[tmp_mol -> md][r].sp;
         t = active_project -> atoms[tmp_mol -> md][r].coord[1];
         u = pgeo[s] + t;
-        tmp_mol -> pangles[p][k][u] ++;
-        tmp_mol -> pangles[u][k][p] ++;
-      }
-    }
-  }
-}
-
-/*!
-  \fn void update_mol_details (search_molecule * mol, int sp, int cp)
-
-  \brief update molecule information
-
-  \param mol the molecule to update
-  \param sp the chemical species
-  \param cp the partial coordination id
-*/
-void update_mol_details (search_molecule * mol, int sp, int cp)
-{
-  int i, j, k, l, m;
-  for (i=0; i<active_project -> nspec; i++)
-  {
-    j = active_coord -> partial_geo[sp][cp][i];
-    mol -> nbonds += j;
-    if (j && mol -> natoms > 2)
-    {
-      for (k=0; k<active_project -> nspec; k++)
-      {
-        l = active_coord -> partial_geo[sp][cp][k];
-        if (k != i || l > 1)
-        {
-          m = (j+l)*((j+l)-1)/2;
-          mol -> nangles += m;
-        }
+        // Angles p-k-u and u-k-p are the same angle
+        tmp_mol -> pangles[tmp_mol -> npangles] = (min(p,u)*geo + k)*geo + max(p,u);
+        tmp_mol -> npangles ++;
       }
     }
   }
@@ -301,31 +231,28 @@ void update_mol_details (search_molecule * mol, int sp, int cp)
 */
 void send_mol_details_ (int * stp, int * mol, int * ats, int * sps, int spec_in_mol[* sps], int atom_in_mol[* ats])
 {
-  int i, j, k, l;
-  search_molecule * tmp_mol = & in_calc_mol[* stp - 1][* mol - 1];
+  int i, j, k, l, m, n;
+  search_molecule * tmp_mol = & in_calc_mol[* stp - 1].current;
   tmp_mol -> id = * mol - 1;
   tmp_mol -> md = * stp - 1;
   tmp_mol -> multiplicity = 1;
   tmp_mol -> fragments = allocint (1);
   tmp_mol -> fragments[0] = * mol - 1;
   tmp_mol -> natoms = * ats;
-  tmp_mol -> lgeo = allocdint (active_project -> nspec, active_coord -> totcoord[1]);
-  if (tmp_mol -> natoms > 1)
-  {
-    tmp_mol -> pbonds = allocdint (active_coord -> totcoord[1], active_coord -> totcoord[1]);
-    if (tmp_mol -> natoms > 2)
-    {
-      tmp_mol -> pangles = alloctint (active_coord -> totcoord[1], active_coord -> totcoord[1], active_coord -> totcoord[1]);
-    }
-  }
+  tmp_mol -> lgeo = allocint (* ats);
   tmp_mol -> atoms = duplicate_int (* ats, atom_in_mol);
+  tmp_mol -> msize[0] = 1;
+  tmp_mol -> msize[1] = * ats;
   for (i=0; i< * ats; i++)
   {
     j = atom_in_mol[i]-1;
     k = active_project -> atoms[0][j].sp;
     l = active_project -> atoms[* stp - 1][j].coord[1];
-    tmp_mol -> lgeo[k][pgeo[k]+l] ++;
-    update_mol_details (tmp_mol, k, l);
+    tmp_mol -> lgeo[i] = pgeo[k]+l;
+    m = 0;
+    for (n=0; n<active_project -> nspec; n++) m += active_coord -> partial_geo[k][l][n];
+    tmp_mol -> nbonds += m;
+    tmp_mol -> nangles += (m*(m-1))/2;
   }
   j = 0;
   for (i=0; i<active_project -> nspec; i++)
@@ -334,8 +261,79 @@ void send_mol_details_ (int * stp, int * mol, int * ats, int * sps, int spec_in_
   }
   tmp_mol -> nspec = j;
   tmp_mol -> species = duplicate_int (active_project -> nspec, spec_in_mol);
+  if (tmp_mol -> nbonds) tmp_mol -> pbonds = g_malloc0(tmp_mol -> nbonds*sizeof*tmp_mol -> pbonds);
+  if (tmp_mol -> nangles) tmp_mol -> pangles = g_malloc0(tmp_mol -> nangles*sizeof*tmp_mol -> pangles);
   tmp_mol -> nbonds /= 2;
-  tmp_mol -> nangles /= 2;
+}
+
+/*!
+  \fn int compare_mol_int (const void * a, const void * b)
+
+  \brief compare two integers to sort molecule data
+
+  \param a the 1st integer
+  \param b the 2nd integer
+*/
+int compare_mol_int (const void * a, const void * b)
+{
+  int u = * (const int *) a;
+  int v = * (const int *) b;
+  return (u < v) ? -1 : (u > v);
+}
+
+/*!
+  \fn int compare_mol_int64 (const void * a, const void * b)
+
+  \brief compare two 64 bits integers to sort molecule data
+
+  \param a the 1st integer
+  \param b the 2nd integer
+*/
+int compare_mol_int64 (const void * a, const void * b)
+{
+  gint64 u = * (const gint64 *) a;
+  gint64 v = * (const gint64 *) b;
+  return (u < v) ? -1 : (u > v);
+}
+
+/*!
+  \fn guint64 hash_mol_data (guint64 key, gint64 val)
+
+  \brief add a value to a molecule topology signature
+
+  \param key the signature
+  \param val the value to add
+*/
+guint64 hash_mol_data (guint64 key, gint64 val)
+{
+  int i;
+  for (i=0; i<8; i++)
+  {
+    key ^= (guint64)((val >> (8*i)) & 0xff);
+    key *= 1099511628211ULL;
+  }
+  return key;
+}
+
+/*!
+  \fn guint64 molecule_signature (search_molecule * mol)
+
+  \brief compute the topology signature of a molecule, the topology lists must be sorted
+
+  \param mol the target molecule
+*/
+guint64 molecule_signature (search_molecule * mol)
+{
+  int i;
+  guint64 key = 14695981039346656037ULL;
+  key = hash_mol_data (key, mol -> natoms);
+  key = hash_mol_data (key, mol -> npbonds);
+  key = hash_mol_data (key, mol -> npangles);
+  for (i=0; i<active_project -> nspec; i++) key = hash_mol_data (key, mol -> species[i]);
+  for (i=0; i<mol -> natoms; i++) key = hash_mol_data (key, mol -> lgeo[i]);
+  for (i=0; i<mol -> npbonds; i++) key = hash_mol_data (key, mol -> pbonds[i]);
+  for (i=0; i<mol -> npangles; i++) key = hash_mol_data (key, mol -> pangles[i]);
+  return key;
 }
 
 /*!
@@ -348,83 +346,43 @@ void send_mol_details_ (int * stp, int * mol, int * ats, int * sps, int spec_in_
 */
 gboolean are_identical_molecules (search_molecule * mol_a, search_molecule * mol_b)
 {
-  int i, j, k;
-/*#ifdef DEBUG
-  g_debug ("AID:: mol_a -> id= %d, mol_b-> id= %d", mol_a -> id, mol_b -> id);
-  g_debug ("AID:: mol_a -> natoms= %d, mol_b-> natoms= %d", mol_a -> natoms, mol_b -> natoms);
-  g_debug ("AID:: mol_a -> nspec= %d, mol_b-> nspec= %d", mol_a -> nspec, mol_b -> nspec);
-  g_debug ("AID:: mol_a -> nbonds= %d, mol_b-> nbonds= %d", mol_a -> nbonds, mol_b -> nbonds);
-  g_debug ("AID:: mol_a -> nangles= %d, mol_b-> nangles= %d", mol_a -> nangles, mol_b -> nangles);
-#endif*/
+  if (mol_a -> key != mol_b -> key) return FALSE;
   if (mol_a -> md != mol_b -> md) return FALSE;
   if (mol_a -> natoms != mol_b -> natoms) return FALSE;
   if (mol_a -> nspec != mol_b -> nspec) return FALSE;
-  for (i=0; i < active_project -> nspec; i++)
-  {
-    if (mol_a -> species[i] != mol_b -> species[i]) return FALSE;
-  }
-
-  if (mol_a -> nbonds != mol_b -> nbonds) return FALSE;
-  if (mol_a -> nangles != mol_b -> nangles) return FALSE;
-
-  for (i=0; i < active_project -> nspec; i++)
-  {
-    for (j=0; j< active_coord -> totcoord[1]; j++)
-    {
-      if (mol_a -> lgeo[i][j] != mol_b -> lgeo[i][j]) return FALSE;
-    }
-  }
-
-  if (mol_a -> nbonds > 1)
-  {
-    for (i=0; i < active_coord -> totcoord[1]; i++)
-    {
-      for (j=0; j < active_coord -> totcoord[1]; j++)
-      {
-        if (mol_a -> pbonds[i][j] != mol_b -> pbonds[i][j]) return FALSE;
-      }
-    }
-    if (mol_a -> nangles > 1)
-    {
-      for (i=0; i < active_coord -> totcoord[1]; i++)
-      {
-        for (j=0; j < active_coord -> totcoord[1]; j++)
-        {
-          for (k=0; k < active_coord -> totcoord[1]; k++)
-          {
-            if (mol_a -> pangles[i][j][k] != mol_b -> pangles[i][j][k]) return FALSE;
-          }
-        }
-      }
-    }
-  }
+  if (memcmp (mol_a -> species, mol_b -> species, active_project -> nspec*sizeof*mol_a -> species)) return FALSE;
+  if (mol_a -> npbonds != mol_b -> npbonds) return FALSE;
+  if (mol_a -> npangles != mol_b -> npangles) return FALSE;
+  if (memcmp (mol_a -> lgeo, mol_b -> lgeo, mol_a -> natoms*sizeof*mol_a -> lgeo)) return FALSE;
+  if (mol_a -> npbonds && memcmp (mol_a -> pbonds, mol_b -> pbonds, mol_a -> npbonds*sizeof*mol_a -> pbonds)) return FALSE;
+  if (mol_a -> npangles && memcmp (mol_a -> pangles, mol_b -> pangles, mol_a -> npangles*sizeof*mol_a -> pangles)) return FALSE;
   return TRUE;
 }
 
 /*!
-  \fn int * merge_mol_data (int val_a, int val_b, int table_a[val_a], int table_b[val_b])
+  \fn void merge_mol_data (search_molecule * mol_a, search_molecule * mol_b)
 
-  \brief merge molecule a and molecule b data
+  \brief merge molecule b data into molecule a
 
-  \param val_a multiplicity, or multiplicity x atoms, for molecule a
-  \param val_b multiplicity, or multiplicity x atoms, for molecule b
-  \param table_a the list of molecular fragment(s) or atoms for molecule a
-  \param table_b the list of molecular fragment(s) or atoms for molecule b
+  \param mol_a the molecule to update
+  \param mol_b the molecule to merge into molecule a
 */
-int * merge_mol_data (int val_a, int val_b, int table_a[val_a], int table_b[val_b])
+void merge_mol_data (search_molecule * mol_a, search_molecule * mol_b)
 {
-  int * p_data;
-  int i;
-  p_data = allocint (val_a + val_b);
-  for (i=0; i<val_a; i++)
+  int i = mol_a -> natoms*mol_a -> multiplicity;
+  if (mol_a -> multiplicity == mol_a -> msize[0])
   {
-    p_data[i] = table_a[i];
+    mol_a -> msize[0] *= 2;
+    mol_a -> fragments = g_realloc (mol_a -> fragments, mol_a -> msize[0]*sizeof*mol_a -> fragments);
   }
-  for (i=0; i<val_b; i++)
+  mol_a -> fragments[mol_a -> multiplicity] = mol_b -> fragments[0];
+  if (i + mol_b -> natoms > mol_a -> msize[1])
   {
-    p_data[val_a+i] = table_b[i];
+    mol_a -> msize[1] *= 2;
+    mol_a -> atoms = g_realloc (mol_a -> atoms, mol_a -> msize[1]*sizeof*mol_a -> atoms);
   }
-  return p_data;
+  memcpy (& mol_a -> atoms[i], mol_b -> atoms, mol_b -> natoms*sizeof*mol_b -> atoms);
+  mol_a -> multiplicity ++;
 }
 
 /*!
@@ -436,63 +394,70 @@ int * merge_mol_data (int val_a, int val_b, int table_a[val_a], int table_b[val_
 */
 void free_search_molecule_data (search_molecule * smol)
 {
-  int i, j;
-  if (smol -> atoms)
-  {
-    g_free (smol -> atoms);
-    smol -> atoms = NULL;
-  }
-  if (smol -> pbonds)
+  g_free (smol -> atoms);
+  smol -> atoms = NULL;
+  g_free (smol -> lgeo);
+  smol -> lgeo = NULL;
+  g_free (smol -> pbonds);
+  smol -> pbonds = NULL;
+  g_free (smol -> pangles);
+  smol -> pangles = NULL;
+  g_free (smol -> species);
+  smol -> species = NULL;
+  g_free (smol -> fragments);
+  smol -> fragments = NULL;
+}
+
+/*!
+  \fn void store_molecule_ (int * stepid)
+
+  \brief store the molecule received from Fortran90, or merge it with an identical molecule
+
+  \param stepid the MD step
+*/
+void store_molecule_ (int * stepid)
+{
+  step_molecules * smol = & in_calc_mol[* stepid - 1];
+  search_molecule * mol = & smol -> current;
+  search_molecule * twin;
+  qsort (mol -> lgeo, mol -> natoms, sizeof*mol -> lgeo, compare_mol_int);
+  if (mol -> npbonds) qsort (mol -> pbonds, mol -> npbonds, sizeof*mol -> pbonds, compare_mol_int64);
+  if (mol -> npangles) qsort (mol -> pangles, mol -> npangles, sizeof*mol -> pangles, compare_mol_int64);
+  mol -> key = molecule_signature (mol);
+  twin = g_hash_table_lookup (smol -> unique, & mol -> key);
+  while (twin)
   {
-    for (i=0; i<active_coord -> totcoord[1]; i++)
+    if (are_identical_molecules (twin, mol))
     {
-      if (smol -> pbonds[i])
-      {
-        g_free (smol -> pbonds[i]);
-        smol -> pbonds[i] = NULL;
-      }
+      merge_mol_data (twin, mol);
+      free_search_molecule_data (mol);
+      memset (mol, 0, sizeof*mol);
+      return;
     }
-    g_free (smol -> pbonds);
-    smol -> pbonds = NULL;
+    if (! twin -> twin) break;
+    twin = twin -> twin;
   }
-  if (smol -> pangles)
+  search_molecule * new_mol = g_malloc0(sizeof*new_mol);
+  * new_mol = * mol;
+  if (twin)
   {
-    for (i=0; i<active_coord -> totcoord[1]; i++)
-    {
-      if (smol -> pangles[i])
-      {
-        for (j=0; j<active_coord -> totcoord[1]; j++)
-        {
-          if (smol -> pangles[i][j])
-          {
-            g_free (smol -> pangles[i][j]);
-            smol -> pangles[i][j] = NULL;
-          }
-        }
-        g_free (smol -> pangles[i]);
-        smol -> pangles[i] = NULL;
-      }
-    }
-    g_free (smol -> pangles);
-    smol -> pangles = NULL;
+    twin -> twin = new_mol;
   }
-  if (smol -> lgeo)
+  else
   {
-    for (i=0; i<active_project -> nspec; i++)
-    {
-      if (smol -> lgeo[i])
-      {
-        g_free (smol -> lgeo[i]);
-        smol -> lgeo[i] = NULL;
-      }
-    }
-    g_free (smol -> lgeo);
-    smol -> lgeo = NULL;
+    g_hash_table_insert (smol -> unique, & new_mol -> key, new_mol);
   }
-  g_free (smol -> species);
-  smol -> species = NULL;
-  g_free (smol -> fragments);
-  smol -> fragments = NULL;
+  if (smol -> last)
+  {
+    smol -> last -> next = new_mol;
+  }
+  else
+  {
+    smol -> first = new_mol;
+  }
+  smol -> last = new_mol;
+  smol -> num ++;
+  memset (mol, 0, sizeof*mol);
 }
 
 /*!
@@ -505,64 +470,14 @@ void free_search_molecule_data (search_molecule * smol)
 void setup_molecules_ (int * stepid)
 {
   int i, j, k, l, m, n;
-  search_molecule * mtmp_at, * mtmp_bt;
-  search_molecule * first_mol = NULL;
+  step_molecules * smol;
   search_molecule * tmp_mol;
-  gboolean add_it;
-  int * tmp_data;
   i = * stepid -1;
-  j = 0;
-  for (k=0; k<active_project -> modelfc -> mol_by_step[i]; k++)
-  {
-    mtmp_bt = & in_calc_mol[i][k];
-    add_it = TRUE;
-    mtmp_at = (first_mol) ? first_mol : NULL;
-    while (mtmp_at)
-    {
-      if (are_identical_molecules (mtmp_at, mtmp_bt))
-      {
-        tmp_data = merge_mol_data (mtmp_at -> multiplicity, mtmp_bt -> multiplicity, mtmp_at -> fragments, mtmp_bt -> fragments);
-        g_free (mtmp_at -> fragments);
-        mtmp_at -> fragments = NULL;
-        mtmp_at -> fragments = duplicate_int (mtmp_at -> multiplicity+mtmp_bt -> multiplicity, tmp_data);
-        g_free (tmp_data);
-        tmp_data = merge_mol_data (mtmp_at -> natoms*mtmp_at -> multiplicity, mtmp_bt -> natoms*mtmp_bt -> multiplicity, mtmp_at -> atoms, mtmp_bt -> atoms);
-        g_free (mtmp_at -> atoms);
-        mtmp_at -> atoms = NULL;
-        mtmp_at -> atoms = duplicate_int (mtmp_at -> natoms*mtmp_at -> multiplicity+mtmp_bt -> natoms*mtmp_bt -> multiplicity, tmp_data);
-        g_free (tmp_data);
-        mtmp_at -> multiplicity ++;
-        add_it = FALSE;
-        break;
-      }
-      mtmp_at = mtmp_at -> next;
-    }
-    if (add_it)
-    {
-      if (first_mol)
-      {
-        mtmp_at = first_mol;
-        while (mtmp_at -> next) mtmp_at = mtmp_at -> next;
-        mtmp_at -> next = duplicate_search_molecule (mtmp_bt);
-        mtmp_at -> next -> prev = mtmp_at;
-      }
-      else
-      {
-        first_mol = duplicate_search_molecule (mtmp_bt);
-        mtmp_at = first_mol;
-      }
-      j ++;
-    }
-  }
-  for (k=0; k<active_project -> modelfc -> mol_by_step[i]; k++)
-  {
-    free_search_molecule_data (& in_calc_mol[i][k]);
-  }
-  g_free (in_calc_mol[i]);
-  in_calc_mol[i] = NULL;
+  smol = & in_calc_mol[i];
+  j = smol -> num;
   active_project -> modelfc -> mol_by_step[i] = j;
   active_project -> modelfc -> mols[i] = g_malloc0(j*sizeof*active_project -> modelfc -> mols[i]);
-  tmp_mol = first_mol;
+  tmp_mol = smol -> first;
   for (k=0; k<j; k++)
   {
     l = tmp_mol -> natoms*tmp_mol -> multiplicity;
@@ -573,23 +488,19 @@ void setup_molecules_ (int * stepid)
     }
     duplicate_molecule (& active_project -> modelfc -> mols[i][k], tmp_mol);
     active_project -> modelfc -> mols[i][k].id = k;
-    if (k < j-1) tmp_mol = tmp_mol -> next;
+    tmp_mol = tmp_mol -> next;
   }
-  tmp_mol = first_mol;
+  g_hash_table_destroy (smol -> unique);
+  smol -> unique = NULL;
+  tmp_mol = smol -> first;
   while (tmp_mol)
   {
+    smol -> first = tmp_mol -> next;
     free_search_molecule_data (tmp_mol);
-    if (tmp_mol -> next)
-    {
-      tmp_mol = tmp_mol -> next;
-      g_free (tmp_mol -> prev);
-    }
-    else
-    {
-      g_free (tmp_mol);
-      tmp_mol = NULL;
-    }
+    g_free (tmp_mol);
+    tmp_mol = smol -> first;
   }
+  smol -> last = NULL;
 }
 
 /*!
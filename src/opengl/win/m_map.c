@@ -35,6 +35,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   gboolean setup_custom_color_map (float * data, project * this_proj, gboolean init);
   gboolean open_save_map (FILE * fp, int act, project * this_proj);
+  gboolean bond_order_map (project * this_proj, int lval, int qtype);
   gboolean use_custom_color_map (int p);
 
   void init_map_range (colormap * map, int pts);
@@ -53,6 +54,10 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void run_open_save_data_map (GtkNativeDialog * info, gint response_id, gpointer data);
   G_MODULE_EXPORT void run_open_save_data_map (GtkDialog * info, gint response_id, gpointer data);
   G_MODULE_EXPORT void open_save_data_map (GtkWidget * but, gpointer data);
+  G_MODULE_EXPORT void set_bop_l (GtkSpinButton * res, gpointer data);
+  G_MODULE_EXPORT void set_bop_type (GtkComboBox * box, gpointer data);
+  G_MODULE_EXPORT void run_bond_order_data_map (GtkDialog * win, gint response_id, gpointer data);
+  G_MODULE_EXPORT void bond_order_data_map (GtkWidget * but, gpointer data);
   G_MODULE_EXPORT void run_use_color_map (GtkDialog * win, gint response_id, gpointer data);
   G_MODULE_EXPORT void set_color_map (GtkWidget * widg, gpointer data);
   G_MODULE_EXPORT void change_color_radio (GSimpleAction * action, GVariant * parameter, gpointer data);
@@ -76,10 +81,13 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 #include "project.h"
 #include "glwindow.h"
 #include "glview.h"
+#include "bind.h"
 
 extern const gchar * dfi[2];
+extern gboolean run_distance_matrix (GtkWidget * widg, int calc, int up_ngb);
+extern int update_voisj_and_contj ();
 gboolean cmap_changed = FALSE;
-GtkWidget * map_but[3];
+GtkWidget * map_but[4];
 GtkTreeStore * map_model;
 colormap * the_map;
 colormap * tmp_map;
@@ -945,6 +953,136 @@ G_MODULE_EXPORT void open_save_data_map (GtkWidget * but, gpointer data)
   }
 }
 
+int bop_l = 6;
+int bop_type = 0;
+
+/*!
+  \fn gboolean bond_order_map (project * this_proj, int lval, int qtype)
+
+  \brief compute the Steinhardt bond order parameters, for each atom
+  and each MD step, and use them as custom color map data
+
+  \param this_proj the target project
+  \param lval the spherical harmonics degree l
+  \param qtype the parameter type (0 = q_l, 1 = averaged q_l, 2 = w_l, 3 = averaged w_l)
+*/
+gboolean bond_order_map (project * this_proj, int lval, int qtype)
+{
+  int i;
+  int err_update = 1;
+  gboolean done = FALSE;
+  i = activep;
+  if (this_proj -> id != activep) active_project_changed (this_proj -> id);
+  if (! active_project -> dmtx)
+  {
+    active_project -> dmtx = run_distance_matrix (NULL, 0, 0);
+  }
+  else
+  {
+    err_update = update_voisj_and_contj ();
+  }
+  if (! err_update)
+  {
+    show_error (_("Impossible to update FORTRAN data"), 0, this_proj -> modelgl -> win);
+  }
+  else if (! active_project -> dmtx)
+  {
+    show_error (_("The nearest neighbors table calculation has failed"), 0, this_proj -> modelgl -> win);
+  }
+  else
+  {
+    float * qmap = allocfloat (this_proj -> natomes*this_proj -> steps);
+    if (steinhardt_ (& lval, & qtype, qmap))
+    {
+      cmap_changed = setup_custom_color_map (qmap, this_proj, TRUE);
+      done = TRUE;
+    }
+    g_free (qmap);
+    free_contj_voisj_ ();
+  }
+  if (i != activep) active_project_changed (i);
+  return done;
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_bop_l (GtkSpinButton * res, gpointer data)
+
+  \brief set the spherical harmonics degree for the bond order parameters
+
+  \param res the GtkSpinButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_bop_l (GtkSpinButton * res, gpointer data)
+{
+  bop_l = gtk_spin_button_get_value_as_int (res);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_bop_type (GtkComboBox * box, gpointer data)
+
+  \brief set the type of bond order parameters
+
+  \param box the GtkComboBox sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_bop_type (GtkComboBox * box, gpointer data)
+{
+  bop_type = combo_get_active ((GtkWidget *)box);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void run_bond_order_data_map (GtkDialog * win, gint response_id, gpointer data)
+
+  \brief bond order parameters color map data - running the dialog
+
+  \param win the GtkDialog sending the signal
+  \param response_id the response id
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void run_bond_order_data_map (GtkDialog * win, gint response_id, gpointer data)
+{
+  if (response_id == GTK_RESPONSE_APPLY)
+  {
+    if (bond_order_map (get_project_by_id(GPOINTER_TO_INT(data)), bop_l, bop_type))
+    {
+      widget_set_sensitive (map_but[1], cmap_changed);
+      widget_set_sensitive (map_but[2], cmap_changed);
+    }
+  }
+  destroy_this_dialog (win);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void bond_order_data_map (GtkWidget * but, gpointer data)
+
+  \brief bond order parameters color map data - creating the dialog
+
+  \param but the GtkWidget sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void bond_order_data_map (GtkWidget * but, gpointer data)
+{
+  project * this_proj = get_project_by_id(GPOINTER_TO_INT(data));
+  GtkWidget * win = dialogmodal (_("Bond order parameters"), GTK_WINDOW(this_proj -> modelgl -> win));
+  gtk_dialog_add_button (GTK_DIALOG(win), _("Apply"), GTK_RESPONSE_APPLY);
+  GtkWidget * vbox = dialog_get_content_area (win);
+  gchar * qtypes[4] = {i18n("Steinhardt q<sub>l</sub>"), i18n("Averaged q<sub>l</sub> (Lechner-Dellago)"),
+                       i18n("Steinhardt w<sub>l</sub>"), i18n("Averaged w<sub>l</sub> (Lechner-Dellago)")};
+  GtkWidget * hbox = abox (vbox, _("Degree l:"), 5);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                       spin_button (G_CALLBACK(set_bop_l), bop_l, 1, 12, 1, 0, 100, NULL),
+                       FALSE, FALSE, 0);
+  hbox = abox (vbox, _("Order parameter:"), 5);
+  GtkWidget * combo = create_combo ();
+  int i;
+  for (i=0; i<4; i++) combo_text_append (combo, _(qtypes[i]));
+  combo_set_active (combo, bop_type);
+  combo_set_markup (combo);
+  g_signal_connect (G_OBJECT (combo), "changed", G_CALLBACK(set_bop_type), NULL);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, combo, FALSE, FALSE, 0);
+  run_this_gtk_dialog (win, G_CALLBACK(run_bond_order_data_map), data);
+}
+
 gboolean res_use_map;
 
 /*!
@@ -982,15 +1120,15 @@ gboolean use_custom_color_map (int p)
   GtkWidget * win = dialogmodal (_("Custom color map settings"), GTK_WINDOW(this_proj -> modelgl -> win));
   gtk_dialog_add_button (GTK_DIALOG(win), _("Apply"), GTK_RESPONSE_APPLY);
   GtkWidget * vbox = dialog_get_content_area (win);
-  gchar * btitle[3] = {i18n("Import / Save data"), i18n("Edit data"), i18n("Customize color map")};
-  gchar * bimage[3] = {FOPEN, EDITA, EDITA};
-  GCallback handlers[3] = {G_CALLBACK(open_save_data_map), G_CALLBACK(edit_data_map), G_CALLBACK(custom_mize_map)};
+  gchar * btitle[4] = {i18n("Import / Save data"), i18n("Edit data"), i18n("Customize color map"), i18n("Bond order parameters")};
+  gchar * bimage[4] = {FOPEN, EDITA, EDITA, EXECUTE};
+  GCallback handlers[4] = {G_CALLBACK(open_save_data_map), G_CALLBACK(edit_data_map), G_CALLBACK(custom_mize_map), G_CALLBACK(bond_order_data_map)};
   int i;
-  for (i=0; i<3; i++)
+  for (i=0; i<4; i++)
   {
     map_but[i] = create_button (_(btitle[i]), IMG_STOCK, bimage[i], 150, 50, GTK_RELIEF_NORMAL, handlers[i], GINT_TO_POINTER(p));
     add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, map_but[i], FALSE, FALSE, 10);
-    if (i > 0  && the_map == NULL)
+    if ((i == 1 || i == 2) && the_map == NULL)
     {
       widget_set_sensitive (map_but[i], 0);
     }
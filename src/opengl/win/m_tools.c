@@ -38,6 +38,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void invert_this (GtkWidget * widg, gpointer data);
   G_MODULE_EXPORT void to_window_measures (GSimpleAction * action, GVariant * parameter, gpointer data);
   G_MODULE_EXPORT void to_window_volumes (GSimpleAction * action, GVariant * parameter, gpointer data);
+  G_MODULE_EXPORT void to_window_density (GSimpleAction * action, GVariant * parameter, gpointer data);
   G_MODULE_EXPORT void change_mouse_mode_radio (GSimpleAction * action, GVariant * parameter, gpointer data);
   G_MODULE_EXPORT void change_sel_mode_radio (GSimpleAction * action, GVariant * parameter, gpointer data);
   G_MODULE_EXPORT void to_create_field (GSimpleAction * action, GVariant * parameter, gpointer data);
@@ -64,6 +65,7 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
 extern G_MODULE_EXPORT void window_measures (GtkWidget * widg, gpointer data);
 extern G_MODULE_EXPORT void window_volumes (GtkWidget * widg, gpointer data);
+extern G_MODULE_EXPORT void window_density (GtkWidget * widg, gpointer data);
 extern G_MODULE_EXPORT void create_field (GtkWidget * widg, gpointer data);
 extern gboolean spin (gpointer data);
 extern void check_hidden_visible (project * this_proj);
@@ -316,6 +318,7 @@ GtkWidget * menu_tools (glwin * view, int id)
   gtk3_menu_item (menut, _("Measures"), IMG_NONE, NULL, G_CALLBACK(window_measures), (gpointer)view, TRUE, GDK_KEY_m, GDK_CONTROL_MASK, FALSE, FALSE, FALSE);
   GtkWidget * widg = gtk3_menu_item (menut, _("Volumes"), IMG_NONE, NULL, G_CALLBACK(window_volumes), (gpointer)view, FALSE, 0, 0, FALSE, FALSE, FALSE);
   widget_set_sensitive (widg, (get_project_by_id(view -> proj) -> steps > 1) ? 0 : 1);
+  gtk3_menu_item (menut, _("Density maps"), IMG_NONE, NULL, G_CALLBACK(window_density), (gpointer)view, FALSE, 0, 0, FALSE, FALSE, FALSE);
   add_menu_separator (menut);
   gtk_menu_shell_append ((GtkMenuShell *)menut, menu_item_new_with_submenu(_("Edit"), TRUE, menu_edit(view, id)));
   add_menu_separator (menut);
@@ -496,10 +499,24 @@ G_MODULE_EXPORT void to_window_volumes (GSimpleAction * action, GVariant * param
   window_volumes (NULL, data);
 }
 
+/*!
+  \fn G_MODULE_EXPORT void to_window_density (GSimpleAction * action, GVariant * parameter, gpointer data)
+
+  \brief open the density maps window callback GTK4
+
+  \param action the GAction sending the signal
+  \param parameter GVariant parameter of the GAction, if any
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void to_window_density (GSimpleAction * action, GVariant * parameter, gpointer data)
+{
+  window_density (NULL, data);
+}
+
 /*!
   \fn GMenu * volume_section (glwin * view, int popm)
 
-  \brief create the 'Tools -> Volumes' menu item GTK4
+  \brief create the 'Tools -> Volumes' and 'Tools -> Density maps' menu items GTK4
 
   \param view the target glwin
   \param popm main app (0) or popup (1)
@@ -508,6 +525,7 @@ GMenu * volume_section (glwin * view, int popm)
 {
   GMenu * menu = g_menu_new ();
   append_opengl_item (view, menu, _("Volumes"), "volumes", popm, popm, NULL, IMG_NONE, NULL, FALSE, G_CALLBACK(to_window_volumes), (gpointer)view, FALSE, FALSE, FALSE, TRUE);
+  append_opengl_item (view, menu, _("Density maps"), "density", popm, popm, NULL, IMG_NONE, NULL, FALSE, G_CALLBACK(to_window_density), (gpointer)view, FALSE, FALSE, FALSE, TRUE);
   return menu;
 }
 
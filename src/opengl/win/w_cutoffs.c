@@ -105,8 +105,7 @@ void update_cutoffs (project * this_proj)
 #endif
     }
     bonds_update = 1;
-    frag_update = (this_proj -> natomes > ATOM_LIMIT) ? 0 : 1;
-    mol_update = (frag_update) ? ((this_proj -> steps > STEP_LIMIT) ? 0 : 1) : 0;
+    frag_update = mol_update = 1;
     this_proj -> runc[0] = FALSE;
     if (this_proj -> id != activep)
     {
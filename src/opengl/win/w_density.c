@@ -0,0 +1,1188 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file w_density.c
+* @short Functions to create the 'Density maps' window \n
+         Functions to compute 3D density maps from the MD trajectory \n
+         Functions to extract the isosurface(s) of the density maps
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'w_density.c'
+*
+* Contains:
+*
+
+ - The functions to create the 'Density maps' window
+ - The functions to compute 3D density maps from the MD trajectory
+ - The functions to extract the isosurface(s) of the density maps
+
+*
+* List of functions:
+
+  int density_index (density_map * dmap, int i, int j, int k);
+  int density_grid_point (density_map * dmap, double frac[3]);
+
+  gboolean setup_density_grid (density_map * dmap, double res);
+  gboolean write_density_cube (project * this_proj, int map, gchar * filename);
+
+  void free_density_maps (glwin * view);
+  void clean_density_maps (glwin * view);
+  void density_min_image (project * this_proj, int bid, double vec[3]);
+  void density_reference_frame (project * this_proj, density_map * dmap, int sid, double cent[3], double frame[3][3]);
+  void density_gradient (density_map * dmap, int map, int i, int j, int k, double grad[3]);
+  void density_vertex (density_map * dmap, int map, int * pa, int * pb, double iso, double cent[3], double frame[3][3], ColRGBA col, float * vert);
+  void update_density_info (glwin * view, double time);
+  void add_density_maps_list (glwin * view);
+
+  G_MODULE_EXPORT void compute_density_maps (GtkButton * but, gpointer data);
+  G_MODULE_EXPORT void set_density_iso (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void show_density_map (GtkCheckButton * but, gpointer data);
+  G_MODULE_EXPORT void show_density_map (GtkToggleButton * but, gpointer data);
+  G_MODULE_EXPORT void set_density_color (GtkColorChooser * colob, gpointer data);
+  G_MODULE_EXPORT void set_density_weight (GtkComboBox * box, gpointer data);
+  G_MODULE_EXPORT void set_density_param (GtkEntry * res, gpointer data);
+  G_MODULE_EXPORT void set_density_reference (GtkSpinButton * res, gpointer data);
+  G_MODULE_EXPORT void run_save_density_map (GtkNativeDialog * info, gint response_id, gpointer data);
+  G_MODULE_EXPORT void run_save_density_map (GtkDialog * info, gint response_id, gpointer data);
+  G_MODULE_EXPORT void save_density_map (GtkButton * but, gpointer data);
+  G_MODULE_EXPORT void window_density (GtkWidget * widg, gpointer data);
+
+  object_3d * density_isosurface (project * this_proj, int map, int sid);
+
+*/
+
+#include "global.h"
+#include "interface.h"
+#include "project.h"
+#include "glview.h"
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+
+char * density_type[4] = {i18n("Number density"),
+                          i18n("Atomic number density"),
+                          i18n("Neutron scattering length density"),
+                          i18n("X-rays scattering density")};
+
+/*!
+  \fn void free_density_maps (glwin * view)
+
+  \brief free the 3D density map(s) data, without updating the shaders
+
+  \param view the target glwin
+*/
+void free_density_maps (glwin * view)
+{
+  if (view -> dmap)
+  {
+    int i;
+    for (i=0; i<view -> dmap -> nmaps; i++) if (view -> dmap -> rho[i]) g_free (view -> dmap -> rho[i]);
+    g_free (view -> dmap -> rho);
+    if (view -> dmap -> ref_list) g_free (view -> dmap -> ref_list);
+    g_free (view -> dmap -> rmax);
+    g_free (view -> dmap -> iso);
+    g_free (view -> dmap -> show);
+    g_free (view -> dmap -> col);
+    g_free (view -> dmap);
+    view -> dmap = NULL;
+  }
+}
+
+/*!
+  \fn void clean_density_maps (glwin * view)
+
+  \brief free the 3D density map(s)
+
+  \param view the target glwin
+*/
+void clean_density_maps (glwin * view)
+{
+  if (view -> dmap)
+  {
+    free_density_maps (view);
+    int shaders[1] = {VOLMS};
+    re_create_md_shaders (1, shaders, get_project_by_id(view -> proj));
+  }
+  if (view -> density_win)
+  {
+    if (view -> density_win -> info) gtk_label_set_text (GTK_LABEL(view -> density_win -> info), "");
+    if (view -> density_win -> maps_vbox) view -> density_win -> maps_vbox = destroy_this_widget (view -> density_win -> maps_vbox);
+  }
+}
+
+/*!
+  \fn gboolean setup_density_grid (density_map * dmap, double res)
+
+  \brief compute the inverse grid matrix and the number of grid points
+
+  \param dmap the target density map
+  \param res the grid spacing
+*/
+gboolean setup_density_grid (density_map * dmap, double res)
+{
+  int i;
+  double (* v)[3] = dmap -> vect;
+  double det = v[0][0]*(v[1][1]*v[2][2]-v[1][2]*v[2][1])
+             - v[0][1]*(v[1][0]*v[2][2]-v[1][2]*v[2][0])
+             + v[0][2]*(v[1][0]*v[2][1]-v[1][1]*v[2][0]);
+  if (fabs(det) < 1e-12) return FALSE;
+  dmap -> inv[0][0] = (v[1][1]*v[2][2]-v[1][2]*v[2][1])/det;
+  dmap -> inv[0][1] = (v[0][2]*v[2][1]-v[0][1]*v[2][2])/det;
+  dmap -> inv[0][2] = (v[0][1]*v[1][2]-v[0][2]*v[1][1])/det;
+  dmap -> inv[1][0] = (v[1][2]*v[2][0]-v[1][0]*v[2][2])/det;
+  dmap -> inv[1][1] = (v[0][0]*v[2][2]-v[0][2]*v[2][0])/det;
+  dmap -> inv[1][2] = (v[0][2]*v[1][0]-v[0][0]*v[1][2])/det;
+  dmap -> inv[2][0] = (v[1][0]*v[2][1]-v[1][1]*v[2][0])/det;
+  dmap -> inv[2][1] = (v[0][1]*v[2][0]-v[0][0]*v[2][1])/det;
+  dmap -> inv[2][2] = (v[0][0]*v[1][1]-v[0][1]*v[1][0])/det;
+  for (i=0; i<3; i++)
+  {
+    dmap -> n[i] = max (2, (int)ceil(sqrt(v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) / res));
+  }
+  if ((double)dmap -> n[0]*dmap -> n[1]*dmap -> n[2] > (double)G_MAXINT) return FALSE;
+  return TRUE;
+}
+
+/*!
+  \fn int density_index (density_map * dmap, int i, int j, int k)
+
+  \brief get the id of a grid point, wrapped if the grid is periodic, clamped otherwise
+
+  \param dmap the target density map
+  \param i grid point id along the 1st grid vector
+  \param j grid point id along the 2nd grid vector
+  \param k grid point id along the 3rd grid vector
+*/
+int density_index (density_map * dmap, int i, int j, int k)
+{
+  int l;
+  int id[3] = {i, j, k};
+  for (l=0; l<3; l++)
+  {
+    if (dmap -> pbc)
+    {
+      id[l] %= dmap -> n[l];
+      if (id[l] < 0) id[l] += dmap -> n[l];
+    }
+    else
+    {
+      id[l] = max (0, min (id[l], dmap -> n[l]-1));
+    }
+  }
+  return (id[0]*dmap -> n[1] + id[1])*dmap -> n[2] + id[2];
+}
+
+/*!
+  \fn int density_grid_point (density_map * dmap, double frac[3])
+
+  \brief get the id of the grid point for fractional grid coordinates, -1 if outside the grid
+
+  \param dmap the target density map
+  \param frac the fractional grid coordinates
+*/
+int density_grid_point (density_map * dmap, double frac[3])
+{
+  int l;
+  int id[3];
+  for (l=0; l<3; l++)
+  {
+    if (dmap -> pbc) frac[l] -= floor(frac[l]);
+    id[l] = (int)floor(frac[l]*dmap -> n[l]);
+    if (dmap -> pbc)
+    {
+      id[l] = min (id[l], dmap -> n[l]-1);
+    }
+    else if (id[l] < 0 || id[l] >= dmap -> n[l])
+    {
+      return -1;
+    }
+  }
+  return (id[0]*dmap -> n[1] + id[1])*dmap -> n[2] + id[2];
+}
+
+/*!
+  \fn void density_min_image (project * this_proj, int bid, double vec[3])
+
+  \brief apply the minimum image convention to a vector
+
+  \param this_proj the target project
+  \param bid the box id
+  \param vec the vector to correct
+*/
+void density_min_image (project * this_proj, int bid, double vec[3])
+{
+  if (this_proj -> cell.pbc && this_proj -> cell.has_a_box)
+  {
+    vec3_t nij = m4_mul_coord (this_proj -> cell.box[bid].cart_to_frac, vec3(vec[0], vec[1], vec[2]));
+    nij.x -= round(nij.x);
+    nij.y -= round(nij.y);
+    nij.z -= round(nij.z);
+    nij = m4_mul_coord (this_proj -> cell.box[bid].frac_to_cart, nij);
+    vec[0] = nij.x;
+    vec[1] = nij.y;
+    vec[2] = nij.z;
+  }
+}
+
+/*!
+  \fn void density_reference_frame (project * this_proj, density_map * dmap, int sid, double cent[3], double frame[3][3])
+
+  \brief compute the local frame of the reference fragment: \n
+  origin at the centroid, 1st axis along the first two atoms, \n
+  2nd axis in the plane of the first three non collinear atoms
+
+  \param this_proj the target project
+  \param dmap the target density map
+  \param sid the MD step
+  \param cent the centroid of the reference fragment
+  \param frame the axis of the local frame, by row
+*/
+void density_reference_frame (project * this_proj, density_map * dmap, int sid, double cent[3], double frame[3][3])
+{
+  int i, j, nr;
+  int bid = (this_proj -> cell.npt) ? sid : 0;
+  double rpos[3][3];
+  double u[3], v[3], w[3];
+  double lu, lw;
+  atom * ref = & this_proj -> atoms[sid][dmap -> ref_list[0]];
+  distance dist;
+
+  for (i=0; i<3; i++)
+  {
+    cent[i] = 0.0;
+    for (j=0; j<3; j++) frame[i][j] = (i == j) ? 1.0 : 0.0;
+  }
+  nr = 0;
+  for (i=0; i<dmap -> nref; i++)
+  {
+    dist = distance_3d (& this_proj -> cell, bid, & this_proj -> atoms[sid][dmap -> ref_list[i]], ref);
+    v[0] = ref -> x + dist.x;
+    v[1] = ref -> y + dist.y;
+    v[2] = ref -> z + dist.z;
+    for (j=0; j<3; j++) cent[j] += v[j];
+    if (nr == 1 && dist.length < 0.01) continue;
+    if (nr == 2)
+    {
+      // Skip the atoms collinear to the first two
+      for (j=0; j<3; j++) w[j] = v[j] - rpos[0][j];
+      u[0] = frame[0][1]*w[2] - frame[0][2]*w[1];
+      u[1] = frame[0][2]*w[0] - frame[0][0]*w[2];
+      u[2] = frame[0][0]*w[1] - frame[0][1]*w[0];
+      if (sqrt(u[0]*u[0] + u[1]*u[1] + u[2]*u[2]) < 0.01) continue;
+    }
+    if (nr < 3)
+    {
+      for (j=0; j<3; j++) rpos[nr][j] = v[j];
+      if (nr == 1)
+      {
+        for (j=0; j<3; j++) frame[0][j] = (rpos[1][j] - rpos[0][j]) / dist.length;
+      }
+      nr ++;
+    }
+  }
+  for (i=0; i<3; i++) cent[i] /= dmap -> nref;
+  if (nr < 2) return;
+  if (nr == 3)
+  {
+    for (i=0; i<3; i++) w[i] = rpos[2][i] - rpos[0][i];
+  }
+  else
+  {
+    // Linear fragment: any direction perpendicular to the 1st axis
+    j = 0;
+    for (i=1; i<3; i++) if (fabs(frame[0][i]) < fabs(frame[0][j])) j = i;
+    for (i=0; i<3; i++) w[i] = (i == j) ? 1.0 : 0.0;
+  }
+  lu = 0.0;
+  for (i=0; i<3; i++) lu += w[i]*frame[0][i];
+  lw = 0.0;
+  for (i=0; i<3; i++)
+  {
+    w[i] -= lu*frame[0][i];
+    lw += w[i]*w[i];
+  }
+  lw = sqrt(lw);
+  for (i=0; i<3; i++) frame[1][i] = w[i] / lw;
+  frame[2][0] = frame[0][1]*frame[1][2] - frame[0][2]*frame[1][1];
+  frame[2][1] = frame[0][2]*frame[1][0] - frame[0][0]*frame[1][2];
+  frame[2][2] = frame[0][0]*frame[1][1] - frame[0][1]*frame[1][0];
+}
+
+/*!
+  \fn G_MODULE_EXPORT void compute_density_maps (GtkButton * but, gpointer data)
+
+  \brief accumulate the 3D density map(s) over all MD steps
+
+  \param but the GtkButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void compute_density_maps (GtkButton * but, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  project * this_proj = get_project_by_id (view -> proj);
+  density_window * dwin = view -> density_win;
+  density_map * dmap;
+  int i, j, k, l, m;
+  int bid;
+  gint64 ngrid;
+  double res = dwin -> param[0];
+  double vol, norm, mean;
+  double vmin[3], vmax[3];
+  double cent[3], frame[3][3], vec[3], loc[3], frac[3];
+  double * weight;
+  gboolean * in_ref = NULL;
+  vec3_t fp;
+  gint64 t_start = g_get_monotonic_time ();
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+#endif
+
+  clean_density_maps (view);
+  dmap = g_malloc0(sizeof*dmap);
+  dmap -> weight = dwin -> weight;
+  dmap -> nmaps = this_proj -> nspec + 1;
+  if (dwin -> ref && view -> adv_bonding[0])
+  {
+    // The reference fragment is defined using the first MD step
+    dmap -> ref_list = allocint (this_proj -> natomes);
+    in_ref = g_malloc0 (this_proj -> natomes*sizeof*in_ref);
+    for (i=0; i<this_proj -> natomes; i++)
+    {
+      if (this_proj -> atoms[0][i].coord[2] == dwin -> ref - 1)
+      {
+        dmap -> ref_list[dmap -> nref] = i;
+        in_ref[i] = TRUE;
+        dmap -> nref ++;
+      }
+    }
+  }
+  if (dmap -> nref)
+  {
+    for (i=0; i<3; i++)
+    {
+      dmap -> org[i] = - dwin -> param[1];
+      for (j=0; j<3; j++) dmap -> vect[i][j] = (i == j) ? 2.0*dwin -> param[1] : 0.0;
+    }
+  }
+  else if (this_proj -> cell.pbc && this_proj -> cell.has_a_box)
+  {
+    dmap -> pbc = TRUE;
+    for (i=0; i<3; i++)
+    {
+      dmap -> org[i] = 0.0;
+      for (j=0; j<3; j++) dmap -> vect[i][j] = this_proj -> cell.box[0].vect[i][j];
+    }
+  }
+  else
+  {
+    vmin[0] = vmax[0] = this_proj -> atoms[0][0].x;
+    vmin[1] = vmax[1] = this_proj -> atoms[0][0].y;
+    vmin[2] = vmax[2] = this_proj -> atoms[0][0].z;
+    for (i=0; i<this_proj -> steps; i++)
+    {
+      for (j=0; j<this_proj -> natomes; j++)
+      {
+        vmin[0] = min (vmin[0], this_proj -> atoms[i][j].x);
+        vmin[1] = min (vmin[1], this_proj -> atoms[i][j].y);
+        vmin[2] = min (vmin[2], this_proj -> atoms[i][j].z);
+        vmax[0] = max (vmax[0], this_proj -> atoms[i][j].x);
+        vmax[1] = max (vmax[1], this_proj -> atoms[i][j].y);
+        vmax[2] = max (vmax[2], this_proj -> atoms[i][j].z);
+      }
+    }
+    for (i=0; i<3; i++)
+    {
+      dmap -> org[i] = vmin[i] - 2.0*res;
+      for (j=0; j<3; j++) dmap -> vect[i][j] = (i == j) ? vmax[i] - vmin[i] + 4.0*res : 0.0;
+    }
+  }
+  if (! setup_density_grid (dmap, res))
+  {
+    if (in_ref) g_free (in_ref);
+    if (dmap -> ref_list) g_free (dmap -> ref_list);
+    g_free (dmap);
+    show_error (_("Impossible to build the density grid:\nplease increase the grid spacing"), 0, dwin -> win);
+    return;
+  }
+  ngrid = (gint64)dmap -> n[0]*dmap -> n[1]*dmap -> n[2];
+  dmap -> rho = g_malloc0(dmap -> nmaps*sizeof*dmap -> rho);
+  for (i=0; i<dmap -> nmaps; i++) dmap -> rho[i] = allocdouble (ngrid);
+  weight = allocdouble (this_proj -> nspec);
+  for (i=0; i<this_proj -> nspec; i++)
+  {
+    switch (dmap -> weight)
+    {
+      case 0:
+        weight[i] = 1.0;
+        break;
+      case 1:
+        weight[i] = this_proj -> chemistry -> chem_prop[CHEM_Z][i];
+        break;
+      case 2:
+        weight[i] = this_proj -> chemistry -> chem_prop[CHEM_N][i];
+        break;
+      case 3:
+        weight[i] = this_proj -> chemistry -> chem_prop[CHEM_X][i];
+        break;
+    }
+  }
+
+  // Each MD step is processed independently, the histograms are updated atomically
+#ifdef OPENMP
+  #pragma omp parallel for num_threads(numth) private(i,j,k,l,m,bid,cent,frame,vec,loc,frac,fp) shared(this_proj,dmap,weight,in_ref)
+#endif
+  for (i=0; i<this_proj -> steps; i++)
+  {
+    bid = (this_proj -> cell.npt) ? i : 0;
+    if (dmap -> nref) density_reference_frame (this_proj, dmap, i, cent, frame);
+    for (j=0; j<this_proj -> natomes; j++)
+    {
+      if (in_ref && in_ref[j]) continue;
+      vec[0] = this_proj -> atoms[i][j].x;
+      vec[1] = this_proj -> atoms[i][j].y;
+      vec[2] = this_proj -> atoms[i][j].z;
+      if (dmap -> pbc)
+      {
+        fp = m4_mul_coord (this_proj -> cell.box[bid].cart_to_frac, vec3(vec[0], vec[1], vec[2]));
+        frac[0] = fp.x;
+        frac[1] = fp.y;
+        frac[2] = fp.z;
+      }
+      else
+      {
+        if (dmap -> nref)
+        {
+          for (k=0; k<3; k++) vec[k] -= cent[k];
+          density_min_image (this_proj, bid, vec);
+          for (k=0; k<3; k++) loc[k] = frame[k][0]*vec[0] + frame[k][1]*vec[1] + frame[k][2]*vec[2];
+        }
+        else
+        {
+          for (k=0; k<3; k++) loc[k] = vec[k];
+        }
+        for (k=0; k<3; k++)
+        {
+          frac[k] = 0.0;
+          for (l=0; l<3; l++) frac[k] += (loc[l] - dmap -> org[l])*dmap -> inv[l][k];
+        }
+      }
+      m = density_grid_point (dmap, frac);
+      if (m > -1)
+      {
+        k = this_proj -> atoms[i][j].sp;
+#ifdef OPENMP
+        #pragma omp atomic
+#endif
+        dmap -> rho[k][m] += weight[k];
+#ifdef OPENMP
+        #pragma omp atomic
+#endif
+        dmap -> rho[this_proj -> nspec][m] += weight[k];
+      }
+    }
+  }
+  g_free (weight);
+  if (in_ref) g_free (in_ref);
+
+  // Normalization: density per Å^3 averaged over the MD steps
+  if (dmap -> pbc)
+  {
+    vol = (this_proj -> cell.npt) ? this_proj -> cell.volume : this_proj -> cell.box[0].vol;
+  }
+  else
+  {
+    vol = dmap -> vect[0][0]*dmap -> vect[1][1]*dmap -> vect[2][2];
+  }
+  norm = (double)ngrid / (vol * this_proj -> steps);
+  dmap -> rmax = allocdouble (dmap -> nmaps);
+  dmap -> iso = allocdouble (dmap -> nmaps);
+  dmap -> show = g_malloc0(dmap -> nmaps*sizeof*dmap -> show);
+  dmap -> col = g_malloc0(dmap -> nmaps*sizeof*dmap -> col);
+  for (i=0; i<dmap -> nmaps; i++)
+  {
+    mean = 0.0;
+    for (m=0; m<ngrid; m++)
+    {
+      dmap -> rho[i][m] *= norm;
+      dmap -> rmax[i] = max (dmap -> rmax[i], dmap -> rho[i][m]);
+      mean += dmap -> rho[i][m];
+    }
+    mean /= ngrid;
+    // Default isosurface: 3 times the average density, to highlight preferential locations
+    dmap -> iso[i] = min (3.0*mean, 0.8*dmap -> rmax[i]);
+    if (i < this_proj -> nspec)
+    {
+      dmap -> col[i] = view -> anim -> last -> img -> at_color[i];
+    }
+    else
+    {
+      dmap -> col[i].red = dmap -> col[i].green = dmap -> col[i].blue = 0.8;
+    }
+    dmap -> col[i].alpha = 0.6;
+  }
+  view -> dmap = dmap;
+  update_density_info (view, (g_get_monotonic_time () - t_start) / 1000000.0);
+  add_density_maps_list (view);
+}
+
+/*!
+  \fn void density_gradient (density_map * dmap, int map, int i, int j, int k, double grad[3])
+
+  \brief compute the gradient of the density at a grid point
+
+  \param dmap the target density map
+  \param map the map id
+  \param i grid point id along the 1st grid vector
+  \param j grid point id along the 2nd grid vector
+  \param k grid point id along the 3rd grid vector
+  \param grad the gradient to compute, in the grid frame
+*/
+void density_gradient (density_map * dmap, int map, int i, int j, int k, double grad[3])
+{
+  int l, m;
+  double dfrac[3];
+  double * rho = dmap -> rho[map];
+  dfrac[0] = 0.5*(rho[density_index(dmap, i+1, j, k)] - rho[density_index(dmap, i-1, j, k)])*dmap -> n[0];
+  dfrac[1] = 0.5*(rho[density_index(dmap, i, j+1, k)] - rho[density_index(dmap, i, j-1, k)])*dmap -> n[1];
+  dfrac[2] = 0.5*(rho[density_index(dmap, i, j, k+1)] - rho[density_index(dmap, i, j, k-1)])*dmap -> n[2];
+  for (l=0; l<3; l++)
+  {
+    grad[l] = 0.0;
+    for (m=0; m<3; m++) grad[l] += dfrac[m]*dmap -> inv[l][m];
+  }
+}
+
+/*!
+  \fn void density_vertex (density_map * dmap, int map, int * pa, int * pb, double iso, double cent[3], double frame[3][3], ColRGBA col, float * vert)
+
+  \brief compute an isosurface vertex on the edge between two grid points
+
+  \param dmap the target density map
+  \param map the map id
+  \param pa the 1st grid point (i, j, k)
+  \param pb the 2nd grid point (i, j, k)
+  \param iso the isosurface level
+  \param cent the origin of the reference frame, if any
+  \param frame the axis of the reference frame, if any
+  \param col the isosurface color
+  \param vert the vertex buffer to fill
+*/
+void density_vertex (density_map * dmap, int map, int * pa, int * pb, double iso, double cent[3], double frame[3][3], ColRGBA col, float * vert)
+{
+  int l, m;
+  double va = dmap -> rho[map][density_index(dmap, pa[0], pa[1], pa[2])];
+  double vb = dmap -> rho[map][density_index(dmap, pb[0], pb[1], pb[2])];
+  double t = (fabs(vb - va) > 1e-15) ? (iso - va) / (vb - va) : 0.5;
+  double ga[3], gb[3], pos[3], nor[3];
+  double frac, nl;
+
+  density_gradient (dmap, map, pa[0], pa[1], pa[2], ga);
+  density_gradient (dmap, map, pb[0], pb[1], pb[2], gb);
+  nl = 0.0;
+  for (l=0; l<3; l++)
+  {
+    pos[l] = dmap -> org[l];
+    for (m=0; m<3; m++)
+    {
+      frac = (pa[m] + t*(pb[m] - pa[m]) + 0.5) / dmap -> n[m];
+      pos[l] += frac*dmap -> vect[m][l];
+    }
+    // The normal points toward the lower density
+    nor[l] = - (ga[l] + t*(gb[l] - ga[l]));
+    nl += nor[l]*nor[l];
+  }
+  nl = sqrt(nl);
+  if (nl < 1e-15)
+  {
+    nor[0] = nor[1] = 0.0;
+    nor[2] = nl = 1.0;
+  }
+  for (l=0; l<3; l++)
+  {
+    if (dmap -> nref)
+    {
+      vert[l] = cent[l] + pos[0]*frame[0][l] + pos[1]*frame[1][l] + pos[2]*frame[2][l];
+      vert[l+3] = (nor[0]*frame[0][l] + nor[1]*frame[1][l] + nor[2]*frame[2][l]) / nl;
+    }
+    else
+    {
+      vert[l] = pos[l];
+      vert[l+3] = nor[l] / nl;
+    }
+  }
+  vert[6] = col.red;
+  vert[7] = col.green;
+  vert[8] = col.blue;
+  vert[9] = col.alpha;
+}
+
+/*!
+  \fn object_3d * density_isosurface (project * this_proj, int map, int sid)
+
+  \brief extract the isosurface of a density map, using marching tetrahedra: \n
+  each grid cell is split in 6 tetrahedra sharing the cell diagonal
+
+  \param this_proj the target project
+  \param map the map id
+  \param sid the MD step, to position the map on the reference fragment, if any
+*/
+object_3d * density_isosurface (project * this_proj, int map, int sid)
+{
+  density_map * dmap = this_proj -> modelgl -> dmap;
+  int tetra[6][4] = {{0, 1, 3, 7}, {0, 3, 2, 7}, {0, 2, 6, 7}, {0, 6, 4, 7}, {0, 4, 5, 7}, {0, 5, 1, 7}};
+  int i, j, k, l, n, o, p, t;
+  int nin, nout, ntri;
+  int cmax[3];
+  int corner[8][3];
+  int tin[4], tout[4], edge[6][2];
+  double val[8];
+  double cent[3], frame[3][3];
+  double iso = dmap -> iso[map];
+  object_3d * surf = NULL;
+
+  if (dmap -> nref) density_reference_frame (this_proj, dmap, sid, cent, frame);
+  for (l=0; l<3; l++) cmax[l] = (dmap -> pbc) ? dmap -> n[l] : dmap -> n[l] - 1;
+  ntri = 0;
+  for (n=0; n<2; n++)
+  {
+    // First pass: count the triangles, second pass: store the vertices
+    if (n)
+    {
+      if (! ntri) return NULL;
+      surf = g_malloc0(sizeof*surf);
+      surf -> vert_buffer_size = POLY_BUFF_SIZE;
+      surf -> num_vertices = 3*ntri;
+      surf -> vertices = allocfloat (surf -> vert_buffer_size*surf -> num_vertices);
+    }
+    o = 0;
+    for (i=0; i<cmax[0]; i++)
+    {
+      for (j=0; j<cmax[1]; j++)
+      {
+        for (k=0; k<cmax[2]; k++)
+        {
+          nin = 0;
+          for (l=0; l<8; l++)
+          {
+            corner[l][0] = i + (l & 1);
+            corner[l][1] = j + ((l >> 1) & 1);
+            corner[l][2] = k + ((l >> 2) & 1);
+            val[l] = dmap -> rho[map][density_index(dmap, corner[l][0], corner[l][1], corner[l][2])];
+            if (val[l] >= iso) nin ++;
+          }
+          if (! nin || nin == 8) continue;
+          for (t=0; t<6; t++)
+          {
+            nin = nout = 0;
+            for (l=0; l<4; l++)
+            {
+              p = tetra[t][l];
+              if (val[p] >= iso)
+              {
+                tin[nin] = p;
+                nin ++;
+              }
+              else
+              {
+                tout[nout] = p;
+                nout ++;
+              }
+            }
+            if (! nin || ! nout) continue;
+            if (nin == 2)
+            {
+              // Quad: 2 triangles
+              edge[0][0] = tin[0];
+              edge[0][1] = tout[0];
+              edge[1][0] = tin[0];
+              edge[1][1] = tout[1];
+              edge[2][0] = tin[1];
+              edge[2][1] = tout[1];
+              edge[3][0] = tin[0];
+              edge[3][1] = tout[0];
+              edge[4][0] = tin[1];
+              edge[4][1] = tout[1];
+              edge[5][0] = tin[1];
+              edge[5][1] = tout[0];
+              p = 6;
+            }
+            else
+            {
+              // One corner separated from the 3 others: 1 triangle
+              for (l=0; l<3; l++)
+              {
+                edge[l][0] = (nin == 1) ? tin[0] : tout[0];
+                edge[l][1] = (nin == 1) ? tout[l] : tin[l];
+              }
+              p = 3;
+            }
+            if (n)
+            {
+              for (l=0; l<p; l++)
+              {
+                density_vertex (dmap, map, corner[edge[l][0]], corner[edge[l][1]], iso, cent, frame, dmap -> col[map], & surf -> vertices[o*POLY_BUFF_SIZE]);
+                o ++;
+              }
+            }
+            else
+            {
+              ntri += p/3;
+            }
+          }
+        }
+      }
+    }
+  }
+  return surf;
+}
+
+/*!
+  \fn gboolean write_density_cube (project * this_proj, int map, gchar * filename)
+
+  \brief export a density map using the Gaussian cube file format
+
+  \param this_proj the target project
+  \param map the map id
+  \param filename the name of the file
+*/
+gboolean write_density_cube (project * this_proj, int map, gchar * filename)
+{
+  density_map * dmap = this_proj -> modelgl -> dmap;
+  FILE * fp = fopen (filename, "w");
+  if (! fp) return FALSE;
+  int i, j, k, l, m;
+  int nats;
+  double bohr = 0.52917721;
+  double cent[3], frame[3][3], org[3], pos[3], vec[3];
+  atom * at;
+
+  fprintf (fp, "%s - %s: %s\n", prepare_for_title(this_proj -> name),
+                                (map < this_proj -> nspec) ? this_proj -> chemistry -> label[map] : _("Total"),
+                                _(density_type[dmap -> weight]));
+  fprintf (fp, (dmap -> nref) ? _("Averaged over %d MD step(s), per bohr^3, aligned on a reference fragment\n") : _("Averaged over %d MD step(s), per bohr^3\n"), this_proj -> steps);
+  for (i=0; i<3; i++)
+  {
+    org[i] = dmap -> org[i];
+    for (j=0; j<3; j++) org[i] += 0.5*dmap -> vect[j][i] / dmap -> n[j];
+  }
+  nats = (dmap -> nref) ? dmap -> nref : this_proj -> natomes;
+  fprintf (fp, "%5d %12.6f %12.6f %12.6f\n", nats, org[0]/bohr, org[1]/bohr, org[2]/bohr);
+  for (i=0; i<3; i++)
+  {
+    fprintf (fp, "%5d %12.6f %12.6f %12.6f\n", dmap -> n[i], dmap -> vect[i][0] / (dmap -> n[i]*bohr),
+                                                              dmap -> vect[i][1] / (dmap -> n[i]*bohr),
+                                                              dmap -> vect[i][2] / (dmap -> n[i]*bohr));
+  }
+  // Atomic coordinates: 1st MD step, reference frame if the map was aligned
+  if (dmap -> nref) density_reference_frame (this_proj, dmap, 0, cent, frame);
+  for (i=0; i<nats; i++)
+  {
+    at = & this_proj -> atoms[0][(dmap -> nref) ? dmap -> ref_list[i] : i];
+    pos[0] = at -> x;
+    pos[1] = at -> y;
+    pos[2] = at -> z;
+    if (dmap -> nref)
+    {
+      for (j=0; j<3; j++) vec[j] = pos[j] - cent[j];
+      density_min_image (this_proj, 0, vec);
+      for (j=0; j<3; j++) pos[j] = frame[j][0]*vec[0] + frame[j][1]*vec[1] + frame[j][2]*vec[2];
+    }
+    fprintf (fp, "%5d %12.6f %12.6f %12.6f %12.6f\n", (int)this_proj -> chemistry -> chem_prop[CHEM_Z][at -> sp], 0.0, pos[0]/bohr, pos[1]/bohr, pos[2]/bohr);
+  }
+  for (i=0; i<dmap -> n[0]; i++)
+  {
+    for (j=0; j<dmap -> n[1]; j++)
+    {
+      m = 0;
+      for (k=0; k<dmap -> n[2]; k++)
+      {
+        l = (i*dmap -> n[1] + j)*dmap -> n[2] + k;
+        fprintf (fp, " %12.5E", dmap -> rho[map][l]*bohr*bohr*bohr);
+        m ++;
+        if (m == 6 || k == dmap -> n[2]-1)
+        {
+          fprintf (fp, "\n");
+          m = 0;
+        }
+      }
+    }
+  }
+  fclose (fp);
+  return TRUE;
+}
+
+#ifdef GTK4
+/*!
+  \fn G_MODULE_EXPORT void run_save_density_map (GtkNativeDialog * info, gint response_id, gpointer data)
+
+  \brief export a density map to a cube file: run the dialog
+
+  \param info the GtkNativeDialog sending the signal
+  \param response_id the response id
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void run_save_density_map (GtkNativeDialog * info, gint response_id, gpointer data)
+{
+  GtkFileChooser * chooser = GTK_FILE_CHOOSER((GtkFileChooserNative *)info);
+#else
+/*!
+  \fn G_MODULE_EXPORT void run_save_density_map (GtkDialog * info, gint response_id, gpointer data)
+
+  \brief export a density map to a cube file: run the dialog
+
+  \param info the GtkDialog sending the signal
+  \param response_id the response id
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void run_save_density_map (GtkDialog * info, gint response_id, gpointer data)
+{
+  GtkFileChooser * chooser = GTK_FILE_CHOOSER((GtkWidget *)info);
+#endif
+  if (response_id == GTK_RESPONSE_ACCEPT)
+  {
+    gchar * cube_file = file_chooser_get_file_name (chooser);
+    if (cube_file)
+    {
+      tint * dat = (tint *)data;
+      project * this_proj = get_project_by_id (dat -> a);
+      if (! write_density_cube (this_proj, dat -> c, cube_file))
+      {
+        gchar * str = g_strdup_printf (_("Impossible to open file: %s"), cube_file);
+        show_error (str, 0, this_proj -> modelgl -> density_win -> win);
+        g_free (str);
+      }
+      g_free (cube_file);
+    }
+  }
+#ifdef GTK4
+  destroy_this_native_dialog (info);
+#else
+  destroy_this_dialog (info);
+#endif
+}
+
+/*!
+  \fn G_MODULE_EXPORT void save_density_map (GtkButton * but, gpointer data)
+
+  \brief export a density map to a cube file
+
+  \param but the GtkButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void save_density_map (GtkButton * but, gpointer data)
+{
+  tint * dat = (tint *)data;
+  project * this_proj = get_project_by_id (dat -> a);
+#ifdef GTK4
+  GtkFileChooserNative * info;
+#else
+  GtkWidget * info;
+#endif
+  info = create_file_chooser (_("Export density map to cube file"),
+                              GTK_WINDOW(MainWindow),
+                              GTK_FILE_CHOOSER_ACTION_SAVE,
+                              _("Save"));
+  GtkFileChooser * chooser = GTK_FILE_CHOOSER(info);
+#ifdef GTK3
+  gtk_file_chooser_set_do_overwrite_confirmation (chooser, TRUE);
+#endif
+  file_chooser_set_current_folder (chooser);
+  gchar * str = g_strdup_printf ("%s-density.cube", (dat -> c < this_proj -> nspec) ? this_proj -> chemistry -> label[dat -> c] : "total");
+  gtk_file_chooser_set_current_name (chooser, str);
+  g_free (str);
+#ifdef GTK4
+  run_this_gtk_native_dialog ((GtkNativeDialog *)info, G_CALLBACK(run_save_density_map), data);
+#else
+  run_this_gtk_dialog (info, G_CALLBACK(run_save_density_map), data);
+#endif
+}
+
+/*!
+  \fn void update_density_info (glwin * view, double time)
+
+  \brief update the description of the density map(s)
+
+  \param view the target glwin
+  \param time the CPU time, in seconds, not displayed if 0.0
+*/
+void update_density_info (glwin * view, double time)
+{
+  project * this_proj = get_project_by_id (view -> proj);
+  density_map * dmap = view -> dmap;
+  int i;
+  gchar * str, * tmp;
+
+  str = g_strdup_printf (_("<b>%s</b>, averaged over %d MD step(s)\n"), _(density_type[dmap -> weight]), this_proj -> steps);
+  tmp = g_strdup_printf (_("%s\tGrid: %d x %d x %d points, %s\n"), str, dmap -> n[0], dmap -> n[1], dmap -> n[2],
+                         (dmap -> pbc) ? _("periodic") : (dmap -> nref) ? _("aligned on the reference fragment") : _("isolated model"));
+  g_free (str);
+  str = g_strdup_printf (_("%s\tMaximum density (per &#xC5;<sup>3</sup>):"), tmp);
+  g_free (tmp);
+  for (i=0; i<dmap -> nmaps; i++)
+  {
+    tmp = g_strdup_printf ("%s\n\t\t%s: %f", str, (i < this_proj -> nspec) ? this_proj -> chemistry -> label[i] : _("Total"), dmap -> rmax[i]);
+    g_free (str);
+    str = g_strdup_printf ("%s", tmp);
+    g_free (tmp);
+  }
+  if (time > 0.0)
+  {
+    tmp = g_strdup_printf (_("%s\n\tComputation time: %.2f s"), str, time);
+    g_free (str);
+    str = g_strdup_printf ("%s", tmp);
+    g_free (tmp);
+  }
+  gtk_label_set_markup (GTK_LABEL(view -> density_win -> info), str);
+  g_free (str);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_density_iso (GtkEntry * res, gpointer data)
+
+  \brief set the isosurface level entry callback
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_density_iso (GtkEntry * res, gpointer data)
+{
+  tint * dat = (tint *)data;
+  project * this_proj = get_project_by_id (dat -> a);
+  density_map * dmap = this_proj -> modelgl -> dmap;
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if (v > 0.0) dmap -> iso[dat -> c] = v;
+  update_entry_double (res, dmap -> iso[dat -> c]);
+  if (dmap -> show[dat -> c])
+  {
+    int shaders[1] = {VOLMS};
+    re_create_md_shaders (1, shaders, this_proj);
+    update (this_proj -> modelgl);
+  }
+}
+
+#ifdef GTK4
+/*!
+  \fn G_MODULE_EXPORT void show_density_map (GtkCheckButton * but, gpointer data)
+
+  \brief toggle show / hide isosurface callback GTK4
+
+  \param but the GtkCheckButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void show_density_map (GtkCheckButton * but, gpointer data)
+#else
+/*!
+  \fn G_MODULE_EXPORT void show_density_map (GtkToggleButton * but, gpointer data)
+
+  \brief toggle show / hide isosurface callback GTK3
+
+  \param but the GtkToggleButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void show_density_map (GtkToggleButton * but, gpointer data)
+#endif
+{
+  tint * dat = (tint *)data;
+  project * this_proj = get_project_by_id (dat -> a);
+  this_proj -> modelgl -> dmap -> show[dat -> c] = button_get_status ((GtkWidget *)but);
+  int shaders[1] = {VOLMS};
+  re_create_md_shaders (1, shaders, this_proj);
+  update (this_proj -> modelgl);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_density_color (GtkColorChooser * colob, gpointer data)
+
+  \brief change isosurface color
+
+  \param colob the GtkColorChooser sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_density_color (GtkColorChooser * colob, gpointer data)
+{
+  tint * dat = (tint *)data;
+  project * this_proj = get_project_by_id (dat -> a);
+  this_proj -> modelgl -> dmap -> col[dat -> c] = get_button_color (colob);
+  int shaders[1] = {VOLMS};
+  re_create_md_shaders (1, shaders, this_proj);
+  update (this_proj -> modelgl);
+}
+
+/*!
+  \fn void add_density_maps_list (glwin * view)
+
+  \brief create the list of the density map(s)
+
+  \param view the target glwin
+*/
+void add_density_maps_list (glwin * view)
+{
+  project * this_proj = get_project_by_id (view -> proj);
+  density_map * dmap = view -> dmap;
+  GtkWidget * hbox;
+  GtkWidget * entry;
+  int i;
+  view -> density_win -> maps_vbox = create_vbox (BSEP);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, view -> density_win -> maps_box, view -> density_win -> maps_vbox, FALSE, FALSE, 0);
+  abox (view -> density_win -> maps_vbox, _("<u>Isosurface(s):</u>"), 5);
+  for (i=0; i<dmap -> nmaps; i++)
+  {
+    hbox = create_hbox (BSEP);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label ((i < this_proj -> nspec) ? this_proj -> chemistry -> label[i] : _("Total"), 60, -1, 0.0, 0.5), FALSE, FALSE, 20);
+    entry = create_entry (G_CALLBACK(set_density_iso), 100, 15, FALSE, & view -> colorp[0][i]);
+    update_entry_double (GTK_ENTRY(entry), dmap -> iso[i]);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, check_button (_("Show/Hide"), 100, -1, dmap -> show[i], G_CALLBACK(show_density_map), & view -> colorp[0][i]), FALSE, FALSE, 5);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, color_button (dmap -> col[i], TRUE, 50, -1, G_CALLBACK(set_density_color), & view -> colorp[0][i]), FALSE, FALSE, 5);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                         create_button (_("Export"), IMG_NONE, NULL, 80, -1, GTK_RELIEF_NORMAL, G_CALLBACK(save_density_map), & view -> colorp[0][i]), FALSE, FALSE, 5);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, view -> density_win -> maps_vbox, hbox, FALSE, FALSE, 2);
+  }
+  show_the_widgets (view -> density_win -> maps_vbox);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_density_weight (GtkComboBox * box, gpointer data)
+
+  \brief change the type of density
+
+  \param box the GtkComboBox sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_density_weight (GtkComboBox * box, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  view -> density_win -> weight = combo_get_active ((GtkWidget *)box);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_density_param (GtkEntry * res, gpointer data)
+
+  \brief set grid spacing or half size of the aligned grid entry callback
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_density_param (GtkEntry * res, gpointer data)
+{
+  tint * dat = (tint *)data;
+  glwin * view = get_project_by_id(dat -> a) -> modelgl;
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if (v > 0.0) view -> density_win -> param[dat -> b] = v;
+  update_entry_double (res, view -> density_win -> param[dat -> b]);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_density_reference (GtkSpinButton * res, gpointer data)
+
+  \brief change the reference fragment spin callback
+
+  \param res the GtkSpinButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_density_reference (GtkSpinButton * res, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  view -> density_win -> ref = gtk_spin_button_get_value_as_int(res);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void window_density (GtkWidget * widg, gpointer data)
+
+  \brief create the 'Density maps' window callback
+
+  \param widg the GtkWidget sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void window_density (GtkWidget * widg, gpointer data)
+{
+  glwin * view = (glwin *) data;
+  if (view -> density_win == NULL)
+  {
+    view -> density_win = g_malloc0(sizeof*view -> density_win);
+    view -> density_win -> param[0] = 0.25;
+    view -> density_win -> param[1] = 8.0;
+    project * this_proj = get_project_by_id (view -> proj);
+    gchar * str = g_strdup_printf (_("%s - density maps"), this_proj -> name);
+    view -> density_win -> win = create_win (str, view -> win, FALSE, FALSE);
+    gtk_widget_set_size_request (view -> density_win -> win, 550, 500);
+    g_free (str);
+    GtkWidget * vbox = create_vbox (BSEP);
+    GtkWidget * scroll = create_scroll (NULL, -1, -1, GTK_SHADOW_NONE);
+    gtk_widget_set_hexpand (scroll, TRUE);
+    gtk_widget_set_vexpand (scroll, TRUE);
+    add_container_child (CONTAINER_WIN, view -> density_win -> win, scroll);
+    add_container_child (CONTAINER_SCR, scroll, vbox);
+    abox (vbox, _("<u>3D density map(s) accumulated over the MD trajectory:</u>"), 5);
+    GtkWidget * hbox = create_hbox (BSEP);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Density:"), 200, -1, 0.0, 0.5), FALSE, FALSE, 30);
+    GtkWidget * combo = create_combo ();
+    int i;
+    for (i=0; i<4; i++) combo_text_append (combo, _(density_type[i]));
+    combo_set_active (combo, view -> density_win -> weight);
+    g_signal_connect (G_OBJECT (combo), "changed", G_CALLBACK(set_density_weight), view);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, combo, FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+    gchar * dparam[2] = {i18n("Grid spacing (&#xC5;):"), i18n("Half size of the aligned grid (&#xC5;):")};
+    GtkWidget * entry;
+    for (i=0; i<2; i++)
+    {
+      if (i && ! view -> adv_bonding[0]) break;
+      hbox = create_hbox (BSEP);
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_(dparam[i]), 200, -1, 0.0, 0.5), FALSE, FALSE, 30);
+      entry = create_entry (G_CALLBACK(set_density_param), 100, 15, FALSE, & view -> colorp[i][0]);
+      update_entry_double (GTK_ENTRY(entry), view -> density_win -> param[i]);
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 0);
+      add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+    }
+    hbox = create_hbox (BSEP);
+    if (view -> adv_bonding[0])
+    {
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Reference fragment (0 = none):"), 200, -1, 0.0, 0.5), FALSE, FALSE, 30);
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                           spin_button (G_CALLBACK(set_density_reference), view -> density_win -> ref, 0.0, (double)this_proj -> coord -> totcoord[2], 1.0, 0, 100, view), FALSE, FALSE, 0);
+    }
+    else
+    {
+      add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                           markup_label (_("<i>Fragment(s) are required to align the map(s) on a reference fragment</i>"), -1, -1, 0.0, 0.5), FALSE, FALSE, 30);
+    }
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+    hbox = create_hbox (BSEP);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                         create_button (_("Compute"), IMG_NONE, NULL, 150, -1, GTK_RELIEF_NORMAL, G_CALLBACK(compute_density_maps), view), FALSE, FALSE, 30);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+    view -> density_win -> info = markup_label ("", -1, -1, 0.0, 0.0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, view -> density_win -> info, FALSE, FALSE, 5);
+    view -> density_win -> maps_box = create_vbox (BSEP);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, view -> density_win -> maps_box, FALSE, FALSE, 5);
+    if (view -> dmap)
+    {
+      update_density_info (view, 0.0);
+      add_density_maps_list (view);
+    }
+    add_gtk_close_event (view -> density_win -> win, G_CALLBACK(hide_this_window), NULL);
+    show_the_widgets (view -> density_win -> win);
+  }
+  else
+  {
+    show_the_widgets (view -> density_win -> win);
+  }
+}
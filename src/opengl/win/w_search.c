@@ -41,8 +41,12 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   int get_asearch_filter (atom_search * asearch);
   int get_selected_object_id (gboolean visible, int p, gchar * str, atom_search * asearch);
   int get_todo_size (atom_search * asearch);
+  int get_atom_node (project * this_proj, int filter, int step, int aid);
+
+  int * sort_atoms_by_node (project * this_proj, int filter, int step, int nodes, int ** node_start);
 
   gboolean get_asearch_is_object (atom_search * asearch);
+  gboolean is_place_holder (GtkTreeModel * model, GtkTreeIter * child);
   gboolean fill_for_action (atom_search * asearch, int i, int j, project * this_proj);
   gboolean append (atom_search * asearch, project * this_proj, int i, int j);
   gboolean update_this_search (atom_search * asearch);
@@ -53,10 +57,12 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   gchar * adjust_picked (gchar * picked, atomic_object * object, gboolean init);
   gchar * get_node_name (int node, atom_search * asearch, project * this_proj);
 
+  void get_node_status (atom_search * asearch, project * this_proj, int * node_atoms, int start, int end, int * pick, int * move, double * msd);
   void check_tree_for_this_search (project * this_proj, atom_search * asearch);
   void check_all_trees (project * this_proj);
   void motion_to_zero (atom_search * asearch);
   void adjust_object_to_move (project * this_proj, atom_search * asearch, int mv, int id);
+  void set_todo_for_all (atom_search * asearch, project * this_proj, int i);
   void append_to_model (GtkTreeIter * atom_level, atom_search * asearch, gboolean is_object, int h, int i, project * this_proj);
   void fill_atom_model (atom_search * asearch, project * this_proj);
   void update_search_tree (atom_search * asearch);
@@ -74,6 +80,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   void add_random_column (atom_search * asearch);
   void prep_search_box (GtkWidget * vbox, GtkWidget * lab, GtkWidget * combo);
 
+  G_MODULE_EXPORT gboolean expand_atom_node (GtkTreeView * tree_view, GtkTreeIter * iter, GtkTreePath * path, gpointer data);
+
   G_MODULE_EXPORT void set_atom (GtkEntry * entry, gpointer data);
   G_MODULE_EXPORT void remove_atom (GtkButton * but, gpointer data);
   G_MODULE_EXPORT void add_atom (GtkButton * but, gpointer data);
@@ -203,6 +211,142 @@ gboolean get_asearch_is_object (atom_search * asearch)
   }
 }
 
+/*!
+  \fn int get_atom_node (project * this_proj, int filter, int step, int aid)
+
+  \brief get the tree node of an atom for an atom search filter
+
+  \param this_proj the target project
+  \param filter the atom search filter
+  \param step the MD step
+  \param aid the atom id
+*/
+int get_atom_node (project * this_proj, int filter, int step, int aid)
+{
+  int i, j, k;
+  j = this_proj -> atoms[0][aid].sp;
+  if (! filter) return j;
+  k = this_proj -> atoms[step][aid].coord[filter - 1];
+  if (filter == 1) return this_proj -> coord -> geolist[0][j][k];
+  if (filter == 2) for (i=0; i<j; i++) k += this_proj -> coord -> ntg[1][i];
+  return k;
+}
+
+/*!
+  \fn int * sort_atoms_by_node (project * this_proj, int filter, int step, int nodes, int ** node_start)
+
+  \brief sort the atom(s) by tree node (counting sort), so that each node of the search tree
+  does not require to browse the entire model: the atom(s) of node 'n' are stored, in increasing id order,
+  from node_start[n] to node_start[n+1]-1 in the returned list
+
+  \param this_proj the target project
+  \param filter the atom search filter
+  \param step the MD step
+  \param nodes the number of node(s) in the tree
+  \param node_start the position of each node in the list, to allocate
+*/
+int * sort_atoms_by_node (project * this_proj, int filter, int step, int nodes, int ** node_start)
+{
+  int i, j;
+  int * node_of = allocint (this_proj -> natomes);
+  int * start = allocint (nodes+1);
+  int * list = allocint (this_proj -> natomes);
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    j = get_atom_node (this_proj, filter, step, i);
+    node_of[i] = (j > -1 && j < nodes) ? j : -1;
+    if (node_of[i] > -1) start[j+1] ++;
+  }
+  for (i=0; i<nodes; i++) start[i+1] += start[i];
+  int * next = duplicate_int (nodes, start);
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    j = node_of[i];
+    if (j > -1)
+    {
+      list[next[j]] = i;
+      next[j] ++;
+    }
+  }
+  g_free (next);
+  g_free (node_of);
+  * node_start = start;
+  return list;
+}
+
+/*!
+  \fn gboolean is_place_holder (GtkTreeModel * model, GtkTreeIter * child)
+
+  \brief is this child row the place holder of a node of the search tree that was not expanded yet
+
+  \param model the tree model
+  \param child the first child row of the node
+*/
+gboolean is_place_holder (GtkTreeModel * model, GtkTreeIter * child)
+{
+  int i;
+  gtk_tree_model_get (model, child, IDCOL, & i, -1);
+  return (i) ? FALSE : TRUE;
+}
+
+gboolean append (atom_search * asearch, project * this_proj, int i, int j);
+
+/*!
+  \fn void get_node_status (atom_search * asearch, project * this_proj, int * node_atoms, int start, int end, int * pick, int * move, double * msd)
+
+  \brief get the status of a node of the search tree from its atom(s), when the atom(s) are not in the tree store
+
+  \param asearch the target atom search
+  \param this_proj the target project
+  \param node_atoms the atom(s) sorted by tree node
+  \param start the position of the first atom of the node in the list
+  \param end the position after the last atom of the node in the list
+  \param pick the 'pick' status of the node, to set
+  \param move the 'move' status of the node (RANMOVE object), to set
+  \param msd the max MSD shared by the atom(s) of the node, if any, to set (RANMOVE)
+*/
+void get_node_status (atom_search * asearch, project * this_proj, int * node_atoms, int start, int end, int * pick, int * move, double * msd)
+{
+  int i, j, k, l;
+  gboolean is_first = TRUE;
+  int obj = get_asearch_object (asearch);
+  int step = this_proj -> modelgl -> anim -> last -> img -> step;
+  * pick = * move = 1;
+  * msd = 0.0;
+  for (i=start; i<end; i++)
+  {
+    j = node_atoms[i];
+    if (append (asearch, this_proj, j, this_proj -> atoms[0][j].sp))
+    {
+      l = 0;
+      if (asearch -> action < 2)
+      {
+        k = this_proj -> atoms[step][j].pick[0];
+      }
+      else if (asearch -> action == RANMOVE)
+      {
+        k = (asearch -> todo[j] == 1 || asearch -> todo[j] == 3) ? 1 : 0;
+        if (obj) l = (asearch -> todo[j] == 2 || asearch -> todo[j] == 3) ? 1 : 0;
+        if (is_first || this_proj -> modelgl -> atom_win -> msd[j] == * msd)
+        {
+          * msd = this_proj -> modelgl -> atom_win -> msd[j];
+        }
+        else
+        {
+          * msd = 0.0;
+        }
+        is_first = FALSE;
+      }
+      else
+      {
+        k = asearch -> todo[j];
+      }
+      * pick = (* pick && k) ? 1 : 0;
+      * move = (* move && l) ? 1 : 0;
+    }
+  }
+}
+
 /*!
   \fn void check_tree_for_this_search (project * this_proj, atom_search * asearch)
 
@@ -213,7 +357,8 @@ gboolean get_asearch_is_object (atom_search * asearch)
 */
 void check_tree_for_this_search (project * this_proj, atom_search * asearch)
 {
-  int j, k, l, m, n, o, p;
+  int j, k, l, m, n, o;
+  int * node_start, * node_atoms;
   double u, v;
   gchar * str;
   GtkTreeIter iter;
@@ -231,6 +376,7 @@ void check_tree_for_this_search (project * this_proj, atom_search * asearch)
   if (gtk_tree_model_get_iter_first (atom_model, & iter))
   {
     dothis = TRUE;
+    node_atoms = sort_atoms_by_node (this_proj, filter, step, val, & node_start);
     if (! filter && status == 2)
     {
       while (dothis)
@@ -246,6 +392,11 @@ void check_tree_for_this_search (project * this_proj, atom_search * asearch)
             u = v = 0.0;
             l = 0;
             m = 1;
+            if (is_place_holder (atom_model, & child))
+            {
+              get_node_status (asearch, this_proj, node_atoms, node_start[j], node_start[j+1], & m, & o, & v);
+              dothat = FALSE;
+            }
             while (dothat)
             {
               gtk_tree_model_get (atom_model, & child, IDCOL, & k, TOPIC, & l, -1);
@@ -307,58 +458,27 @@ void check_tree_for_this_search (project * this_proj, atom_search * asearch)
         if (j > -1 && j < val)
         {
           k = l = 0;
-          switch (filter)
+          for (o=node_start[j]; o<node_start[j+1]; o++)
           {
-            case 0:
-              for (m=0; m<this_proj -> natomes; m++)
-              {
-                n = this_proj -> atoms[step][m].sp;
-                if (n == j && (this_proj -> atoms[step][m].pick[is_clone] == status || status == 2))
-                {
-                  k ++;
-                  l += (this_proj -> atoms[step][m].label[is_clone]) ? 1 : 0;
-                }
-              }
-              break;
-            case 1:
-              for (m=0; m<this_proj -> natomes; m++)
-              {
-                n = this_proj -> atoms[step][m].sp;
-                o = this_proj -> atoms[step][m].coord[filter-1];
-                if (this_proj -> atoms[step][m].numv == j && (this_proj -> atoms[step][m].pick[is_clone] == status || status == 2))
-                {
-                  k ++;
-                  l += (this_proj -> atoms[step][m].label[is_clone]) ? 1 : 0;
-                }
-              }
-              break;
-            default:
-              for (m=0; m<this_proj -> natomes; m++)
-              {
-                n = this_proj -> atoms[step][m].sp;
-                o = this_proj -> atoms[step][m].coord[filter-1];
-                if (filter == 2)
-                {
-                  for (p=0; p<n; p++)
-                  {
-                    o += this_proj -> coord -> ntg[1][p];
-                  }
-                }
-                if (o == j && (this_proj -> atoms[step][m].pick[is_clone] == status || status == 2))
-                {
-                  k ++;
-                  l += (this_proj -> atoms[step][m].label[is_clone]) ? 1 : 0;
-                }
-              }
-              break;
+            m = node_atoms[o];
+            if (this_proj -> atoms[step][m].pick[is_clone] == status || status == 2)
+            {
+              k ++;
+              l += (this_proj -> atoms[step][m].label[is_clone]) ? 1 : 0;
+            }
           }
           gtk_tree_store_set (asearch -> atom_model, & iter, TOLAB, (k == l && k != 0) ? 1 : 0, -1);
           if (gtk_tree_model_iter_children (atom_model, & child, & iter))
           {
-            dothat = TRUE;
+            dothat = is_first = TRUE;
             u = v = 0.0;
             l = n = 0;
             m = o = 1;
+            if (is_place_holder (atom_model, & child))
+            {
+              get_node_status (asearch, this_proj, node_atoms, node_start[j], node_start[j+1], & m, & o, & v);
+              dothat = FALSE;
+            }
             while (dothat)
             {
               gtk_tree_model_get (atom_model, & child, IDCOL, & k, TOPIC, & l, -1);
@@ -437,6 +557,8 @@ void check_tree_for_this_search (project * this_proj, atom_search * asearch)
         dothis = gtk_tree_model_iter_next (atom_model, & iter);
       }
     }
+    g_free (node_start);
+    g_free (node_atoms);
   }
 }
 
@@ -628,6 +750,27 @@ void adjust_object_to_move (project * this_proj, atom_search * asearch, int mv,
   if (adjust_mv && ! mv && this_proj -> modelgl -> atom_win) motion_to_zero (asearch);
 }
 
+/*!
+  \fn void set_todo_for_all (atom_search * asearch, project * this_proj, int i)
+
+  \brief apply the 'for all' status of the atom search to atom 'i'
+
+  \param asearch the target atom search
+  \param this_proj the target project
+  \param i the atom id
+*/
+void set_todo_for_all (atom_search * asearch, project * this_proj, int i)
+{
+  if (asearch -> action > 1)
+  {
+    asearch -> todo[i] = asearch -> set_for_all;
+    if ((asearch -> action == RANMOVE || asearch -> action == DISPL) && get_asearch_object (asearch))
+    {
+      adjust_object_to_move (this_proj, asearch, (asearch -> action == RANMOVE) ? 1 : 0, i);
+    }
+  }
+}
+
 /*!
   \fn void append_to_model (GtkTreeIter * atom_level, atom_search * asearch, gboolean is_object, int h, int i, project * this_proj)
 
@@ -653,6 +796,7 @@ void append_to_model (GtkTreeIter * atom_level, atom_search * asearch, gboolean
   gtk_tree_store_set (asearch -> atom_model, atom_level, IDCOL, i+1, 1, " ", 2, str, TOLAB, this_proj -> atoms[step][i].label[is_clone], -1);
   g_free (str);
   atomic_object * object;
+  if (asearch -> set_for_all > 0) set_todo_for_all (asearch, this_proj, i);
   switch (asearch -> action)
   {
     case 0:
@@ -662,14 +806,6 @@ void append_to_model (GtkTreeIter * atom_level, atom_search * asearch, gboolean
       gtk_tree_store_set (asearch -> atom_model, atom_level, TOPIC, this_proj -> atoms[step][i].pick[0], -1);
       break;
     case RANMOVE:
-      if (asearch -> set_for_all > 0)
-      {
-        asearch -> todo[i] = asearch -> set_for_all;
-        if (aobj)
-        {
-          adjust_object_to_move (this_proj, asearch, 1, i);
-        }
-      }
       k = (asearch -> todo[i] == 1 || asearch -> todo[i] == 3) ? 1 : 0;
       l = (asearch -> todo[i] == 2 || asearch -> todo[i] == 3) ? 1 : 0;
       if (this_proj -> modelgl -> atom_win -> msd[i] > 0.0)
@@ -688,17 +824,6 @@ void append_to_model (GtkTreeIter * atom_level, atom_search * asearch, gboolean
       g_free (str);
       break;
     default:
-      if (asearch -> set_for_all > 0)
-      {
-        asearch -> todo[i] = asearch -> set_for_all;
-        if (asearch -> action == DISPL)
-        {
-          if (aobj)
-          {
-            adjust_object_to_move (this_proj, asearch, 0, i);
-          }
-        }
-      }
       gtk_tree_store_set (asearch -> atom_model, atom_level, TOPIC, asearch -> todo[i], -1);
       if (asearch -> action == REPLACE)
       {
@@ -893,7 +1018,8 @@ gchar * get_node_name (int node, atom_search * asearch, project * this_proj)
 void fill_atom_model (atom_search * asearch, project * this_proj)
 {
   GtkTreeIter spec_level, atom_level;
-  int g, h, i, j, k, l, m, n;
+  int g, h, i, j, k, m, n, o;
+  int * node_start, * node_atoms;
   gchar * str;
   gboolean do_append;
   gboolean doit;
@@ -929,6 +1055,7 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
         }
       }
       int val = get_asearch_num_objects (asearch);
+      node_atoms = sort_atoms_by_node (this_proj, filter, step, val, & node_start);
       to_insert = allocbool(val);
       n = 0;
       if (asearch -> action == REPLACE)
@@ -944,8 +1071,9 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
             doit = TRUE;
             if (! asearch -> spec || asearch -> spec == h+1)
             {
-              for (i=0; i<this_proj -> natomes; i++)
+              for (m=node_start[h]; m<node_start[h+1]; m++)
               {
+                i = node_atoms[m];
                 j = this_proj -> atoms[0][i].sp;
                 if (j == h)
                 {
@@ -970,8 +1098,9 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
           for (h=0; h<val; h++)
           {
             doit = TRUE;
-            for (i=0; i<this_proj -> natomes; i++)
+            for (m=node_start[h]; m<node_start[h+1]; m++)
             {
+              i = node_atoms[m];
               if (this_proj -> atoms[0][i].numv == h)
               {
                 j = this_proj -> atoms[0][i].sp;
@@ -1004,8 +1133,9 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
             for (h=0; h<val; h++)
             {
               doit = TRUE;
-              for (i=0; i<this_proj -> natomes; i++)
+              for (m=node_start[h]; m<node_start[h+1]; m++)
               {
+                i = node_atoms[m];
                 if (asearch -> spec == 0 || asearch -> spec == this_proj -> atoms[0][i].sp + 1)
                 {
                   j = this_proj -> atoms[step][i].coord[filter - 1];
@@ -1209,35 +1339,24 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
             }
             if (doit && (! obj || (filter > 0 && filter < 3)))
             {
-              for (i=0; i<this_proj -> natomes; i++)
+              // The atom(s) of the node are added to the store when the node is expanded (see 'expand_atom_node'),
+              // until then the node only holds a place holder row
+              do_append = FALSE;
+              for (o=node_start[h]; o<node_start[h+1]; o++)
               {
-                do_append = FALSE;
-                j = this_proj -> atoms[0][i].sp;
-                if (! filter)
-                {
-                  if (j == h && append (asearch, this_proj, i, j)) do_append=TRUE;
-                }
-                else
-                {
-                  k = filter - 1;
-                  l = this_proj -> atoms[step][i].coord[k];
-                  if (filter == 1)
-                  {
-                    m = this_proj -> coord -> geolist[0][j][l];
-                    if (m == h && append (asearch, this_proj, i, j)) do_append=TRUE;
-                  }
-                  else
-                  {
-                    if (filter == 2) for (m=0; m<j; m++) l += this_proj -> coord -> ntg[1][m];
-                    if (l == h && append (asearch, this_proj, i, j)) do_append=TRUE;
-                  }
-                }
-                if (do_append)
+                i = node_atoms[o];
+                if (append (asearch, this_proj, i, this_proj -> atoms[0][i].sp))
                 {
-                  gtk_tree_store_append (asearch -> atom_model, & atom_level, & spec_level);
-                  append_to_model (& atom_level, asearch, is_object, h, i, this_proj);
+                  do_append = TRUE;
+                  if (asearch -> set_for_all < 1) break;
+                  set_todo_for_all (asearch, this_proj, i);
                 }
               }
+              if (do_append)
+              {
+                gtk_tree_store_append (asearch -> atom_model, & atom_level, & spec_level);
+                gtk_tree_store_set (asearch -> atom_model, & atom_level, IDCOL, 0, -1);
+              }
             }
           }
         }
@@ -1245,6 +1364,8 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
         if (asearch -> action == DISPL) check_motion_interactors (this_proj, asearch);
         if (asearch -> action == REPLACE) g_free (picked_names);
       }
+      g_free (node_start);
+      g_free (node_atoms);
       //if (asearch -> passivating)
       check_tree_for_this_search (this_proj, asearch);
     }
@@ -1274,6 +1395,46 @@ void fill_atom_model (atom_search * asearch, project * this_proj)
   if (asearch -> set_for_all > 0) asearch -> set_for_all = -asearch -> set_for_all;
 }
 
+/*!
+  \fn G_MODULE_EXPORT gboolean expand_atom_node (GtkTreeView * tree_view, GtkTreeIter * iter, GtkTreePath * path, gpointer data)
+
+  \brief add the atom(s) of a node of the search tree to the tree store when the node is expanded
+
+  \param tree_view the GtkTreeView sending the signal
+  \param iter the tree iter of the node
+  \param path the path of the node in the tree model
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT gboolean expand_atom_node (GtkTreeView * tree_view, GtkTreeIter * iter, GtkTreePath * path, gpointer data)
+{
+  int h, i;
+  GtkTreeIter child, atom_level;
+  atom_search * asearch = (atom_search *)data;
+  GtkTreeModel * atom_model = GTK_TREE_MODEL(asearch -> atom_model);
+  if (gtk_tree_model_iter_children (atom_model, & child, iter))
+  {
+    if (is_place_holder (atom_model, & child))
+    {
+      project * this_proj = get_project_by_id(asearch -> proj);
+      int filter = get_asearch_filter (asearch);
+      int step = this_proj -> modelgl -> anim -> last -> img -> step;
+      gboolean is_object = get_asearch_is_object (asearch);
+      gtk_tree_model_get (atom_model, iter, IDCOL, & h, -1);
+      h = abs(h) - 1;
+      for (i=0; i<this_proj -> natomes; i++)
+      {
+        if (get_atom_node (this_proj, filter, step, i) == h && append (asearch, this_proj, i, this_proj -> atoms[0][i].sp))
+        {
+          gtk_tree_store_insert_before (asearch -> atom_model, & atom_level, iter, & child);
+          append_to_model (& atom_level, asearch, is_object, h, i, this_proj);
+        }
+      }
+      gtk_tree_store_remove (asearch -> atom_model, & child);
+    }
+  }
+  return FALSE;
+}
+
 G_MODULE_EXPORT void move_up_down (GtkTreeModel * tree_model, GtkTreePath * path, gpointer data);
 void add_random_column (atom_search * asearch);
 
@@ -2707,7 +2868,7 @@ void search_set_visible (GtkTreeViewColumn * col, GtkCellRenderer * renderer, Gt
   i = GPOINTER_TO_INT(data);
   i ++;
   gtk_tree_model_get (mod, iter, IDCOL, & j, -1);
-  gboolean vis = (j < 0 && i == 2) ? FALSE : TRUE;
+  gboolean vis = (! j || (j < 0 && i == 2)) ? FALSE : TRUE;
   gtk_cell_renderer_set_visible (renderer, vis);
   if (vis && (i < TOLAB || i > TOPIC))
   {
@@ -3609,6 +3770,7 @@ GtkWidget * create_atoms_tree (atom_search * asearch, project * this_proj, int n
   else
   {
     asearch -> atom_tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(asearch -> atom_model));
+    g_signal_connect (G_OBJECT(asearch -> atom_tree), "test-expand-row", G_CALLBACK(expand_atom_node), asearch);
   }
 
   for (i=0; i<4+j; i++)
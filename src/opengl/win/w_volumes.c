@@ -39,9 +39,21 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   double molecular_volume (int nats, atom * ats_vol, double baryc[3], double * rvdws, double a_ang, double b_ang, double c_ang);
   double get_atoms_box (project * this_proj, int rid, int sid, int geo, int gid);
 
+  gboolean setup_voxel_grid (voxel_grid * grid, double res);
+  gboolean in_excluded_volume (voxel_grid * grid, int m, gboolean probe);
+
+  gint64 voxel_volumes (project * this_proj, int rid, int sid, int geo, int gid, double * vals, object_3d ** surface);
+
+  int voxel_neighbor (voxel_grid * grid, int i, int j, int k, int axis, int dir);
+
+  void clean_voxel_grid (glwin * view);
+  void clean_voxel_data (glwin * view);
   void clean_volumes_data (glwin * view);
   void adjust_vol_md_step (project * this_proj, int geo);
   void add_frag_mol_vol_data (GtkWidget * vbox, project * this_proj, glwin * view, int geo);
+  void voxel_center (voxel_grid * grid, int i, int j, int k, double pos[3]);
+  void rasterize_sphere (voxel_grid * grid, double pos[3], double rad, unsigned char flag);
+  void update_voxel_results (glwin * view, gint64 nvox, int ngrids, double time);
 
   G_MODULE_EXPORT void molecular_volumes (GtkButton * but, gpointer data);
   G_MODULE_EXPORT void fm_molecular_volumes (GtkButton * but, gpointer data);
@@ -54,11 +66,23 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   G_MODULE_EXPORT void set_md_step_vol (GtkSpinButton * res, gpointer data);
   G_MODULE_EXPORT void update_vol_frag_mol_search (GtkEntry * res, gpointer data);
   G_MODULE_EXPORT void set_angular_precision (GtkComboBox * box, gpointer data);
+  G_MODULE_EXPORT void compute_voxel_volumes (GtkButton * but, gpointer data);
+  G_MODULE_EXPORT void show_voxel_surface (GtkCheckButton * but, gpointer data);
+  G_MODULE_EXPORT void show_voxel_surface (GtkToggleButton * but, gpointer data);
+  G_MODULE_EXPORT void set_voxel_color (GtkColorChooser * colob, gpointer data);
+  G_MODULE_EXPORT void set_voxel_radius (GtkComboBox * box, gpointer data);
+  G_MODULE_EXPORT void set_voxel_param (GtkEntry * res, gpointer data);
   G_MODULE_EXPORT void window_volumes (GtkWidget * widg, gpointer data);
 
   GtkWidget * frag_mol_volume_search (project * this_proj, int g);
   GtkWidget * frag_mol_volume_tab (glwin * view, int geo);
   GtkWidget * vol_model_tab (glwin * view);
+  GtkWidget * voxel_volume_tab (glwin * view);
+
+  object_3d * voxel_surface_mesh (voxel_grid * grid, gboolean probe, ColRGBA col);
+  object_3d * voxel_surface (project * this_proj, int sid);
+
+  voxel_grid * create_voxel_grid (project * this_proj, int rid, int sid, int geo, int gid);
 
 */
 
@@ -69,10 +93,59 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 #include "project.h"
 #include "glview.h"
 #include "atom_edit.h"
+#ifdef OPENMP
+#  include <omp.h>
+#endif
 
 extern void center_this_molecule (glwin * view);
 extern double draw_cuboid (gboolean draw, int SHADID, int shadnum, mat4_t rot, vec3_t cpos, double paral[3][3], ColRGBA col, double slab_alpha);
 
+/*!
+  \fn void clean_voxel_grid (glwin * view)
+
+  \brief free the cached voxel grid of the model, if any
+
+  \param view the target glwin
+*/
+void clean_voxel_grid (glwin * view)
+{
+  if (! view || ! view -> voxel_cache) return;
+  g_free (view -> voxel_cache -> vox);
+  g_free (view -> voxel_cache);
+  view -> voxel_cache = NULL;
+}
+
+/*!
+  \fn void clean_voxel_data (glwin * view)
+
+  \brief free the voxel grid volumes data
+
+  \param view the target glwin
+*/
+void clean_voxel_data (glwin * view)
+{
+  int g, i, j;
+  if (view -> voxel_volume)
+  {
+    for (i=0; i<view -> voxel_dim[0]; i++) g_free (view -> voxel_volume[i]);
+    g_free (view -> voxel_volume);
+    view -> voxel_volume = NULL;
+  }
+  for (g=0; g<2; g++)
+  {
+    if (view -> fm_voxel_volume[g])
+    {
+      for (i=0; i<view -> voxel_dim[0]; i++)
+      {
+        for (j=0; j<view -> voxel_dim[g+1]; j++) g_free (view -> fm_voxel_volume[g][i][j]);
+        g_free (view -> fm_voxel_volume[g][i]);
+      }
+      g_free (view -> fm_voxel_volume[g]);
+      view -> fm_voxel_volume[g] = NULL;
+    }
+  }
+}
+
 /*!
   \fn void clean_volumes_data (glwin * view)
 
@@ -124,6 +197,9 @@ void clean_volumes_data (glwin * view)
       view -> anim -> last -> img -> fm_vol_col[i][j] = NULL;
     }
   }
+  clean_voxel_data (view);
+  clean_voxel_grid (view);
+  view -> show_voxel = FALSE;
   int shaders[1] = {VOLMS};
   re_create_md_shaders (1, shaders, get_project_by_id(view -> proj));
 }
@@ -251,6 +327,519 @@ double get_atoms_volume (project * this_proj, int rid, int sid, int gid, int gci
   return vol;
 }
 
+#define VOXEL_VDW 1
+#define VOXEL_SAS 2
+#define VOXEL_PROBE 4
+
+/*!
+  \fn gboolean setup_voxel_grid (voxel_grid * grid, double res)
+
+  \brief compute the inverse grid matrix, the number of voxels and the voxel volume
+
+  \param grid the target voxel grid
+  \param res the grid spacing
+*/
+gboolean setup_voxel_grid (voxel_grid * grid, double res)
+{
+  int i;
+  double (* v)[3] = grid -> vect;
+  double det = v[0][0]*(v[1][1]*v[2][2]-v[1][2]*v[2][1])
+             - v[0][1]*(v[1][0]*v[2][2]-v[1][2]*v[2][0])
+             + v[0][2]*(v[1][0]*v[2][1]-v[1][1]*v[2][0]);
+  if (fabs(det) < 1e-12) return FALSE;
+  grid -> inv[0][0] = (v[1][1]*v[2][2]-v[1][2]*v[2][1])/det;
+  grid -> inv[0][1] = (v[0][2]*v[2][1]-v[0][1]*v[2][2])/det;
+  grid -> inv[0][2] = (v[0][1]*v[1][2]-v[0][2]*v[1][1])/det;
+  grid -> inv[1][0] = (v[1][2]*v[2][0]-v[1][0]*v[2][2])/det;
+  grid -> inv[1][1] = (v[0][0]*v[2][2]-v[0][2]*v[2][0])/det;
+  grid -> inv[1][2] = (v[0][2]*v[1][0]-v[0][0]*v[1][2])/det;
+  grid -> inv[2][0] = (v[1][0]*v[2][1]-v[1][1]*v[2][0])/det;
+  grid -> inv[2][1] = (v[0][1]*v[2][0]-v[0][0]*v[2][1])/det;
+  grid -> inv[2][2] = (v[0][0]*v[1][1]-v[0][1]*v[1][0])/det;
+  for (i=0; i<3; i++)
+  {
+    grid -> n[i] = max (1, (int)ceil(sqrt(v[i][0]*v[i][0] + v[i][1]*v[i][1] + v[i][2]*v[i][2]) / res));
+  }
+  if ((double)grid -> n[0]*grid -> n[1]*grid -> n[2] > (double)G_MAXINT) return FALSE;
+  grid -> vvol = fabs(det) / ((double)grid -> n[0]*grid -> n[1]*grid -> n[2]);
+  return TRUE;
+}
+
+/*!
+  \fn void voxel_center (voxel_grid * grid, int i, int j, int k, double pos[3])
+
+  \brief cartesian coordinates of the center of a voxel
+
+  \param grid the target voxel grid
+  \param i voxel id along the 1st grid vector
+  \param j voxel id along the 2nd grid vector
+  \param k voxel id along the 3rd grid vector
+  \param pos the coordinates to compute
+*/
+void voxel_center (voxel_grid * grid, int i, int j, int k, double pos[3])
+{
+  int l;
+  double f[3] = {(i+0.5)/grid -> n[0], (j+0.5)/grid -> n[1], (k+0.5)/grid -> n[2]};
+  for (l=0; l<3; l++) pos[l] = grid -> org[l] + f[0]*grid -> vect[0][l] + f[1]*grid -> vect[1][l] + f[2]*grid -> vect[2][l];
+}
+
+/*!
+  \fn int voxel_neighbor (voxel_grid * grid, int i, int j, int k, int axis, int dir)
+
+  \brief id of the neighbor of a voxel, -1 if outside a non periodic grid
+
+  \param grid the target voxel grid
+  \param i voxel id along the 1st grid vector
+  \param j voxel id along the 2nd grid vector
+  \param k voxel id along the 3rd grid vector
+  \param axis the grid vector to move along
+  \param dir the direction, -1 or 1
+*/
+int voxel_neighbor (voxel_grid * grid, int i, int j, int k, int axis, int dir)
+{
+  int id[3] = {i, j, k};
+  id[axis] += dir;
+  if (id[axis] < 0 || id[axis] >= grid -> n[axis])
+  {
+    if (! grid -> pbc) return -1;
+    id[axis] = (id[axis] + grid -> n[axis]) % grid -> n[axis];
+  }
+  return (id[0]*grid -> n[1] + id[1])*grid -> n[2] + id[2];
+}
+
+/*!
+  \fn void rasterize_sphere (voxel_grid * grid, double pos[3], double rad, unsigned char flag)
+
+  \brief flag all voxels whose center is inside a sphere
+
+  \param grid the target voxel grid
+  \param pos the center of the sphere
+  \param rad the radius of the sphere
+  \param flag the flag to set
+*/
+void rasterize_sphere (voxel_grid * grid, double pos[3], double rad, unsigned char flag)
+{
+  int i, j, k, l, m;
+  int lo[3], hi[3], id[3];
+  double f[3], df[3], d, dd, ext;
+  double r2 = rad*rad;
+  for (k=0; k<3; k++)
+  {
+    f[k] = 0.0;
+    for (l=0; l<3; l++) f[k] += (pos[l] - grid -> org[l]) * grid -> inv[l][k];
+    // extent of the sphere, in voxels, along the k grid vector
+    ext = rad * sqrt(grid -> inv[0][k]*grid -> inv[0][k] + grid -> inv[1][k]*grid -> inv[1][k] + grid -> inv[2][k]*grid -> inv[2][k]) * grid -> n[k];
+    lo[k] = (int)floor (f[k]*grid -> n[k] - 0.5 - ext);
+    hi[k] = (int)ceil (f[k]*grid -> n[k] - 0.5 + ext);
+    if (! grid -> pbc)
+    {
+      lo[k] = max (lo[k], 0);
+      hi[k] = min (hi[k], grid -> n[k] - 1);
+    }
+  }
+  for (i=lo[0]; i<=hi[0]; i++)
+  {
+    df[0] = (i+0.5)/grid -> n[0] - f[0];
+    id[0] = (grid -> pbc) ? ((i % grid -> n[0]) + grid -> n[0]) % grid -> n[0] : i;
+    for (j=lo[1]; j<=hi[1]; j++)
+    {
+      df[1] = (j+0.5)/grid -> n[1] - f[1];
+      id[1] = (grid -> pbc) ? ((j % grid -> n[1]) + grid -> n[1]) % grid -> n[1] : j;
+      for (k=lo[2]; k<=hi[2]; k++)
+      {
+        df[2] = (k+0.5)/grid -> n[2] - f[2];
+        dd = 0.0;
+        for (l=0; l<3; l++)
+        {
+          d = df[0]*grid -> vect[0][l] + df[1]*grid -> vect[1][l] + df[2]*grid -> vect[2][l];
+          dd += d*d;
+        }
+        if (dd <= r2)
+        {
+          id[2] = (grid -> pbc) ? ((k % grid -> n[2]) + grid -> n[2]) % grid -> n[2] : k;
+          m = (id[0]*grid -> n[1] + id[1])*grid -> n[2] + id[2];
+#ifdef OPENMP
+          #pragma omp atomic
+#endif
+          grid -> vox[m] |= flag;
+        }
+      }
+    }
+  }
+}
+
+/*!
+  \fn gboolean in_excluded_volume (voxel_grid * grid, int m, gboolean probe)
+
+  \brief is this voxel inside the solvent excluded volume ?
+
+  \param grid the target voxel grid
+  \param m the voxel id
+  \param probe was a solvent probe used
+*/
+gboolean in_excluded_volume (voxel_grid * grid, int m, gboolean probe)
+{
+  if (probe) return (grid -> vox[m] & VOXEL_SAS) && ! (grid -> vox[m] & VOXEL_PROBE);
+  return (grid -> vox[m] & VOXEL_VDW);
+}
+
+/*!
+  \fn object_3d * voxel_surface_mesh (voxel_grid * grid, gboolean probe, ColRGBA col)
+
+  \brief create the triangle mesh of the faces of the solvent excluded volume
+
+  \param grid the target voxel grid
+  \param probe was a solvent probe used
+  \param col the surface color
+*/
+object_3d * voxel_surface_mesh (voxel_grid * grid, gboolean probe, ColRGBA col)
+{
+  int i, j, k, l, m, n, o, p, q;
+  int ax, bx, cx, dir;
+  double cpos[3], norm[3], nl, corner;
+  double edge[3][3];
+  double sa[4] = {-0.5, 0.5, 0.5, -0.5};
+  double sb[4] = {-0.5, -0.5, 0.5, 0.5};
+  int tri[6] = {0, 1, 2, 0, 2, 3};
+  int faces = 0;
+  for (i=0; i<3; i++) for (j=0; j<3; j++) edge[i][j] = grid -> vect[i][j] / grid -> n[i];
+  for (n=0; n<2; n++)
+  {
+    // First pass: count the faces, second pass: store the vertices
+    object_3d * surf = NULL;
+    if (n)
+    {
+      if (! faces) return NULL;
+      surf = g_malloc0(sizeof*surf);
+      surf -> vert_buffer_size = POLY_BUFF_SIZE;
+      surf -> num_vertices = 6*faces;
+      surf -> vertices = allocfloat (surf -> vert_buffer_size*surf -> num_vertices);
+    }
+    o = 0;
+    for (i=0; i<grid -> n[0]; i++)
+    {
+      for (j=0; j<grid -> n[1]; j++)
+      {
+        for (k=0; k<grid -> n[2]; k++)
+        {
+          m = (i*grid -> n[1] + j)*grid -> n[2] + k;
+          if (! in_excluded_volume (grid, m, probe)) continue;
+          for (ax=0; ax<3; ax++)
+          {
+            for (dir=-1; dir<2; dir+=2)
+            {
+              l = voxel_neighbor (grid, i, j, k, ax, dir);
+              if (l > -1 && in_excluded_volume (grid, l, probe)) continue;
+              if (n)
+              {
+                voxel_center (grid, i, j, k, cpos);
+                bx = (ax+1)%3;
+                cx = (ax+2)%3;
+                nl = 0.0;
+                for (p=0; p<3; p++)
+                {
+                  norm[p] = dir * grid -> inv[p][ax];
+                  nl += norm[p]*norm[p];
+                }
+                nl = sqrt(nl);
+                for (p=0; p<6; p++)
+                {
+                  q = o*POLY_BUFF_SIZE;
+                  for (l=0; l<3; l++)
+                  {
+                    corner = cpos[l] + 0.5*dir*edge[ax][l] + sa[tri[p]]*edge[bx][l] + dir*sb[tri[p]]*edge[cx][l];
+                    surf -> vertices[q+l] = corner;
+                    surf -> vertices[q+3+l] = norm[l]/nl;
+                  }
+                  surf -> vertices[q+6] = col.red;
+                  surf -> vertices[q+7] = col.green;
+                  surf -> vertices[q+8] = col.blue;
+                  surf -> vertices[q+9] = col.alpha;
+                  o ++;
+                }
+              }
+              else
+              {
+                faces ++;
+              }
+            }
+          }
+        }
+      }
+    }
+    if (n) return surf;
+  }
+  return NULL;
+}
+
+/*!
+  \fn voxel_grid * create_voxel_grid (project * this_proj, int rid, int sid, int geo, int gid)
+
+  \brief create the voxel grid of all system or fragment or molecule, NULL if it could not be created
+
+  \param this_proj the target project
+  \param rid the type of atomic radius(ii)
+  \param sid the MD step
+  \param geo -1 = all system, 2 = fragment(s), 3 = molecule(s)
+  \param gid fragment or molecule id number
+*/
+voxel_grid * create_voxel_grid (project * this_proj, int rid, int sid, int geo, int gid)
+{
+  int i, j, k, l, m;
+  int nats = 0;
+  double res = this_proj -> modelgl -> voxel_param[0];
+  double probe = this_proj -> modelgl -> voxel_param[1];
+  double rmax = 0.0;
+  double cpos[3], vmin[3], vmax[3];
+  double * rvdws = allocdouble (this_proj -> nspec);
+  double * pos = allocdouble (3*this_proj -> natomes);
+  double * rads = allocdouble (this_proj -> natomes);
+  int bid = (this_proj -> cell.npt) ? sid : 0;
+  atom * ref = NULL;
+  distance dist;
+  voxel_grid * grid = g_malloc0 (sizeof*grid);
+  gint64 nvox;
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+#endif
+
+  for (i=0; i<this_proj -> nspec; i++)
+  {
+    j = (int)this_proj -> chemistry -> chem_prop[CHEM_Z][i];
+    rvdws[i] =  set_radius_ (& j, & rid);
+  }
+  grid -> pbc = (geo < 0 && this_proj -> cell.pbc && this_proj -> cell.has_a_box);
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    if (geo < 0 || this_proj -> atoms[sid][i].coord[geo] == gid)
+    {
+      if (! ref) ref = & this_proj -> atoms[sid][i];
+      if (! grid -> pbc && this_proj -> cell.pbc && this_proj -> cell.has_a_box)
+      {
+        // Fragment or molecule: gather the atoms around the first one
+        dist = distance_3d (& this_proj -> cell, bid, & this_proj -> atoms[sid][i], ref);
+        pos[3*nats] = ref -> x + dist.x;
+        pos[3*nats+1] = ref -> y + dist.y;
+        pos[3*nats+2] = ref -> z + dist.z;
+      }
+      else
+      {
+        pos[3*nats] = this_proj -> atoms[sid][i].x;
+        pos[3*nats+1] = this_proj -> atoms[sid][i].y;
+        pos[3*nats+2] = this_proj -> atoms[sid][i].z;
+      }
+      rads[nats] = rvdws[this_proj -> atoms[sid][i].sp];
+      rmax = max (rmax, rads[nats]);
+      nats ++;
+    }
+  }
+  g_free (rvdws);
+  if (! nats)
+  {
+    g_free (grid);
+    grid = NULL;
+    goto end;
+  }
+
+  for (i=0; i<3; i++) for (j=0; j<3; j++) grid -> vect[i][j] = 0.0;
+  if (grid -> pbc)
+  {
+    for (i=0; i<3; i++)
+    {
+      grid -> org[i] = 0.0;
+      for (j=0; j<3; j++) grid -> vect[i][j] = this_proj -> cell.box[bid].vect[i][j];
+    }
+  }
+  else
+  {
+    for (i=0; i<3; i++)
+    {
+      vmin[i] = vmax[i] = pos[i];
+      for (j=1; j<nats; j++)
+      {
+        vmin[i] = min (vmin[i], pos[3*j+i]);
+        vmax[i] = max (vmax[i], pos[3*j+i]);
+      }
+      // Margin large enough to keep the solvent accessible volume inside the grid
+      grid -> org[i] = vmin[i] - rmax - probe - 2.0*res;
+      grid -> vect[i][i] = vmax[i] - vmin[i] + 2.0*(rmax + probe + 2.0*res);
+    }
+  }
+  if (! setup_voxel_grid (grid, res))
+  {
+    g_free (grid);
+    grid = NULL;
+    goto end;
+  }
+  nvox = (gint64)grid -> n[0]*grid -> n[1]*grid -> n[2];
+  grid -> vox = g_malloc0 (nvox*sizeof*grid -> vox);
+
+  // Van der Waals and solvent accessible volumes
+#ifdef OPENMP
+  #pragma omp parallel for num_threads(numth) private(i) shared(grid,pos,rads,probe)
+#endif
+  for (i=0; i<nats; i++)
+  {
+    rasterize_sphere (grid, & pos[3*i], rads[i], (probe > 0.0) ? VOXEL_VDW : VOXEL_VDW | VOXEL_SAS);
+    if (probe > 0.0) rasterize_sphere (grid, & pos[3*i], rads[i] + probe, VOXEL_SAS);
+  }
+
+  // Volume swept by the probe: probe centers outside the solvent accessible volume,
+  // the probe is rolled from all the centers that touch the solvent accessible surface
+  if (probe > 0.0)
+  {
+    for (m=0; m<nvox; m++) if (! (grid -> vox[m] & VOXEL_SAS)) grid -> vox[m] |= VOXEL_PROBE;
+#ifdef OPENMP
+    #pragma omp parallel for num_threads(numth) private(i,j,k,l,m,cpos) shared(grid,probe)
+#endif
+    for (i=0; i<grid -> n[0]; i++)
+    {
+      for (j=0; j<grid -> n[1]; j++)
+      {
+        for (k=0; k<grid -> n[2]; k++)
+        {
+          m = (i*grid -> n[1] + j)*grid -> n[2] + k;
+          if (grid -> vox[m] & VOXEL_SAS) continue;
+          for (l=0; l<6; l++)
+          {
+            m = voxel_neighbor (grid, i, j, k, l/2, (l%2) ? 1 : -1);
+            if (m > -1 && (grid -> vox[m] & VOXEL_SAS))
+            {
+              voxel_center (grid, i, j, k, cpos);
+              rasterize_sphere (grid, cpos, probe, VOXEL_PROBE);
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+  grid -> sid = sid;
+  grid -> rid = rid;
+  grid -> param[0] = res;
+  grid -> param[1] = probe;
+
+  end:
+  g_free (pos);
+  g_free (rads);
+  return grid;
+}
+
+/*!
+  \fn gint64 voxel_volumes (project * this_proj, int rid, int sid, int geo, int gid, double * vals, object_3d ** surface)
+
+  \brief compute volumes and surface for all system or fragment or molecule using a voxel grid: \n
+         vals[0] = van der Waals volume, \n
+         vals[1] = solvent excluded volume, \n
+         vals[2] = solvent accessible surface, \n
+         vals[3] = free volume (periodic system only), \n
+         vals[4] = porosity, probe occupiable fraction of the box (periodic system only) \n
+         the number of voxels of the grid is returned, 0 if the grid could not be created
+
+  \param this_proj the target project
+  \param rid the type of atomic radius(ii)
+  \param sid the MD step
+  \param geo -1 = all system, 2 = fragment(s), 3 = molecule(s)
+  \param gid fragment or molecule id number
+  \param vals the values to compute
+  \param surface if not NULL, the mesh of the solvent excluded surface to create
+*/
+gint64 voxel_volumes (project * this_proj, int rid, int sid, int geo, int gid, double * vals, object_3d ** surface)
+{
+  int i, j, k, l, m;
+  double probe = this_proj -> modelgl -> voxel_param[1];
+  voxel_grid * grid = this_proj -> modelgl -> voxel_cache;
+  gint64 nvox;
+  gint64 nvdw = 0;
+  gint64 nses = 0;
+  gint64 faces[3] = {0, 0, 0};
+  gint64 fa = 0;
+  gint64 fb = 0;
+  gint64 fc = 0;
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+#endif
+
+  for (i=0; i<VOXEL_DATA; i++) vals[i] = 0.0;
+  // The grid of the model is cached, until the coordinates or the grid parameters change
+  if (geo > -1 || ! grid || grid -> sid != sid || grid -> rid != rid
+   || grid -> param[0] != this_proj -> modelgl -> voxel_param[0] || grid -> param[1] != probe)
+  {
+    grid = create_voxel_grid (this_proj, rid, sid, geo, gid);
+    if (! grid) return 0;
+    if (geo < 0)
+    {
+      clean_voxel_grid (this_proj -> modelgl);
+      this_proj -> modelgl -> voxel_cache = grid;
+    }
+  }
+  nvox = (gint64)grid -> n[0]*grid -> n[1]*grid -> n[2];
+
+  // Volumes, and solvent accessible surface from the voxel faces:
+  // for a randomly oriented surface the voxel faces over-estimate the area by 3/2
+#ifdef OPENMP
+  #pragma omp parallel for num_threads(numth) private(i,j,k,l,m) shared(grid,probe) reduction(+:nvdw,nses,fa,fb,fc)
+#endif
+  for (i=0; i<grid -> n[0]; i++)
+  {
+    for (j=0; j<grid -> n[1]; j++)
+    {
+      for (k=0; k<grid -> n[2]; k++)
+      {
+        m = (i*grid -> n[1] + j)*grid -> n[2] + k;
+        if (grid -> vox[m] & VOXEL_VDW) nvdw ++;
+        if (in_excluded_volume (grid, m, (probe > 0.0))) nses ++;
+        l = voxel_neighbor (grid, i, j, k, 0, 1);
+        if (l > -1 && (grid -> vox[m] & VOXEL_SAS) != (grid -> vox[l] & VOXEL_SAS)) fa ++;
+        l = voxel_neighbor (grid, i, j, k, 1, 1);
+        if (l > -1 && (grid -> vox[m] & VOXEL_SAS) != (grid -> vox[l] & VOXEL_SAS)) fb ++;
+        l = voxel_neighbor (grid, i, j, k, 2, 1);
+        if (l > -1 && (grid -> vox[m] & VOXEL_SAS) != (grid -> vox[l] & VOXEL_SAS)) fc ++;
+      }
+    }
+  }
+  faces[0] = fa;
+  faces[1] = fb;
+  faces[2] = fc;
+  vals[0] = nvdw * grid -> vvol;
+  vals[1] = nses * grid -> vvol;
+  for (i=0; i<3; i++)
+  {
+    // face area = voxel volume / distance between lattice planes
+    vals[2] += faces[i] * grid -> vvol * grid -> n[i] * sqrt(grid -> inv[0][i]*grid -> inv[0][i] + grid -> inv[1][i]*grid -> inv[1][i] + grid -> inv[2][i]*grid -> inv[2][i]);
+  }
+  vals[2] *= 2.0/3.0;
+  if (grid -> pbc)
+  {
+    vals[3] = nvox*grid -> vvol - vals[0];
+    vals[4] = 1.0 - (double)nses/nvox;
+  }
+  if (surface) * surface = voxel_surface_mesh (grid, (probe > 0.0), this_proj -> modelgl -> voxel_col);
+
+  if (grid != this_proj -> modelgl -> voxel_cache)
+  {
+    g_free (grid -> vox);
+    g_free (grid);
+  }
+  return nvox;
+}
+
+/*!
+  \fn object_3d * voxel_surface (project * this_proj, int sid)
+
+  \brief create the solvent excluded surface of the model for the OpenGL rendering
+
+  \param this_proj the target project
+  \param sid the MD step
+*/
+object_3d * voxel_surface (project * this_proj, int sid)
+{
+  double vals[VOXEL_DATA];
+  object_3d * surf = NULL;
+  voxel_volumes (this_proj, this_proj -> modelgl -> voxel_radius, sid, -1, 0, vals, & surf);
+  return surf;
+}
+
 double vamin[3], vamax[3];
 
 /*!
@@ -1112,6 +1701,298 @@ GtkWidget * vol_model_tab (glwin * view)
   return vbox;
 }
 
+/*!
+  \fn void update_voxel_results (glwin * view, gint64 nvox, int ngrids, double time)
+
+  \brief update the voxel grid results label
+
+  \param view the target glwin
+  \param nvox the largest number of voxels of a grid
+  \param ngrids the number of grids computed
+  \param time the computational time, in seconds
+*/
+void update_voxel_results (glwin * view, gint64 nvox, int ngrids, double time)
+{
+  project * this_proj = get_project_by_id (view -> proj);
+  gchar * vox_name[VOXEL_DATA] = {i18n("van der Waals volume"), i18n("Solvent excluded volume"), i18n("Solvent accessible surface"),
+                                  i18n("Free volume"), i18n("Porosity")};
+  gchar * vox_unit[VOXEL_DATA] = {"&#xC5;<sup>3</sup>", "&#xC5;<sup>3</sup>", "&#xC5;<sup>2</sup>", "&#xC5;<sup>3</sup>", "%"};
+  gchar * fmo[2] = {i18n("Fragment"), i18n("Molecule")};
+  gchar * str, * stra;
+  double vals[VOXEL_DATA];
+  int g, i, j, k;
+  int sid = view -> anim -> last -> img -> step;
+  int ndata = (this_proj -> cell.pbc && this_proj -> cell.has_a_box) ? VOXEL_DATA : 3;
+  for (i=0; i<VOXEL_DATA; i++)
+  {
+    vals[i] = 0.0;
+    for (j=0; j<this_proj -> steps; j++) vals[i] += view -> voxel_volume[j][i];
+    vals[i] /= this_proj -> steps;
+  }
+  vals[4] *= 100.0;
+  str = g_strdup_printf (_("<b>Model</b>%s:\n"), (this_proj -> steps > 1) ? _(", average by MD step") : "");
+  for (i=0; i<ndata; i++)
+  {
+    stra = g_strdup_printf ("%s\t%s:\t%15.3f %s\n", str, _(vox_name[i]), vals[i], vox_unit[i]);
+    g_free (str);
+    str = g_strdup_printf ("%s", stra);
+    g_free (stra);
+  }
+  if (view -> atoms_volume[view -> voxel_radius])
+  {
+    vals[0] = 0.0;
+    for (j=0; j<this_proj -> steps; j++) vals[0] += view -> atoms_volume[view -> voxel_radius][j];
+    vals[0] /= this_proj -> steps;
+    stra = g_strdup_printf (_("%s\tPair-wise analytical van der Waals volume:\t%15.3f %s\n"), str, vals[0], vox_unit[0]);
+    g_free (str);
+    str = g_strdup_printf ("%s", stra);
+    g_free (stra);
+  }
+  for (g=0; g<2; g++)
+  {
+    if (view -> fm_voxel_volume[g])
+    {
+      k = min (this_proj -> coord -> totcoord[g+2], 20);
+      stra = g_strdup_printf (_("%s\n<b>%s(s)</b>, MD step %d:\n"), str, _(fmo[g]), sid+1);
+      g_free (str);
+      str = g_strdup_printf ("%s", stra);
+      g_free (stra);
+      for (i=0; i<k; i++)
+      {
+        stra = g_strdup_printf ("%s\tN°%d:\t%12.3f / %12.3f %s - %12.3f %s\n", str, i+1,
+                                view -> fm_voxel_volume[g][sid][i][0], view -> fm_voxel_volume[g][sid][i][1], vox_unit[0],
+                                view -> fm_voxel_volume[g][sid][i][2], vox_unit[2]);
+        g_free (str);
+        str = g_strdup_printf ("%s", stra);
+        g_free (stra);
+      }
+      if (k < this_proj -> coord -> totcoord[g+2])
+      {
+        stra = g_strdup_printf (_("%s\t... %d more\n"), str, this_proj -> coord -> totcoord[g+2] - k);
+        g_free (str);
+        str = g_strdup_printf ("%s", stra);
+        g_free (stra);
+      }
+    }
+  }
+  stra = g_strdup_printf (_("%s\n<b>Cost</b>: %d grid(s) of up to %" G_GINT64_FORMAT " voxels in %.3f s\n"
+                            "<b>Accuracy</b>: the errors on volumes and surface scale with the grid spacing,\n"
+                            "halving the spacing divides the errors by 2 and multiplies the cost by 8"), str, ngrids, nvox, time);
+  g_free (str);
+  gtk_label_set_markup ((GtkLabel *)view -> volume_win -> vox_lab, stra);
+  g_free (stra);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void compute_voxel_volumes (GtkButton * but, gpointer data)
+
+  \brief compute the voxel grid volumes for all MD steps, model and fragment(s) / molecule(s)
+
+  \param but the GtkButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void compute_voxel_volumes (GtkButton * but, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  project * this_proj = get_project_by_id (view -> proj);
+  int g, i, j, k, l;
+  int ngrids = 0;
+  gint64 nvox, vmax = 0;
+  gint64 t_start = g_get_monotonic_time ();
+  clean_voxel_data (view);
+  view -> voxel_dim[0] = this_proj -> steps;
+  view -> voxel_volume = allocddouble (this_proj -> steps, VOXEL_DATA);
+  for (i=0; i<this_proj -> steps; i++)
+  {
+    // The current MD step is computed last, so that its grid is cached for the surface
+    j = (view -> anim -> last -> img -> step + 1 + i) % this_proj -> steps;
+    nvox = voxel_volumes (this_proj, view -> voxel_radius, j, -1, 0, view -> voxel_volume[j], NULL);
+    vmax = max (vmax, nvox);
+    ngrids ++;
+  }
+  for (g=0; g<2; g++)
+  {
+    if (view -> adv_bonding[g] && (! g || view -> fm_voxel_volume[0]))
+    {
+      view -> voxel_dim[g+1] = this_proj -> coord -> totcoord[g+2];
+      view -> fm_voxel_volume[g] = alloctdouble (this_proj -> steps, this_proj -> coord -> totcoord[g+2], VOXEL_DATA);
+      for (i=0; i<this_proj -> steps; i++)
+      {
+        for (j=0; j<this_proj -> coord -> totcoord[g+2]; j++)
+        {
+          if (! g)
+          {
+            nvox = voxel_volumes (this_proj, view -> voxel_radius, i, 2, j, view -> fm_voxel_volume[0][i][j], NULL);
+            vmax = max (vmax, nvox);
+            ngrids ++;
+          }
+          else
+          {
+            // Molecule: average over the fragments of the molecule
+            for (k=0; k<this_proj -> modelfc -> mols[i][j].multiplicity; k++)
+            {
+              l = this_proj -> modelfc -> mols[i][j].fragments[k];
+              view -> fm_voxel_volume[1][i][j][0] += view -> fm_voxel_volume[0][i][l][0];
+              view -> fm_voxel_volume[1][i][j][1] += view -> fm_voxel_volume[0][i][l][1];
+              view -> fm_voxel_volume[1][i][j][2] += view -> fm_voxel_volume[0][i][l][2];
+            }
+            for (k=0; k<3; k++) view -> fm_voxel_volume[1][i][j][k] /= this_proj -> modelfc -> mols[i][j].multiplicity;
+          }
+        }
+      }
+    }
+  }
+  update_voxel_results (view, vmax, ngrids, (g_get_monotonic_time () - t_start) / 1000000.0);
+  widget_set_sensitive (view -> volume_win -> vox_show, TRUE);
+  if (view -> show_voxel)
+  {
+    int shaders[1] = {VOLMS};
+    re_create_md_shaders (1, shaders, this_proj);
+    update (view);
+  }
+}
+
+#ifdef GTK4
+/*!
+  \fn G_MODULE_EXPORT void show_voxel_surface (GtkCheckButton * but, gpointer data)
+
+  \brief toggle show / hide solvent excluded surface callback GTK4
+
+  \param but the GtkCheckButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void show_voxel_surface (GtkCheckButton * but, gpointer data)
+#else
+/*!
+  \fn G_MODULE_EXPORT void show_voxel_surface (GtkToggleButton * but, gpointer data)
+
+  \brief toggle show / hide solvent excluded surface callback GTK3
+
+  \param but the GtkToggleButton sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void show_voxel_surface (GtkToggleButton * but, gpointer data)
+#endif
+{
+  glwin * view = (glwin *)data;
+  view -> show_voxel = button_get_status ((GtkWidget *)but);
+  int shaders[1] = {VOLMS};
+  re_create_md_shaders (1, shaders, get_project_by_id(view -> proj));
+  update (view);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_voxel_color (GtkColorChooser * colob, gpointer data)
+
+  \brief change solvent excluded surface color
+
+  \param colob the GtkColorChooser sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_voxel_color (GtkColorChooser * colob, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  view -> voxel_col = get_button_color (colob);
+  int shaders[1] = {VOLMS};
+  re_create_md_shaders (1, shaders, get_project_by_id(view -> proj));
+  update (view);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_voxel_radius (GtkComboBox * box, gpointer data)
+
+  \brief change the type of atomic radius for the voxel grid
+
+  \param box the GtkComboBox sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_voxel_radius (GtkComboBox * box, gpointer data)
+{
+  glwin * view = (glwin *)data;
+  view -> voxel_radius = combo_get_active ((GtkWidget *)box);
+}
+
+/*!
+  \fn G_MODULE_EXPORT void set_voxel_param (GtkEntry * res, gpointer data)
+
+  \brief set voxel grid spacing or probe radius entry callback
+
+  \param res the GtkEntry sending the signal
+  \param data the associated data pointer
+*/
+G_MODULE_EXPORT void set_voxel_param (GtkEntry * res, gpointer data)
+{
+  tint * dat = (tint *)data;
+  glwin * view = get_project_by_id(dat -> a) -> modelgl;
+  const gchar * m = entry_get_text (res);
+  double v = string_to_double ((gpointer)m);
+  if ((dat -> b == 0 && v > 0.0) || (dat -> b == 1 && v >= 0.0))
+  {
+    view -> voxel_param[dat -> b] = v;
+  }
+  update_entry_double (res, view -> voxel_param[dat -> b]);
+}
+
+/*!
+  \fn GtkWidget * voxel_volume_tab (glwin * view)
+
+  \brief create the 'Voxel grid' volume tab
+
+  \param view the target glwin
+*/
+GtkWidget * voxel_volume_tab (glwin * view)
+{
+  GtkWidget * vbox = create_vbox (BSEP);
+  GtkWidget * hbox;
+  GtkWidget * entry;
+  gchar * vox_param[2] = {i18n("Grid spacing (&#xC5;):"), i18n("Solvent probe radius (&#xC5;):")};
+  int i;
+  if (view -> voxel_param[0] == 0.0)
+  {
+    view -> voxel_param[0] = 0.2;
+    view -> voxel_param[1] = 1.4;
+    view -> voxel_col.red = 0.2;
+    view -> voxel_col.green = 0.6;
+    view -> voxel_col.blue = 1.0;
+    view -> voxel_col.alpha = 0.75;
+  }
+  abox (vbox, _("<u>Volume(s) and surface(s) computed on a voxel grid:</u>"), 5);
+  hbox = create_hbox (BSEP);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_("Atomic radius:"), 200, -1, 0.0, 0.5), FALSE, FALSE, 30);
+  GtkWidget * rad_combo = create_combo ();
+  for (i=0; i<FILLED_STYLES; i++) combo_text_append (rad_combo, _(text_filled[i]));
+  combo_set_active (rad_combo, view -> voxel_radius);
+  g_signal_connect (G_OBJECT (rad_combo), "changed", G_CALLBACK(set_voxel_radius), view);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, rad_combo, FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+  for (i=0; i<2; i++)
+  {
+    hbox = create_hbox (BSEP);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, markup_label (_(vox_param[i]), 200, -1, 0.0, 0.5), FALSE, FALSE, 30);
+    entry = create_entry (G_CALLBACK(set_voxel_param), 100, 15, FALSE, & view -> colorp[i][0]);
+    update_entry_double (GTK_ENTRY(entry), view -> voxel_param[i]);
+    add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, entry, FALSE, FALSE, 0);
+    add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+  }
+  hbox = create_hbox (BSEP);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox,
+                       create_button (_("Compute"), IMG_NONE, NULL, 150, -1, GTK_RELIEF_NORMAL, G_CALLBACK(compute_voxel_volumes), view), FALSE, FALSE, 30);
+  view -> volume_win -> vox_show = create_hbox (BSEP);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, view -> volume_win -> vox_show,
+                       check_button (_("Show/Hide surface"), 150, -1, view -> show_voxel, G_CALLBACK(show_voxel_surface), view), FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, view -> volume_win -> vox_show,
+                       color_button (view -> voxel_col, TRUE, 50, -1, G_CALLBACK(set_voxel_color), view), FALSE, FALSE, 5);
+  widget_set_sensitive (view -> volume_win -> vox_show, (view -> voxel_volume) ? TRUE : FALSE);
+  add_box_child_start (GTK_ORIENTATION_HORIZONTAL, hbox, view -> volume_win -> vox_show, FALSE, FALSE, 0);
+  add_box_child_start (GTK_ORIENTATION_VERTICAL, vbox, hbox, FALSE, FALSE, 5);
+  GtkWidget * scroll = create_scroll (vbox, -1, -1, GTK_SHADOW_NONE);
+  gtk_widget_set_hexpand (scroll, TRUE);
+  gtk_widget_set_vexpand (scroll, TRUE);
+  view -> volume_win -> vox_lab = markup_label ("", -1, -1, 0.0, 0.0);
+  add_container_child (CONTAINER_SCR, scroll, view -> volume_win -> vox_lab);
+  return vbox;
+}
+
 /*!
   \fn G_MODULE_EXPORT void window_volumes (GtkWidget * widg, gpointer data)
 
@@ -1138,6 +2019,7 @@ G_MODULE_EXPORT void window_volumes (GtkWidget * widg, gpointer data)
     gtk_notebook_append_page (GTK_NOTEBOOK(notebook), vol_model_tab (view), gtk_label_new (_("Model")));
     if (view -> adv_bonding[0]) gtk_notebook_append_page (GTK_NOTEBOOK(notebook), frag_mol_volume_tab (view, 2), gtk_label_new (_("Fragment(s)")));
     if (view -> adv_bonding[1]) gtk_notebook_append_page (GTK_NOTEBOOK(notebook), frag_mol_volume_tab (view, 3), gtk_label_new (_("Molecule(s)")));
+    gtk_notebook_append_page (GTK_NOTEBOOK(notebook), voxel_volume_tab (view), gtk_label_new (_("Voxel grid")));
     add_gtk_close_event (view -> volume_win -> win, G_CALLBACK(hide_this_window), NULL);
     show_the_widgets (view -> volume_win -> win);
     int i;
@@ -56,6 +56,9 @@ extern GtkTreeModel * replace_combo_tree (gboolean insert, int proj);
 extern G_MODULE_EXPORT void spin_stop (GtkButton * but, gpointer data);
 extern void clean_animation (project * proj, glwin * view);
 extern void free_glwin_spec_data (project * this_proj, int spec);
+extern void clean_edit_journal (project * this_proj);
+extern void free_atom_grid (atom_grid * grid);
+extern void clean_voxel_data (glwin * view);
 
 /*!
   \fn void update_insert_combos ()
@@ -102,6 +105,16 @@ glwin * free_glwin (project * to_close, glwin * to_clow)
     g_free (to_clow -> color_to_pick);
     to_clow -> color_to_pick = NULL;
   }
+  if (to_clow -> pick_to_object != NULL)
+  {
+    g_free (to_clow -> pick_to_object);
+    to_clow -> pick_to_object = NULL;
+  }
+  if (to_clow -> region_path != NULL)
+  {
+    g_free (to_clow -> region_path);
+    to_clow -> region_path = NULL;
+  }
 
 #ifdef GTK3
   for (i=0; i<2; i++)
@@ -188,6 +201,11 @@ glwin * free_glwin (project * to_close, glwin * to_clow)
     to_clow -> volume_win -> win = destroy_this_widget (to_clow -> volume_win -> win);
     g_free (to_clow -> volume_win);
   }
+  if (to_clow -> density_win)
+  {
+    to_clow -> density_win -> win = destroy_this_widget (to_clow -> density_win -> win);
+    g_free (to_clow -> density_win);
+  }
   if (to_clow -> player)
   {
     to_clow -> player -> win = destroy_this_widget (to_clow -> player -> win);
@@ -246,6 +264,12 @@ glwin * free_glwin (project * to_close, glwin * to_clow)
     g_free (to_clow -> n_shaders[i]);
   }
   clean_animation (to_close, to_clow);
+  clean_edit_journal (to_close);
+  free_atom_grid (to_clow -> grid);
+  to_clow -> grid = NULL;
+  clean_voxel_data (to_clow);
+  clean_voxel_grid (to_clow);
+  free_density_maps (to_clow);
   g_free (to_clow);
   return NULL;
 }
@@ -310,6 +334,7 @@ void close_project (project * to_close)
     }
     g_free (to_close -> atoms);
   }
+  if (to_close -> dynamics) g_free (to_close -> dynamics);
   if (to_close -> cell.box) g_free (to_close -> cell.box);
   if (to_close -> cell.sp_group) g_free (to_close -> cell.sp_group);
 
@@ -115,6 +115,7 @@ void apply_analysis_default_parameters_to_project (project * this_proj)
   }
   if (this_proj -> analysis[MSD]) this_proj -> analysis[MSD] -> num_delta = default_num_delta[7];
   if (this_proj -> analysis[MSD]) this_proj -> analysis[MSD] -> delta = default_delta_t[0];
+  if (this_proj -> analysis[VHF]) this_proj -> analysis[VHF] -> num_delta = default_num_delta[GDR];
 
   // Other analysis parameters
   for (i=0; i<5; i++)
@@ -134,6 +135,7 @@ void apply_analysis_default_parameters_to_project (project * this_proj)
   this_proj -> skt_n_data_sets = default_skt_n_sets;
   this_proj -> sqw_n_data_sets = default_sqw_n_sets;
   this_proj -> sqw_freq = default_sqw_freq;
+  this_proj -> sqw_window = default_sqw_window;
 }
 
 /*!
@@ -208,6 +210,7 @@ void apply_default_parameters_to_project (project * this_proj, gboolean with_ana
     this_proj -> skt_n_data_sets = default_skt_n_sets;
     this_proj -> sqw_n_data_sets = default_sqw_n_sets;
     this_proj -> sqw_freq = default_sqw_freq;
+    this_proj -> sqw_window = default_sqw_window;
   }
 
   if (this_proj -> modelgl)
@@ -290,6 +293,7 @@ void init_project (gboolean alloc_box)
   // new_proj -> skt_corr_threshold = 10;
   // new_proj -> skt_n_data_sets = 5;
   // new_proj -> sqw_n_data_sets = 5;
+  new_proj -> vhf_stride = 1;
 
   //
   new_proj -> coord = g_malloc0(sizeof*new_proj -> coord);
@@ -66,6 +66,8 @@ extern void init_chain (project * this_proj);
 extern void init_msd (project * this_proj);
 extern void init_sph (project * this_proj, int opening);
 extern void init_skt (project * this_proj, int opening);
+extern void init_fsk (project * this_proj);
+extern void init_vhf (project * this_proj);
 extern void alloc_analysis_curves (int pid, atomes_analysis * this_analysis);
 extern void add_curve_widgets (project * this_proj, int rid);
 
@@ -77,6 +79,7 @@ gboolean version_2_6_and_above;
 gboolean version_2_7_and_above;
 gboolean version_2_8_and_above;
 gboolean version_2_9_and_above;
+gboolean version_3_0_and_above;
 
 /*!
   \fn char * read_string (int i, FILE * fp)
@@ -164,6 +167,12 @@ void initcnames (project * this_proj, int rid)
     case SKT:
       init_skt (this_proj, 1);
       break;
+    case FSK:
+      init_fsk (this_proj);
+      break;
+    case VHF:
+      init_vhf (this_proj);
+      break;
   }
 }
 
@@ -260,7 +269,19 @@ int read_analysis (FILE * fp, project * this_proj, atomes_analysis * this_analys
   if (fread (& this_analysis -> graph_res, sizeof(gboolean), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
   if (this_analysis -> graph_res)
   {
-    if (fread (& this_analysis -> numc, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
+    if (fread (& i, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
+    if (i < 0) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
+    if (i != this_analysis -> numc)
+    {
+      // The number of curves depends on data not stored in the file (ex: MSD with velocities)
+      if (this_analysis -> curves)
+      {
+        for (j=0; j<this_analysis -> numc; j++) g_free (this_analysis -> curves[j]);
+      }
+      this_analysis -> numc = i;
+      // For SPH and SKT the curves are allocated when the names are initialized
+      if (this_analysis -> aid != SPH && this_analysis -> aid != SKT) alloc_analysis_curves (this_proj -> id, this_analysis);
+    }
     if (fread (& i, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
     if (i != this_analysis -> c_sets)
     {
@@ -275,6 +296,7 @@ int read_analysis (FILE * fp, project * this_proj, atomes_analysis * this_analys
       if (! this_analysis -> x_title) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
     }
     if (fread (& i, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
+    if (i < 0 || i > this_analysis -> numc) return signal_error (__FILE__, __func__, __LINE__, ERROR_ANA);
     if (i)
     {
       initcnames (this_proj, this_analysis -> aid);
@@ -322,6 +344,7 @@ int open_project (FILE * fp, int wid)
   version_2_7_and_above = FALSE;
   version_2_8_and_above = FALSE;
   version_2_9_and_above = FALSE;
+  version_3_0_and_above = FALSE;
 
   int calcs_to_read;
 
@@ -348,6 +371,14 @@ int open_project (FILE * fp, int wid)
     version_2_8_and_above = TRUE;
     version_2_9_and_above = TRUE;
   }
+  else if (g_strcmp0(version, "%\n% project file v-3.0\n%\n") == 0)
+  {
+    version_2_6_and_above = TRUE;
+    version_2_7_and_above = TRUE;
+    version_2_8_and_above = TRUE;
+    version_2_9_and_above = TRUE;
+    version_3_0_and_above = TRUE;
+  }
   // End version related tests
 
   // Ensure file compatibility with STEP_LIMIT for atomes version < 1.3.0
@@ -385,6 +416,7 @@ int open_project (FILE * fp, int wid)
   if (version_2_9_and_above)
   {
     if (fread (& calcs_to_read, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    if (calcs_to_read < 0 || calcs_to_read > NCALCS) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
   }
   else
   {
@@ -491,6 +523,22 @@ int open_project (FILE * fp, int wid)
         if (fread (active_project -> sqw_q_id, sizeof(double), active_project -> sqw_n_data_sets, fp) != active_project -> sqw_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
       }
       if (fread (& active_project -> sqw_freq, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+      if (version_3_0_and_above)
+      {
+        if (fread (& active_project -> fsk_n_data_sets, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+        if (active_project -> fsk_n_data_sets)
+        {
+          active_project -> fsk_k_id = allocdouble (active_project -> fsk_n_data_sets);
+          if (fread (active_project -> fsk_k_id, sizeof(double), active_project -> fsk_n_data_sets, fp) != active_project -> fsk_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+        }
+        if (fread (& active_project -> vhf_n_data_sets, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+        if (active_project -> vhf_n_data_sets)
+        {
+          active_project -> vhf_step_id = allocint (active_project -> vhf_n_data_sets);
+          if (fread (active_project -> vhf_step_id, sizeof(int), active_project -> vhf_n_data_sets, fp) != active_project -> vhf_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+        }
+        if (fread (& active_project -> vhf_stride, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+      }
     }
   }
   if (! active_project -> natomes || ! active_project -> nspec)
@@ -96,6 +96,19 @@ extern void opengl_project_changed (int id);
 extern G_MODULE_EXPORT void on_close_activate (GtkWidget * widg, gpointer cdata);
 extern void add_project (GtkTreeStore * store, int i);
 
+/*!< \def XTC_FIRSTIDX
+  \brief first non zero index in the XTC magic integers table
+*/
+#define XTC_FIRSTIDX 9
+/*!< \def XTC_LASTIDX
+  \brief size of the XTC magic integers table
+*/
+#define XTC_LASTIDX 73
+// XTC magic integers table, shared by the XTC reader and writer
+extern const int xtc_magicints[XTC_LASTIDX];
+extern int xtc_size_of_int (int size);
+extern int xtc_size_of_ints (unsigned int sizes[3]);
+
 extern void debugiocurve (project * this_proj, gboolean win, int rid, int cid, gchar * iost);
 extern void debugioproj (project * this_proj, gchar * iost);
 #endif
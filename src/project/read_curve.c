@@ -85,6 +85,9 @@ int read_project_curve (FILE * fp, int wid, int pid)
   project * this_proj = get_project_by_id (pid);
   if (fread (& rid, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_CURVE);
   if (fread (& cid, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_CURVE);
+  if (rid < 0 || rid >= NCALCS) return signal_error (__FILE__, __func__, __LINE__, ERROR_CURVE);
+  if (! this_proj -> analysis[rid]) return signal_error (__FILE__, __func__, __LINE__, ERROR_CURVE);
+  if (cid < 0 || cid >= this_proj -> analysis[rid] -> numc) return signal_error (__FILE__, __func__, __LINE__, ERROR_CURVE);
   Curve * this_curve = this_proj -> analysis[rid] -> curves[cid];
   if (version_2_9_and_above)
   {
@@ -0,0 +1,1258 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file read_bin.c
+* @short Functions to read binary MD trajectories: CHARMM/NAMD DCD, LAMMPS binary dump and GROMACS XTC
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'read_bin.c'
+*
+* Contains:
+*
+
+ - The functions to read binary MD trajectories: CHARMM/NAMD DCD, LAMMPS binary dump and GROMACS XTC
+
+*
+* List of functions:
+
+  int bin_read_int (bin_cursor * cur);
+  int bin_selected_steps (int nframes);
+  int xtc_size_of_int (int size);
+  int xtc_size_of_ints (unsigned int sizes[3]);
+  int xtc_receive_bits (xtc_bits * bits, int num_of_bits);
+  int bin_file_natomes (gchar * filename, int fti);
+  int open_bin_file (gchar * filename, int fti);
+
+  float bin_read_float (bin_cursor * cur);
+
+  double bin_read_double (bin_cursor * cur);
+
+  gint64 bin_read_int64 (bin_cursor * cur);
+
+  gboolean bin_skip (bin_cursor * cur, guint64 nbytes);
+  gboolean dcd_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only);
+  gboolean dcd_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3]);
+  gboolean lmp_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only);
+  gboolean lmp_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3]);
+  gboolean xtc_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only);
+  gboolean xtc_decompress (bin_cursor * cur, int natoms, int magic, float * pos);
+  gboolean xtc_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3]);
+  gboolean bin_index_frames (bin_cursor * cur, bin_traj * traj, int fti, gboolean first_only);
+
+  guint32 bin_read_uint32 (bin_cursor * cur);
+
+  guint64 bin_read_uint64 (bin_cursor * cur);
+
+  void xtc_receive_ints (xtc_bits * bits, int num_of_bits, unsigned int sizes[3], int nums[3]);
+  void bin_cell_from_parameters (double a, double b, double c, double alpha, double beta, double gamma, double box[3][3]);
+
+*/
+
+#include "global.h"
+#include "glview.h"
+#include "callbacks.h"
+#include "interface.h"
+#include "project.h"
+#include "bind.h"
+#include "readers.h"
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+
+/*! \typedef bin_cursor
+
+  \brief read position in a memory mapped binary file
+*/
+typedef struct bin_cursor bin_cursor;
+struct bin_cursor
+{
+  const guchar * data;      /*!< File content */
+  gsize size;               /*!< File size */
+  gsize pos;                /*!< Current position in the file */
+  gboolean swap;            /*!< Byte order of the file differs from the one of the host */
+  gboolean failed;          /*!< Tried to read past the end of the file */
+};
+
+/*! \typedef bin_traj
+
+  \brief binary trajectory layout, as found when indexing the file
+*/
+typedef struct bin_traj bin_traj;
+struct bin_traj
+{
+  int natomes;              /*!< Number of atom(s) */
+  int nframes;              /*!< Number of frame(s) in the file */
+  gsize * frame;            /*!< Position of each frame in the file */
+  gboolean swap;            /*!< Byte order of the file differs from the one of the host */
+  // The following lines are only used for DCD files:
+  int marker;               /*!< Size of the Fortran record markers, 4 or 8 bytes */
+  gboolean cell;            /*!< Unit cell stored for each frame */
+  gboolean fourd;           /*!< Fourth dimension stored for each frame */
+  // The following lines are only used for LAMMPS binary dump files:
+  int size_one;             /*!< Number of values per atom */
+  int col[4];               /*!< Columns of the atom id, x, y and z, -1 if missing */
+  gboolean scaled;          /*!< Scaled (fractional) coordinates */
+  // The following line is only used for XTC files:
+  int magic;                /*!< XTC magic number, 1995 or 2023 (64 bits data size) */
+};
+
+/*! \typedef xtc_bits
+
+  \brief bit reader for XTC compressed coordinates
+*/
+typedef struct xtc_bits xtc_bits;
+struct xtc_bits
+{
+  const guchar * buf;       /*!< Compressed data */
+  gsize size;               /*!< Size of the compressed data */
+  gsize cnt;                /*!< Next byte to read */
+  unsigned int lastbits;    /*!< Number of bits left in lastbyte */
+  unsigned int lastbyte;    /*!< Bits read but not used yet */
+  gboolean failed;          /*!< Tried to read past the end of the data */
+};
+
+/*!
+  \fn guint32 bin_read_uint32 (bin_cursor * cur)
+
+  \brief read a 32 bits value from a binary file
+
+  \param cur the read position
+*/
+guint32 bin_read_uint32 (bin_cursor * cur)
+{
+  guint32 val = 0;
+  if (cur -> pos + 4 > cur -> size)
+  {
+    cur -> failed = TRUE;
+    return 0;
+  }
+  memcpy (& val, cur -> data + cur -> pos, 4);
+  cur -> pos += 4;
+  return (cur -> swap) ? GUINT32_SWAP_LE_BE (val) : val;
+}
+
+/*!
+  \fn guint64 bin_read_uint64 (bin_cursor * cur)
+
+  \brief read a 64 bits value from a binary file
+
+  \param cur the read position
+*/
+guint64 bin_read_uint64 (bin_cursor * cur)
+{
+  guint64 val = 0;
+  if (cur -> pos + 8 > cur -> size)
+  {
+    cur -> failed = TRUE;
+    return 0;
+  }
+  memcpy (& val, cur -> data + cur -> pos, 8);
+  cur -> pos += 8;
+  return (cur -> swap) ? GUINT64_SWAP_LE_BE (val) : val;
+}
+
+/*!
+  \fn int bin_read_int (bin_cursor * cur)
+
+  \brief read an integer from a binary file
+
+  \param cur the read position
+*/
+int bin_read_int (bin_cursor * cur)
+{
+  return (gint32)bin_read_uint32 (cur);
+}
+
+/*!
+  \fn gint64 bin_read_int64 (bin_cursor * cur)
+
+  \brief read a 64 bits integer from a binary file
+
+  \param cur the read position
+*/
+gint64 bin_read_int64 (bin_cursor * cur)
+{
+  return (gint64)bin_read_uint64 (cur);
+}
+
+/*!
+  \fn float bin_read_float (bin_cursor * cur)
+
+  \brief read a float from a binary file
+
+  \param cur the read position
+*/
+float bin_read_float (bin_cursor * cur)
+{
+  guint32 val = bin_read_uint32 (cur);
+  float res;
+  memcpy (& res, & val, 4);
+  return res;
+}
+
+/*!
+  \fn double bin_read_double (bin_cursor * cur)
+
+  \brief read a double from a binary file
+
+  \param cur the read position
+*/
+double bin_read_double (bin_cursor * cur)
+{
+  guint64 val = bin_read_uint64 (cur);
+  double res;
+  memcpy (& res, & val, 8);
+  return res;
+}
+
+/*!
+  \fn gboolean bin_skip (bin_cursor * cur, guint64 nbytes)
+
+  \brief skip data in a binary file
+
+  \param cur the read position
+  \param nbytes the number of bytes to skip
+*/
+gboolean bin_skip (bin_cursor * cur, guint64 nbytes)
+{
+  if (nbytes > cur -> size - cur -> pos)
+  {
+    cur -> failed = TRUE;
+    return FALSE;
+  }
+  cur -> pos += nbytes;
+  return TRUE;
+}
+
+/*!
+  \fn void bin_cell_from_parameters (double a, double b, double c, double alpha, double beta, double gamma, double box[3][3])
+
+  \brief compute the lattice vectors from the lattice parameters
+
+  \param a a
+  \param b b
+  \param c c
+  \param alpha alpha, in degrees
+  \param beta beta, in degrees
+  \param gamma gamma, in degrees
+  \param box the lattice vectors to compute
+*/
+void bin_cell_from_parameters (double a, double b, double c, double alpha, double beta, double gamma, double box[3][3])
+{
+  double ca = cos(alpha*pi/180.0);
+  double cb = cos(beta*pi/180.0);
+  double cg = cos(gamma*pi/180.0);
+  double sg = sin(gamma*pi/180.0);
+  double cy = (ca - cb*cg)/sg;
+  box[0][0] = a;
+  box[0][1] = box[0][2] = 0.0;
+  box[1][0] = b*cg;
+  box[1][1] = b*sg;
+  box[1][2] = 0.0;
+  box[2][0] = c*cb;
+  box[2][1] = c*cy;
+  box[2][2] = c*sqrt(fabs(1.0 - cb*cb - cy*cy));
+}
+
+/*!
+  \fn int bin_selected_steps (int nframes)
+
+  \brief apply the first / last / stride selection, return the number of MD step(s) to read
+
+  \param nframes the number of frame(s) in the file
+*/
+int bin_selected_steps (int nframes)
+{
+  if (this_reader -> stride < 1) this_reader -> stride = 1;
+  if (this_reader -> first < 1) this_reader -> first = 1;
+  if (this_reader -> last < 1 || this_reader -> last > nframes) this_reader -> last = nframes;
+  if (this_reader -> first > this_reader -> last) return 0;
+  return (this_reader -> last - this_reader -> first) / this_reader -> stride + 1;
+}
+
+/*!
+  \fn gboolean dcd_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+
+  \brief read the header of a DCD file, then locate the frames
+
+  \param cur the read position
+  \param traj the trajectory layout to fill
+  \param first_only only read the header (1/0)
+*/
+gboolean dcd_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+{
+  int i;
+  int icntrl[20];
+  guint64 len;
+  gsize fsize;
+  gboolean swap;
+
+  // Fortran records: the first record is 84 bytes long, this gives the byte order and the marker size
+  if (cur -> size < 8) return FALSE;
+  traj -> marker = 0;
+  for (i=0; i<4; i++)
+  {
+    swap = (i%2) ? TRUE : FALSE;
+    cur -> pos = 0;
+    cur -> swap = swap;
+    // 8 bytes markers first: the lower half of a 8 bytes marker reads like a 4 bytes marker
+    len = (i < 2) ? bin_read_uint64 (cur) : bin_read_uint32 (cur);
+    if (len == 84)
+    {
+      traj -> marker = (i < 2) ? 8 : 4;
+      traj -> swap = swap;
+      break;
+    }
+  }
+  if (! traj -> marker) return FALSE;
+  if (cur -> pos + 84 > cur -> size || memcmp (cur -> data + cur -> pos, "CORD", 4) != 0) return FALSE;
+  cur -> pos += 4;
+  for (i=0; i<20; i++) icntrl[i] = bin_read_int (cur);
+  bin_skip (cur, traj -> marker);
+  // CHARMM format if the version is set
+  traj -> cell = (icntrl[19] && icntrl[10]) ? TRUE : FALSE;
+  traj -> fourd = (icntrl[19] && icntrl[11]) ? TRUE : FALSE;
+  if (icntrl[8])
+  {
+    add_reader_info (_("DCD file with fixed atoms: not supported !\n"), 0);
+    return FALSE;
+  }
+  // Title
+  len = (traj -> marker == 4) ? bin_read_uint32 (cur) : bin_read_uint64 (cur);
+  bin_skip (cur, len + traj -> marker);
+  // Number of atoms
+  len = (traj -> marker == 4) ? bin_read_uint32 (cur) : bin_read_uint64 (cur);
+  if (len != 4) return FALSE;
+  traj -> natomes = bin_read_int (cur);
+  bin_skip (cur, traj -> marker);
+  if (cur -> failed || traj -> natomes < 1) return FALSE;
+  if (first_only) return TRUE;
+
+  // Frames have a fixed size, the number of frames in the header is not always up to date
+  fsize = 3 * (2*traj -> marker + 4*(gsize)traj -> natomes);
+  if (traj -> cell) fsize += 2*traj -> marker + 48;
+  if (traj -> fourd) fsize += 2*traj -> marker + 4*(gsize)traj -> natomes;
+  traj -> nframes = (cur -> size - cur -> pos) / fsize;
+  if (! traj -> nframes) return FALSE;
+  traj -> frame = g_malloc0(traj -> nframes*sizeof*traj -> frame);
+  for (i=0; i<traj -> nframes; i++) traj -> frame[i] = cur -> pos + i*fsize;
+  return TRUE;
+}
+
+/*!
+  \fn gboolean dcd_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+
+  \brief read a frame in a DCD file
+
+  \param cur the read position, at the start of the frame
+  \param traj the trajectory layout
+  \param pos the atomic coordinates to read
+  \param box the lattice vectors to read, if any
+*/
+gboolean dcd_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+{
+  int i, j;
+  double cell[6];
+  guint64 len;
+  if (traj -> cell)
+  {
+    len = (traj -> marker == 4) ? bin_read_uint32 (& cur) : bin_read_uint64 (& cur);
+    if (len != 48) return FALSE;
+    // A, gamma, B, beta, alpha, C
+    for (i=0; i<6; i++) cell[i] = bin_read_double (& cur);
+    bin_skip (& cur, traj -> marker);
+    // Recent CHARMM and NAMD versions store the cosines of the angles
+    if (fabs(cell[1]) <= 1.0 && fabs(cell[3]) <= 1.0 && fabs(cell[4]) <= 1.0)
+    {
+      cell[1] = acos(cell[1])*180.0/pi;
+      cell[3] = acos(cell[3])*180.0/pi;
+      cell[4] = acos(cell[4])*180.0/pi;
+    }
+    bin_cell_from_parameters (cell[0], cell[2], cell[5], cell[4], cell[3], cell[1], box);
+  }
+  for (i=0; i<3; i++)
+  {
+    len = (traj -> marker == 4) ? bin_read_uint32 (& cur) : bin_read_uint64 (& cur);
+    if (len != 4*(guint64)traj -> natomes) return FALSE;
+    for (j=0; j<traj -> natomes; j++) pos[3*j+i] = bin_read_float (& cur);
+    bin_skip (& cur, traj -> marker);
+  }
+  return ! cur.failed;
+}
+
+/*!
+  \fn gboolean lmp_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+
+  \brief read the header of a LAMMPS binary dump file, then locate the frames
+
+  \param cur the read position
+  \param traj the trajectory layout to fill
+  \param first_only only read the first frame header (1/0)
+*/
+gboolean lmp_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+{
+  gint64 val;
+  int i, j, k;
+  int revision;
+  int triclinic;
+  int nchunk;
+  int len;
+  gsize start;
+  gchar * str;
+  gchar ** columns;
+  gchar * xyz[3] = {"x", "y", "z"};
+  GArray * frames = g_array_new (FALSE, FALSE, sizeof (gsize));
+
+  cur -> pos = 0;
+  cur -> swap = traj -> swap = FALSE;
+  traj -> nframes = 0;
+  while (cur -> pos < cur -> size)
+  {
+    start = cur -> pos;
+    revision = 0;
+    val = bin_read_int64 (cur);
+    if (val < 0)
+    {
+      // Magic string, endianness and revision
+      bin_skip (cur, -val);
+      bin_read_int (cur);
+      revision = bin_read_int (cur);
+      val = bin_read_int64 (cur);
+    }
+    val = bin_read_int64 (cur);
+    if (! traj -> nframes)
+    {
+      traj -> natomes = (int)val;
+    }
+    else if (val != traj -> natomes)
+    {
+      str = g_strdup_printf (_("The number of atoms changes at frame %d !\n"), traj -> nframes+1);
+      add_reader_info (str, 0);
+      g_free (str);
+      g_array_free (frames, TRUE);
+      return FALSE;
+    }
+    triclinic = bin_read_int (cur);
+    // Boundaries, then box bounds, then tilt factors
+    bin_skip (cur, 6*4 + 6*8 + ((triclinic) ? 3*8 : 0));
+    traj -> size_one = bin_read_int (cur);
+    if (! traj -> nframes)
+    {
+      // Default 'dump atom' layout, id type xs ys zs, unless the column names are given
+      traj -> col[0] = 0;
+      for (i=1; i<4; i++) traj -> col[i] = i+1;
+      traj -> scaled = TRUE;
+    }
+    if (revision > 1)
+    {
+      // Units, time, and column names
+      len = bin_read_int (cur);
+      if (! traj -> nframes && len > 0 && cur -> pos + len <= cur -> size)
+      {
+        str = g_strndup ((gchar *)cur -> data + cur -> pos, len);
+        if (g_strcmp0 (str, "real") != 0 && g_strcmp0 (str, "metal") != 0)
+        {
+          gchar * info = g_strdup_printf (_("LAMMPS units '%s': coordinates read in Å !\n"), str);
+          add_reader_info (info, 1);
+          g_free (info);
+        }
+        g_free (str);
+      }
+      if (len > 0) bin_skip (cur, len);
+      if (cur -> pos < cur -> size && cur -> data[cur -> pos])
+      {
+        bin_skip (cur, 1 + 8);
+      }
+      else
+      {
+        bin_skip (cur, 1);
+      }
+      len = bin_read_int (cur);
+      if (! traj -> nframes && len > 0 && cur -> pos + len <= cur -> size)
+      {
+        str = g_strndup ((gchar *)cur -> data + cur -> pos, len);
+        columns = g_strsplit_set (str, " \t", -1);
+        g_free (str);
+        for (i=0; i<4; i++) traj -> col[i] = -1;
+        traj -> scaled = FALSE;
+        k = 0;
+        for (i=0; columns[i]; i++)
+        {
+          if (! columns[i][0]) continue;
+          if (g_strcmp0 (columns[i], "id") == 0) traj -> col[0] = k;
+          for (j=0; j<3; j++)
+          {
+            if (traj -> col[j+1] < 0 && columns[i][0] == xyz[j][0] && (! columns[i][1] || g_strcmp0 (& columns[i][1], "u") == 0))
+            {
+              traj -> col[j+1] = k;
+            }
+            else if (traj -> col[j+1] < 0 && columns[i][0] == xyz[j][0] && (g_strcmp0 (& columns[i][1], "s") == 0 || g_strcmp0 (& columns[i][1], "su") == 0))
+            {
+              traj -> col[j+1] = k;
+              traj -> scaled = TRUE;
+            }
+          }
+          k ++;
+        }
+        g_strfreev (columns);
+      }
+      if (len > 0) bin_skip (cur, len);
+    }
+    nchunk = bin_read_int (cur);
+    for (i=0; i<nchunk; i++)
+    {
+      len = bin_read_int (cur);
+      if (len < 0 || ! bin_skip (cur, 8*(guint64)len)) break;
+    }
+    if (cur -> failed) break;
+    g_array_append_val (frames, start);
+    traj -> nframes ++;
+    if (first_only) break;
+  }
+  traj -> frame = (gsize *)g_array_free (frames, FALSE);
+  if (! traj -> nframes || traj -> natomes < 1) return FALSE;
+  for (i=1; i<4; i++)
+  {
+    if (traj -> col[i] < 0 || traj -> col[i] >= traj -> size_one)
+    {
+      add_reader_info (_("LAMMPS binary dump: atomic coordinates not found !\n"), 0);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/*!
+  \fn gboolean lmp_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+
+  \brief read a frame in a LAMMPS binary dump file
+
+  \param cur the read position, at the start of the frame
+  \param traj the trajectory layout
+  \param pos the atomic coordinates to read
+  \param box the lattice vectors to read
+*/
+gboolean lmp_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+{
+  gint64 val;
+  int i, j, k;
+  int revision = 0;
+  int triclinic;
+  int nchunk, nval;
+  int aid;
+  int row = 0;
+  double bound[3][2];
+  double tilt[3] = {0.0, 0.0, 0.0};
+  double lo[3], len[3];
+  double * vals;
+
+  val = bin_read_int64 (& cur);
+  if (val < 0)
+  {
+    bin_skip (& cur, -val);
+    bin_read_int (& cur);
+    revision = bin_read_int (& cur);
+    bin_read_int64 (& cur);
+  }
+  if (bin_read_int64 (& cur) != traj -> natomes) return FALSE;
+  triclinic = bin_read_int (& cur);
+  bin_skip (& cur, 6*4);
+  for (i=0; i<3; i++)
+  {
+    bound[i][0] = bin_read_double (& cur);
+    bound[i][1] = bin_read_double (& cur);
+  }
+  if (triclinic)
+  {
+    // xy, xz, yz
+    for (i=0; i<3; i++) tilt[i] = bin_read_double (& cur);
+  }
+  if (bin_read_int (& cur) != traj -> size_one) return FALSE;
+  if (revision > 1)
+  {
+    nval = bin_read_int (& cur);
+    if (nval > 0) bin_skip (& cur, nval);
+    if (cur.pos < cur.size && cur.data[cur.pos])
+    {
+      bin_skip (& cur, 1 + 8);
+    }
+    else
+    {
+      bin_skip (& cur, 1);
+    }
+    nval = bin_read_int (& cur);
+    if (nval > 0) bin_skip (& cur, nval);
+  }
+  // From the bounding box to the lattice vectors
+  lo[0] = bound[0][0] - min(min(0.0, tilt[0]), min(tilt[1], tilt[0]+tilt[1]));
+  len[0] = bound[0][1] - max(max(0.0, tilt[0]), max(tilt[1], tilt[0]+tilt[1])) - lo[0];
+  lo[1] = bound[1][0] - min(0.0, tilt[2]);
+  len[1] = bound[1][1] - max(0.0, tilt[2]) - lo[1];
+  lo[2] = bound[2][0];
+  len[2] = bound[2][1] - lo[2];
+  box[0][0] = len[0];
+  box[0][1] = box[0][2] = 0.0;
+  box[1][0] = tilt[0];
+  box[1][1] = len[1];
+  box[1][2] = 0.0;
+  box[2][0] = tilt[1];
+  box[2][1] = tilt[2];
+  box[2][2] = len[2];
+
+  vals = g_malloc0(traj -> size_one*sizeof*vals);
+  nchunk = bin_read_int (& cur);
+  for (i=0; i<nchunk; i++)
+  {
+    nval = bin_read_int (& cur) / traj -> size_one;
+    for (j=0; j<nval; j++)
+    {
+      for (k=0; k<traj -> size_one; k++) vals[k] = bin_read_double (& cur);
+      // Atoms are written in any order, the id gives the position
+      if (traj -> col[0] < 0)
+      {
+        aid = row;
+      }
+      else
+      {
+        aid = (vals[traj -> col[0]] >= 1.0 && vals[traj -> col[0]] <= traj -> natomes) ? (int)vals[traj -> col[0]] - 1 : -1;
+      }
+      if (cur.failed || aid < 0 || aid >= traj -> natomes)
+      {
+        g_free (vals);
+        return FALSE;
+      }
+      if (traj -> scaled)
+      {
+        pos[3*aid] = lo[0] + vals[traj -> col[1]]*len[0] + vals[traj -> col[2]]*tilt[0] + vals[traj -> col[3]]*tilt[1];
+        pos[3*aid+1] = lo[1] + vals[traj -> col[2]]*len[1] + vals[traj -> col[3]]*tilt[2];
+        pos[3*aid+2] = lo[2] + vals[traj -> col[3]]*len[2];
+      }
+      else
+      {
+        for (k=0; k<3; k++) pos[3*aid+k] = vals[traj -> col[k+1]];
+      }
+      row ++;
+    }
+  }
+  g_free (vals);
+  return (! cur.failed && row == traj -> natomes);
+}
+
+/*!
+  \fn gboolean xtc_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+
+  \brief read the header of a XTC file, then locate the frames
+
+  \param cur the read position
+  \param traj the trajectory layout to fill
+  \param first_only only read the first frame header (1/0)
+*/
+gboolean xtc_index_frames (bin_cursor * cur, bin_traj * traj, gboolean first_only)
+{
+  int natoms;
+  guint64 nbytes;
+  gsize start;
+  GArray * frames = g_array_new (FALSE, FALSE, sizeof (gsize));
+
+  // XDR: big endian
+  cur -> pos = 0;
+  cur -> swap = traj -> swap = (G_BYTE_ORDER == G_LITTLE_ENDIAN);
+  traj -> nframes = 0;
+  while (cur -> pos + 4 <= cur -> size)
+  {
+    start = cur -> pos;
+    traj -> magic = bin_read_int (cur);
+    if (traj -> magic != 1995 && traj -> magic != 2023) break;
+    natoms = bin_read_int (cur);
+    if (! traj -> nframes)
+    {
+      traj -> natomes = natoms;
+    }
+    else if (natoms != traj -> natomes)
+    {
+      break;
+    }
+    // Step, time, box, then the number of atoms again
+    bin_skip (cur, 4 + 4 + 9*4 + 4);
+    if (natoms <= 9)
+    {
+      bin_skip (cur, 3*4*(guint64)natoms);
+    }
+    else
+    {
+      // Precision, min and max integer coordinates, smallidx, then the compressed data
+      bin_skip (cur, 4 + 6*4 + 4);
+      nbytes = (traj -> magic == 2023) ? bin_read_uint64 (cur) : bin_read_uint32 (cur);
+      bin_skip (cur, (nbytes + 3) / 4 * 4);
+    }
+    if (cur -> failed) break;
+    g_array_append_val (frames, start);
+    traj -> nframes ++;
+    if (first_only) break;
+  }
+  traj -> frame = (gsize *)g_array_free (frames, FALSE);
+  return (traj -> nframes && traj -> natomes > 0);
+}
+
+const int xtc_magicints[XTC_LASTIDX] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+                                        80, 101, 128, 161, 203, 256, 322, 406, 512, 645, 812, 1024, 1290,
+                                        1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003,
+                                        16384, 20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031,
+                                        131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+                                        832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021,
+                                        4194304, 5284491, 6658042, 8388607, 10568983, 13316085, 16777216};
+
+/*!
+  \fn int xtc_size_of_int (int size)
+
+  \brief number of bits required to store an integer up to 'size'
+
+  \param size the largest value
+*/
+int xtc_size_of_int (int size)
+{
+  unsigned int num = 1;
+  int num_of_bits = 0;
+  while (size >= num && num_of_bits < 32)
+  {
+    num_of_bits ++;
+    num <<= 1;
+  }
+  return num_of_bits;
+}
+
+/*!
+  \fn int xtc_size_of_ints (unsigned int sizes[3])
+
+  \brief number of bits required to store 3 integers, up to 'sizes', packed together
+
+  \param sizes the largest values
+*/
+int xtc_size_of_ints (unsigned int sizes[3])
+{
+  int i, num;
+  unsigned int num_of_bytes, num_of_bits, bytes[32], bytecnt, tmp;
+  num_of_bytes = 1;
+  bytes[0] = 1;
+  num_of_bits = 0;
+  for (i=0; i<3; i++)
+  {
+    tmp = 0;
+    for (bytecnt=0; bytecnt<num_of_bytes; bytecnt++)
+    {
+      tmp = bytes[bytecnt] * sizes[i] + tmp;
+      bytes[bytecnt] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    while (tmp != 0)
+    {
+      bytes[bytecnt++] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    num_of_bytes = bytecnt;
+  }
+  num = 1;
+  num_of_bytes --;
+  while (bytes[num_of_bytes] >= num)
+  {
+    num_of_bits ++;
+    num *= 2;
+  }
+  return num_of_bits + num_of_bytes * 8;
+}
+
+/*!
+  \fn int xtc_receive_bits (xtc_bits * bits, int num_of_bits)
+
+  \brief read bits from the XTC compressed data
+
+  \param bits the bit reader
+  \param num_of_bits the number of bits to read
+*/
+int xtc_receive_bits (xtc_bits * bits, int num_of_bits)
+{
+  unsigned int num = 0;
+  unsigned int mask = (num_of_bits < 32) ? (1u << num_of_bits) - 1 : 0xffffffff;
+  while (num_of_bits >= 8)
+  {
+    if (bits -> cnt >= bits -> size)
+    {
+      bits -> failed = TRUE;
+      return 0;
+    }
+    bits -> lastbyte = (bits -> lastbyte << 8) | bits -> buf[bits -> cnt ++];
+    num |= (bits -> lastbyte >> bits -> lastbits) << (num_of_bits - 8);
+    num_of_bits -= 8;
+  }
+  if (num_of_bits > 0)
+  {
+    if (bits -> lastbits < num_of_bits)
+    {
+      if (bits -> cnt >= bits -> size)
+      {
+        bits -> failed = TRUE;
+        return 0;
+      }
+      bits -> lastbits += 8;
+      bits -> lastbyte = (bits -> lastbyte << 8) | bits -> buf[bits -> cnt ++];
+    }
+    bits -> lastbits -= num_of_bits;
+    num |= (bits -> lastbyte >> bits -> lastbits) & ((1u << num_of_bits) - 1);
+  }
+  return (int)(num & mask);
+}
+
+/*!
+  \fn void xtc_receive_ints (xtc_bits * bits, int num_of_bits, unsigned int sizes[3], int nums[3])
+
+  \brief read 3 integers packed together in the XTC compressed data
+
+  \param bits the bit reader
+  \param num_of_bits the number of bits used to store the 3 integers
+  \param sizes the largest values
+  \param nums the integers to read
+*/
+void xtc_receive_ints (xtc_bits * bits, int num_of_bits, unsigned int sizes[3], int nums[3])
+{
+  unsigned int bytes[32];
+  unsigned int p, num;
+  int i, j, num_of_bytes;
+  bytes[0] = bytes[1] = bytes[2] = bytes[3] = 0;
+  num_of_bytes = 0;
+  while (num_of_bits > 8 && num_of_bytes < 31)
+  {
+    bytes[num_of_bytes ++] = xtc_receive_bits (bits, 8);
+    num_of_bits -= 8;
+  }
+  if (num_of_bits > 0) bytes[num_of_bytes ++] = xtc_receive_bits (bits, num_of_bits);
+  for (i=2; i>0; i--)
+  {
+    num = 0;
+    for (j=num_of_bytes-1; j>-1; j--)
+    {
+      num = (num << 8) | bytes[j];
+      p = num / sizes[i];
+      bytes[j] = p;
+      num = num - p * sizes[i];
+    }
+    nums[i] = num;
+  }
+  nums[0] = (int)(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24));
+}
+
+/*!
+  \fn gboolean xtc_decompress (bin_cursor * cur, int natoms, int magic, float * pos)
+
+  \brief decompress the atomic coordinates of a XTC frame
+
+  \param cur the read position, at the precision of the compressed coordinates
+  \param natoms the number of atom(s)
+  \param magic the XTC magic number
+  \param pos the atomic coordinates to read, in nm
+*/
+gboolean xtc_decompress (bin_cursor * cur, int natoms, int magic, float * pos)
+{
+  int i, k, m;
+  int minint[3], maxint[3];
+  int bitsizeint[3];
+  int bitsize;
+  int smallidx, smaller, smallnum;
+  int flag, run, is_smaller, tmp;
+  int thiscoord[3], prevcoord[3];
+  unsigned int sizeint[3], sizesmall[3];
+  guint64 nbytes;
+  float precision;
+  xtc_bits bits;
+
+  precision = bin_read_float (cur);
+  for (k=0; k<3; k++) minint[k] = bin_read_int (cur);
+  for (k=0; k<3; k++) maxint[k] = bin_read_int (cur);
+  if (cur -> failed || precision <= 0.0) return FALSE;
+  for (k=0; k<3; k++)
+  {
+    if (maxint[k] < minint[k] || (gint64)maxint[k] - minint[k] >= G_MAXINT) return FALSE;
+    sizeint[k] = maxint[k] - minint[k] + 1;
+  }
+  // Sizes too large to be multiplied are stored separately
+  if ((sizeint[0] | sizeint[1] | sizeint[2]) > 0xffffff)
+  {
+    for (k=0; k<3; k++) bitsizeint[k] = xtc_size_of_int (sizeint[k]);
+    bitsize = 0;
+  }
+  else
+  {
+    bitsize = xtc_size_of_ints (sizeint);
+  }
+  smallidx = bin_read_int (cur);
+  if (smallidx < XTC_FIRSTIDX || smallidx >= XTC_LASTIDX) return FALSE;
+  smaller = xtc_magicints[max(XTC_FIRSTIDX, smallidx-1)] / 2;
+  smallnum = xtc_magicints[smallidx] / 2;
+  sizesmall[0] = sizesmall[1] = sizesmall[2] = xtc_magicints[smallidx];
+  nbytes = (magic == 2023) ? bin_read_uint64 (cur) : bin_read_uint32 (cur);
+  if (cur -> failed || nbytes > cur -> size - cur -> pos) return FALSE;
+
+  bits.buf = cur -> data + cur -> pos;
+  bits.size = nbytes;
+  bits.cnt = 0;
+  bits.lastbits = 0;
+  bits.lastbyte = 0;
+  bits.failed = FALSE;
+  i = 0;
+  m = 0;
+  run = 0;
+  while (i < natoms)
+  {
+    if (bitsize == 0)
+    {
+      for (k=0; k<3; k++) thiscoord[k] = xtc_receive_bits (& bits, bitsizeint[k]);
+    }
+    else
+    {
+      xtc_receive_ints (& bits, bitsize, sizeint, thiscoord);
+    }
+    i ++;
+    for (k=0; k<3; k++)
+    {
+      if ((unsigned int)thiscoord[k] >= sizeint[k]) return FALSE;
+      thiscoord[k] += minint[k];
+      prevcoord[k] = thiscoord[k];
+    }
+    flag = xtc_receive_bits (& bits, 1);
+    is_smaller = 0;
+    // Without flag the previous run length is used again
+    if (flag == 1)
+    {
+      run = xtc_receive_bits (& bits, 5);
+      is_smaller = run % 3;
+      run -= is_smaller;
+      is_smaller --;
+    }
+    if (run > 0)
+    {
+      if (i + run/3 > natoms) return FALSE;
+      for (k=0; k<run; k+=3)
+      {
+        xtc_receive_ints (& bits, smallidx, sizesmall, thiscoord);
+        i ++;
+        thiscoord[0] += prevcoord[0] - smallnum;
+        thiscoord[1] += prevcoord[1] - smallnum;
+        thiscoord[2] += prevcoord[2] - smallnum;
+        if (k == 0)
+        {
+          // The first two atoms are interchanged, for a better compression of water molecules
+          tmp = thiscoord[0]; thiscoord[0] = prevcoord[0]; prevcoord[0] = tmp;
+          tmp = thiscoord[1]; thiscoord[1] = prevcoord[1]; prevcoord[1] = tmp;
+          tmp = thiscoord[2]; thiscoord[2] = prevcoord[2]; prevcoord[2] = tmp;
+          pos[m ++] = prevcoord[0] / precision;
+          pos[m ++] = prevcoord[1] / precision;
+          pos[m ++] = prevcoord[2] / precision;
+        }
+        else
+        {
+          prevcoord[0] = thiscoord[0];
+          prevcoord[1] = thiscoord[1];
+          prevcoord[2] = thiscoord[2];
+        }
+        pos[m ++] = thiscoord[0] / precision;
+        pos[m ++] = thiscoord[1] / precision;
+        pos[m ++] = thiscoord[2] / precision;
+      }
+    }
+    else
+    {
+      pos[m ++] = thiscoord[0] / precision;
+      pos[m ++] = thiscoord[1] / precision;
+      pos[m ++] = thiscoord[2] / precision;
+    }
+    smallidx += is_smaller;
+    if (smallidx < XTC_FIRSTIDX || smallidx >= XTC_LASTIDX) return FALSE;
+    if (is_smaller < 0)
+    {
+      smallnum = smaller;
+      smaller = (smallidx > XTC_FIRSTIDX) ? xtc_magicints[smallidx - 1] / 2 : 0;
+    }
+    else if (is_smaller > 0)
+    {
+      smaller = smallnum;
+      smallnum = xtc_magicints[smallidx] / 2;
+    }
+    sizesmall[0] = sizesmall[1] = sizesmall[2] = xtc_magicints[smallidx];
+    if (bits.failed) return FALSE;
+  }
+  return TRUE;
+}
+
+/*!
+  \fn gboolean xtc_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+
+  \brief read a frame in a XTC file
+
+  \param cur the read position, at the start of the frame
+  \param traj the trajectory layout
+  \param pos the atomic coordinates to read
+  \param box the lattice vectors to read
+*/
+gboolean xtc_read_frame (bin_cursor cur, bin_traj * traj, float * pos, double box[3][3])
+{
+  int i, j;
+  int magic = bin_read_int (& cur);
+  if (bin_read_int (& cur) != traj -> natomes) return FALSE;
+  // Step and time
+  bin_skip (& cur, 8);
+  // Lengths in nm
+  for (i=0; i<3; i++)
+  {
+    for (j=0; j<3; j++) box[i][j] = 10.0 * bin_read_float (& cur);
+  }
+  if (bin_read_int (& cur) != traj -> natomes) return FALSE;
+  if (traj -> natomes <= 9)
+  {
+    for (i=0; i<3*traj -> natomes; i++) pos[i] = bin_read_float (& cur);
+  }
+  else if (! xtc_decompress (& cur, traj -> natomes, magic, pos))
+  {
+    return FALSE;
+  }
+  for (i=0; i<3*traj -> natomes; i++) pos[i] *= 10.0;
+  return ! cur.failed;
+}
+
+/*!
+  \fn gboolean bin_index_frames (bin_cursor * cur, bin_traj * traj, int fti, gboolean first_only)
+
+  \brief locate the frames in a binary trajectory
+
+  \param cur the read position
+  \param traj the trajectory layout to fill
+  \param fti the type of trajectory: 13 = DCD, 14 = LAMMPS binary dump, 15 = XTC
+  \param first_only only read the first frame header (1/0)
+*/
+gboolean bin_index_frames (bin_cursor * cur, bin_traj * traj, int fti, gboolean first_only)
+{
+  switch (fti)
+  {
+    case 13:
+      return dcd_index_frames (cur, traj, first_only);
+      break;
+    case 14:
+      return lmp_index_frames (cur, traj, first_only);
+      break;
+    case 15:
+      return xtc_index_frames (cur, traj, first_only);
+      break;
+  }
+  return FALSE;
+}
+
+/*!
+  \fn int bin_file_natomes (gchar * filename, int fti)
+
+  \brief read the number of atom(s) in a binary trajectory, 0 if the file cannot be read
+
+  \param filename the file name
+  \param fti the type of trajectory: 13 = DCD, 14 = LAMMPS binary dump, 15 = XTC
+*/
+int bin_file_natomes (gchar * filename, int fti)
+{
+  bin_cursor cur;
+  bin_traj traj;
+  int natomes = 0;
+  GMappedFile * mfile = g_mapped_file_new (filename, FALSE, NULL);
+  if (! mfile) return 0;
+  memset (& cur, 0, sizeof (bin_cursor));
+  memset (& traj, 0, sizeof (bin_traj));
+  cur.data = (const guchar *)g_mapped_file_get_contents (mfile);
+  cur.size = g_mapped_file_get_length (mfile);
+  if (bin_index_frames (& cur, & traj, fti, TRUE)) natomes = traj.natomes;
+  if (traj.frame) g_free (traj.frame);
+  g_mapped_file_unref (mfile);
+  return natomes;
+}
+
+/*!
+  \fn int open_bin_file (gchar * filename, int fti)
+
+  \brief open binary trajectory, reading the selected frames only
+
+  \param filename the file name
+  \param fti the type of trajectory: 13 = DCD, 14 = LAMMPS binary dump, 15 = XTC
+*/
+int open_bin_file (gchar * filename, int fti)
+{
+  int i, j, k, l;
+  int res = 0;
+  gboolean done;
+  gboolean has_box;
+  gchar * str;
+  gchar * ftype[3] = {"dcd", "lmp", "xtc"};
+  float * pos;
+  double box[3][3];
+  bin_cursor cur, fcur;
+  bin_traj traj;
+  GError * error = NULL;
+  GMappedFile * mfile = g_mapped_file_new (filename, FALSE, & error);
+  if (! mfile)
+  {
+    add_reader_info (_("Error - cannot open coordinates file !\n"), 0);
+    g_clear_error (& error);
+    return 1;
+  }
+  memset (& cur, 0, sizeof (bin_cursor));
+  memset (& traj, 0, sizeof (bin_traj));
+  cur.data = (const guchar *)g_mapped_file_get_contents (mfile);
+  cur.size = g_mapped_file_get_length (mfile);
+  if (! bin_index_frames (& cur, & traj, fti, FALSE))
+  {
+    add_reader_info (_("Wrong file format: impossible to locate the MD steps in the file !\n"), 0);
+    res = 2;
+    goto end;
+  }
+  reader_info (ftype[fti-13], _("Number of atoms"), traj.natomes);
+  reader_info (ftype[fti-13], _("Number of frames"), traj.nframes);
+  if (traj.natomes != this_reader -> natomes)
+  {
+    str = g_strdup_printf (_("Wrong number of atoms: %d in the file, %d provided !\n"), traj.natomes, this_reader -> natomes);
+    add_reader_info (str, 0);
+    g_free (str);
+    res = 2;
+    goto end;
+  }
+  this_reader -> steps = bin_selected_steps (traj.nframes);
+  if (! this_reader -> steps)
+  {
+    add_reader_info (_("No MD step selected !\n"), 0);
+    res = 2;
+    goto end;
+  }
+  reader_info (ftype[fti-13], _("Number of steps"), this_reader -> steps);
+  active_project -> steps = this_reader -> steps;
+  active_project -> natomes = this_reader -> natomes;
+  allocatoms (active_project);
+  this_reader -> lattice.box = g_malloc0(this_reader -> steps*sizeof*this_reader -> lattice.box);
+
+  // The frames are located: read the selected ones in parallel
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+  #pragma omp parallel for num_threads(numth) private(i,j,k,l,pos,box,fcur,done) shared(cur,traj,fti,res,active_project,this_reader)
+#endif
+  for (i=0; i<this_reader -> steps; i++)
+  {
+    if (res) continue;
+    pos = g_malloc0(3*this_reader -> natomes*sizeof*pos);
+    for (j=0; j<3; j++) for (k=0; k<3; k++) box[j][k] = 0.0;
+    fcur = cur;
+    fcur.swap = traj.swap;
+    fcur.failed = FALSE;
+    fcur.pos = traj.frame[this_reader -> first - 1 + i*this_reader -> stride];
+    switch (fti)
+    {
+      case 13:
+        done = dcd_read_frame (fcur, & traj, pos, box);
+        break;
+      case 14:
+        done = lmp_read_frame (fcur, & traj, pos, box);
+        break;
+      default:
+        done = xtc_read_frame (fcur, & traj, pos, box);
+        break;
+    }
+    if (! done)
+    {
+      res = 2;
+    }
+    else
+    {
+      for (j=0; j<this_reader -> natomes; j++)
+      {
+        active_project -> atoms[i][j].x = pos[3*j];
+        active_project -> atoms[i][j].y = pos[3*j+1];
+        active_project -> atoms[i][j].z = pos[3*j+2];
+      }
+      for (k=0; k<3; k++)
+      {
+        for (l=0; l<3; l++) this_reader -> lattice.box[i].vect[k][l] = box[k][l];
+      }
+    }
+    g_free (pos);
+  }
+  if (res)
+  {
+    add_reader_info (_("Wrong file format: corrupted MD step(s) in the file !\n"), 0);
+    goto end;
+  }
+
+  // Chemical species, in the order provided by the user
+  i = 0;
+  for (j=0; j<this_reader -> nspec; j++)
+  {
+    for (k=0; k<this_reader -> nsps[j]; k++)
+    {
+      for (l=0; l<active_project -> steps; l++)
+      {
+        active_project -> atoms[l][i].sp = j;
+      }
+      i ++;
+    }
+  }
+
+  // Lattice, if any
+  has_box = FALSE;
+  for (k=0; k<3; k++) if (this_reader -> lattice.box[0].vect[k][k] != 0.0) has_box = TRUE;
+  if (has_box)
+  {
+    this_reader -> lattice.npt = FALSE;
+    for (i=1; i<this_reader -> steps; i++)
+    {
+      for (j=0; j<3; j++)
+      {
+        for (k=0; k<3; k++)
+        {
+          if (this_reader -> lattice.box[i].vect[j][k] != this_reader -> lattice.box[0].vect[j][k]) this_reader -> lattice.npt = TRUE;
+        }
+      }
+      if (this_reader -> lattice.npt) break;
+    }
+    active_cell -> ltype = 2;
+    active_cell -> pbc = 1;
+    active_cell -> npt = this_reader -> lattice.npt;
+    i = (active_cell -> npt) ? this_reader -> steps : 1;
+    if (active_cell -> npt)
+    {
+      g_free (active_cell -> box);
+      active_cell -> box = g_malloc0(i*sizeof*active_cell -> box);
+      active_box = & active_cell -> box[0];
+    }
+    for (j=0; j<i; j++)
+    {
+      for (k=0; k<3; k++)
+      {
+        for (l=0; l<3; l++)
+        {
+          active_cell -> box[j].vect[k][l] = this_reader -> lattice.box[j].vect[k][l];
+        }
+      }
+    }
+    active_cell -> has_a_box = TRUE;
+    active_cell -> crystal = FALSE;
+  }
+
+  end:;
+  if (traj.frame) g_free (traj.frame);
+  g_mapped_file_unref (mfile);
+  return res;
+}
@@ -54,6 +54,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   gboolean cif_get_cell_data (int linec, int conf);
 
   gchar * get_cif_word (gchar * mot);
+  gchar * cif_normalize_tag (gchar * tag, int len);
+  gchar * cif_get_tag_value (gchar * line, gboolean all_ligne);
   gchar * get_atom_label (gchar * line, int lid);
   gchar * get_atom_disorder (gchar * line, int lid);
   gchar * get_string_from_origin (space_group * spg);
@@ -61,6 +63,8 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
   G_MODULE_EXPORT void set_cif_to_insert (GtkComboBox * box, gpointer data);
   void file_get_to_line (int line_id);
+  void cif_free_tag_index ();
+  void cif_build_tag_index (int linec);
   void check_for_to_lab (int ato, gchar * stlab);
 
 */
@@ -87,7 +91,6 @@ extern gchar * wnpos[3];
 extern void get_wyck_char (float val, int ax, int bx);
 extern space_group * duplicate_space_group (space_group * spg);
 extern distance distance_3d (cell_info * cell, int mdstep, atom * at, atom * bt);
-extern void sort (int dim, int * tab);
 
 extern gchar * tmp_pos;
 
@@ -104,6 +107,18 @@ gboolean cif_multiple = FALSE;
 
 gchar ** cif_strings = NULL;
 
+/*! \typedef cif_tag */
+typedef struct cif_tag cif_tag;
+struct cif_tag
+{
+  int line;   /*!< Line id of the tag */
+  int pos;    /*!< Position of the end of the tag on the line */
+};
+
+GHashTable * cif_tag_index = NULL; // Normalized tag -> GArray of cif_tag, in line order
+int * cif_loop_id = NULL;          // For each line, line id after the last 'loop_', or 0
+gchar ** cif_lines = NULL;
+
 gchar * cif_coord_opts[40][2] = {{"b1", "Monoclinic unique axis b, cell choice 1, abc"},    // 0
                                  {"b2", "Monoclinic unique axis b, cell choice 2, abc"},    // 1
                                  {"b3", "Monoclinic unique axis b, cell choice 3, abc"},    // 2
@@ -204,8 +219,9 @@ gchar * cif_coord_opts[40][2] = {{"b1", "Monoclinic unique axis b, cell choice 1
 */
 gchar * get_cif_word (gchar * mot)
 {
-  gchar * word = substitute_string (mot, "\n", NULL);
-  word = substitute_string (word, "\r", NULL);
+  gchar * str = substitute_string (mot, "\n", NULL);
+  gchar * word = substitute_string (str, "\r", NULL);
+  g_free (str);
   return word;
 }
 
@@ -416,11 +432,159 @@ void file_get_to_line (int line_id)
 }
 #endif
 
+/*!
+  \fn void cif_free_tag_index ()
+
+  \brief free the CIF tag index
+*/
+void cif_free_tag_index ()
+{
+  if (cif_tag_index)
+  {
+    g_hash_table_destroy (cif_tag_index);
+    cif_tag_index = NULL;
+  }
+  if (cif_loop_id)
+  {
+    g_free (cif_loop_id);
+    cif_loop_id = NULL;
+  }
+  if (cif_lines)
+  {
+    g_free (cif_lines);
+    cif_lines = NULL;
+  }
+}
+
+/*!
+  \fn gchar * cif_normalize_tag (gchar * tag, int len)
+
+  \brief lower case CIF tag, with '.' (DDLm) replaced by '_'
+
+  \param tag the tag
+  \param len the length of the tag, or -1 if NULL terminated
+*/
+gchar * cif_normalize_tag (gchar * tag, int len)
+{
+  gchar * str = g_ascii_strdown (tag, len);
+  int i;
+  for (i=0; str[i]; i++) if (str[i] == '.') str[i] = '_';
+  return str;
+}
+
+/*!
+  \fn void cif_build_tag_index (int linec)
+
+  \brief tokenize the CIF file once: index the position of all tags, and the loop of each line
+
+  \param linec total number of lines
+*/
+void cif_build_tag_index (int linec)
+{
+  int i, j, k;
+  int loop_id = 0;
+  gboolean first;
+  gchar * the_line;
+  gchar * tag;
+  GArray * tag_pos;
+  cif_tag this_tag;
+
+  cif_free_tag_index ();
+  cif_lines = g_malloc0(linec*sizeof*cif_lines);
+#ifdef OPENMP
+  for (i=0; i<linec; i++) cif_lines[i] = coord_line[i];
+#else
+  line_node * node = head;
+  for (i=0; i<linec && node; i++)
+  {
+    cif_lines[i] = node -> line;
+    node = node -> next;
+  }
+#endif
+  cif_loop_id = allocint (linec);
+  cif_tag_index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_array_unref);
+  for (i=0; i<linec; i++)
+  {
+    the_line = cif_lines[i];
+    j = 0;
+    first = TRUE;
+    while (the_line && the_line[j])
+    {
+      while (the_line[j] == ' ' || the_line[j] == '\t' || the_line[j] == '\r' || the_line[j] == '\n') j ++;
+      if (! the_line[j]) break;
+      k = j;
+      while (the_line[j] && the_line[j] != ' ' && the_line[j] != '\t' && the_line[j] != '\r' && the_line[j] != '\n') j ++;
+      if (first && j-k == 5 && g_ascii_strncasecmp (& the_line[k], "loop_", 5) == 0) loop_id = i+1;
+      if (the_line[k] == '_')
+      {
+        tag = cif_normalize_tag (& the_line[k], j-k);
+        tag_pos = g_hash_table_lookup (cif_tag_index, tag);
+        if (! tag_pos)
+        {
+          tag_pos = g_array_new (FALSE, FALSE, sizeof (cif_tag));
+          g_hash_table_insert (cif_tag_index, tag, tag_pos);
+        }
+        else
+        {
+          g_free (tag);
+        }
+        // Only the first occurrence on a line is considered
+        if (! tag_pos -> len || g_array_index (tag_pos, cif_tag, tag_pos -> len-1).line != i)
+        {
+          this_tag.line = i;
+          this_tag.pos = j;
+          g_array_append_val (tag_pos, this_tag);
+        }
+      }
+      first = FALSE;
+    }
+    cif_loop_id[i] = loop_id;
+  }
+}
+
+/*!
+  \fn gchar * cif_get_tag_value (gchar * line, gboolean all_ligne)
+
+  \brief read the value that follows a tag on a line
+
+  \param line the end of the line, after the tag
+  \param all_ligne read all the remaining words (1/0)
+*/
+gchar * cif_get_tag_value (gchar * line, gboolean all_ligne)
+{
+  gchar * the_line = g_strdup_printf ("%s", line);
+  gchar * saved_line;
+  gchar * the_word = strtok_r (the_line, " ", & saved_line);
+  gchar * value = NULL;
+  GString * mot;
+  if (the_word)
+  {
+    if (all_ligne)
+    {
+      mot = g_string_new (the_word);
+      the_word = strtok_r (NULL, " ", & saved_line);
+      while (the_word)
+      {
+        g_string_append (mot, the_word);
+        the_word = strtok_r (NULL, " ", & saved_line);
+      }
+      value = get_cif_word (mot -> str);
+      g_string_free (mot, TRUE);
+    }
+    else
+    {
+      value = get_cif_word (the_word);
+    }
+  }
+  g_free (the_line);
+  return value;
+}
+
 /*!
   \fn int cif_get_value (gchar * kroot, gchar * keyw, int lstart, int linec, gchar ** cif_word,
                          gboolean rec_val, gboolean all_ligne, gboolean total_num, gboolean record_position, int * line_position)
 
-  \brief read pattern in CIF file
+  \brief read pattern in CIF file, using the tag index
 
   \param kroot string key (first part)
   \param keyw string key (second part)
@@ -437,190 +601,57 @@ int cif_get_value (gchar * kroot, gchar * keyw, int lstart, int lend, gchar ** c
                    gboolean rec_val, gboolean all_ligne, gboolean total_num, gboolean record_position, int * line_position)
 {
   int res = 0;
-  int i;
-  size_t j, k, l, m;
+  guint i;
   gchar * str;
-  gchar * str_w, * str_a, * str_b;
-  gchar * mot;
-  gchar * saved_line;
-  gchar * the_line;
-  gchar * the_word;
-  j = strlen(kroot);
-  k = strlen(keyw);
-  l = j+k+1;
+  gchar * value;
+  cif_tag * this_tag;
+  GArray * tag_pos = NULL;
 
-#ifdef OPENMP
-  int numth = omp_get_max_threads ();
-  #pragma omp parallel for num_threads(numth) private(i,m,the_line,saved_line,the_word,mot,str_a,str_b,str_w) shared(j,k,l,this_reader,coord_line,cif_word,rec_val,all_ligne,kroot,keyw,total_num,record_position,line_position,res)
-  for (i=lstart; i<lend; i++)
+  if (cif_tag_index)
   {
-    the_line = NULL;
-    if (res && ! total_num) goto endi;
-    the_line = g_strdup_printf ("%s", coord_line[i]);
-    the_word = strtok_r (the_line, " ", & saved_line);
-    while (the_word)
-    {
-      str_w = get_cif_word (the_word);
-      str_w = g_ascii_strdown (str_w, strlen(str_w));
-      if (strlen(str_w) == l)
-      {
-        str_a = g_strdup_printf ("%c", str_w[0]);
-        for (m=1; m<j; m++) str_a = g_strdup_printf ("%s%c", str_a, str_w[m]);
-        str_b = g_strdup_printf ("%c", str_w[j+1]);
-        for (m=j+2; m<l; m++) str_b = g_strdup_printf ("%s%c", str_b, str_w[m]);
-        if (g_strcmp0(str_a, kroot) == 0 && g_strcmp0(str_b,keyw) == 0)
-        {
-          the_word = strtok_r (NULL, " ", & saved_line);
-          if (! the_word)
-          {
-            if (rec_val || all_ligne)
-            {
-              str = g_strdup_printf (_("Wrong file format: searching for <b>%s</b> - error at line <b>%d</b> !\n"), keyw, i+1);
-              add_reader_info (str, 0);
-              g_free (str);
-              g_free (str_w);
-              g_free (str_a);
-              g_free (str_b);
-              res = -1;
-              goto endi;
-            }
-          }
-          if (total_num)
-          {
-            #pragma omp critical
-            {
-              if (record_position)
-              {
-                line_position[res] = i + 1;
-              }
-              res ++;
-              if (this_reader -> steps && res == this_reader -> steps) total_num = FALSE;
-            }
-          }
-          else
-          {
-            res = i + 1;
-          }
-          if (all_ligne)
-          {
-            mot = g_strdup_printf ("%s", the_word);
-            the_word = strtok_r (NULL, " ", & saved_line);
-            while (the_word)
-            {
-              mot = g_strdup_printf ("%s%s", mot, the_word);
-              the_word = strtok_r (NULL, " ", & saved_line);
-            }
-            the_word = g_strdup_printf ("%s", mot);
-            g_free (mot);
-          }
-          if (the_word && rec_val)
-          {
-            * cif_word = get_cif_word (the_word);
-          }
-          g_free (str_w);
-          g_free (str_a);
-          g_free (str_b);
-          goto endi;
-        }
-        g_free (str_a);
-        g_free (str_b);
-      }
-      g_free (str_w);
-      the_word = strtok_r (NULL, " ", & saved_line);
-    }
-    endi:;
-    g_free (the_line);
+    str = g_strdup_printf ("%s_%s", kroot, keyw);
+    value = cif_normalize_tag (str, -1);
+    tag_pos = g_hash_table_lookup (cif_tag_index, value);
+    g_free (str);
+    g_free (value);
   }
-
-  if (res < 0) res = 0;
-#else
-  file_get_to_line (lstart);
-  res = 0;
-  i = lstart;
-  while (tail)
+  if (! tag_pos) return 0;
+  for (i=0; i<tag_pos -> len; i++)
   {
-    the_line = g_strdup_printf ("%s", tail -> line);
-    the_word = strtok_r (the_line, " ", & saved_line);
-    while (the_word)
+    this_tag = & g_array_index (tag_pos, cif_tag, i);
+    if (this_tag -> line < lstart) continue;
+    if (this_tag -> line >= lend) break;
+    if (rec_val || all_ligne)
     {
-      str_w = get_cif_word (the_word);
-      str_w = g_ascii_strdown (str_w, strlen(str_w));
-      if (strlen(str_w) == l)
+      value = cif_get_tag_value (& cif_lines[this_tag -> line][this_tag -> pos], all_ligne);
+      if (! value)
       {
-        str_a = g_strdup_printf ("%c", str_w[0]);
-        for (m=1; m<j; m++) str_a = g_strdup_printf ("%s%c", str_a, str_w[m]);
-        str_b = g_strdup_printf ("%c", str_w[j+1]);
-        for (m=j+2; m<l; m++) str_b = g_strdup_printf ("%s%c", str_b, str_w[m]);
-        if (g_strcmp0(str_a, kroot) == 0 && g_strcmp0(str_b,keyw) == 0)
-        {
-          the_word = strtok_r (NULL, " ", & saved_line);
-          if (! the_word)
-          {
-            if (rec_val || all_ligne)
-            {
-              str = g_strdup_printf (_("Wrong file format: searching for <b>%s</b> - error at line <b>%d</b> !\n"), keyw, i+1);
-              add_reader_info (str, 0);
-              g_free (str);
-              g_free (str_w);
-              g_free (str_a);
-              g_free (str_b);
-              g_free (the_line);
-              return 0;
-            }
-          }
-
-          if (all_ligne)
-          {
-            mot = g_strdup_printf ("%s", the_word);
-            the_word = strtok_r (NULL, " ", & saved_line);
-            while (the_word)
-            {
-              mot = g_strdup_printf ("%s%s", mot, the_word);
-              the_word = strtok_r (NULL, " ", & saved_line);
-            }
-            the_word = g_strdup_printf ("%s", mot);
-            g_free (mot);
-          }
-          if (the_word && rec_val)
-          {
-             * cif_word = get_cif_word (the_word);
-          }
-          if (total_num)
-          {
-            if (record_position)
-            {
-              line_position[res] = i + 1;
-            }
-            res ++;
-            if (this_reader -> steps && res == this_reader -> steps)
-            {
-              g_free (str_a);
-              g_free (str_b);
-              g_free (str_w);
-              g_free (the_line);
-              return res;
-            }
-          }
-          else
-          {
-            g_free (str_a);
-            g_free (str_b);
-            g_free (str_w);
-            g_free (the_line);
-            return i + 1;
-          }
-        }
-        g_free (str_a);
-        g_free (str_b);
+        str = g_strdup_printf (_("Wrong file format: searching for <b>%s</b> - error at line <b>%d</b> !\n"), keyw, this_tag -> line+1);
+        add_reader_info (str, 0);
+        g_free (str);
+        return 0;
+      }
+      if (rec_val)
+      {
+        if (* cif_word) g_free (* cif_word);
+        * cif_word = value;
+      }
+      else
+      {
+        g_free (value);
       }
-      g_free (str_w);
-      the_word = strtok_r (NULL, " ", & saved_line);
     }
-    g_free (the_line);
-    tail = tail -> next;
-    i ++;
+    if (total_num)
+    {
+      if (record_position) line_position[res] = this_tag -> line + 1;
+      res ++;
+      if (this_reader -> steps && res == this_reader -> steps) break;
+    }
+    else
+    {
+      return this_tag -> line + 1;
+    }
   }
-#endif
   return res;
 }
 
@@ -692,55 +723,13 @@ int cif_file_get_data_in_loop (int linec, int lid)
 /*!
   \fn int get_loop_line_id (int lid)
 
-  \brief reach a line in the CIF file
+  \brief get the first line of the loop that contains a line, using the tag index
 
   \param lid line to reach
 */
 int get_loop_line_id (int lid)
 {
-  int i;
-  gchar * the_word;
-  gchar * the_line;
-  gchar * saved_line;
-  gchar * str_w;
-#ifdef OPENMP
-  for (i=lid-1; i>-1; i--)
-  {
-    the_line = g_strdup_printf ("%s", coord_line[i]);
-    the_word = strtok_r (the_line, " ", & saved_line);
-    if (the_word)
-    {
-      str_w = g_ascii_strdown (the_word, strlen(the_word));
-      if (g_strcmp0 ("loop_", get_cif_word(str_w)) == 0)
-      {
-        g_free (str_w);
-        return i+1;
-      }
-      g_free (str_w);
-    }
-  }
-#else
-  file_get_to_line (lid);
-  i = lid;
-  while (tail)
-  {
-    the_line = g_strdup_printf ("%s", tail -> line);
-    the_word = strtok_r (the_line, " ", & saved_line);
-    if (the_word)
-    {
-      str_w = g_ascii_strdown (the_word, strlen(the_word));
-      if (g_strcmp0 ("loop_", get_cif_word(str_w)) == 0)
-      {
-        g_free (str_w);
-        return i+1;
-      }
-      g_free (str_w);
-    }
-    i --;
-    tail = tail -> prev;
-  }
-#endif
-  return 0;
+  return (cif_loop_id && lid > 0) ? cif_loop_id[lid-1] : 0;
 }
 
 /*!
@@ -774,7 +763,6 @@ int get_loop_line_for_key (int linec, int conf, gchar * key_a, gchar * key_b)
         g_free (line_numbers);
         return 0;
       }
-      sort (steps, line_numbers);
       lli = line_numbers[conf];
       g_free (line_numbers);
     }
@@ -826,7 +814,6 @@ gchar * cif_retrieve_value (int linec, int conf, gchar * key_a, gchar * key_b, g
         line_numbers = NULL;
         return NULL;
       }
-      sort (steps, line_numbers);
       if (in_loop)
       {
         // Considering that the loop has not more than a thousand keys
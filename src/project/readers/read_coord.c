@@ -59,7 +59,10 @@ extern int open_trj_file (int linec);
 extern int open_vas_file (int linec);
 extern int open_cif_configuration (int linec, int conf);
 extern int open_cif_file (int linec);
+extern void cif_build_tag_index (int linec);
+extern void cif_free_tag_index ();
 extern int open_hist_file (int linec);
+extern int open_bin_file (gchar * filename, int fti);
 extern void allocatoms (project * this_proj);
 extern chemical_data * alloc_chem_data (int spec);
 extern int build_crystal (gboolean visible, project * this_proj, int c_step, gboolean to_wrap, gboolean show_clones, cell_info * cell, GtkWidget * widg);
@@ -274,6 +277,12 @@ void check_for_species (double v, int ato)
 int open_coord_file (gchar * filename, int fti)
 {
   int res = 0;
+  if (fti > 12)
+  {
+    // Binary trajectories are memory mapped, not read line by line
+    res = open_bin_file (filename, fti);
+    goto read_done;
+  }
 #ifdef OPENMP
   struct stat status;
   res = stat (filename, & status);
@@ -369,6 +378,7 @@ int open_coord_file (gchar * filename, int fti)
     {
       if (fti == 11) cif_use_symmetry_positions = TRUE;
       this_reader -> cartesian = FALSE;
+      cif_build_tag_index (i);
       if (fti == 10)
       {
         res = open_cif_file (i);
@@ -380,6 +390,7 @@ int open_coord_file (gchar * filename, int fti)
         cif_multiple = FALSE;
         res = open_cif_configuration (i, 0);
       }
+      cif_free_tag_index ();
     }
     else if (fti == 12)
     {
@@ -393,6 +404,7 @@ int open_coord_file (gchar * filename, int fti)
 #ifndef OPENMP
   if (tail) g_free (tail);
 #endif
+  read_done:;
   if (! res)
   {
     if (fti == 9 && ! this_reader -> cartesian)
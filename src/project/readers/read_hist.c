@@ -34,6 +34,10 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
   int hist_get_content ();
   int open_hist_file (int linec);
 
+  gboolean hist_get_vector (gchar * line, float * vect);
+
+  float * hist_dynamics (int step, int dyn, int at);
+
 */
 
 #include "global.h"
@@ -49,6 +53,42 @@ Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
 
 extern void check_for_species (double v, int ato);
 
+/*!
+  \fn gboolean hist_get_vector (gchar * line, float * vect)
+
+  \brief read a velocity or force vector from a DL-POLY history line, thread safe
+
+  \param line the line to read
+  \param vect the vector to store the data
+*/
+gboolean hist_get_vector (gchar * line, float * vect)
+{
+  int i;
+  gchar * str = line;
+  gchar * end_ptr;
+  for (i=0; i<3; i++)
+  {
+    vect[i] = (float)g_ascii_strtod (str, & end_ptr);
+    if (end_ptr == str) return FALSE;
+    str = end_ptr;
+  }
+  return TRUE;
+}
+
+/*!
+  \fn float * hist_dynamics (int step, int dyn, int at)
+
+  \brief get the position of a velocity or force vector in the project dynamics data
+
+  \param step the MD step
+  \param dyn 0 = velocity, 1 = force
+  \param at the atom
+*/
+float * hist_dynamics (int step, int dyn, int at)
+{
+  return active_project -> dynamics + (((gsize)step*this_reader -> traj + dyn)*this_reader -> natomes + at)*3;
+}
+
 /*!
   \fn int hist_get_data (int linec)
 
@@ -106,6 +146,21 @@ int hist_get_content ()
   active_project -> steps = this_reader -> steps;
   active_project -> natomes = this_reader -> natomes;
   allocatoms (active_project);
+  if (active_project -> dynamics)
+  {
+    g_free (active_project -> dynamics);
+    active_project -> dynamics = NULL;
+  }
+  active_project -> dyn_data = 0;
+  if (this_reader -> traj > 0)
+  {
+    // Velocities, and forces if traj = 2, for each MD step, not stored in the atom data structure
+    active_project -> dynamics = g_try_malloc0 ((gsize)this_reader -> steps*this_reader -> traj*this_reader -> natomes*3*sizeof*active_project -> dynamics);
+    if (! active_project -> dynamics)
+    {
+      add_reader_info (_("Not enough memory to store the velocities and forces, only the positions will be read !"), 1);
+    }
+  }
   this_reader -> z = allocdouble (1);
   this_reader -> nsps = allocint (1);
   this_reader -> lattice.box = g_malloc0(this_reader -> steps*sizeof*this_reader -> lattice.box);
@@ -197,6 +252,18 @@ int hist_get_content ()
             goto enda;
           }
           active_project -> atoms[i][j].z = string_to_double ((gpointer)this_word);
+          if (active_project -> dynamics)
+          {
+            for (l=0; l<this_reader -> traj; l++)
+            {
+              if (! hist_get_vector (coord_line[k+j*(2+this_reader -> traj)+2+l], hist_dynamics (i, l, j)))
+              {
+                format_error (i+1, j+1, lil[0], k+j*(2+this_reader -> traj)+2+l);
+                res = 0;
+                goto enda;
+              }
+            }
+          }
         }
         else
         {
@@ -279,6 +346,18 @@ int hist_get_content ()
             goto ends;
           }
           active_project -> atoms[i][j].z = string_to_double ((gpointer)this_word);
+          if (active_project -> dynamics)
+          {
+            for (l=0; l<this_reader -> traj; l++)
+            {
+              if (! hist_get_vector (coord_line[k+j*(2+this_reader -> traj)+2+l], hist_dynamics (i, l, j)))
+              {
+                format_error (i+1, j+1, lil[0], k+j*(2+this_reader -> traj)+2+l);
+                res = 0;
+                goto ends;
+              }
+            }
+          }
         }
         else
         {
@@ -363,6 +442,21 @@ int hist_get_content ()
           return 0;
         }
         active_project -> atoms[i][j].z = string_to_double ((gpointer)this_word);
+        // Velocities, and forces if traj = 2, follow the positions
+        for (l=0; l<this_reader -> traj; l++)
+        {
+          tmp_line = tail;
+          tail = tail -> next;
+          g_free (tmp_line);
+          if (active_project -> dynamics)
+          {
+            if (! hist_get_vector (tail -> line, hist_dynamics (i, l, j)))
+            {
+              format_error (i+1, j+1, lil[0], k+j*(2+this_reader -> traj)+2+l);
+              return 0;
+            }
+          }
+        }
       }
       else
       {
@@ -404,6 +498,7 @@ int hist_get_content ()
       active_project -> atoms[i][j].sp = active_project -> atoms[0][j].sp;
     }
   }
+  if (active_project -> dynamics) active_project -> dyn_data = this_reader -> traj;
   this_reader -> lattice.npt = FALSE;
   for (i=1; i<this_reader -> steps; i++)
   {
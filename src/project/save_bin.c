@@ -0,0 +1,636 @@
+/* This file is part of the 'atomes' software
+
+'atomes' is free software: you can redistribute it and/or modify it under the terms
+of the GNU Affero General Public License as published by the Free Software Foundation,
+either version 3 of the License, or (at your option) any later version.
+
+'atomes' is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License along with 'atomes'.
+If not, see <https://www.gnu.org/licenses/>
+
+Copyright (C) 2022-2026 by CNRS and University of Strasbourg */
+
+/*!
+* @file save_bin.c
+* @short Functions to export binary MD trajectories: CHARMM/NAMD DCD and GROMACS XTC
+* @author Sébastien Le Roux <sebastien.leroux@ipcms.unistra.fr>
+*/
+
+/*
+* This file: 'save_bin.c'
+*
+* Contains:
+*
+
+ - The functions to export binary MD trajectories: CHARMM/NAMD DCD and GROMACS XTC
+
+*
+* List of functions:
+
+  int xtc_run_diff (int * ipos, int first, int id, int dim);
+  int xtc_encode_frame (GByteArray * frame, float * pos, int natoms, int step, float box[3][3]);
+  int write_bin_file (project * this_proj, gchar * filename, int format, gboolean selection);
+
+  void bin_put_int (GByteArray * frame, int val, gboolean big_endian);
+  void bin_put_float (GByteArray * frame, float val, gboolean big_endian);
+  void bin_put_double (GByteArray * frame, double val);
+  void dcd_put_record (GByteArray * frame, const void * data, int size);
+  void dcd_header (GByteArray * header, int natoms, int nframes, gboolean cell);
+  void dcd_encode_frame (GByteArray * frame, float * pos, int natoms, double box[3][3], gboolean cell);
+  void xtc_send_bits (xtc_writer * bits, int num_of_bits, unsigned int num);
+  void xtc_send_ints (xtc_writer * bits, int num_of_bits, unsigned int sizes[3], unsigned int nums[3]);
+
+*/
+
+#include "global.h"
+#include "project.h"
+#ifdef OPENMP
+#  include <omp.h>
+#endif
+
+extern const gchar * dfi[2];
+
+/*!< \def XTC_PRECISION
+  \brief XTC coordinates precision, 1000 = 0.001 nm
+*/
+#define XTC_PRECISION 1000.0
+
+/*!< \def BIN_CHUNK
+  \brief number of MD steps encoded together per thread, this bounds the memory used by the export
+*/
+#define BIN_CHUNK 16
+
+/*! \typedef xtc_writer
+
+  \brief bit writer for XTC compressed coordinates
+*/
+typedef struct xtc_writer xtc_writer;
+struct xtc_writer
+{
+  GByteArray * buf;         /*!< Compressed data */
+  unsigned int lastbits;    /*!< Number of bits in lastbyte, not written yet */
+  unsigned int lastbyte;    /*!< Bits not written yet */
+};
+
+/*!
+  \fn void bin_put_int (GByteArray * frame, int val, gboolean big_endian)
+
+  \brief append a 32 bits integer to a binary frame
+
+  \param frame the binary frame
+  \param val the value to append
+  \param big_endian use big endian (XDR) byte order (1/0)
+*/
+void bin_put_int (GByteArray * frame, int val, gboolean big_endian)
+{
+  guint32 uval = (big_endian) ? GUINT32_TO_BE ((guint32)val) : (guint32)val;
+  g_byte_array_append (frame, (guint8 *)& uval, 4);
+}
+
+/*!
+  \fn void bin_put_float (GByteArray * frame, float val, gboolean big_endian)
+
+  \brief append a 32 bits float to a binary frame
+
+  \param frame the binary frame
+  \param val the value to append
+  \param big_endian use big endian (XDR) byte order (1/0)
+*/
+void bin_put_float (GByteArray * frame, float val, gboolean big_endian)
+{
+  guint32 uval;
+  memcpy (& uval, & val, 4);
+  bin_put_int (frame, (int)uval, big_endian);
+}
+
+/*!
+  \fn void bin_put_double (GByteArray * frame, double val)
+
+  \brief append a 64 bits float to a binary frame
+
+  \param frame the binary frame
+  \param val the value to append
+*/
+void bin_put_double (GByteArray * frame, double val)
+{
+  g_byte_array_append (frame, (guint8 *)& val, 8);
+}
+
+/*!
+  \fn void dcd_put_record (GByteArray * frame, const void * data, int size)
+
+  \brief append a Fortran record to a DCD frame
+
+  \param frame the binary frame
+  \param data the record data
+  \param size the record size, in bytes
+*/
+void dcd_put_record (GByteArray * frame, const void * data, int size)
+{
+  bin_put_int (frame, size, FALSE);
+  g_byte_array_append (frame, (const guint8 *)data, size);
+  bin_put_int (frame, size, FALSE);
+}
+
+/*!
+  \fn void dcd_header (GByteArray * header, int natoms, int nframes, gboolean cell)
+
+  \brief prepare the header of a DCD file
+
+  \param header the binary header
+  \param natoms the number of atom(s)
+  \param nframes the number of frame(s)
+  \param cell save the unit cell for each frame (1/0)
+*/
+void dcd_header (GByteArray * header, int natoms, int nframes, gboolean cell)
+{
+  int i;
+  gchar title[84];
+  GByteArray * record = g_byte_array_new ();
+  g_byte_array_append (record, (const guint8 *)"CORD", 4);
+  for (i=0; i<20; i++)
+  {
+    switch (i)
+    {
+      case 0:
+        // Number of frames
+        bin_put_int (record, nframes, FALSE);
+        break;
+      case 1:
+      case 2:
+        // First step and saving frequency
+        bin_put_int (record, 1, FALSE);
+        break;
+      case 3:
+        bin_put_int (record, nframes, FALSE);
+        break;
+      case 10:
+        bin_put_int (record, (cell) ? 1 : 0, FALSE);
+        break;
+      case 19:
+        // CHARMM version, required to read the unit cell
+        bin_put_int (record, 24, FALSE);
+        break;
+      default:
+        bin_put_int (record, 0, FALSE);
+        break;
+    }
+  }
+  dcd_put_record (header, record -> data, record -> len);
+  g_byte_array_free (record, TRUE);
+  i = 1;
+  memcpy (title, & i, 4);
+  memset (title + 4, ' ', 80);
+  memcpy (title + 4, "Created by atomes", strlen ("Created by atomes"));
+  dcd_put_record (header, title, 84);
+  dcd_put_record (header, & natoms, 4);
+}
+
+/*!
+  \fn void dcd_encode_frame (GByteArray * frame, float * pos, int natoms, double box[3][3], gboolean cell)
+
+  \brief encode a frame of a DCD file
+
+  \param frame the binary frame
+  \param pos the atomic coordinates
+  \param natoms the number of atom(s)
+  \param box the lattice vectors
+  \param cell save the unit cell (1/0)
+*/
+void dcd_encode_frame (GByteArray * frame, float * pos, int natoms, double box[3][3], gboolean cell)
+{
+  int i, j;
+  double len[3], ang[3];
+  float * coord;
+  if (cell)
+  {
+    for (i=0; i<3; i++) len[i] = sqrt(box[i][0]*box[i][0] + box[i][1]*box[i][1] + box[i][2]*box[i][2]);
+    // alpha = (b,c), beta = (a,c), gamma = (a,b), in degrees
+    for (i=0; i<3; i++)
+    {
+      j = (i+1)%3;
+      int k = (i+2)%3;
+      ang[i] = (len[j] > 0.0 && len[k] > 0.0) ? acos((box[j][0]*box[k][0] + box[j][1]*box[k][1] + box[j][2]*box[k][2])/(len[j]*len[k]))*180.0/pi : 90.0;
+    }
+    bin_put_int (frame, 48, FALSE);
+    bin_put_double (frame, len[0]);
+    bin_put_double (frame, ang[2]);
+    bin_put_double (frame, len[1]);
+    bin_put_double (frame, ang[1]);
+    bin_put_double (frame, ang[0]);
+    bin_put_double (frame, len[2]);
+    bin_put_int (frame, 48, FALSE);
+  }
+  coord = g_malloc0(natoms*sizeof*coord);
+  for (i=0; i<3; i++)
+  {
+    for (j=0; j<natoms; j++) coord[j] = pos[3*j+i];
+    dcd_put_record (frame, coord, 4*natoms);
+  }
+  g_free (coord);
+}
+
+/*!
+  \fn void xtc_send_bits (xtc_writer * bits, int num_of_bits, unsigned int num)
+
+  \brief write bits to the XTC compressed data
+
+  \param bits the bit writer
+  \param num_of_bits the number of bits to write
+  \param num the value to write
+*/
+void xtc_send_bits (xtc_writer * bits, int num_of_bits, unsigned int num)
+{
+  guint8 byte;
+  while (num_of_bits >= 8)
+  {
+    bits -> lastbyte = (bits -> lastbyte << 8) | ((num >> (num_of_bits - 8)) & 0xff);
+    byte = (guint8)(bits -> lastbyte >> bits -> lastbits);
+    g_byte_array_append (bits -> buf, & byte, 1);
+    num_of_bits -= 8;
+  }
+  if (num_of_bits > 0)
+  {
+    bits -> lastbyte = (bits -> lastbyte << num_of_bits) | (num & ((1u << num_of_bits) - 1));
+    bits -> lastbits += num_of_bits;
+    if (bits -> lastbits >= 8)
+    {
+      bits -> lastbits -= 8;
+      byte = (guint8)(bits -> lastbyte >> bits -> lastbits);
+      g_byte_array_append (bits -> buf, & byte, 1);
+    }
+  }
+}
+
+/*!
+  \fn void xtc_send_ints (xtc_writer * bits, int num_of_bits, unsigned int sizes[3], unsigned int nums[3])
+
+  \brief write 3 integers packed together in the XTC compressed data
+
+  \param bits the bit writer
+  \param num_of_bits the number of bits used to store the 3 integers
+  \param sizes the largest values
+  \param nums the integers to write
+*/
+void xtc_send_ints (xtc_writer * bits, int num_of_bits, unsigned int sizes[3], unsigned int nums[3])
+{
+  int i, num_of_bytes, bytecnt;
+  unsigned int bytes[32], tmp;
+  tmp = nums[0];
+  num_of_bytes = 0;
+  do
+  {
+    bytes[num_of_bytes ++] = tmp & 0xff;
+    tmp >>= 8;
+  } while (tmp != 0);
+  for (i=1; i<3; i++)
+  {
+    tmp = nums[i];
+    for (bytecnt=0; bytecnt<num_of_bytes; bytecnt++)
+    {
+      tmp = bytes[bytecnt] * sizes[i] + tmp;
+      bytes[bytecnt] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    while (tmp != 0)
+    {
+      bytes[bytecnt ++] = tmp & 0xff;
+      tmp >>= 8;
+    }
+    num_of_bytes = bytecnt;
+  }
+  if (num_of_bits >= num_of_bytes * 8)
+  {
+    for (i=0; i<num_of_bytes; i++) xtc_send_bits (bits, 8, bytes[i]);
+    for (i=num_of_bits - num_of_bytes * 8; i>0; i-=8) xtc_send_bits (bits, min(i, 8), 0);
+  }
+  else
+  {
+    for (i=0; i<num_of_bytes-1; i++) xtc_send_bits (bits, 8, bytes[i]);
+    xtc_send_bits (bits, num_of_bits - (num_of_bytes - 1) * 8, bytes[i]);
+  }
+}
+
+/*!
+  \fn int xtc_run_diff (int * ipos, int first, int id, int dim)
+
+  \brief difference stored for an atom of a run in the XTC compressed data
+
+  \param ipos the integer coordinates
+  \param first the first atom of the run
+  \param id the position in the run
+  \param dim the dimension
+*/
+int xtc_run_diff (int * ipos, int first, int id, int dim)
+{
+  // The first two atoms are interchanged: the first atom is stored relative to the second,
+  // the third atom relative to the first, then each atom relative to the previous one
+  switch (id)
+  {
+    case 0:
+      return ipos[3*first+dim] - ipos[3*(first+1)+dim];
+      break;
+    case 1:
+      return ipos[3*(first+2)+dim] - ipos[3*first+dim];
+      break;
+    default:
+      return ipos[3*(first+1+id)+dim] - ipos[3*(first+id)+dim];
+      break;
+  }
+}
+
+/*!
+  \fn int xtc_encode_frame (GByteArray * frame, float * pos, int natoms, int step, float box[3][3])
+
+  \brief encode a frame of a XTC file, return 0 if successful
+
+  \param frame the binary frame
+  \param pos the atomic coordinates, in nm
+  \param natoms the number of atom(s)
+  \param step the MD step
+  \param box the lattice vectors, in nm
+*/
+int xtc_encode_frame (GByteArray * frame, float * pos, int natoms, int step, float box[3][3])
+{
+  int i, j, k;
+  int * ipos;
+  int minint[3], maxint[3];
+  int bitsizeint[3];
+  int bitsize, bitsize_max;
+  int smallidx, smaller, smallnum;
+  int run, prevrun, is_smaller;
+  int mindiff, diff;
+  gboolean fit;
+  unsigned int sizeint[3], sizesmall[3], tmp[3];
+  double val;
+  guint8 zero = 0;
+  xtc_writer bits;
+
+  bin_put_int (frame, 1995, TRUE);
+  bin_put_int (frame, natoms, TRUE);
+  bin_put_int (frame, step, TRUE);
+  bin_put_float (frame, (float)step, TRUE);
+  for (i=0; i<3; i++)
+  {
+    for (j=0; j<3; j++) bin_put_float (frame, box[i][j], TRUE);
+  }
+  bin_put_int (frame, natoms, TRUE);
+  if (natoms <= 9)
+  {
+    // Small systems are not compressed
+    for (i=0; i<3*natoms; i++) bin_put_float (frame, pos[i], TRUE);
+    return 0;
+  }
+
+  // Fixed precision: integer coordinates
+  ipos = g_malloc0(3*natoms*sizeof*ipos);
+  for (k=0; k<3; k++)
+  {
+    minint[k] = G_MAXINT;
+    maxint[k] = G_MININT;
+  }
+  for (i=0; i<natoms; i++)
+  {
+    for (k=0; k<3; k++)
+    {
+      val = pos[3*i+k] * XTC_PRECISION;
+      if (fabs(val) > G_MAXINT/2)
+      {
+        g_free (ipos);
+        return 2;
+      }
+      ipos[3*i+k] = (int)((val >= 0.0) ? val + 0.5 : val - 0.5);
+      minint[k] = min(minint[k], ipos[3*i+k]);
+      maxint[k] = max(maxint[k], ipos[3*i+k]);
+    }
+  }
+  for (k=0; k<3; k++) sizeint[k] = maxint[k] - minint[k] + 1;
+  if ((sizeint[0] | sizeint[1] | sizeint[2]) > 0xffffff)
+  {
+    for (k=0; k<3; k++) bitsizeint[k] = xtc_size_of_int (sizeint[k]);
+    bitsize = 0;
+  }
+  else
+  {
+    bitsize = xtc_size_of_ints (sizeint);
+  }
+  bitsize_max = (bitsize) ? bitsize : bitsizeint[0] + bitsizeint[1] + bitsizeint[2];
+  // Initial size of the small differences, from the closest consecutive atoms
+  mindiff = G_MAXINT;
+  for (i=1; i<natoms; i++)
+  {
+    diff = 0;
+    for (k=0; k<3; k++) diff = max(diff, abs(ipos[3*i+k] - ipos[3*(i-1)+k]));
+    mindiff = min(mindiff, diff);
+  }
+  smallidx = XTC_FIRSTIDX;
+  while (smallidx < XTC_LASTIDX-2 && xtc_magicints[smallidx] < 2*mindiff+1) smallidx ++;
+  bin_put_float (frame, XTC_PRECISION, TRUE);
+  for (k=0; k<3; k++) bin_put_int (frame, minint[k], TRUE);
+  for (k=0; k<3; k++) bin_put_int (frame, maxint[k], TRUE);
+  bin_put_int (frame, smallidx, TRUE);
+
+  bits.buf = g_byte_array_new ();
+  bits.lastbits = 0;
+  bits.lastbyte = 0;
+  smaller = xtc_magicints[max(XTC_FIRSTIDX, smallidx-1)] / 2;
+  smallnum = xtc_magicints[smallidx] / 2;
+  prevrun = -1;
+  i = 0;
+  while (i < natoms)
+  {
+    sizesmall[0] = sizesmall[1] = sizesmall[2] = xtc_magicints[smallidx];
+    // Run of atoms close to each other, stored as small differences
+    run = 0;
+    fit = TRUE;
+    while (run < 8 && i+1+run < natoms)
+    {
+      for (k=0; k<3; k++)
+      {
+        diff = xtc_run_diff (ipos, i, run, k);
+        if (abs(diff) >= smallnum) fit = FALSE;
+      }
+      if (! fit) break;
+      run ++;
+    }
+    // Adapt the size of the small differences, for the next atoms:
+    // larger if an atom did not fit, as long as this is cheaper than a full position
+    is_smaller = 0;
+    if (! fit)
+    {
+      if (smallidx+1 < min(XTC_LASTIDX-1, bitsize_max)) is_smaller = 1;
+    }
+    else if (run && smallidx > XTC_FIRSTIDX)
+    {
+      is_smaller = -1;
+      for (j=0; j<run; j++)
+      {
+        for (k=0; k<3; k++)
+        {
+          if (abs(xtc_run_diff (ipos, i, j, k)) >= smaller) is_smaller = 0;
+        }
+      }
+    }
+    j = (run) ? i+1 : i;
+    for (k=0; k<3; k++) tmp[k] = ipos[3*j+k] - minint[k];
+    if (bitsize == 0)
+    {
+      for (k=0; k<3; k++) xtc_send_bits (& bits, bitsizeint[k], tmp[k]);
+    }
+    else
+    {
+      xtc_send_ints (& bits, bitsize, sizeint, tmp);
+    }
+    if (3*run == prevrun && is_smaller == 0)
+    {
+      xtc_send_bits (& bits, 1, 0);
+    }
+    else
+    {
+      xtc_send_bits (& bits, 1, 1);
+      xtc_send_bits (& bits, 5, 3*run + is_smaller + 1);
+    }
+    prevrun = 3*run;
+    for (j=0; j<run; j++)
+    {
+      for (k=0; k<3; k++) tmp[k] = xtc_run_diff (ipos, i, j, k) + smallnum;
+      xtc_send_ints (& bits, smallidx, sizesmall, tmp);
+    }
+    i += (run) ? run + 1 : 1;
+    smallidx += is_smaller;
+    if (is_smaller < 0)
+    {
+      smallnum = smaller;
+      smaller = (smallidx > XTC_FIRSTIDX) ? xtc_magicints[smallidx - 1] / 2 : 0;
+    }
+    else if (is_smaller > 0)
+    {
+      smaller = smallnum;
+      smallnum = xtc_magicints[smallidx] / 2;
+    }
+  }
+  if (bits.lastbits)
+  {
+    bits.lastbyte <<= (8 - bits.lastbits);
+    zero = (guint8)bits.lastbyte;
+    g_byte_array_append (bits.buf, & zero, 1);
+    zero = 0;
+  }
+  bin_put_int (frame, bits.buf -> len, TRUE);
+  g_byte_array_append (frame, bits.buf -> data, bits.buf -> len);
+  for (i=bits.buf -> len; i%4; i++) g_byte_array_append (frame, & zero, 1);
+  g_byte_array_free (bits.buf, TRUE);
+  g_free (ipos);
+  return 0;
+}
+
+/*!
+  \fn int write_bin_file (project * this_proj, gchar * filename, int format, gboolean selection)
+
+  \brief export the MD trajectory in a binary file, return 0 if successful
+
+  \param this_proj the target project
+  \param filename the file name
+  \param format the file format: 0 = DCD, 1 = XTC
+  \param selection only export the selected atom(s) (1/0)
+*/
+int write_bin_file (project * this_proj, gchar * filename, int format, gboolean selection)
+{
+  int i, j, k, l, m, n;
+  int natoms;
+  int nchunk;
+  int res = 0;
+  int * list;
+  float * pos;
+  float fbox[3][3];
+  gboolean cell = (this_proj -> cell.has_a_box && this_proj -> cell.pbc) ? TRUE : FALSE;
+  GByteArray ** frame;
+  FILE * fp;
+
+  list = allocint (this_proj -> natomes);
+  natoms = 0;
+  for (i=0; i<this_proj -> natomes; i++)
+  {
+    if (! selection || this_proj -> atoms[0][i].pick[0]) list[natoms ++] = i;
+  }
+  if (! natoms)
+  {
+    g_free (list);
+    return ERROR_NO_WAY;
+  }
+  fp = fopen (filename, dfi[1]);
+  if (! fp)
+  {
+    g_free (list);
+    return ERROR_RW;
+  }
+  if (format == 0)
+  {
+    frame = g_malloc0(sizeof*frame);
+    frame[0] = g_byte_array_new ();
+    dcd_header (frame[0], natoms, this_proj -> steps, cell);
+    if (fwrite (frame[0] -> data, 1, frame[0] -> len, fp) != frame[0] -> len) res = ERROR_RW;
+    g_byte_array_free (frame[0], TRUE);
+    g_free (frame);
+  }
+
+  // The frames are encoded in parallel, then written in order, chunk by chunk
+#ifdef OPENMP
+  int numth = omp_get_max_threads ();
+#else
+  int numth = 1;
+#endif
+  nchunk = BIN_CHUNK * numth;
+  frame = g_malloc0(nchunk*sizeof*frame);
+  for (i=0; i<this_proj -> steps && ! res; i+=nchunk)
+  {
+    n = min(nchunk, this_proj -> steps - i);
+#ifdef OPENMP
+    #pragma omp parallel for num_threads(numth) private(j,k,l,m,pos,fbox) shared(i,n,natoms,list,cell,format,frame,this_proj,res)
+#endif
+    for (j=0; j<n; j++)
+    {
+      int step = i + j;
+      double dbox[3][3];
+      m = (this_proj -> cell.npt) ? step : 0;
+      for (k=0; k<3; k++)
+      {
+        for (l=0; l<3; l++)
+        {
+          dbox[k][l] = (cell) ? this_proj -> cell.box[m].vect[k][l] : 0.0;
+          fbox[k][l] = dbox[k][l] / 10.0;
+        }
+      }
+      pos = g_malloc0(3*natoms*sizeof*pos);
+      for (k=0; k<natoms; k++)
+      {
+        // XTC lengths are in nm
+        pos[3*k] = this_proj -> atoms[step][list[k]].x / ((format) ? 10.0 : 1.0);
+        pos[3*k+1] = this_proj -> atoms[step][list[k]].y / ((format) ? 10.0 : 1.0);
+        pos[3*k+2] = this_proj -> atoms[step][list[k]].z / ((format) ? 10.0 : 1.0);
+      }
+      frame[j] = g_byte_array_new ();
+      if (format == 0)
+      {
+        dcd_encode_frame (frame[j], pos, natoms, dbox, cell);
+      }
+      else if (xtc_encode_frame (frame[j], pos, natoms, step, fbox))
+      {
+        res = ERROR_COORD;
+      }
+      g_free (pos);
+    }
+    for (j=0; j<n; j++)
+    {
+      if (! res && fwrite (frame[j] -> data, 1, frame[j] -> len, fp) != frame[j] -> len) res = ERROR_RW;
+      g_byte_array_free (frame[j], TRUE);
+    }
+  }
+  g_free (frame);
+  g_free (list);
+  fclose (fp);
+  return res;
+}
@@ -156,8 +156,8 @@ int save_project (FILE * fp, project * this_proj, int wid)
   gchar * ver;
 
   // First 2 lines for compatibility issues
-  i = 2;
-  j = 9;
+  i = 3;
+  j = 0;
   ver = g_strdup_printf ("%%\n%% project file v-%1d.%1d\n%%\n", i, j);
   if (save_this_string (fp, ver) != OK)
   {
@@ -254,6 +254,20 @@ int save_project (FILE * fp, project * this_proj, int wid)
       if (fwrite (this_proj -> sqw_q_id, sizeof(double), this_proj -> sqw_n_data_sets, fp) != this_proj -> sqw_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
     }
     if (fwrite (& this_proj -> sqw_freq, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    // Fs(k,t) k vectors, G(r,t) time steps and time origins stride
+    i = (this_proj -> fsk_k_id) ? this_proj -> fsk_n_data_sets : 0;
+    if (fwrite (& i, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    if (i)
+    {
+      if (fwrite (this_proj -> fsk_k_id, sizeof(double), this_proj -> fsk_n_data_sets, fp) != this_proj -> fsk_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    }
+    i = (this_proj -> vhf_step_id) ? this_proj -> vhf_n_data_sets : 0;
+    if (fwrite (& i, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    if (i)
+    {
+      if (fwrite (this_proj -> vhf_step_id, sizeof(int), this_proj -> vhf_n_data_sets, fp) != this_proj -> vhf_n_data_sets) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
+    }
+    if (fwrite (& this_proj -> vhf_stride, sizeof(int), 1, fp) != 1) return signal_error (__FILE__, __func__, __LINE__, ERROR_PROJECT);
   }
   if (this_proj -> natomes == 0 || this_proj -> nspec == 0)
   {
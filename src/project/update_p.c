@@ -143,6 +143,8 @@ void update_analysis_availability (project * this_proj)
     if (this_proj -> analysis[CHA]) this_proj -> analysis[CHA] -> avail_ok = TRUE;
     if (this_proj -> analysis[SPH]) this_proj -> analysis[SPH] -> avail_ok = TRUE;
     if (this_proj -> steps > 1 && this_proj -> analysis[MSD]) this_proj -> analysis[MSD] -> avail_ok = TRUE;
+    if (this_proj -> steps > 1 && this_proj -> analysis[FSK]) this_proj -> analysis[FSK] -> avail_ok = TRUE;
+    if (this_proj -> steps > 1 && this_proj -> analysis[VHF]) this_proj -> analysis[VHF] -> avail_ok = TRUE;
   }
   else if (this_proj -> analysis)
   {
@@ -46,6 +46,8 @@ extern void update_chains_view (project * this_proj);
 extern void update_spherical_view (project * this_proj);
 extern void update_msd_view (project * this_proj);
 extern void update_skt_view (project * this_proj);
+extern void update_fsk_view (project * this_proj);
+extern void update_vhf_view (project * this_proj);
 extern void model_info (project * this_proj, GtkTextBuffer * buf);
 extern void opengl_info (project * this_proj, GtkTextBuffer * buf);
 
@@ -132,6 +134,12 @@ void workinfo (project * this_proj, int i)
             case SKT:
               update_skt_view (this_proj);
               break;
+            case FSK:
+              update_fsk_view (this_proj);
+              break;
+            case VHF:
+              update_vhf_view (this_proj);
+              break;
           }
         }
       }
@@ -131,7 +131,7 @@ void add_project (GtkTreeStore * store, int i)
 
   for (j=0; j<NCALCS; j++)
   {
-    if (j < NCALCS-2 || get_project_by_id(i) -> steps > 1)
+    if (j < MSD || (j != SKT && get_project_by_id(i) -> steps > 1))
     {
       gtk_tree_store_append (store, & optslevel, & steplevel);
       gtk_tree_store_set (store, & optslevel, 0, gdk_pixbuf_new_from_file(graph_img[j], NULL), 1, _(graph_name[j]), 2, j, -1);
@@ -424,7 +424,7 @@ G_MODULE_EXPORT void change_project_name (GtkWidget * wid, gpointer edata)
     g_free (tmp_title);
     for (j=0; j<NCALCS; j++)
     {
-      if (this_proj -> analysis[j] -> init_ok)
+      if (this_proj -> analysis[j] && this_proj -> analysis[j] -> init_ok)
       {
         for (k=0; k<this_proj -> analysis[j] -> numc; k++)
         {